@@ -38,6 +38,13 @@
     The grid API also provides a generic interface for user supplied functions
     to edit, display, delete, copy and paste user data in each cell of the grid.
 
+    Each grid API keeps its own status and copied cell data, so distinct grid
+    APIs may be used from different threads at once.  A single grid API must
+    only be used by one thread at a time.
+
+    grid_api_do_batch() executes a vector of commands in one call, merging
+    runs of cursor movement commands into a single move.
+
   */
 
 #ifndef GRID_API_H
@@ -106,6 +113,18 @@ typedef union
   void *data;
 } grid_api_data_u;
 
+  /*!
+    @brief Structure to hold one command of a grid API batch
+  */
+
+typedef struct grid_api_cmd
+{
+    /*! @brief API command to execute */
+  grid_api_command_t command;
+    /*! @brief Data needed to execute command */
+  grid_api_data_u data;
+} grid_api_cmd_s;
+
   /*!
     @brief Grid data structure
   */
@@ -138,8 +157,12 @@ void grid_api_set_paste(grid_api_s *ga, grid_api_data_func func);
 
     // grid API command function
 
-grid_api_status_s *grid_api_do(grid_api_s *ga,
-                               grid_api_command_t command,
-                               grid_api_data_u data);
+const grid_api_status_s *grid_api_do(grid_api_s *ga,
+                                     grid_api_command_t command,
+                                     grid_api_data_u data);
+int grid_api_do_batch(grid_api_s *ga,
+                      const grid_api_cmd_s *cmds,
+                      int n,
+                      grid_api_status_s *statuses);
 
 #endif // GRID_API_H
@@ -0,0 +1,80 @@
+/*!
+    @file grid-binary.h
+
+    @brief Header file for grid binary data management routines
+
+    @timestamp Sat, 17 Oct 2026 02:57:12 +0000
+
+    @author Patrick Head  mailto:patrickhead@gmail.com
+
+    @copyright Copyright (C) 2014  Patrick Head
+
+    @license
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.@n
+    @n
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.@n
+    @n
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+  /*!
+
+    @file grid-binary.h
+
+    Header file for managing grid data to/from a binary file format.
+
+    A grid binary file holds a header, giving the number of rows and
+    columns, a row-major table of payload offsets, one per cell, and the
+    payload data of every non-empty cell, as serialized by a user function.
+
+    grid_binary_open() maps a grid binary file into memory, and returns a
+    read-only grid whose payload data points straight into the mapping, so
+    that opening a file takes the same time however many cells it holds.
+    Pages of the file are only read as cells are used.  The payload data of
+    a cell is 8 byte aligned, and its size is returned by
+    grid_binary_payload_size().
+
+    The file format uses the byte order of the machine writing it, and is
+    only opened on machines with the same byte order.
+
+  */
+
+#ifndef GRID_BINARY_H
+#define GRID_BINARY_H
+
+#include <stddef.h>
+
+  // Base type include file(s)
+
+#include "grid.h"
+
+  /*!
+    @brief Function template for user defined payload serialization
+
+    Serializes payload data into buf, which holds size bytes, returning the
+    number of bytes the serialized payload data needs.  When that exceeds
+    size, the function is called again with a large enough buf.
+  */
+
+typedef size_t (*grid_cell_to_binary)(void *payload,
+                                      void *buf,
+                                      size_t size,
+                                      void *data);
+
+  // Grid binary function prototypes
+
+int grid_binary_write(grid_s *g,
+                      const char *path,
+                      grid_cell_to_binary func,
+                      void *data);
+grid_s *grid_binary_open(const char *path);
+size_t grid_binary_payload_size(const void *payload);
+
+#endif // GRID_BINARY_H
@@ -0,0 +1,91 @@
+/*!
+    @file grid-csv.h
+
+    @brief Header file for grid CSV data management routines
+
+    @timestamp Sat, 17 Oct 2026 02:57:12 +0000
+
+    @author Patrick Head  mailto:patrickhead@gmail.com
+
+    @copyright Copyright (C) 2014  Patrick Head
+
+    @license
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.@n
+    @n
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.@n
+    @n
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+  /*!
+
+    @file grid-csv.h
+
+    Header file for managing grid data to/from CSV (comma separated values)
+    files.
+
+    Each line of a CSV file holds one row of a grid, with the fields of the
+    row separated by a delimiter, usually a comma or a tab.  Fields holding
+    the delimiter, double quotes, or line breaks are quoted as described by
+    RFC 4180, with double quotes doubled.  An empty field is an empty cell,
+    while a quoted empty field ("") is a cell holding an empty value, so that
+    grids without line breaks in their data survive a round trip unchanged.
+    Lines end with a line feed when written, and with a line feed or a
+    carriage return and line feed when read.
+
+    grid_from_csv() maps the file into memory, scans it once to size the
+    grid, and then fills the grid in row order, without copying the file or
+    growing the grid as it goes.  grid_to_csv() writes through a large
+    output buffer.
+
+  */
+
+#ifndef GRID_CSV_H
+#define GRID_CSV_H
+
+#include <stddef.h>
+
+  // Base type include file(s)
+
+#include "grid.h"
+
+  /*!
+    @brief Function templates for user defined field conversion
+
+    grid_cell_from_csv converts the len bytes of an unquoted field, which
+    are not terminated, into payload data, returning NULL for an empty cell.
+
+    grid_cell_to_csv converts payload data into text in buf, which holds
+    size bytes, returning the number of bytes the text needs.  When that
+    exceeds size, the function is called again with a large enough buf.
+  */
+
+typedef void *(*grid_cell_from_csv)(const char *field,
+                                    size_t len,
+                                    void *data);
+typedef size_t (*grid_cell_to_csv)(void *payload,
+                                   char *buf,
+                                   size_t size,
+                                   void *data);
+
+  // Grid CSV function prototypes
+
+grid_s *grid_from_csv(const char *path,
+                      char delimiter,
+                      grid_storage_t storage,
+                      grid_cell_from_csv func,
+                      void *data);
+int grid_to_csv(grid_s *g,
+                const char *path,
+                char delimiter,
+                grid_cell_to_csv func,
+                void *data);
+
+#endif // GRID_CSV_H
@@ -0,0 +1,126 @@
+/*!
+    @file grid-delta.h
+
+    @brief Header file for grid change journals and deltas
+
+    @timestamp Sat, 17 Oct 2026 02:57:12 +0000
+
+    @author Patrick Head  mailto:patrickhead@gmail.com
+
+    @copyright Copyright (C) 2014  Patrick Head
+
+    @license
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.@n
+    @n
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.@n
+    @n
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+  /*!
+
+    @file grid-delta.h
+
+    Header file for tracking the changes made to a grid, and for carrying
+    them to other grids as deltas.
+
+    A journal attached to a grid with grid_journal_create() records which
+    cells were set or cleared, and which rows and columns were inserted or
+    removed, since it was created.  grid_journal_checkpoint() returns a token
+    for the current state of the grid, and grid_delta_write() writes the
+    changes made since a token as a delta: the structural changes, in order,
+    followed by the final payload data of each changed cell, serialized by a
+    user function.  grid_delta_apply() makes the same changes to another
+    grid, so that a replica in the state of a token is brought up to date by
+    the delta since that token.
+
+    A cell changed many times is written once, and cells that were changed
+    and then removed are not written at all.  Sorting the rows of a grid
+    moves nearly every cell, so a delta spanning a sort rewrites the whole
+    grid instead.
+
+    grid_journal_trim() forgets the changes made before a token, once no
+    replica needs a delta from an earlier token.  The journal takes the
+    change function of its grid (see grid_set_notify()), and must be
+    destroyed before the grid is.
+
+    The delta format uses the byte order of the machine writing it, and is
+    only applied on machines with the same byte order.
+
+  */
+
+#ifndef GRID_DELTA_H
+#define GRID_DELTA_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+  // Base type include file(s)
+
+#include "grid.h"
+
+  /*!
+    @brief Grid change journal data structure
+  */
+
+typedef struct
+{
+    /*! @brief Pointer to internal information (encapsulates interface) */
+  void *_internals;
+} grid_journal_s;
+
+  /*!
+    @brief Function template for user defined payload serialization
+
+    Serializes payload data into buf, which holds size bytes, returning the
+    number of bytes the serialized payload data needs.  When that exceeds
+    size, the function is called again with a large enough buf.
+  */
+
+typedef size_t (*grid_cell_to_delta)(void *payload,
+                                     void *buf,
+                                     size_t size,
+                                     void *data);
+
+  /*!
+    @brief Function template for user defined payload de-serialization
+
+    Returns new payload data from the size bytes at buf, or NULL on failure.
+  */
+
+typedef void *(*grid_cell_from_delta)(const void *buf,
+                                      size_t size,
+                                      void *data);
+
+  // Grid journal function prototypes
+
+    // Structure management functions
+
+grid_journal_s *grid_journal_create(grid_s *g);
+void grid_journal_destroy(grid_journal_s *j);
+
+    // Checkpoint functions
+
+unsigned long grid_journal_checkpoint(grid_journal_s *j);
+void grid_journal_trim(grid_journal_s *j, unsigned long token);
+
+    // Delta functions
+
+int grid_delta_write(grid_journal_s *j,
+                     unsigned long since,
+                     FILE *fp,
+                     grid_cell_to_delta func,
+                     void *data);
+int grid_delta_apply(grid_s *g,
+                     FILE *fp,
+                     grid_cell_from_delta func,
+                     void *data);
+
+#endif // GRID_DELTA_H
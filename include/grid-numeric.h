@@ -0,0 +1,154 @@
+/*!
+    @file grid-numeric.h
+
+    @brief Header file for typed numeric grid data
+
+    @timestamp Sat, 17 Oct 2026 02:57:12 +0000
+
+    @author Patrick Head  mailto:patrickhead@gmail.com
+
+    @copyright Copyright (C) 2014  Patrick Head
+
+    @license
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.@n
+    @n
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.@n
+    @n
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+  /*!
+
+    @file grid-numeric.h
+
+    Header file for typed numeric grid data
+
+    A numeric grid holds numbers directly, rather than user payload data.
+    All cells of a numeric grid hold the same type of number, either double
+    or 64 bit integer, chosen when the grid is created.  Each column of the
+    grid is kept as one contiguous array of numbers, so that whole columns,
+    rows and rectangular ranges can be summarized quickly.
+
+    A cell either holds a number, or is empty.  Empty cells read as zero, and
+    are ignored by the summary functions.
+
+    Rows and columns are inserted and removed in the same manner as for a
+    grid (see grid.h).  A new numeric grid has no cells.
+
+  */
+
+#ifndef GRID_NUMERIC_H
+#define GRID_NUMERIC_H
+
+#include <stdint.h>
+
+  // Base type include file(s)
+
+#include "grid-size.h"
+
+  /*!
+    @brief enum defining numeric grid cell types
+  */
+
+typedef enum
+{
+  grid_numeric_double = 0,
+  grid_numeric_int64
+} grid_numeric_t;
+
+  /*!
+    @brief Numeric grid data structure
+  */
+
+typedef struct
+{
+    /*! @brief Pointer to internal information (encapsulates interface) */
+  void *_internals;
+} grid_numeric_s;
+
+  /*!
+    @brief Numeric grid summary structure
+
+    The integer members are exact, and are only set for int64 grids; cells
+    whose sum does not fit in an int64 can not be summarized.  With no
+    non-empty cells, every member is zero.
+  */
+
+typedef struct
+{
+    /*! @brief number of non-empty cells */
+  long count;
+    /*! @brief sum of cells */
+  double sum;
+    /*! @brief smallest cell */
+  double min;
+    /*! @brief largest cell */
+  double max;
+    /*! @brief mean of cells */
+  double mean;
+    /*! @brief sum of cells, int64 grids only */
+  int64_t isum;
+    /*! @brief smallest cell, int64 grids only */
+  int64_t imin;
+    /*! @brief largest cell, int64 grids only */
+  int64_t imax;
+} grid_numeric_stats_s;
+
+  // Numeric grid function prototypes
+
+    // Structure managment functions
+
+grid_numeric_s *grid_numeric_create(grid_numeric_t type);
+void grid_numeric_destroy(grid_numeric_s *gn);
+grid_numeric_t grid_numeric_get_type(grid_numeric_s *gn);
+
+    // Getters/setters
+
+int grid_numeric_set_size(grid_numeric_s *gn, grid_size_s *gs);
+grid_size_s *grid_numeric_get_size(grid_numeric_s *gn);
+
+    // Row/column management functions
+
+void grid_numeric_create_row(grid_numeric_s *gn, int row);
+void grid_numeric_create_column(grid_numeric_s *gn, int column);
+void grid_numeric_destroy_row(grid_numeric_s *gn, int row);
+void grid_numeric_destroy_column(grid_numeric_s *gn, int column);
+
+    // Cell management functions
+
+void grid_numeric_clear_cell(grid_numeric_s *gn, int row, int column);
+int grid_numeric_is_set(grid_numeric_s *gn, int row, int column);
+double grid_numeric_get_double(grid_numeric_s *gn, int row, int column);
+int grid_numeric_set_double(grid_numeric_s *gn,
+                            int row,
+                            int column,
+                            double value);
+int64_t grid_numeric_get_int64(grid_numeric_s *gn, int row, int column);
+void grid_numeric_set_int64(grid_numeric_s *gn,
+                            int row,
+                            int column,
+                            int64_t value);
+
+    // Summary functions
+
+int grid_numeric_stats(grid_numeric_s *gn,
+                       int row,
+                       int column,
+                       int rows,
+                       int columns,
+                       grid_numeric_stats_s *stats);
+int grid_numeric_row_stats(grid_numeric_s *gn,
+                           int row,
+                           grid_numeric_stats_s *stats);
+int grid_numeric_column_stats(grid_numeric_s *gn,
+                              int column,
+                              grid_numeric_stats_s *stats);
+
+#endif // GRID_NUMERIC_H
@@ -0,0 +1,108 @@
+/*!
+    @file grid-recalc.h
+
+    @brief Header file for grid recalculation
+
+    @timestamp Sat, 17 Oct 2026 02:57:12 +0000
+
+    @author Patrick Head  mailto:patrickhead@gmail.com
+
+    @copyright Copyright (C) 2014  Patrick Head
+
+    @license
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.@n
+    @n
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.@n
+    @n
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+  /*!
+
+    @file grid-recalc.h
+
+    Header file for dependency tracked recalculation of grid cells
+
+    A recalculation layer (grid_recalc_s) sits on top of a grid whose payload
+    data holds formulas, or other values computed from other cells.  Each
+    computed cell declares the cells, or ranges of cells, it depends on.
+    When a cell changes, grid_recalc_mark() marks every computed cell that
+    depends on it, directly or indirectly, as dirty.  grid_recalc_run() then
+    re-computes only the dirty cells, calling a user function for each, in
+    an order where every cell is computed after the cells it depends on.
+    Dirty cells that do not depend on each other are computed at once, by
+    the threads of a thread pool.
+
+    Cells are identified by position.  After inserting or removing rows or
+    columns of the grid, the computed cells must be declared again.
+
+  */
+
+#ifndef GRID_RECALC_H
+#define GRID_RECALC_H
+
+  // Base type include file(s)
+
+#include "grid.h"
+#include "thread-pool.h"
+
+  /*!
+    @brief Grid recalculation data structure
+  */
+
+typedef struct
+{
+    /*! @brief Pointer to internal information (encapsulates interface) */
+  void *_internals;
+} grid_recalc_s;
+
+  /*!
+    @brief Function template for user defined cell computation
+
+    Computes the cell at row, column, whose payload data is given, typically
+    storing the result in the payload data.  The function may be called from
+    several threads at once, for cells that do not depend on each other.  It
+    must read other cells of the grid through a grid cursor (grid_cursor_s),
+    never by moving the current cell of the grid, and must not change the
+    grid.
+  */
+
+typedef void (*grid_recalc_eval)(grid_s *g,
+                                 int row,
+                                 int column,
+                                 void *payload,
+                                 void *data);
+
+  // Grid recalculation function prototypes
+
+    // Structure management functions
+
+grid_recalc_s *grid_recalc_create(grid_s *g, grid_recalc_eval func, void *data);
+void grid_recalc_destroy(grid_recalc_s *gr);
+
+    // Dependency management functions
+
+int grid_recalc_set(grid_recalc_s *gr, int row, int column);
+void grid_recalc_unset(grid_recalc_s *gr, int row, int column);
+int grid_recalc_depend(grid_recalc_s *gr,
+                       int row,
+                       int column,
+                       int dep_row,
+                       int dep_column,
+                       int rows,
+                       int columns);
+
+    // Recalculation functions
+
+int grid_recalc_mark(grid_recalc_s *gr, int row, int column);
+int grid_recalc_is_dirty(grid_recalc_s *gr, int row, int column);
+int grid_recalc_run(grid_recalc_s *gr, thread_pool_s *pool);
+
+#endif // GRID_RECALC_H
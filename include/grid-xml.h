@@ -35,6 +35,12 @@
     Also includes a stream sieve function for building filter pipe lines on
     STDIO that can capture or edit existing color data in XML format.
 
+    Grids may also be streamed straight to a file with grid_write_xml(),
+    which emits the same XML vocabulary through an xmlTextWriter without
+    building a document tree first, optionally rendering bands of rows on
+    a thread pool.  grid_read_xml() is its counterpart, pulling cells from a
+    file through an xmlTextReader.
+
     NOTE:  The user is responsible for including at least <libxml/tree.h> in
            any source that includes this header.
 
@@ -45,6 +51,10 @@
 
   // Base type include file(s)
 
+#include <stdio.h>
+#include <libxml/xmlreader.h>
+#include <libxml/xmlwriter.h>
+
 #include "grid.h"
 
   /*!
@@ -53,6 +63,9 @@
 
 typedef xmlNodePtr (*grid_cell_to_xml_node)(void *payload);
 typedef void *(*grid_cell_from_xml_node)(xmlNodePtr node);
+typedef int (*grid_cell_to_xml_writer)(xmlTextWriterPtr writer,
+                                       void *payload);
+typedef void *(*grid_cell_from_xml_reader)(xmlTextReaderPtr reader);
 
   // grid-xml function prototypes
 
@@ -60,6 +73,8 @@ typedef void *(*grid_cell_from_xml_node)(xmlNodePtr node);
 
 xmlDocPtr grid_to_xml_doc(grid_s *g, grid_cell_to_xml_node func);
 xmlNodePtr grid_to_xml_node(grid_s *g, grid_cell_to_xml_node func);
+int grid_write_xml(grid_s *g, FILE *file, grid_cell_to_xml_writer func,
+                   thread_pool_s *pool);
 
     // Utility functions
 
@@ -69,6 +84,7 @@ xmlNodePtr grid_root_node(xmlDocPtr doc);
 
 grid_s *grid_from_xml_doc(xmlDocPtr doc, grid_cell_from_xml_node func);
 grid_s *grid_from_xml_node(xmlNodePtr node, grid_cell_from_xml_node func);
+grid_s *grid_read_xml(FILE *file, grid_cell_from_xml_reader func);
 
     // Filter functions
 
@@ -40,15 +40,121 @@
     Functions are provided for adding new rows and columns to the grid, as well
     as removing rows and columns.
 
+    The cells of a grid may be kept in one of several storage engines, chosen
+    when the grid is created.  The default "mesh" engine links every cell to
+    its neighbors as described above.  The "dense" engine keeps a row-major
+    array of payload pointers, which makes random access (grid_goto(),
+    grid_get_cell(), grid_set_cell()) constant time.  The "sparse" engine
+    keeps only non-empty cells in a hash table keyed by row and column, so
+    that empty cells cost nothing.  The "tiled" engine keeps cells in 64x64
+    blocks grouped into bands of rows, so that scans stay cache friendly and
+    inserting a row only shifts the rows of one band.  All grid functions
+    behave identically regardless of the storage engine in use; an empty cell
+    is simply a cell with a NULL payload.
+
+    Besides the current cell of the grid itself, any number of independent
+    cursors (grid_cursor_s) may be created for a grid.  Reading through a
+    cursor never modifies the grid, so several threads may traverse the same
+    grid at once, as long as no thread changes the grid meanwhile.
+
+    A grid may optionally keep a reference index, mapping payload data back
+    to the cell holding it, which makes grid_find_by_reference() a constant
+    time operation at the cost of extra work in every function that changes
+    the grid.
+
+    grid_find_first_by_value() and grid_find_all_by_value() search a grid
+    without moving its current cell, optionally splitting the rows of the
+    grid across the threads of a thread pool (thread_pool_s).
+
+    grid_sort_rows() sorts the rows of a grid by one or more key columns,
+    sorting in parallel on the threads of a thread pool, and then moving the
+    existing cells of each row into place.
+
+    grid_snapshot() takes a read-only snapshot of a grid, which later changes
+    to the grid do not affect, so that one thread may read a consistent grid
+    while another thread keeps changing it.  Snapshots of tiled grids share
+    tiles with the grid until either changes them.
+
+    grid_view_create() makes a view (grid_view_s), a rectangular window onto
+    the cells of a grid, optionally transposed.  A view copies no cells;
+    reading a view reads the grid it was made from, so that a range of a
+    large grid may be exported or searched without copying it first.
+
+    grid_create_mapped() makes a read-only grid over payload data already in
+    memory, typically a mapped file (see grid-binary.h), located through a
+    table of offsets, so that no cell is allocated when loading it.
+
+    grid_set_reclaim() hands the payload data a grid de-allocates to a
+    reclaimer (reclaim_s), so that destroying rows, columns or a whole grid
+    returns without waiting for every payload to be de-allocated.
+
+    grid_set_notify() registers a function told of every change to the cells
+    or structure of a grid, on which change journals (see grid-delta.h) are
+    built.
+
   */
 
 #ifndef GRID_H
 #define GRID_H
 
+#include <stdint.h>
+
   // Base type include file(s)
 
 #include "grid-size.h"
 #include "vertex.h"
+#include "vertices.h"
+#include "thread-pool.h"
+#include "reclaim.h"
+
+  /*!
+    @brief enum defining grid storage engines
+  */
+
+typedef enum
+{
+  grid_storage_mesh = 0,
+  grid_storage_dense,
+  grid_storage_sparse,
+  grid_storage_tiled,
+  grid_storage_view,
+  grid_storage_mapped
+} grid_storage_t;
+
+  /*!
+    @brief enum defining grid iteration orders
+  */
+
+typedef enum
+{
+  grid_order_rows = 0,
+  grid_order_columns
+} grid_order_t;
+
+  /*!
+    @brief enum defining kinds of grid changes
+
+    Changes are reported to a grid change function with the arguments:
+
+      grid_change_cell              row, column of cell
+      grid_change_size              new number of rows, new number of columns
+      grid_change_insert_rows       first new row, count
+      grid_change_insert_columns    first new column, count
+      grid_change_remove_rows       first removed row, count
+      grid_change_remove_columns    first removed column, count
+      grid_change_order             zero, zero, number of rows reordered
+  */
+
+typedef enum
+{
+  grid_change_cell = 0,
+  grid_change_size,
+  grid_change_insert_rows,
+  grid_change_insert_columns,
+  grid_change_remove_rows,
+  grid_change_remove_columns,
+  grid_change_order
+} grid_change_t;
 
   /*!
     @brief Grid data structure
@@ -60,21 +166,72 @@ typedef struct
   void *_internals;
 } grid_s;
 
+  /*!
+    @brief Grid view data structure, a read-only window onto another grid
+
+    A view is a grid in its own right, so that every function reading a grid
+    may be given a view.
+  */
+
+typedef grid_s grid_view_s;
+
+  /*!
+    @brief Grid cursor data structure
+  */
+
+typedef struct
+{
+    /*! @brief Pointer to internal information (encapsulates interface) */
+  void *_internals;
+} grid_cursor_s;
+
   /*!
     @brief Function templates for user defined data compare and free functions
   */
 
 typedef void (*grid_payload_free)(void *payload);
 typedef int (*grid_payload_compare)(void *pl1, void *pl2);
+typedef void (*grid_mapped_release)(void *data);
+
+  /*!
+    @brief Function templates for user defined iteration functions
+
+    An iteration function returns 0 to continue, or non-zero to stop the
+    iteration.  A span holds count payloads of a row, starting at column col.
+  */
+
+typedef int (*grid_cell_visit)(void *payload, int row, int col, void *data);
+typedef int (*grid_span_visit)(void * const *payloads,
+                               int row,
+                               int col,
+                               int count,
+                               void *data);
+
+  /*!
+    @brief Function template for user defined change functions
+
+    Called after each change to a grid, with arguments as described for
+    grid_change_t.  A change function must not change the grid.
+  */
+
+typedef void (*grid_change_notify)(grid_change_t change,
+                                   int row,
+                                   int col,
+                                   int count,
+                                   void *data);
 
   // Grid function prototypes
 
     // Structure managment functions 
 
 grid_s *grid_create(void);
+grid_s *grid_create_storage(grid_storage_t storage);
+grid_storage_t grid_get_storage(grid_s *g);
 void grid_destroy(grid_s *g);
 void grid_free(grid_s *g);
 void grid_set_free(grid_s *g, grid_payload_free func);
+void grid_set_reclaim(grid_s *g, reclaim_s *r);
+void grid_set_notify(grid_s *g, grid_change_notify func, void *data);
 
     // Getters/setters
 
@@ -82,6 +239,8 @@ void grid_set_size(grid_s *g, grid_size_s *gs);
 void grid_set_size_free_only(grid_s *g, grid_size_s *gs);
 grid_size_s *grid_get_size(grid_s *g);
 vertex_s *grid_get_location(grid_s *g);
+int grid_set_index(grid_s *g, int enable);
+int grid_get_index(grid_s *g);
 
     // Row/column management functions
 
@@ -91,6 +250,10 @@ void grid_free_row(grid_s *g, int row);
 void grid_free_column(grid_s *g, int column);
 void grid_destroy_row(grid_s *g, int row);
 void grid_destroy_column(grid_s *g, int column);
+void grid_create_rows(grid_s *g, int row, int count);
+void grid_create_columns(grid_s *g, int column, int count);
+void grid_destroy_rows(grid_s *g, int row, int count);
+void grid_destroy_columns(grid_s *g, int column, int count);
 
     // Cell management functions
 
@@ -104,6 +267,57 @@ void *grid_find_by_reference(grid_s *g, void *reference);
 void *grid_find_by_value(grid_s *g,
                        void *value,
                        grid_payload_compare func);
+void *grid_find_first_by_value(grid_s *g,
+                               void *value,
+                               grid_payload_compare func,
+                               thread_pool_s *pool,
+                               int *row,
+                               int *column);
+vertices_s *grid_find_all_by_value(grid_s *g,
+                                   void *value,
+                                   grid_payload_compare func,
+                                   thread_pool_s *pool);
+
+    // Sort functions
+
+int grid_sort_rows(grid_s *g,
+                   const int *keys,
+                   int nkeys,
+                   grid_payload_compare func,
+                   thread_pool_s *pool);
+
+    // Snapshot functions
+
+grid_s *grid_snapshot(grid_s *g);
+int grid_is_snapshot(grid_s *g);
+
+    // View functions
+
+grid_view_s *grid_view_create(grid_s *g,
+                              int row,
+                              int column,
+                              int rows,
+                              int columns,
+                              int transpose);
+void grid_view_destroy(grid_view_s *v);
+
+    // Mapped grid functions
+
+grid_s *grid_create_mapped(int rows,
+                           int columns,
+                           const uint64_t *offsets,
+                           const void *base,
+                           uint64_t limit,
+                           grid_mapped_release func,
+                           void *data);
+
+    // Cell iteration functions
+
+int grid_foreach(grid_s *g,
+                 grid_order_t order,
+                 grid_cell_visit func,
+                 void *data);
+int grid_foreach_row(grid_s *g, grid_span_visit func, void *data);
 
     // Cell "cursor" movement functions
 
@@ -116,4 +330,18 @@ void *grid_up(grid_s *g);
 void *grid_down(grid_s *g);
 void *grid_goto(grid_s *g, int row, int column);
 
+    // Independent cursor functions
+
+grid_cursor_s *grid_cursor_create(grid_s *g);
+grid_cursor_s *grid_cursor_copy(grid_cursor_s *gc);
+void grid_cursor_destroy(grid_cursor_s *gc);
+void grid_cursor_get_location(grid_cursor_s *gc, int *row, int *column);
+void *grid_cursor_get_cell(grid_cursor_s *gc);
+void *grid_cursor_origin(grid_cursor_s *gc);
+void *grid_cursor_left(grid_cursor_s *gc);
+void *grid_cursor_right(grid_cursor_s *gc);
+void *grid_cursor_up(grid_cursor_s *gc);
+void *grid_cursor_down(grid_cursor_s *gc);
+void *grid_cursor_goto(grid_cursor_s *gc, int row, int column);
+
 #endif // GRID_H
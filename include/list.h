@@ -38,11 +38,19 @@
     reference and data value.  Also, functions are provided for queue and stack
     operations.
 
+    list_set_reclaim() hands the payload data and items a list de-allocates to
+    a reclaimer (reclaim_s), so that destroying a long list returns without
+    waiting for every item to be de-allocated.
+
   */
 
 #ifndef LIST_H
 #define LIST_H
 
+  // Base type include file(s)
+
+#include "reclaim.h"
+
   /*!
     @brief Prototypes for user defined data free/compare functions
   */
@@ -79,6 +87,7 @@ list_s *list_create(void);
 void list_destroy(list_s * const list);
 void list_free(list_s * const list);
 void list_set_free(list_s * const list, list_payload_free func);
+void list_set_reclaim(list_s * const list, reclaim_s * const r);
 int list_len(list_s * const list);
 
     // Element operation functions
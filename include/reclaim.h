@@ -0,0 +1,85 @@
+/*!
+    @file reclaim.h
+
+    @brief Header file for deferred payload reclamation
+
+    @timestamp Sat, 17 Oct 2026 02:57:12 +0000
+
+    @author Patrick Head  mailto:patrickhead@gmail.com
+
+    @copyright Copyright (C) 2014  Patrick Head
+
+    @license
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.@n
+    @n
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.@n
+    @n
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+  /*!
+
+    @file reclaim.h
+
+    Header file for deferred payload reclamation
+
+    A reclaimer takes payload data, together with the function that
+    de-allocates it, and de-allocates it later, so that tearing down a large
+    structure need not wait for every payload to be de-allocated.  Payload
+    data is batched into chunks.  A background reclaimer de-allocates the
+    chunks in its own thread as they fill; otherwise the chunks are kept until
+    reclaim_flush() de-allocates them in the calling thread.
+
+    Grids and lists may be given a reclaimer, with grid_set_reclaim() and
+    list_set_reclaim(), to which they then hand payload data they would
+    otherwise de-allocate themselves.
+
+  */
+
+#ifndef RECLAIM_H
+#define RECLAIM_H
+
+  /*!
+    @brief Reclaimer data structure
+  */
+
+typedef struct
+{
+    /*! @brief Pointer to internal information (encapsulates interface) */
+  void *_internals;
+} reclaim_s;
+
+  /*!
+    @brief Function template for user defined payload de-allocation
+  */
+
+typedef void (*reclaim_free)(void *payload);
+
+  // Reclaimer function prototypes
+
+    // Structure management functions
+
+reclaim_s *reclaim_create(int background);
+void reclaim_destroy(reclaim_s *r);
+
+    // Getters
+
+long reclaim_get_pending(reclaim_s *r);
+
+    // Reclamation functions
+
+void reclaim_add(reclaim_s *r, void *payload, reclaim_free func);
+void reclaim_add_many(reclaim_s *r,
+                      void * const *payloads,
+                      int count,
+                      reclaim_free func);
+void reclaim_flush(reclaim_s *r);
+
+#endif // RECLAIM_H
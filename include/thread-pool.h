@@ -0,0 +1,82 @@
+/*!
+    @file thread-pool.h
+
+    @brief Header file for thread pool management
+
+    @timestamp Sat, 17 Oct 2026 02:57:12 +0000
+
+    @author Patrick Head  mailto:patrickhead@gmail.com
+
+    @copyright Copyright (C) 2014  Patrick Head
+
+    @license
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.@n
+    @n
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.@n
+    @n
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+  /*!
+
+    @file thread-pool.h
+
+    Header file for thread pool management
+
+    A thread pool is a fixed set of worker threads, created once, that run
+    jobs on behalf of other functions.  A job is a function called once for
+    each index in a range, with the indices spread over the worker threads
+    and the calling thread.  thread_pool_run() returns once every index of
+    the job has been run.
+
+    Jobs may be run from several threads at once, and a job may itself run
+    another job on the same pool.  A NULL pool runs every job serially in the
+    calling thread.
+
+  */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+  /*!
+    @brief Thread pool data structure
+  */
+
+typedef struct
+{
+    /*! @brief Pointer to internal information (encapsulates interface) */
+  void *_internals;
+} thread_pool_s;
+
+  /*!
+    @brief Function template for user defined jobs
+  */
+
+typedef void (*thread_pool_job)(int index, void *data);
+
+  // Thread pool function prototypes
+
+    // Structure management functions
+
+thread_pool_s *thread_pool_create(int threads);
+void thread_pool_destroy(thread_pool_s *tp);
+
+    // Getters
+
+int thread_pool_get_size(thread_pool_s *tp);
+
+    // Job functions
+
+void thread_pool_run(thread_pool_s *tp,
+                     int count,
+                     thread_pool_job func,
+                     void *data);
+
+#endif // THREAD_POOL_H
@@ -68,8 +68,18 @@ typedef struct _grid_api_internals
   grid_api_data_func copy_func;
     /*! @brief Pointer to user supplied cell payload data paste function */
   grid_api_data_func paste_func;
+    /*! @brief Status of last command */
+  grid_api_status_s stat;
+    /*! @brief Pointer to cell payload data last copied, for pasting */
+  void *savedata;
 } _grid_api_internals;
 
+  /*!
+    @brief Status returned for a grid API without internals, never changed
+  */
+
+static const grid_api_status_s _grid_api_failure = { -1, 0, 0, NULL, NULL };
+
   /*
     Internal function prototypes
   */
@@ -80,6 +90,12 @@ static grid_api_data_func _grid_api_get_show_func(grid_api_s *ga);
 static grid_api_data_func _grid_api_get_delete_func(grid_api_s *ga);
 static grid_api_data_func _grid_api_get_copy_func(grid_api_s *ga);
 static grid_api_data_func _grid_api_get_paste_func(grid_api_s *ga);
+static int _grid_api_is_valid(const grid_api_cmd_s *cmd);
+static int _grid_api_is_move(grid_api_command_t cmd);
+static void _grid_api_move(_grid_api_internals *gain,
+                           const grid_api_cmd_s *cmds,
+                           int n);
+static int _grid_api_clip(double v, int size);
 
   /*!
 
@@ -339,22 +355,27 @@ void grid_api_set_paste(grid_api_s *ga, grid_api_data_func f)
        grid_api_command_get_data       Nothing required
        grid_api_command_set_data       User data
 
+     The status returned, and the payload data saved by a copy command for
+     later paste commands, belong to the grid API.  The status is read-only,
+     and is overwritten by the next command given to the same grid API, so
+     that distinct grid APIs may be driven from different threads at once.
+
      @param ga    pointer to exising grid API
      @param cmd    API command to execute
      @param data    data needed to execute command
 
-     @retval "grid_api_status *" success
+     @retval "const grid_api_status_s *" success, or shared failure status
 
   */
 
-grid_api_status_s *grid_api_do(grid_api_s *ga,
-                               grid_api_command_t cmd,
-                               grid_api_data_u data)
+const grid_api_status_s *grid_api_do(grid_api_s *ga,
+                                     grid_api_command_t cmd,
+                                     grid_api_data_u data)
 {
-  static void *_savedata = NULL;
-  static grid_api_status_s stat;
   _grid_api_internals *grid_api;
+  grid_api_status_s *stat;
   int i;
+  int row, col;
   void *fr;
   grid_api_data_func func;
   vertex_s *v;
@@ -363,215 +384,301 @@ grid_api_status_s *grid_api_do(grid_api_s *ga,
     // Sanity check parameters.
   assert(ga);
 
-  memset(&stat, 0, sizeof(grid_api_status_s));
-
   grid_api = _grid_api_get_internals(ga);
-  if (!grid_api)
-  {
-    stat.code = -1;
-      // Return RETVAL
-    return &stat;
-  }
+  if (!grid_api) return &_grid_api_failure;
+
+  stat = &grid_api->stat;
+  memset(stat, 0, sizeof(grid_api_status_s));
 
   switch (cmd)
   {
     case grid_api_command_nop:
-      stat.code = 0;
+      stat->code = 0;
       break;
     case grid_api_command_up:
-      stat.code = 0;
+      stat->code = 0;
       for (i = 0; i < data.repeat; i++)
         grid_up(grid_api->grid);
       break;
     case grid_api_command_down:
-      stat.code = 0;
+      stat->code = 0;
       for (i = 0; i < data.repeat; i++)
         grid_down(grid_api->grid);
       break;
     case grid_api_command_left:
-      stat.code = 0;
+      stat->code = 0;
       for (i = 0; i < data.repeat; i++)
         grid_left(grid_api->grid);
       break;
     case grid_api_command_right:
-      stat.code = 0;
+      stat->code = 0;
       for (i = 0; i < data.repeat; i++)
         grid_right(grid_api->grid);
       break;
     case grid_api_command_home:
-      stat.code = 0;
+      stat->code = 0;
       grid_origin(grid_api->grid);
       break;
     case grid_api_command_end:
-      stat.code = 0;
+      stat->code = 0;
       grid_end(grid_api->grid);
       break;
     case grid_api_command_goto:
-      stat.code = 0;
+      stat->code = 0;
       grid_goto(grid_api->grid,
                 vertex_get_y(data.location) - 1,
                 vertex_get_x(data.location) - 1);
       break;
     case grid_api_command_edit:
-      stat.code = 0;
+      stat->code = 0;
       fr = NULL;
       func = _grid_api_get_edit_func(ga);
       fr = grid_get_cell(grid_api->grid);
       if (func) fr = func(fr);
       if (!fr)
-        stat.code = -1;
+        stat->code = -1;
       else
         grid_set_cell(grid_api->grid, fr);
       break;
     case grid_api_command_show:
-      stat.code = 0;
+      stat->code = 0;
       fr = NULL;
       func = _grid_api_get_show_func(ga);
       if (func) fr = func(grid_get_cell(grid_api->grid));
-      if (!fr) stat.code = -1;
+      if (!fr) stat->code = -1;
       break;
     case grid_api_command_delete:
-      stat.code = 0;
+      stat->code = 0;
       fr = NULL;
       func = _grid_api_get_delete_func(ga);
       if (func) fr = func(grid_get_cell(grid_api->grid));
-      if (!fr) stat.code = -1;
+      if (!fr) stat->code = -1;
       if (fr) grid_clear_cell(grid_api->grid);
       break;
     case grid_api_command_copy:
-      stat.code = 0;
+      stat->code = 0;
       fr = NULL;
       func = _grid_api_get_copy_func(ga);
       if (func) fr = func(grid_get_cell(grid_api->grid));
       if (fr)
-        _savedata = fr;
+        grid_api->savedata = fr;
       else
-        stat.code = -1;
+        stat->code = -1;
       break;
     case grid_api_command_paste:
-      stat.code = 0;
+      stat->code = 0;
       fr = NULL;
       func = _grid_api_get_paste_func(ga);
-      if (func) fr = func(_savedata);
+      if (func) fr = func(grid_api->savedata);
       if (fr)
         grid_set_cell(grid_api->grid, fr);
       else
-        stat.code = -1;
+        stat->code = -1;
       break;
     case grid_api_command_new_row:
-      stat.code = 0;
+      stat->code = 0;
       v = grid_get_location(grid_api->grid);
       if (v && data.repeat)
       {
+        row = (int)vertex_get_y(v);
         if (data.repeat < 0)
         {
           data.repeat = abs(data.repeat);
-          --v->y;
+          --row;
         }
-        for (i = 0; i < data.repeat; i++)
-          grid_create_row(grid_api->grid, v->y);
+        grid_create_rows(grid_api->grid, row, data.repeat);
       }
       else
-        stat.code = -1;
+        stat->code = -1;
       break;
     case grid_api_command_del_row:
-      stat.code = 0;
+      stat->code = 0;
       v = grid_get_location(grid_api->grid);
       if (v && data.repeat)
       {
-        --v->y;
+        row = (int)vertex_get_y(v) - 1;
         if (data.repeat < 0)
         {
           data.repeat = abs(data.repeat);
-          v->y -= data.repeat;
-          if (v->y < 0)
+          row -= data.repeat;
+          if (row < 0)
           {
-            data.repeat += v->y;
-            v->y = 0;
+            data.repeat += row;
+            row = 0;
           }
         }
-        for (i = 0; i < data.repeat; i++)
-          grid_destroy_row(grid_api->grid, v->y);
+        grid_destroy_rows(grid_api->grid, row, data.repeat);
       }
       else
-        stat.code = -1;
+        stat->code = -1;
       break;
     case grid_api_command_new_column:
-      stat.code = 0;
+      stat->code = 0;
       v = grid_get_location(grid_api->grid);
       if (v && data.repeat)
       {
+        col = (int)vertex_get_x(v);
         if (data.repeat < 0)
         {
           data.repeat = abs(data.repeat);
-          --v->x;
+          --col;
         }
-        for (i = 0; i < data.repeat; i++)
-          grid_create_column(grid_api->grid, v->x);
+        grid_create_columns(grid_api->grid, col, data.repeat);
       }
       else
-        stat.code = -1;
+        stat->code = -1;
       break;
     case grid_api_command_del_column:
-      stat.code = 0;
+      stat->code = 0;
       v = grid_get_location(grid_api->grid);
       if (v && data.repeat)
       {
+        col = (int)vertex_get_x(v);
         if (data.repeat < 0)
         {
           data.repeat = abs(data.repeat);
-          --v->x;
-          if (v->x < 0)
+          --col;
+          if (col < 0)
           {
-            stat.code = -1;
+            stat->code = -1;
             break;
           }
         }
-        for (i = 0; i < data.repeat; i++)
-          grid_destroy_column(grid_api->grid, v->x);
+        grid_destroy_columns(grid_api->grid, col, data.repeat);
       }
       else
-        stat.code = -1;
+        stat->code = -1;
       break;
     case grid_api_command_set_size:
-      stat.code = 0;
+      stat->code = 0;
       size = grid_size_create();
       grid_size_set(size,
                     vertex_get_y(data.location),
                     vertex_get_x(data.location));
       grid_set_size(grid_api->grid, size);
+      grid_size_destroy(size);
       break;
     case grid_api_command_get_size:
-      stat.code = 0;
+      stat->code = 0;
       break;
     case grid_api_command_get_data:
-      stat.code = 0;
-      stat.data = grid_get_cell(grid_api->grid);
-      if (!stat.data) stat.code = -1;
+      stat->code = 0;
+      stat->data = grid_get_cell(grid_api->grid);
+      if (!stat->data) stat->code = -1;
       break;
     case grid_api_command_set_data:
-      stat.code = 0;
+      stat->code = 0;
       if (data.data)
         grid_set_cell(grid_api->grid, data.data);
       else
-        stat.code = -1;
+        stat->code = -1;
       break;
   }
 
     // Get statistical information that accompanies all commands
   size = grid_get_size(grid_api->grid);
   if (!size)
-    stat.code = -1;
+    stat->code = -1;
   else
   {
-    stat.rows = grid_size_get_height(size);
-    stat.columns = grid_size_get_width(size);
+    stat->rows = grid_size_get_height(size);
+    stat->columns = grid_size_get_width(size);
+  }
+
+  stat->location = grid_get_location(grid_api->grid);
+
+    // Return "const grid_api_status_s *"
+  return stat;
+}
+
+  /*!
+
+     @brief Execute a batch of grid API commands
+
+     Executes a vector of commands in order, as if each were given to
+     grid_api_do() in turn.  Every command is validated before any is
+     executed: unknown commands, and goto or set_size commands without a
+     location, reject the whole batch.
+
+     Each run of adjacent cursor movement commands (up, down, left, right,
+     home, end and goto) is worked out without moving the cursor, which is
+     then moved once, to where the run leaves it.
+
+     The status of each command is copied to statuses, when given.  The
+     location of every status points to the current location of the grid,
+     as with grid_api_do(), so all show where the batch left the cursor.
+     When the batch is rejected, each status code is 0 if its command is
+     valid, and -1 if not.
+
+     @param ga    pointer to exising grid API
+     @param cmds    pointer to commands to execute
+     @param n    number of commands
+     @param statuses    pointer to n statuses to fill, or NULL
+
+     @retval "int" number of commands whose status code is not 0
+     @retval -1    batch rejected, no commands executed
+
+  */
+
+int grid_api_do_batch(grid_api_s *ga,
+                      const grid_api_cmd_s *cmds,
+                      int n,
+                      grid_api_status_s *statuses)
+{
+  _grid_api_internals *gain;
+  const grid_api_status_s *stat;
+  grid_api_data_u data;
+  int invalid = 0;
+  int failed = 0;
+  int i, j, k;
+
+    // Sanity check parameters.
+  assert(ga);
+  assert(cmds || n < 1);
+
+  gain = _grid_api_get_internals(ga);
+  if (!gain) return -1;
+
+  for (i = 0; i < n; i++)
+    if (!_grid_api_is_valid(&cmds[i])) ++invalid;
+
+  if (invalid)
+  {
+    if (statuses)
+    {
+      memset(&data, 0, sizeof(grid_api_data_u));
+      stat = grid_api_do(ga, grid_api_command_nop, data);
+      for (i = 0; i < n; i++)
+      {
+        statuses[i] = *stat;
+        statuses[i].code = _grid_api_is_valid(&cmds[i]) ? 0 : -1;
+      }
+    }
+    return -1;
   }
 
-  stat.location = grid_get_location(grid_api->grid);
+  for (i = 0; i < n; i = j)
+  {
+    j = i + 1;
+
+    if (_grid_api_is_move(cmds[i].command))
+    {
+      while (j < n && _grid_api_is_move(cmds[j].command)) ++j;
+      _grid_api_move(gain, cmds + i, j - i);
+      stat = grid_api_do(ga, grid_api_command_nop, cmds[i].data);
+    }
+    else
+      stat = grid_api_do(ga, cmds[i].command, cmds[i].data);
+
+    if (stat->code) failed += j - i;
+
+    if (statuses)
+      for (k = i; k < j; k++)
+        statuses[k] = *stat;
+  }
 
-    // Return "grid_api_status_s *"
-  return &stat;
+    // Return "int"
+  return failed;
 }
 
   /*!
@@ -730,3 +837,159 @@ static grid_api_data_func _grid_api_get_paste_func(grid_api_s *ga)
   return gain->paste_func;
 }
 
+  /*!
+
+     @brief INTERNAL:  Check a batch command can be executed
+
+     @param cmd    pointer to batch command
+
+     @retval 1    valid
+     @retval 0    invalid
+
+  */
+
+static int _grid_api_is_valid(const grid_api_cmd_s *cmd)
+{
+    // Sanity check parameters.
+  assert(cmd);
+
+  if (cmd->command < grid_api_command_nop ||
+      cmd->command > grid_api_command_set_data)
+    return 0;
+
+  if ((cmd->command == grid_api_command_goto ||
+       cmd->command == grid_api_command_set_size) &&
+      !cmd->data.location)
+    return 0;
+
+    // Return "int"
+  return 1;
+}
+
+  /*!
+
+     @brief INTERNAL:  Check whether a command only moves the cursor
+
+     @param cmd    API command
+
+     @retval 1    cursor movement command
+     @retval 0    other command
+
+  */
+
+static int _grid_api_is_move(grid_api_command_t cmd)
+{
+  switch (cmd)
+  {
+    case grid_api_command_up:
+    case grid_api_command_down:
+    case grid_api_command_left:
+    case grid_api_command_right:
+    case grid_api_command_home:
+    case grid_api_command_end:
+    case grid_api_command_goto:
+      return 1;
+    default:
+      break;
+  }
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Move the cursor once for a run of movement commands
+
+     Works out where the commands leave the cursor, limiting each step to
+     the grid as the single commands do, then moves there.
+
+     @param gain    pointer to grid API internals
+     @param cmds    pointer to cursor movement commands
+     @param n    number of commands
+
+     @retval NONE
+
+  */
+
+static void _grid_api_move(_grid_api_internals *gain,
+                           const grid_api_cmd_s *cmds,
+                           int n)
+{
+  grid_size_s *size;
+  vertex_s *v;
+  int height, width;
+  int row, col;
+  int i, r;
+
+    // Sanity check parameters.
+  assert(gain);
+  assert(cmds);
+
+  size = grid_get_size(gain->grid);
+  v = grid_get_location(gain->grid);
+  if (!size || !v) return;
+
+  height = grid_size_get_height(size);
+  width = grid_size_get_width(size);
+  if (height < 1 || width < 1) return;
+
+  row = (int)vertex_get_y(v);
+  col = (int)vertex_get_x(v);
+
+  for (i = 0; i < n; i++)
+  {
+    r = (cmds[i].data.repeat > 0) ? cmds[i].data.repeat : 0;
+
+    switch (cmds[i].command)
+    {
+      case grid_api_command_up:
+        row = (r > row) ? 0 : row - r;
+        break;
+      case grid_api_command_down:
+        row = (r > height - 1 - row) ? height - 1 : row + r;
+        break;
+      case grid_api_command_left:
+        col = (r > col) ? 0 : col - r;
+        break;
+      case grid_api_command_right:
+        col = (r > width - 1 - col) ? width - 1 : col + r;
+        break;
+      case grid_api_command_home:
+        row = col = 0;
+        break;
+      case grid_api_command_end:
+        row = height - 1;
+        col = width - 1;
+        break;
+      case grid_api_command_goto:
+        row = _grid_api_clip(vertex_get_y(cmds[i].data.location) - 1, height);
+        col = _grid_api_clip(vertex_get_x(cmds[i].data.location) - 1, width);
+        break;
+      default:
+        break;
+    }
+  }
+
+  grid_goto(gain->grid, row, col);
+}
+
+  /*!
+
+     @brief INTERNAL:  Limit a row or column to a grid
+
+     @param v    row or column
+     @param size    number of rows or columns in grid
+
+     @retval "int" nearest row or column of grid
+
+  */
+
+static int _grid_api_clip(double v, int size)
+{
+  if (v < 0) return 0;
+  if (v > size - 1) return size - 1;
+
+    // Return "int"
+  return (int)v;
+}
@@ -0,0 +1,418 @@
+/*!
+    @file grid-binary.c
+
+    @brief Source file for grid binary data management routines
+
+    @timestamp Sat, 17 Oct 2026 02:57:12 +0000
+
+    @author Patrick Head  mailto:patrickhead@gmail.com
+
+    @copyright Copyright (C) 2014  Patrick Head
+
+    @license
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.@n
+    @n
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.@n
+    @n
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+  /*!
+
+    @file grid-binary.c
+
+    Source file for managing grid data to/from a binary file format.
+
+    File layout, every part 8 byte aligned:
+
+      header          _grid_binary_header
+      offset table    rows * columns uint64_t, offset of payload data of
+                      each cell from the start of the payload section, or
+                      zero for an empty cell
+      payload data    for each non-empty cell, a uint64_t size followed by
+                      size bytes of serialized payload data, padded to 8
+                      bytes
+
+  */
+
+  // Required system headers
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+  // Project related headers
+
+#include "grid-binary.h"
+
+  // Common constants
+
+#define GRID_BINARY_MAGIC "GRAYGRID"
+#define GRID_BINARY_VERSION 1
+#define GRID_BINARY_ORDER 0x01020304
+
+  /*!
+    @brief INTERNAL: grid binary file header
+  */
+
+typedef struct
+{
+    /*! @brief: GRID_BINARY_MAGIC, not terminated */
+  char magic[8];
+    /*! @brief: GRID_BINARY_VERSION */
+  uint32_t version;
+    /*! @brief: GRID_BINARY_ORDER, in the byte order of the file */
+  uint32_t order;
+    /*! @brief: number of rows */
+  uint64_t rows;
+    /*! @brief: number of columns */
+  uint64_t cols;
+    /*! @brief: file offset of offset table */
+  uint64_t table;
+    /*! @brief: file offset of payload data */
+  uint64_t data;
+    /*! @brief: size of payload data */
+  uint64_t size;
+} _grid_binary_header;
+
+  /*!
+    @brief INTERNAL: binary export details structure
+  */
+
+typedef struct
+{
+    /*! @brief: file written */
+  FILE *fp;
+    /*! @brief: offset table */
+  uint64_t *offsets;
+    /*! @brief: number of columns */
+  int cols;
+    /*! @brief: size of payload data written so far */
+  uint64_t size;
+    /*! @brief: serialization buffer */
+  void *buf;
+    /*! @brief: size of serialization buffer */
+  size_t cap;
+    /*! @brief: user serialization function */
+  grid_cell_to_binary func;
+    /*! @brief: user data for serialization function */
+  void *data;
+} _grid_binary_export;
+
+  /*!
+    @brief INTERNAL: file mapping of an open grid
+  */
+
+typedef struct
+{
+    /*! @brief: address of mapping */
+  void *addr;
+    /*! @brief: size of mapping */
+  size_t len;
+} _grid_binary_map;
+
+  // INTERNAL: utility function prototypes for module
+
+static int _grid_binary_export_span(void * const *payloads, int row, int col,
+                                    int count, void *data);
+static void _grid_binary_unmap(void *data);
+
+  /*!
+
+     @brief Write grid data to a binary file
+
+     Writes the cells of a grid to a grid binary file, serializing the
+     payload data of every non-empty cell with a user function.
+
+     @param g    pointer to grid data structure
+     @param path    path of file to write
+     @param func    pointer to user serialization function
+     @param data    pointer to user data for serialization function, or NULL
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+int grid_binary_write(grid_s *g,
+                      const char *path,
+                      grid_cell_to_binary func,
+                      void *data)
+{
+  _grid_binary_header hdr;
+  _grid_binary_export ex;
+  size_t cells;
+  int rows;
+  int rc = 0;
+
+    // Sanity check parameters.
+  assert(g);
+  assert(path);
+  assert(func);
+
+  rows = grid_size_get_height(grid_get_size(g));
+
+  memset(&ex, 0, sizeof(_grid_binary_export));
+  ex.cols = grid_size_get_width(grid_get_size(g));
+  ex.func = func;
+  ex.data = data;
+
+  if (!rows || !ex.cols) rows = ex.cols = 0;
+  cells = (size_t)rows * ex.cols;
+
+  memset(&hdr, 0, sizeof(_grid_binary_header));
+  memcpy(hdr.magic, GRID_BINARY_MAGIC, sizeof(hdr.magic));
+  hdr.version = GRID_BINARY_VERSION;
+  hdr.order = GRID_BINARY_ORDER;
+  hdr.rows = (uint64_t)rows;
+  hdr.cols = (uint64_t)ex.cols;
+  hdr.table = sizeof(_grid_binary_header);
+  hdr.data = hdr.table + cells * sizeof(uint64_t);
+
+  ex.offsets = (uint64_t *)calloc(cells + 1, sizeof(uint64_t));
+  if (!ex.offsets) return -1;
+
+  ex.fp = fopen(path, "wb");
+  if (!ex.fp)
+  {
+    free(ex.offsets);
+    return -1;
+  }
+
+    // Payload data follows the offset table, which is written last
+  if (fseek(ex.fp, (long)hdr.data, SEEK_SET) ||
+      (cells && grid_foreach_row(g, _grid_binary_export_span, &ex)))
+    rc = -1;
+
+  hdr.size = ex.size;
+
+  if (!rc &&
+      (fseek(ex.fp, 0, SEEK_SET) ||
+       fwrite(&hdr, sizeof(_grid_binary_header), 1, ex.fp) != 1 ||
+       (cells &&
+        fwrite(ex.offsets, sizeof(uint64_t), cells, ex.fp) != cells)))
+    rc = -1;
+
+  if (fclose(ex.fp)) rc = -1;
+
+  free(ex.offsets);
+  free(ex.buf);
+
+    // Return "int"
+  return rc;
+}
+
+  /*!
+
+     @brief Open a grid binary file as a read-only grid
+
+     Maps the file into memory, and returns a read-only grid whose payload
+     data points into the mapping (see grid_create_mapped()).  Only the
+     header is checked; cells are neither read nor allocated.  A cell whose
+     offset or size lies outside of the payload data of the file reads as
+     empty.  The mapping is released when the grid is destroyed.
+
+     @param path    path of file to open
+
+     @retval "grid_s *" success
+     @retval NULL    failure
+
+  */
+
+grid_s *grid_binary_open(const char *path)
+{
+  const _grid_binary_header *hdr;
+  _grid_binary_map *map;
+  struct stat st;
+  const char *addr;
+  uint64_t cells;
+  grid_s *g;
+  int fd;
+
+    // Sanity check parameters.
+  assert(path);
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0) return NULL;
+
+  if (fstat(fd, &st) ||
+      (uint64_t)st.st_size < sizeof(_grid_binary_header) ||
+      (uint64_t)st.st_size > SIZE_MAX)
+  {
+    close(fd);
+    return NULL;
+  }
+
+  addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) return NULL;
+
+  hdr = (const _grid_binary_header *)addr;
+  cells = hdr->rows * hdr->cols;
+
+  if (memcmp(hdr->magic, GRID_BINARY_MAGIC, sizeof(hdr->magic)) ||
+      hdr->version != GRID_BINARY_VERSION ||
+      hdr->order != GRID_BINARY_ORDER ||
+      hdr->rows > INT_MAX || hdr->cols > INT_MAX ||
+      (hdr->rows && cells / hdr->rows != hdr->cols) ||
+      hdr->table % sizeof(uint64_t) || hdr->data % sizeof(uint64_t) ||
+      hdr->table < sizeof(_grid_binary_header) ||
+      hdr->data < hdr->table ||
+      (hdr->data - hdr->table) / sizeof(uint64_t) < cells ||
+      hdr->data > (uint64_t)st.st_size ||
+      hdr->size > (uint64_t)st.st_size - hdr->data)
+  {
+    munmap((void *)addr, (size_t)st.st_size);
+    return NULL;
+  }
+
+  map = (_grid_binary_map *)malloc(sizeof(_grid_binary_map));
+  if (!map)
+  {
+    munmap((void *)addr, (size_t)st.st_size);
+    return NULL;
+  }
+  map->addr = (void *)addr;
+  map->len = (size_t)st.st_size;
+
+  g = grid_create_mapped((int)hdr->rows,
+                         (int)hdr->cols,
+                         (const uint64_t *)(addr + hdr->table),
+                         addr + hdr->data,
+                         hdr->size,
+                         _grid_binary_unmap,
+                         map);
+  if (!g) _grid_binary_unmap(map);
+
+    // Return "grid_s *"
+  return g;
+}
+
+  /*!
+
+     @brief Get size of payload data of a cell of an open grid binary file
+
+     The payload data must have been got from a grid returned by
+     grid_binary_open(), which only hands out payload data lying wholly
+     within the file.
+
+     @param payload    pointer to payload data of a cell
+
+     @retval "size_t" number of bytes of payload data
+     @retval 0    payload data is not 8 byte aligned
+
+  */
+
+size_t grid_binary_payload_size(const void *payload)
+{
+    // Sanity check parameters.
+  assert(payload);
+
+  if ((uintptr_t)payload % sizeof(uint64_t)) return 0;
+
+    // Return "size_t"
+  return (size_t)((const uint64_t *)payload)[-1];
+}
+
+// STATIC functions
+
+  /*!
+
+     @brief INTERNAL:  Write the payload data of a span of grid cells
+
+     @param payloads    pointer to payload data of span
+     @param row    row of span
+     @param col    first column of span
+     @param count    number of cells in span
+     @param data    pointer to binary export details
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_binary_export_span(void * const *payloads, int row, int col,
+                                    int count, void *data)
+{
+  static const char pad[sizeof(uint64_t)];
+  _grid_binary_export *ex;
+  uint64_t size;
+  size_t n;
+  void *p;
+  int i;
+
+    // Sanity check parameters.
+  assert(payloads);
+  assert(data);
+
+  ex = (_grid_binary_export *)data;
+
+  for (i = 0; i < count; ++i)
+  {
+    if (!payloads[i]) continue;
+
+    n = ex->func(payloads[i], ex->buf, ex->cap, ex->data);
+    if (n > ex->cap)
+    {
+      p = realloc(ex->buf, n);
+      if (!p) return -1;
+      ex->buf = p;
+      ex->cap = n;
+      n = ex->func(payloads[i], ex->buf, ex->cap, ex->data);
+      if (n > ex->cap) return -1;
+    }
+
+    size = (uint64_t)n;
+    if (fwrite(&size, sizeof(uint64_t), 1, ex->fp) != 1 ||
+        (n && fwrite(ex->buf, 1, n, ex->fp) != n) ||
+        (n % sizeof(uint64_t) &&
+         fwrite(pad, 1, sizeof(uint64_t) - n % sizeof(uint64_t), ex->fp) !=
+           sizeof(uint64_t) - n % sizeof(uint64_t)))
+      return -1;
+
+    ex->offsets[(size_t)row * ex->cols + col + i] = ex->size + sizeof(uint64_t);
+    ex->size += sizeof(uint64_t) +
+                (n + sizeof(uint64_t) - 1) / sizeof(uint64_t) *
+                  sizeof(uint64_t);
+  }
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Release the file mapping of an open grid
+
+     @param data    pointer to file mapping
+
+     @retval NONE
+
+  */
+
+static void _grid_binary_unmap(void *data)
+{
+  _grid_binary_map *map;
+
+    // Sanity check parameters.
+  assert(data);
+
+  map = (_grid_binary_map *)data;
+
+  munmap(map->addr, map->len);
+  free(map);
+}
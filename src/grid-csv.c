@@ -0,0 +1,1023 @@
+/*!
+    @file grid-csv.c
+
+    @brief Source file for grid CSV data management routines
+
+    @timestamp Sat, 17 Oct 2026 02:57:12 +0000
+
+    @author Patrick Head  mailto:patrickhead@gmail.com
+
+    @copyright Copyright (C) 2014  Patrick Head
+
+    @license
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.@n
+    @n
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.@n
+    @n
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+  /*!
+
+    @file grid-csv.c
+
+    Source file for managing grid data to/from CSV files.
+
+    Both directions spend most of their time looking for the few bytes that
+    matter to CSV: the delimiter, double quotes and line breaks.  Where SSE2
+    is available, these are found 16 bytes at a time.
+
+  */
+
+  // Required system headers
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define GRID_CSV_SSE2 1
+#endif
+
+  // Project related headers
+
+#include "grid-csv.h"
+
+  // Common constants
+
+#define CSV_BUFFER (1 << 20)
+
+  /*!
+    @brief INTERNAL: how a CSV field ends
+  */
+
+typedef enum
+{
+    /*! @brief: followed by a delimiter */
+  _grid_csv_delimiter,
+    /*! @brief: followed by a line break */
+  _grid_csv_line,
+    /*! @brief: at the end of the file */
+  _grid_csv_eof
+} _grid_csv_end;
+
+  /*!
+    @brief INTERNAL: CSV field details structure
+  */
+
+typedef struct
+{
+    /*! @brief: first byte of field, after any opening quote */
+  const char *start;
+    /*! @brief: number of bytes in field, before any closing quote */
+  size_t len;
+    /*! @brief: non-zero when the field is quoted */
+  int quoted;
+    /*! @brief: non-zero when the field holds doubled quotes */
+  int escaped;
+    /*! @brief: how the field ends */
+  _grid_csv_end end;
+} _grid_csv_field;
+
+  /*!
+    @brief INTERNAL: CSV scanner structure
+  */
+
+typedef struct
+{
+    /*! @brief: pointer past end of CSV data */
+  const char *end;
+    /*! @brief: field delimiter */
+  char delimiter;
+    /*! @brief: last 16 bytes examined, or NULL */
+  const char *block;
+    /*! @brief: bytes of interest found in block */
+  unsigned int mask;
+} _grid_csv_scanner;
+
+  /*!
+    @brief INTERNAL: count of lines and fields of CSV data
+  */
+
+typedef struct
+{
+    /*! @brief: number of lines */
+  long height;
+    /*! @brief: number of fields in widest line */
+  long width;
+    /*! @brief: number of fields so far in current line */
+  long col;
+    /*! @brief: non-zero within a quoted field */
+  int quoted;
+    /*! @brief: start of current field */
+  const char *field;
+    /*! @brief: bytes before this are skipped, after a doubled quote */
+  const char *skip;
+} _grid_csv_count;
+
+  /*!
+    @brief INTERNAL: CSV export details structure
+  */
+
+typedef struct
+{
+    /*! @brief: file written */
+  FILE *fp;
+    /*! @brief: output buffer, CSV_BUFFER bytes */
+  char *out;
+    /*! @brief: number of bytes used in output buffer */
+  size_t used;
+    /*! @brief: conversion buffer for cells not fitting the output buffer */
+  char *buf;
+    /*! @brief: size of conversion buffer */
+  size_t cap;
+    /*! @brief: number of columns */
+  int cols;
+    /*! @brief: field delimiter */
+  char delimiter;
+    /*! @brief: user conversion function */
+  grid_cell_to_csv func;
+    /*! @brief: user data for conversion function */
+  void *data;
+} _grid_csv_export;
+
+  // INTERNAL: utility function prototypes for module
+
+#ifdef GRID_CSV_SSE2
+static unsigned int _grid_csv_mask(const char *p, char delimiter);
+static unsigned int _grid_csv_masks(const char *p, char delimiter,
+                                    unsigned int *d, unsigned int *n);
+#endif
+static const char *_grid_csv_scan(const char *p, const char *end,
+                                  char delimiter);
+static const char *_grid_csv_next(_grid_csv_scanner *sc, const char *p);
+static const char *_grid_csv_parse(_grid_csv_scanner *sc, const char *p,
+                                   _grid_csv_field *f);
+static int _grid_csv_measure(const char *p, const char *end, char delimiter,
+                             int *rows, int *cols);
+static int _grid_csv_count_byte(_grid_csv_count *c, const char *q,
+                                const char *end, char delimiter);
+static int _grid_csv_count_line(_grid_csv_count *c);
+static int _grid_csv_fill(grid_s *g, const char *p, const char *end,
+                          char delimiter, grid_cell_from_csv func,
+                          void *data, char **buf, size_t *cap);
+static int _grid_csv_export_span(void * const *payloads, int row, int col,
+                                 int count, void *data);
+static int _grid_csv_put_cell(_grid_csv_export *ex, void *payload);
+static int _grid_csv_put_quoted(_grid_csv_export *ex, const char *s,
+                                size_t n);
+static int _grid_csv_put(_grid_csv_export *ex, const char *s, size_t n);
+static int _grid_csv_flush(_grid_csv_export *ex);
+
+  /*!
+
+     @brief Read a CSV file into a new grid
+
+     Maps the file into memory and scans it once to find the number of rows
+     and the widest row, which size a new grid using the given storage
+     engine.  The fields are then converted with a user function and stored
+     in row order; short rows leave the cells at their ends empty, and empty
+     unquoted fields are not converted.  Quoted fields are handed to the
+     user function with doubled quotes undone.  Quotes within unquoted fields
+     are taken literally, while text between a closing quote and the end of
+     its field is ignored.
+
+     @param path    path of file to read
+     @param delimiter    field delimiter, such as ',' or '\t'
+     @param storage    storage engine of new grid
+     @param func    pointer to user conversion function
+     @param data    pointer to user data for conversion function, or NULL
+
+     @retval "grid_s *" success
+     @retval NULL    failure
+
+  */
+
+grid_s *grid_from_csv(const char *path,
+                      char delimiter,
+                      grid_storage_t storage,
+                      grid_cell_from_csv func,
+                      void *data)
+{
+  struct stat st;
+  grid_size_s *gs;
+  grid_s *g;
+  const char *addr = NULL;
+  char *buf = NULL;
+  size_t cap = 0;
+  int rows = 0, cols = 0;
+  int fd;
+
+    // Sanity check parameters.
+  assert(path);
+  assert(func);
+  assert(delimiter != '"' && delimiter != '\n' && delimiter != '\r');
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0) return NULL;
+
+  if (fstat(fd, &st) || (uint64_t)st.st_size > SIZE_MAX)
+  {
+    close(fd);
+    return NULL;
+  }
+
+  if (st.st_size)
+  {
+    addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED)
+    {
+      close(fd);
+      return NULL;
+    }
+    madvise((void *)addr, (size_t)st.st_size, MADV_SEQUENTIAL);
+  }
+  close(fd);
+
+  g = NULL;
+  gs = grid_size_create();
+
+  if (gs &&
+      !_grid_csv_measure(addr, addr + st.st_size, delimiter, &rows, &cols))
+    g = grid_create_storage(storage);
+
+  if (g)
+  {
+    grid_size_set(gs, cols, rows);
+    grid_set_size(g, gs);
+
+    if (_grid_csv_fill(g, addr, addr + st.st_size, delimiter, func, data,
+                       &buf, &cap))
+    {
+      grid_destroy(g);
+      g = NULL;
+    }
+    else
+      grid_origin(g);
+  }
+
+  if (gs) grid_size_destroy(gs);
+  if (addr) munmap((void *)addr, (size_t)st.st_size);
+  free(buf);
+
+    // Return "grid_s *"
+  return g;
+}
+
+  /*!
+
+     @brief Write grid data to a CSV file
+
+     Writes each row of a grid as a line of a CSV file, converting the
+     payload data of every non-empty cell with a user function.  Empty cells
+     are written as empty fields, and fields that are empty or hold the
+     delimiter, double quotes or line breaks are quoted.
+
+     @param g    pointer to grid data structure
+     @param path    path of file to write
+     @param delimiter    field delimiter, such as ',' or '\t'
+     @param func    pointer to user conversion function
+     @param data    pointer to user data for conversion function, or NULL
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+int grid_to_csv(grid_s *g,
+                const char *path,
+                char delimiter,
+                grid_cell_to_csv func,
+                void *data)
+{
+  _grid_csv_export ex;
+  int rc = 0;
+
+    // Sanity check parameters.
+  assert(g);
+  assert(path);
+  assert(func);
+  assert(delimiter != '"' && delimiter != '\n' && delimiter != '\r');
+
+  memset(&ex, 0, sizeof(_grid_csv_export));
+  ex.cols = grid_size_get_width(grid_get_size(g));
+  ex.delimiter = delimiter;
+  ex.func = func;
+  ex.data = data;
+
+  ex.out = (char *)malloc(CSV_BUFFER);
+  if (!ex.out) return -1;
+
+  ex.fp = fopen(path, "wb");
+  if (!ex.fp)
+  {
+    free(ex.out);
+    return -1;
+  }
+
+  if (grid_foreach_row(g, _grid_csv_export_span, &ex) ||
+      _grid_csv_flush(&ex))
+    rc = -1;
+
+  if (fclose(ex.fp)) rc = -1;
+
+  free(ex.out);
+  free(ex.buf);
+
+    // Return "int"
+  return rc;
+}
+
+// STATIC functions
+
+#ifdef GRID_CSV_SSE2
+
+  /*!
+
+     @brief INTERNAL:  Find the bytes of interest to CSV in 16 bytes
+
+     @param p    pointer to first of 16 bytes to examine
+     @param delimiter    field delimiter
+
+     @retval "unsigned int" mask with bit i set when p[i] is a delimiter,
+                            double quote, carriage return or line feed
+
+  */
+
+static unsigned int _grid_csv_mask(const char *p, char delimiter)
+{
+  __m128i v;
+
+    // Sanity check parameters.
+  assert(p);
+
+  v = _mm_loadu_si128((const __m128i *)p);
+
+    // Return "unsigned int"
+  return (unsigned int)_mm_movemask_epi8(
+           _mm_or_si128(
+             _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(delimiter)),
+                          _mm_cmpeq_epi8(v, _mm_set1_epi8('"'))),
+             _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')),
+                          _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')))));
+}
+
+  /*!
+
+     @brief INTERNAL:  Find the bytes of interest to CSV in 16 bytes, by kind
+
+     @param p    pointer to first of 16 bytes to examine
+     @param delimiter    field delimiter
+     @param d    pointer to mask of delimiters, set on return
+     @param n    pointer to mask of line feeds, set on return
+
+     @retval "unsigned int" mask of every byte of interest, as returned by
+                            _grid_csv_mask()
+
+  */
+
+static unsigned int _grid_csv_masks(const char *p, char delimiter,
+                                    unsigned int *d, unsigned int *n)
+{
+  __m128i v, vd, vn;
+
+    // Sanity check parameters.
+  assert(p);
+  assert(d);
+  assert(n);
+
+  v = _mm_loadu_si128((const __m128i *)p);
+  vd = _mm_cmpeq_epi8(v, _mm_set1_epi8(delimiter));
+  vn = _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'));
+
+  *d = (unsigned int)_mm_movemask_epi8(vd);
+  *n = (unsigned int)_mm_movemask_epi8(vn);
+
+    // Return "unsigned int"
+  return (unsigned int)_mm_movemask_epi8(
+           _mm_or_si128(
+             _mm_or_si128(vd, _mm_cmpeq_epi8(v, _mm_set1_epi8('"'))),
+             _mm_or_si128(vn, _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')))));
+}
+
+#endif
+
+  /*!
+
+     @brief INTERNAL:  Find the next byte of interest to CSV
+
+     @param p    pointer to first byte to examine
+     @param end    pointer past last byte to examine
+     @param delimiter    field delimiter
+
+     @retval "const char *" pointer to next delimiter, double quote, carriage
+                            return or line feed, or end
+
+  */
+
+static const char *_grid_csv_scan(const char *p, const char *end,
+                                  char delimiter)
+{
+#ifdef GRID_CSV_SSE2
+  unsigned int mask;
+
+  for (; end - p >= 16; p += 16)
+  {
+    mask = _grid_csv_mask(p, delimiter);
+    if (mask) return p + __builtin_ctz(mask);
+  }
+#endif
+
+  while (p < end &&
+         *p != delimiter && *p != '"' && *p != '\r' && *p != '\n')
+    ++p;
+
+    // Return "const char *"
+  return p;
+}
+
+  /*!
+
+     @brief INTERNAL:  Find the next byte of interest to CSV with a scanner
+
+     Like _grid_csv_scan(), but keeps the bytes of interest found in the
+     last 16 bytes examined, so that short fields are not examined again.
+
+     @param sc    pointer to scanner
+     @param p    pointer to first byte to examine
+
+     @retval "const char *" pointer to next delimiter, double quote, carriage
+                            return or line feed, or end of data
+
+  */
+
+static const char *_grid_csv_next(_grid_csv_scanner *sc, const char *p)
+{
+#ifdef GRID_CSV_SSE2
+  unsigned int mask;
+
+    // Sanity check parameters.
+  assert(sc);
+
+  for (;;)
+  {
+    if (sc->block && p >= sc->block && p < sc->block + 16)
+    {
+      mask = sc->mask & (~0u << (p - sc->block));
+      if (mask) return sc->block + __builtin_ctz(mask);
+      p = sc->block + 16;
+    }
+
+    if (sc->end - p < 16) break;
+
+    sc->block = p;
+    sc->mask = _grid_csv_mask(p, sc->delimiter);
+  }
+#endif
+
+    // Return "const char *"
+  return _grid_csv_scan(p, sc->end, sc->delimiter);
+}
+
+  /*!
+
+     @brief INTERNAL:  Parse one CSV field
+
+     @param sc    pointer to scanner of CSV data
+     @param p    pointer to start of field
+     @param f    pointer to field details to fill
+
+     @retval "const char *" pointer to start of next field
+
+  */
+
+static const char *_grid_csv_parse(_grid_csv_scanner *sc, const char *p,
+                                   _grid_csv_field *f)
+{
+  const char *end;
+  char delimiter;
+  const char *q;
+
+    // Sanity check parameters.
+  assert(sc);
+  assert(f);
+
+  end = sc->end;
+  delimiter = sc->delimiter;
+
+  f->quoted = f->escaped = 0;
+
+  if (p < end && *p == '"')
+  {
+      // Quoted field, up to the next quote that is not doubled
+    f->quoted = 1;
+    f->start = ++p;
+
+    for (;;)
+    {
+      q = memchr(p, '"', (size_t)(end - p));
+      if (!q)
+      {
+        q = end;
+        break;
+      }
+      if (q + 1 < end && q[1] == '"')
+      {
+        f->escaped = 1;
+        p = q + 2;
+        continue;
+      }
+      break;
+    }
+
+    f->len = (size_t)(q - f->start);
+    p = (q < end) ? q + 1 : end;
+  }
+  else
+    f->start = p;
+
+    // Find the end of the field; stray quotes and carriage returns count
+    // as data
+  for (q = _grid_csv_next(sc, p);
+       q < end && *q != delimiter && *q != '\n' &&
+         !(*q == '\r' && q + 1 < end && q[1] == '\n');
+       q = _grid_csv_next(sc, q + 1)) ;
+
+  if (!f->quoted) f->len = (size_t)(q - f->start);
+
+  if (q == end)
+  {
+    f->end = _grid_csv_eof;
+    return end;
+  }
+
+  if (*q == delimiter)
+  {
+    f->end = _grid_csv_delimiter;
+    return q + 1;
+  }
+
+  f->end = _grid_csv_line;
+
+    // Return "const char *"
+  return q + ((*q == '\r') ? 2 : 1);
+}
+
+  /*!
+
+     @brief INTERNAL:  Find the number of rows and columns of CSV data
+
+     @param p    pointer to start of CSV data, or NULL when empty
+     @param end    pointer past end of CSV data
+     @param delimiter    field delimiter
+     @param rows    pointer to number of lines, set on success
+     @param cols    pointer to number of fields in widest line, set on success
+
+     @retval 0    success
+     @retval -1    failure, grid too large
+
+  */
+
+static int _grid_csv_measure(const char *p, const char *end, char delimiter,
+                             int *rows, int *cols)
+{
+  _grid_csv_count c;
+  const char *q;
+#ifdef GRID_CSV_SSE2
+  unsigned int d, n, m, b;
+#endif
+
+    // Sanity check parameters.
+  assert(rows);
+  assert(cols);
+
+  memset(&c, 0, sizeof(_grid_csv_count));
+  c.field = c.skip = p;
+
+#ifdef GRID_CSV_SSE2
+  for (; end - p >= 16; p += 16)
+  {
+    m = _grid_csv_masks(p, delimiter, &d, &n);
+
+    if (c.quoted || (m & ~(d | n)))
+    {
+        // Quotes or carriage returns, one byte of interest at a time
+      for (; m; m &= m - 1)
+        if (_grid_csv_count_byte(&c, p + __builtin_ctz(m), end, delimiter))
+          return -1;
+      continue;
+    }
+
+      // Only delimiters and line feeds, counted a line at a time
+    if (d | n) c.field = p + 32 - __builtin_clz(d | n);
+
+    for (; n; n &= n - 1)
+    {
+      b = n & (0u - n);
+      c.col += __builtin_popcount(d & (b - 1)) + 1;
+      d &= ~(b - 1);
+      if (_grid_csv_count_line(&c)) return -1;
+    }
+
+    c.col += __builtin_popcount(d);
+  }
+#endif
+
+  for (q = _grid_csv_scan(p, end, delimiter);
+       q < end;
+       q = _grid_csv_scan(q + 1, end, delimiter))
+    if (_grid_csv_count_byte(&c, q, end, delimiter)) return -1;
+
+    // A last line without a line feed, maybe ending in a delimiter
+  if (c.field < end || c.col)
+  {
+    ++c.col;
+    if (_grid_csv_count_line(&c)) return -1;
+  }
+
+  *rows = (int)c.height;
+  *cols = (int)c.width;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Count a byte of interest to CSV
+
+     Follows the rules of _grid_csv_parse(): a quote only starts a quoted
+     field at the start of the field, doubled quotes within a quoted field
+     stand for a quote, and stray carriage returns are data.
+
+     @param c    pointer to count of lines and fields so far
+     @param q    pointer to delimiter, double quote, carriage return or line
+                 feed
+     @param end    pointer past end of CSV data
+     @param delimiter    field delimiter
+
+     @retval 0    success
+     @retval -1    failure, grid too large
+
+  */
+
+static int _grid_csv_count_byte(_grid_csv_count *c, const char *q,
+                                const char *end, char delimiter)
+{
+    // Sanity check parameters.
+  assert(c);
+  assert(q);
+
+  if (q < c->skip) return 0;
+
+  if (c->quoted)
+  {
+    if (*q != '"') return 0;
+    if (q + 1 < end && q[1] == '"')
+      c->skip = q + 2;
+    else
+      c->quoted = 0;
+    return 0;
+  }
+
+  if (*q == '"')
+  {
+    if (q == c->field) c->quoted = 1;
+    return 0;
+  }
+
+  if (*q == '\r') return 0;
+
+  ++c->col;
+  c->field = q + 1;
+
+  if (*q == delimiter) return 0;
+
+    // Return "int"
+  return _grid_csv_count_line(c);
+}
+
+  /*!
+
+     @brief INTERNAL:  Count the end of a line of CSV data
+
+     @param c    pointer to count of lines and fields so far, with the
+                 fields of the line counted
+
+     @retval 0    success
+     @retval -1    failure, grid too large
+
+  */
+
+static int _grid_csv_count_line(_grid_csv_count *c)
+{
+    // Sanity check parameters.
+  assert(c);
+
+  if (c->col > c->width) c->width = c->col;
+  c->col = 0;
+
+  if (++c->height > INT_MAX || c->width > INT_MAX) return -1;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Fill a grid sized for CSV data with its fields
+
+     @param g    pointer to grid sized by _grid_csv_measure()
+     @param p    pointer to start of CSV data, or NULL when empty
+     @param end    pointer past end of CSV data
+     @param delimiter    field delimiter
+     @param func    pointer to user conversion function
+     @param data    pointer to user data for conversion function
+     @param buf    pointer to buffer for quoted fields, grown as needed
+     @param cap    pointer to size of buffer for quoted fields
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_csv_fill(grid_s *g, const char *p, const char *end,
+                          char delimiter, grid_cell_from_csv func,
+                          void *data, char **buf, size_t *cap)
+{
+  _grid_csv_scanner sc;
+  _grid_csv_field f;
+  const char *s, *q, *e;
+  char *b;
+  size_t n;
+  int row = 0, col = 0;
+
+    // Sanity check parameters.
+  assert(g);
+  assert(func);
+  assert(buf);
+  assert(cap);
+
+  memset(&sc, 0, sizeof(_grid_csv_scanner));
+  sc.end = end;
+  sc.delimiter = delimiter;
+  f.end = _grid_csv_eof;
+
+  while (p < end || f.end == _grid_csv_delimiter)
+  {
+    p = _grid_csv_parse(&sc, p, &f);
+
+    s = f.start;
+
+    if (f.escaped)
+    {
+      if (f.len > *cap)
+      {
+        b = (char *)realloc(*buf, f.len);
+        if (!b) return -1;
+        *buf = b;
+        *cap = f.len;
+      }
+
+        // Undo doubled quotes in a copy of the field, by copying up to and
+        // including the first quote of each pair, and skipping the second
+      for (n = 0, e = f.start + f.len; s < e; s = q)
+      {
+        q = memchr(s, '"', (size_t)(e - s));
+        q = (q) ? q + 1 : e;
+        memcpy(*buf + n, s, (size_t)(q - s));
+        n += (size_t)(q - s);
+        if (q[-1] == '"') ++q;
+      }
+
+      s = *buf;
+      f.len = n;
+    }
+
+    if (f.len || f.quoted)
+    {
+      grid_goto(g, row, col);
+      grid_set_cell(g, func(s, f.len, data));
+    }
+
+    ++col;
+
+    if (f.end != _grid_csv_delimiter)
+    {
+      ++row;
+      col = 0;
+    }
+  }
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Write a span of grid cells as CSV fields
+
+     @param payloads    pointer to payload data of span
+     @param row    row of span
+     @param col    first column of span
+     @param count    number of cells in span
+     @param data    pointer to CSV export details
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_csv_export_span(void * const *payloads, int row, int col,
+                                 int count, void *data)
+{
+  _grid_csv_export *ex;
+  int i;
+
+    // Sanity check parameters.
+  assert(payloads);
+  assert(data);
+
+  (void)row;
+
+  ex = (_grid_csv_export *)data;
+
+  for (i = 0; i < count; ++i)
+  {
+    if (col + i && _grid_csv_put(ex, &ex->delimiter, 1)) return -1;
+    if (payloads[i] && _grid_csv_put_cell(ex, payloads[i])) return -1;
+  }
+
+  if (col + count == ex->cols && _grid_csv_put(ex, "\n", 1)) return -1;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Write the payload data of a cell as a CSV field
+
+     The payload data is converted straight into the output buffer where it
+     fits, and only copied when it needs quoting.
+
+     @param ex    pointer to CSV export details
+     @param payload    pointer to payload data of cell
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_csv_put_cell(_grid_csv_export *ex, void *payload)
+{
+  char *s;
+  char *p;
+  size_t n;
+
+    // Sanity check parameters.
+  assert(ex);
+  assert(payload);
+
+  s = ex->out + ex->used;
+  n = ex->func(payload, s, CSV_BUFFER - ex->used, ex->data);
+
+    // Empty values are quoted, to tell them from empty cells
+  if (!n) return _grid_csv_put(ex, "\"\"", 2);
+
+  if (n <= CSV_BUFFER - ex->used &&
+      _grid_csv_scan(s, s + n, ex->delimiter) == s + n)
+  {
+    ex->used += n;
+    return 0;
+  }
+
+  if (n > ex->cap)
+  {
+    p = (char *)realloc(ex->buf, n);
+    if (!p) return -1;
+    ex->buf = p;
+    ex->cap = n;
+  }
+
+  if (n <= CSV_BUFFER - ex->used)
+    memcpy(ex->buf, s, n);
+  else if (ex->func(payload, ex->buf, ex->cap, ex->data) != n)
+    return -1;
+
+  if (_grid_csv_scan(ex->buf, ex->buf + n, ex->delimiter) == ex->buf + n)
+    return _grid_csv_put(ex, ex->buf, n);
+
+    // Return "int"
+  return _grid_csv_put_quoted(ex, ex->buf, n);
+}
+
+  /*!
+
+     @brief INTERNAL:  Write text as a quoted CSV field
+
+     @param ex    pointer to CSV export details
+     @param s    pointer to text
+     @param n    number of bytes of text
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_csv_put_quoted(_grid_csv_export *ex, const char *s,
+                                size_t n)
+{
+  const char *end;
+  const char *q;
+
+    // Sanity check parameters.
+  assert(ex);
+  assert(s || !n);
+
+  if (_grid_csv_put(ex, "\"", 1)) return -1;
+
+    // Double every quote, by writing it at the end of one piece of text and
+    // the start of the next
+  for (end = s + n; s < end; s = q)
+  {
+    q = memchr(s, '"', (size_t)(end - s));
+    q = (q) ? q + 1 : end;
+    if (_grid_csv_put(ex, s, (size_t)(q - s)) ||
+        (q[-1] == '"' && _grid_csv_put(ex, "\"", 1)))
+      return -1;
+  }
+
+    // Return "int"
+  return _grid_csv_put(ex, "\"", 1);
+}
+
+  /*!
+
+     @brief INTERNAL:  Append text to the CSV output buffer
+
+     @param ex    pointer to CSV export details
+     @param s    pointer to text
+     @param n    number of bytes of text
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_csv_put(_grid_csv_export *ex, const char *s, size_t n)
+{
+    // Sanity check parameters.
+  assert(ex);
+  assert(s || !n);
+
+  if (n > CSV_BUFFER - ex->used && _grid_csv_flush(ex)) return -1;
+
+  if (n > CSV_BUFFER) return (fwrite(s, 1, n, ex->fp) == n) ? 0 : -1;
+
+  memcpy(ex->out + ex->used, s, n);
+  ex->used += n;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Write the CSV output buffer to the file
+
+     @param ex    pointer to CSV export details
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_csv_flush(_grid_csv_export *ex)
+{
+    // Sanity check parameters.
+  assert(ex);
+
+  if (ex->used && fwrite(ex->out, 1, ex->used, ex->fp) != ex->used)
+    return -1;
+
+  ex->used = 0;
+
+    // Return "int"
+  return 0;
+}
@@ -0,0 +1,1119 @@
+/*!
+    @file grid-delta.c
+
+    @brief Source file for grid change journal and delta routines
+
+    @timestamp Sat, 17 Oct 2026 02:57:12 +0000
+
+    @author Patrick Head  mailto:patrickhead@gmail.com
+
+    @copyright Copyright (C) 2014  Patrick Head
+
+    @license
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.@n
+    @n
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.@n
+    @n
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+  /*!
+
+    @file grid-delta.c
+
+    Source file for tracking the changes made to a grid, and for carrying
+    them to other grids as deltas.
+
+    Every change reported to a journal is numbered; a token is the number of
+    the last change made before it was taken.  The journal keeps:
+
+      operations    each structural change (resizing, inserting or removing
+                    rows or columns), with its number, in order
+      cells         each changed cell, at its current location, with the
+                    number of its last change, found through a hash table
+                    keyed by location
+
+    Structural changes move the cells they follow, and drop those they
+    remove.  A change the journal cannot follow cell by cell (a sort, or a
+    change it runs out of memory recording) forgets everything before it,
+    so that deltas spanning it rewrite the whole grid.
+
+    Delta layout:
+
+      header     _grid_delta_header
+      records    _grid_delta_record, each cell record followed by a
+                 uint64_t size and size bytes of serialized payload data,
+                 up to and including an end record
+
+  */
+
+  // Required system headers
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <assert.h>
+
+  // Project related headers
+
+#include "grid-delta.h"
+
+  // Common constants
+
+#define GRID_DELTA_MAGIC "GRAYDLTA"
+#define GRID_DELTA_VERSION 1
+#define GRID_DELTA_ORDER 0x01020304
+
+  /*!
+    @brief INTERNAL: kinds of delta records
+  */
+
+typedef enum
+{
+  _grid_delta_end = 0,
+  _grid_delta_reset,
+  _grid_delta_size,
+  _grid_delta_insert_rows,
+  _grid_delta_insert_columns,
+  _grid_delta_remove_rows,
+  _grid_delta_remove_columns,
+  _grid_delta_cell,
+  _grid_delta_empty
+} _grid_delta_t;
+
+  /*!
+    @brief INTERNAL: delta header
+  */
+
+typedef struct
+{
+    /*! @brief: GRID_DELTA_MAGIC, not terminated */
+  char magic[8];
+    /*! @brief: GRID_DELTA_VERSION */
+  uint32_t version;
+    /*! @brief: GRID_DELTA_ORDER, in the byte order of the delta */
+  uint32_t order;
+} _grid_delta_header;
+
+  /*!
+    @brief INTERNAL: delta record
+
+    Arguments of each kind of record:
+
+      end              none
+      reset            number of rows, number of columns
+      size             number of rows, number of columns
+      insert_rows      first new row, count
+      insert_columns   first new column, count
+      remove_rows      first removed row, count
+      remove_columns   first removed column, count
+      cell             row, column of cell with payload data
+      empty            row, column of empty cell
+  */
+
+typedef struct
+{
+    /*! @brief: kind of record, _grid_delta_t */
+  int32_t type;
+    /*! @brief: row argument */
+  int32_t row;
+    /*! @brief: column argument */
+  int32_t col;
+    /*! @brief: count argument */
+  int32_t count;
+} _grid_delta_record;
+
+  /*!
+    @brief INTERNAL: journal entry for a structural change
+  */
+
+typedef struct
+{
+    /*! @brief: number of change */
+  unsigned long seq;
+    /*! @brief: delta record of change */
+  _grid_delta_record rec;
+} _grid_journal_op;
+
+  /*!
+    @brief INTERNAL: journal entry for a changed cell
+  */
+
+typedef struct
+{
+    /*! @brief: number of last change to cell */
+  unsigned long seq;
+    /*! @brief: current row of cell */
+  int row;
+    /*! @brief: current column of cell */
+  int col;
+} _grid_journal_cell;
+
+  /*!
+    @brief INTERNAL: journal details structure
+  */
+
+typedef struct
+{
+    /*! @brief: grid journalled */
+  grid_s *grid;
+    /*! @brief: number of last change */
+  unsigned long seq;
+    /*! @brief: oldest token a delta may be written since */
+  unsigned long base;
+    /*! @brief: number of last change not followed cell by cell */
+  unsigned long reset;
+    /*! @brief: structural changes, in order */
+  _grid_journal_op *ops;
+    /*! @brief: number of structural changes */
+  int nops;
+    /*! @brief: capacity of ops */
+  int opcap;
+    /*! @brief: changed cells */
+  _grid_journal_cell *cells;
+    /*! @brief: number of changed cells */
+  int ncells;
+    /*! @brief: capacity of cells */
+  int cellcap;
+    /*! @brief: hash table of index + 1 of each changed cell, or zero */
+  int *table;
+    /*! @brief: capacity of table, zero or a power of two */
+  int tabcap;
+} _grid_journal_internals;
+
+  /*!
+    @brief INTERNAL: delta export details structure
+  */
+
+typedef struct
+{
+    /*! @brief: file written */
+  FILE *fp;
+    /*! @brief: serialization buffer */
+  void *buf;
+    /*! @brief: size of serialization buffer */
+  size_t cap;
+    /*! @brief: user serialization function */
+  grid_cell_to_delta func;
+    /*! @brief: user data for serialization function */
+  void *data;
+} _grid_delta_export;
+
+  // INTERNAL: utility function prototypes for module
+
+static _grid_journal_internals *_grid_journal_get_internals(grid_journal_s *j);
+static void _grid_journal_notify(grid_change_t change, int row, int col,
+                                 int count, void *data);
+static int _grid_journal_mark(_grid_journal_internals *ji, int row, int col);
+static int _grid_journal_follow(_grid_journal_internals *ji,
+                                _grid_delta_t type,
+                                int row,
+                                int col,
+                                int count);
+static void _grid_journal_forget(_grid_journal_internals *ji);
+static int _grid_journal_index(_grid_journal_internals *ji, int cap);
+static unsigned _grid_journal_hash(int row, int col);
+static int _grid_journal_cellcmp(const void *c1, const void *c2);
+static int _grid_delta_put(_grid_delta_export *ex,
+                           _grid_delta_t type,
+                           int row,
+                           int col,
+                           int count);
+static int _grid_delta_put_cell(_grid_delta_export *ex,
+                                void *payload,
+                                int row,
+                                int col);
+static int _grid_delta_export_span(void * const *payloads, int row, int col,
+                                   int count, void *data);
+
+  /*!
+
+     @brief Create a new change journal for a grid
+
+     Attaches a journal to the grid, replacing any change function the grid
+     had (see grid_set_notify()).  The journal is empty, and its first token
+     is zero.  Read-only grids never change, so their journals stay empty.
+
+     @param g    pointer to grid data structure
+
+     @retval "grid_journal_s *" success
+     @retval NULL    failure
+
+  */
+
+grid_journal_s *grid_journal_create(grid_s *g)
+{
+  grid_journal_s *j;
+  _grid_journal_internals *ji;
+
+    // Sanity check parameters.
+  assert(g);
+
+  j = malloc(sizeof(grid_journal_s));
+  if (!j) return NULL;
+
+  ji = (void*)malloc(sizeof(_grid_journal_internals));
+  if (!ji)
+  {
+    free(j);
+    return NULL;
+  }
+  memset(ji, 0, sizeof(_grid_journal_internals));
+  ji->grid = g;
+  j->_internals = ji;
+
+  grid_set_notify(g, _grid_journal_notify, ji);
+
+    // Return "grid_journal_s *"
+  return j;
+}
+
+  /*!
+
+     @brief Destroy a change journal
+
+     Detaches the journal from its grid, which must still exist, and
+     de-allocates it.
+
+     @param j    pointer to existing journal
+
+     @retval NONE
+
+  */
+
+void grid_journal_destroy(grid_journal_s *j)
+{
+  _grid_journal_internals *ji;
+
+    // Sanity check parameters.
+  assert(j);
+
+  ji = _grid_journal_get_internals(j);
+  if (ji)
+  {
+    grid_set_notify(ji->grid, NULL, NULL);
+
+    free(ji->ops);
+    free(ji->cells);
+    free(ji->table);
+    free(ji);
+  }
+
+  free(j);
+}
+
+  /*!
+
+     @brief Take a checkpoint of the state of a journalled grid
+
+     @param j    pointer to existing journal
+
+     @retval "unsigned long" token for the current state of the grid
+
+  */
+
+unsigned long grid_journal_checkpoint(grid_journal_s *j)
+{
+  _grid_journal_internals *ji;
+
+    // Sanity check parameters.
+  assert(j);
+
+  ji = _grid_journal_get_internals(j);
+  if (!ji) return 0;
+
+    // Return "unsigned long"
+  return ji->seq;
+}
+
+  /*!
+
+     @brief Forget the changes made to a journalled grid before a checkpoint
+
+     Afterwards, deltas may only be written since the token given, or a
+     later one.
+
+     @param j    pointer to existing journal
+     @param token    token returned by grid_journal_checkpoint()
+
+     @retval NONE
+
+  */
+
+void grid_journal_trim(grid_journal_s *j, unsigned long token)
+{
+  _grid_journal_internals *ji;
+  int i, n;
+
+    // Sanity check parameters.
+  assert(j);
+
+  ji = _grid_journal_get_internals(j);
+  if (!ji) return;
+
+  if (token > ji->seq) token = ji->seq;
+  if (token <= ji->base) return;
+
+  ji->base = token;
+
+  for (i = 0; i < ji->nops && ji->ops[i].seq <= token; i++);
+  if (i)
+  {
+    ji->nops -= i;
+    memmove(ji->ops, ji->ops + i, ji->nops * sizeof(_grid_journal_op));
+  }
+
+  for (i = n = 0; i < ji->ncells; i++)
+    if (ji->cells[i].seq > token) ji->cells[n++] = ji->cells[i];
+
+  if (n < ji->ncells)
+  {
+    ji->ncells = n;
+    _grid_journal_index(ji, ji->tabcap);
+  }
+}
+
+  /*!
+
+     @brief Write the changes made to a journalled grid since a checkpoint
+
+     Writes a delta which, applied to a grid in the state of the token
+     given, brings it to the current state of the journalled grid.  The
+     payload data of changed cells is serialized with a user function.
+
+     @param j    pointer to existing journal
+     @param since    token returned by grid_journal_checkpoint()
+     @param fp    file to write delta to
+     @param func    pointer to user serialization function
+     @param data    pointer to user data for serialization function, or NULL
+
+     @retval 0    success
+     @retval -1    failure, or changes since token forgotten
+
+  */
+
+int grid_delta_write(grid_journal_s *j,
+                     unsigned long since,
+                     FILE *fp,
+                     grid_cell_to_delta func,
+                     void *data)
+{
+  _grid_journal_internals *ji;
+  _grid_delta_header hdr;
+  _grid_delta_export ex;
+  _grid_journal_cell *cells;
+  grid_cursor_s *gc;
+  int rows, cols;
+  int i, n;
+  int rc = 0;
+
+    // Sanity check parameters.
+  assert(j);
+  assert(fp);
+  assert(func);
+
+  ji = _grid_journal_get_internals(j);
+  if (!ji || since < ji->base || since > ji->seq) return -1;
+
+  memset(&ex, 0, sizeof(_grid_delta_export));
+  ex.fp = fp;
+  ex.func = func;
+  ex.data = data;
+
+  memset(&hdr, 0, sizeof(_grid_delta_header));
+  memcpy(hdr.magic, GRID_DELTA_MAGIC, sizeof(hdr.magic));
+  hdr.version = GRID_DELTA_VERSION;
+  hdr.order = GRID_DELTA_ORDER;
+
+  if (fwrite(&hdr, sizeof(_grid_delta_header), 1, fp) != 1) return -1;
+
+  if (ji->reset > since)
+  {
+      // The whole grid
+    rows = grid_size_get_height(grid_get_size(ji->grid));
+    cols = grid_size_get_width(grid_get_size(ji->grid));
+
+    if (_grid_delta_put(&ex, _grid_delta_reset, rows, cols, 0) ||
+        grid_foreach_row(ji->grid, _grid_delta_export_span, &ex))
+      rc = -1;
+  }
+  else
+  {
+      // Structural changes in order, then changed cells in row-major order
+    for (i = 0; i < ji->nops && !rc; i++)
+      if (ji->ops[i].seq > since &&
+          _grid_delta_put(&ex,
+                          (_grid_delta_t)ji->ops[i].rec.type,
+                          ji->ops[i].rec.row,
+                          ji->ops[i].rec.col,
+                          ji->ops[i].rec.count))
+        rc = -1;
+
+    cells = NULL;
+    n = 0;
+    if (!rc && ji->ncells)
+    {
+      cells = malloc(ji->ncells * sizeof(_grid_journal_cell));
+      if (!cells) rc = -1;
+      for (i = 0; i < ji->ncells && !rc; i++)
+        if (ji->cells[i].seq > since) cells[n++] = ji->cells[i];
+      if (n) qsort(cells, n, sizeof(_grid_journal_cell), _grid_journal_cellcmp);
+    }
+
+    if (n)
+    {
+      gc = grid_cursor_create(ji->grid);
+      if (!gc) rc = -1;
+      for (i = 0; i < n && !rc; i++)
+        if (_grid_delta_put_cell(&ex,
+                                 grid_cursor_goto(gc,
+                                                  cells[i].row,
+                                                  cells[i].col),
+                                 cells[i].row,
+                                 cells[i].col))
+          rc = -1;
+      if (gc) grid_cursor_destroy(gc);
+    }
+
+    free(cells);
+  }
+
+  if (!rc && _grid_delta_put(&ex, _grid_delta_end, 0, 0, 0)) rc = -1;
+
+  free(ex.buf);
+
+    // Return "int"
+  return rc;
+}
+
+  /*!
+
+     @brief Apply a delta to a grid
+
+     Makes the changes held in a delta, written by grid_delta_write(), to a
+     grid, which should be in the state of the token the delta was written
+     since.  New payload data is de-serialized with a user function.  On
+     failure, the changes read before the failure have been made.
+
+     @param g    pointer to grid data structure
+     @param fp    file to read delta from
+     @param func    pointer to user de-serialization function
+     @param data    pointer to user data for de-serialization function, or
+                   NULL
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+int grid_delta_apply(grid_s *g,
+                     FILE *fp,
+                     grid_cell_from_delta func,
+                     void *data)
+{
+  _grid_delta_header hdr;
+  _grid_delta_record rec;
+  grid_size_s *gs;
+  uint64_t size;
+  void *buf = NULL;
+  size_t cap = 0;
+  void *payload;
+  void *p;
+  int rows, cols;
+  int rc = 1;
+
+    // Sanity check parameters.
+  assert(g);
+  assert(fp);
+  assert(func);
+
+  if (fread(&hdr, sizeof(_grid_delta_header), 1, fp) != 1 ||
+      memcmp(hdr.magic, GRID_DELTA_MAGIC, sizeof(hdr.magic)) ||
+      hdr.version != GRID_DELTA_VERSION ||
+      hdr.order != GRID_DELTA_ORDER)
+    return -1;
+
+  gs = grid_size_create();
+  if (!gs) return -1;
+
+  while (rc > 0)
+  {
+    if (fread(&rec, sizeof(_grid_delta_record), 1, fp) != 1)
+    {
+      rc = -1;
+      break;
+    }
+
+    rows = grid_size_get_height(grid_get_size(g));
+    cols = grid_size_get_width(grid_get_size(g));
+
+    switch (rec.type)
+    {
+      case _grid_delta_end:
+        rc = 0;
+        break;
+
+      case _grid_delta_reset:
+      case _grid_delta_size:
+        if (rec.row < 0 || rec.col < 0)
+        {
+          rc = -1;
+          break;
+        }
+        if (rec.type == _grid_delta_reset)
+        {
+          grid_size_set(gs, 0, 0);
+          grid_set_size(g, gs);
+        }
+        grid_size_set(gs, rec.col, rec.row);
+        grid_set_size(g, gs);
+        break;
+
+      case _grid_delta_insert_rows:
+        if (rec.row < 0 || rec.row > rows || rec.count < 1) rc = -1;
+        else grid_create_rows(g, rec.row, rec.count);
+        break;
+
+      case _grid_delta_insert_columns:
+        if (rec.col < 0 || rec.col > cols || rec.count < 1) rc = -1;
+        else grid_create_columns(g, rec.col, rec.count);
+        break;
+
+      case _grid_delta_remove_rows:
+        if (rec.row < 0 || rec.row >= rows || rec.count < 1) rc = -1;
+        else grid_destroy_rows(g, rec.row, rec.count);
+        break;
+
+      case _grid_delta_remove_columns:
+        if (rec.col < 0 || rec.col >= cols || rec.count < 1) rc = -1;
+        else grid_destroy_columns(g, rec.col, rec.count);
+        break;
+
+      case _grid_delta_cell:
+      case _grid_delta_empty:
+        if (rec.row < 0 || rec.row >= rows || rec.col < 0 || rec.col >= cols)
+        {
+          rc = -1;
+          break;
+        }
+        grid_goto(g, rec.row, rec.col);
+        if (rec.type == _grid_delta_empty)
+        {
+          grid_clear_cell(g);
+          break;
+        }
+        if (fread(&size, sizeof(uint64_t), 1, fp) != 1 || size > SIZE_MAX)
+        {
+          rc = -1;
+          break;
+        }
+        if (size > cap)
+        {
+          p = realloc(buf, (size_t)size);
+          if (!p)
+          {
+            rc = -1;
+            break;
+          }
+          buf = p;
+          cap = (size_t)size;
+        }
+        if ((size && fread(buf, 1, (size_t)size, fp) != (size_t)size) ||
+            !(payload = func(buf, (size_t)size, data)))
+        {
+          rc = -1;
+          break;
+        }
+        grid_set_cell(g, payload);
+        break;
+
+      default:
+        rc = -1;
+        break;
+    }
+  }
+
+  free(buf);
+  grid_size_destroy(gs);
+
+    // Return "int"
+  return rc;
+}
+
+// STATIC functions
+
+  /*!
+
+     @brief INTERNAL:  Get journal internals
+
+     @param j    pointer to existing journal
+
+     @retval "_grid_journal_internals *" success
+     @retval NULL    failure
+
+  */
+
+static _grid_journal_internals *_grid_journal_get_internals(grid_journal_s *j)
+{
+    // Sanity check parameters.
+  assert(j);
+    // Return "_grid_journal_internals *"
+  return (_grid_journal_internals *)j->_internals;
+}
+
+  /*!
+
+     @brief INTERNAL:  Record a change reported by a journalled grid
+
+     @param change    kind of change
+     @param row    row argument of change
+     @param col    column argument of change
+     @param count    count argument of change
+     @param data    pointer to journal internals
+
+     @retval NONE
+
+  */
+
+static void _grid_journal_notify(grid_change_t change, int row, int col,
+                                 int count, void *data)
+{
+  _grid_journal_internals *ji;
+  int rc = -1;
+
+    // Sanity check parameters.
+  assert(data);
+
+  ji = (_grid_journal_internals *)data;
+
+  ++ji->seq;
+
+  switch (change)
+  {
+    case grid_change_cell:
+      rc = _grid_journal_mark(ji, row, col);
+      break;
+    case grid_change_size:
+      rc = _grid_journal_follow(ji, _grid_delta_size, row, col, count);
+      break;
+    case grid_change_insert_rows:
+      rc = _grid_journal_follow(ji, _grid_delta_insert_rows, row, col, count);
+      break;
+    case grid_change_insert_columns:
+      rc = _grid_journal_follow(ji,
+                                _grid_delta_insert_columns,
+                                row,
+                                col,
+                                count);
+      break;
+    case grid_change_remove_rows:
+      rc = _grid_journal_follow(ji, _grid_delta_remove_rows, row, col, count);
+      break;
+    case grid_change_remove_columns:
+      rc = _grid_journal_follow(ji,
+                                _grid_delta_remove_columns,
+                                row,
+                                col,
+                                count);
+      break;
+    case grid_change_order:
+      break;
+  }
+
+  if (rc) _grid_journal_forget(ji);
+}
+
+  /*!
+
+     @brief INTERNAL:  Record the latest change to a cell
+
+     @param ji    pointer to journal internals
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_journal_mark(_grid_journal_internals *ji, int row, int col)
+{
+  _grid_journal_cell *p;
+  unsigned h;
+  int i;
+
+    // Sanity check parameters.
+  assert(ji);
+
+  if (ji->tabcap)
+  {
+    for (h = _grid_journal_hash(row, col) & (ji->tabcap - 1);
+         ji->table[h];
+         h = (h + 1) & (ji->tabcap - 1))
+    {
+      i = ji->table[h] - 1;
+      if (ji->cells[i].row == row && ji->cells[i].col == col)
+      {
+        ji->cells[i].seq = ji->seq;
+        return 0;
+      }
+    }
+  }
+
+  if (ji->ncells == ji->cellcap)
+  {
+    if (ji->cellcap > INT_MAX / 4) return -1;
+    i = ji->cellcap ? ji->cellcap * 2 : 64;
+    p = realloc(ji->cells, i * sizeof(_grid_journal_cell));
+    if (!p) return -1;
+    ji->cells = p;
+    ji->cellcap = i;
+  }
+
+  i = ji->ncells++;
+  ji->cells[i].seq = ji->seq;
+  ji->cells[i].row = row;
+  ji->cells[i].col = col;
+
+    // Keep the hash table at most half full
+  if (ji->ncells * 2 > ji->tabcap)
+    return _grid_journal_index(ji, ji->tabcap ? ji->tabcap * 2 : 128);
+
+  for (h = _grid_journal_hash(row, col) & (ji->tabcap - 1);
+       ji->table[h];
+       h = (h + 1) & (ji->tabcap - 1));
+  ji->table[h] = i + 1;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Record a structural change, and move changed cells
+
+     @param ji    pointer to journal internals
+     @param type    kind of delta record for change
+     @param row    row argument of change
+     @param col    column argument of change
+     @param count    count argument of change
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_journal_follow(_grid_journal_internals *ji,
+                                _grid_delta_t type,
+                                int row,
+                                int col,
+                                int count)
+{
+  _grid_journal_cell *c;
+  _grid_journal_op *p;
+  int i, n;
+
+    // Sanity check parameters.
+  assert(ji);
+
+  if (ji->nops == ji->opcap)
+  {
+    if (ji->opcap > INT_MAX / 4) return -1;
+    n = ji->opcap ? ji->opcap * 2 : 16;
+    p = realloc(ji->ops, n * sizeof(_grid_journal_op));
+    if (!p) return -1;
+    ji->ops = p;
+    ji->opcap = n;
+  }
+
+  p = &ji->ops[ji->nops++];
+  p->seq = ji->seq;
+  p->rec.type = type;
+  p->rec.row = row;
+  p->rec.col = col;
+  p->rec.count = count;
+
+  if (!ji->ncells) return 0;
+
+  for (i = n = 0; i < ji->ncells; i++)
+  {
+    c = &ji->cells[i];
+
+    switch (type)
+    {
+      case _grid_delta_size:
+        if (c->row >= row || c->col >= col) continue;
+        break;
+      case _grid_delta_insert_rows:
+        if (c->row >= row) c->row += count;
+        break;
+      case _grid_delta_insert_columns:
+        if (c->col >= col) c->col += count;
+        break;
+      case _grid_delta_remove_rows:
+        if (c->row >= row + count) c->row -= count;
+        else if (c->row >= row) continue;
+        break;
+      case _grid_delta_remove_columns:
+        if (c->col >= col + count) c->col -= count;
+        else if (c->col >= col) continue;
+        break;
+      default:
+        break;
+    }
+
+    ji->cells[n++] = *c;
+  }
+
+  ji->ncells = n;
+
+    // Return "int"
+  return _grid_journal_index(ji, ji->tabcap);
+}
+
+  /*!
+
+     @brief INTERNAL:  Forget all changes recorded so far
+
+     Deltas written since a token taken before the latest change then
+     rewrite the whole grid.
+
+     @param ji    pointer to journal internals
+
+     @retval NONE
+
+  */
+
+static void _grid_journal_forget(_grid_journal_internals *ji)
+{
+    // Sanity check parameters.
+  assert(ji);
+
+  ji->reset = ji->seq;
+  ji->nops = 0;
+  ji->ncells = 0;
+
+  if (ji->table) memset(ji->table, 0, ji->tabcap * sizeof(int));
+}
+
+  /*!
+
+     @brief INTERNAL:  Rebuild the hash table of changed cells
+
+     @param ji    pointer to journal internals
+     @param cap    capacity of hash table, zero or a power of two
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_journal_index(_grid_journal_internals *ji, int cap)
+{
+  unsigned h;
+  int *table;
+  int i;
+
+    // Sanity check parameters.
+  assert(ji);
+
+  if (cap != ji->tabcap)
+  {
+    if (cap < 0 || cap > INT_MAX / 2) return -1;
+    table = realloc(ji->table, cap * sizeof(int));
+    if (!table) return -1;
+    ji->table = table;
+    ji->tabcap = cap;
+  }
+
+  if (!ji->tabcap) return 0;
+
+  memset(ji->table, 0, ji->tabcap * sizeof(int));
+
+  for (i = 0; i < ji->ncells; i++)
+  {
+    for (h = _grid_journal_hash(ji->cells[i].row, ji->cells[i].col) &
+               (ji->tabcap - 1);
+         ji->table[h];
+         h = (h + 1) & (ji->tabcap - 1));
+    ji->table[h] = i + 1;
+  }
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Hash the location of a cell
+
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval "unsigned" hash of location
+
+  */
+
+static unsigned _grid_journal_hash(int row, int col)
+{
+  uint32_t h;
+
+  h = (uint32_t)row * 0x9E3779B1u ^ (uint32_t)col * 0x85EBCA77u;
+  h ^= h >> 15;
+
+    // Return "unsigned"
+  return (unsigned)h;
+}
+
+  /*!
+
+     @brief INTERNAL:  Compare the locations of changed cells, row-major
+
+     @param c1    pointer to first changed cell
+     @param c2    pointer to second changed cell
+
+     @retval <0    first cell precedes second
+     @retval 0    same cell
+     @retval >0    first cell follows second
+
+  */
+
+static int _grid_journal_cellcmp(const void *c1, const void *c2)
+{
+  const _grid_journal_cell *a = (const _grid_journal_cell *)c1;
+  const _grid_journal_cell *b = (const _grid_journal_cell *)c2;
+
+  if (a->row != b->row) return (a->row > b->row) - (a->row < b->row);
+
+    // Return "int"
+  return (a->col > b->col) - (a->col < b->col);
+}
+
+  /*!
+
+     @brief INTERNAL:  Write a delta record
+
+     @param ex    pointer to delta export details
+     @param type    kind of record
+     @param row    row argument of record
+     @param col    column argument of record
+     @param count    count argument of record
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_delta_put(_grid_delta_export *ex,
+                           _grid_delta_t type,
+                           int row,
+                           int col,
+                           int count)
+{
+  _grid_delta_record rec;
+
+    // Sanity check parameters.
+  assert(ex);
+
+  rec.type = (int32_t)type;
+  rec.row = (int32_t)row;
+  rec.col = (int32_t)col;
+  rec.count = (int32_t)count;
+
+    // Return "int"
+  return (fwrite(&rec, sizeof(_grid_delta_record), 1, ex->fp) == 1) ? 0 : -1;
+}
+
+  /*!
+
+     @brief INTERNAL:  Write the delta record of a cell
+
+     @param ex    pointer to delta export details
+     @param payload    pointer to payload data of cell, or NULL if empty
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_delta_put_cell(_grid_delta_export *ex,
+                                void *payload,
+                                int row,
+                                int col)
+{
+  uint64_t size;
+  size_t n;
+  void *p;
+
+    // Sanity check parameters.
+  assert(ex);
+
+  if (!payload) return _grid_delta_put(ex, _grid_delta_empty, row, col, 0);
+
+  n = ex->func(payload, ex->buf, ex->cap, ex->data);
+  if (n > ex->cap)
+  {
+    p = realloc(ex->buf, n);
+    if (!p) return -1;
+    ex->buf = p;
+    ex->cap = n;
+    n = ex->func(payload, ex->buf, ex->cap, ex->data);
+    if (n > ex->cap) return -1;
+  }
+
+  size = (uint64_t)n;
+  if (_grid_delta_put(ex, _grid_delta_cell, row, col, 0) ||
+      fwrite(&size, sizeof(uint64_t), 1, ex->fp) != 1 ||
+      (n && fwrite(ex->buf, 1, n, ex->fp) != n))
+    return -1;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Write the delta records of a span of non-empty cells
+
+     @param payloads    pointer to payload data of span
+     @param row    row of span
+     @param col    first column of span
+     @param count    number of cells in span
+     @param data    pointer to delta export details
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_delta_export_span(void * const *payloads, int row, int col,
+                                   int count, void *data)
+{
+  int i;
+
+    // Sanity check parameters.
+  assert(payloads);
+  assert(data);
+
+  for (i = 0; i < count; ++i)
+    if (payloads[i] &&
+        _grid_delta_put_cell((_grid_delta_export *)data,
+                             payloads[i],
+                             row,
+                             col + i))
+      return -1;
+
+    // Return "int"
+  return 0;
+}
@@ -0,0 +1,1267 @@
+/*!
+    @file grid-numeric.c
+
+    @brief Source file for typed numeric grid data
+
+    @timestamp Sat, 17 Oct 2026 02:57:12 +0000
+
+    @author Patrick Head  mailto:patrickhead@gmail.com
+
+    @copyright Copyright (C) 2014  Patrick Head
+
+    @license
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.@n
+    @n
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.@n
+    @n
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+  /*!
+
+    @file grid-numeric.c
+
+    Source file for typed numeric grid data
+
+    Each column is kept as an array of numbers, and a parallel array of flags
+    marking the cells that hold a number.  Both arrays of every column have
+    the same capacity, in rows, so inserting rows moves numbers within each
+    column, while inserting columns only moves the array of columns.  Empty
+    cells always hold zero.
+
+    The summary kernels are plain loops over contiguous arrays, written so
+    that an optimizing compiler can vectorize the sums and counts.  Double
+    sums are kept in several independent partial sums, since the compiler may
+    not reorder floating point additions itself.
+
+  */
+
+  // Required system headers
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+  // Project related headers
+
+#include "grid-numeric.h"
+
+  // Common constants
+
+#define NUMERIC_LANES 8
+#define NUMERIC_BLOCK 256
+#define NUMERIC_MIN_ROWS 16
+
+  /*!
+    @brief INTERNAL: numeric grid column structure
+  */
+
+typedef struct
+{
+    /*! @brief: numbers of column, double or int64_t */
+  void *values;
+    /*! @brief: non-zero for each cell holding a number */
+  unsigned char *set;
+} _grid_numeric_column;
+
+  /*!
+    @brief INTERNAL: numeric grid details structure
+  */
+
+typedef struct
+{
+    /*! @brief: type of numbers held */
+  grid_numeric_t type;
+    /*! @brief: size of grid */
+  grid_size_s *size;
+    /*! @brief: capacity of each column, in rows */
+  int rcap;
+    /*! @brief: capacity of columns array */
+  int ccap;
+    /*! @brief: columns of grid */
+  _grid_numeric_column *cols;
+} _grid_numeric_internals;
+
+  /*!
+    @brief INTERNAL: summary accumulator structure
+  */
+
+typedef struct
+{
+    /*! @brief: number of non-empty cells */
+  long count;
+    /*! @brief: sum of double cells */
+  double sum;
+    /*! @brief: smallest double cell */
+  double min;
+    /*! @brief: largest double cell */
+  double max;
+    /*! @brief: sum of int64 cells */
+  int64_t isum;
+    /*! @brief: smallest int64 cell */
+  int64_t imin;
+    /*! @brief: largest int64 cell */
+  int64_t imax;
+    /*! @brief: non-zero once the sum of int64 cells overflowed */
+  int overflow;
+} _grid_numeric_acc;
+
+  // INTERNAL: utility function prototypes for module
+
+static _grid_numeric_internals *_grid_numeric_get_internals(grid_numeric_s *gn);
+static int _grid_numeric_reserve_rows(_grid_numeric_internals *gni, int rows);
+static int _grid_numeric_reserve_columns(_grid_numeric_internals *gni,
+                                         int cols);
+static int _grid_numeric_insert_rows(_grid_numeric_internals *gni,
+                                     int row, int count);
+static int _grid_numeric_insert_columns(_grid_numeric_internals *gni,
+                                        int col, int count);
+static void _grid_numeric_remove_rows(_grid_numeric_internals *gni,
+                                      int row, int count);
+static void _grid_numeric_remove_columns(_grid_numeric_internals *gni,
+                                         int col, int count);
+static int _grid_numeric_in_grid(_grid_numeric_internals *gni,
+                                 int row, int col);
+static int _grid_numeric_fits_int64(double value);
+static void _grid_numeric_sum_double(const double *v,
+                                     const unsigned char *set,
+                                     int n,
+                                     _grid_numeric_acc *acc);
+static void _grid_numeric_sum_int64(const int64_t *v,
+                                    const unsigned char *set,
+                                    int n,
+                                    _grid_numeric_acc *acc);
+
+  /*!
+
+     @brief Create a new numeric grid
+
+     Creates a numeric grid with no cells.
+
+     @param type    grid_numeric_double, or grid_numeric_int64
+
+     @retval "grid_numeric_s *" success
+     @retval NULL    failure
+
+  */
+
+grid_numeric_s *grid_numeric_create(grid_numeric_t type)
+{
+  grid_numeric_s *gn;
+  _grid_numeric_internals *gni;
+
+  if (type != grid_numeric_double && type != grid_numeric_int64) return NULL;
+
+  gn = malloc(sizeof(grid_numeric_s));
+  if (!gn) return NULL;
+
+  gni = (void*)malloc(sizeof(_grid_numeric_internals));
+  if (!gni)
+  {
+    free(gn);
+    return NULL;
+  }
+  memset(gni, 0, sizeof(_grid_numeric_internals));
+  gn->_internals = gni;
+
+  gni->type = type;
+
+  gni->size = grid_size_create();
+  if (!gni->size)
+  {
+    grid_numeric_destroy(gn);
+    return NULL;
+  }
+
+    // Return "grid_numeric_s *"
+  return gn;
+}
+
+  /*!
+
+     @brief Destroy numeric grid
+
+     De-allocates a numeric grid, and all of its cells.
+
+     @param gn    pointer to existing numeric grid
+
+     @retval NONE
+
+  */
+
+void grid_numeric_destroy(grid_numeric_s *gn)
+{
+  _grid_numeric_internals *gni;
+  int c;
+
+    // Sanity check parameters.
+  assert(gn);
+
+  gni = _grid_numeric_get_internals(gn);
+  if (gni)
+  {
+    for (c = 0; c < gni->ccap; ++c)
+    {
+      free(gni->cols[c].values);
+      free(gni->cols[c].set);
+    }
+    free(gni->cols);
+    if (gni->size) grid_size_destroy(gni->size);
+    free(gni);
+  }
+
+  free(gn);
+}
+
+  /*!
+
+     @brief Get type of numbers held by numeric grid
+
+     @param gn    pointer to existing numeric grid
+
+     @retval "grid_numeric_t" type of numbers
+
+  */
+
+grid_numeric_t grid_numeric_get_type(grid_numeric_s *gn)
+{
+  _grid_numeric_internals *gni;
+
+    // Sanity check parameters.
+  assert(gn);
+
+  gni = _grid_numeric_get_internals(gn);
+  if (!gni) return grid_numeric_double;
+
+    // Return "grid_numeric_t"
+  return gni->type;
+}
+
+  /*!
+
+     @brief Set size of numeric grid
+
+     Adds or removes rows and columns at the end of the grid, so that the grid
+     has the given size.  New cells are empty.  As for a grid, a size with no
+     rows or no columns makes the grid 0x0.  On failure, the grid keeps its
+     size.
+
+     @param gn    pointer to existing numeric grid
+     @param gs    pointer to grid size
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+int grid_numeric_set_size(grid_numeric_s *gn, grid_size_s *gs)
+{
+  _grid_numeric_internals *gni;
+  int height, width;
+  int rows, cols;
+
+    // Sanity check parameters.
+  assert(gn);
+  assert(gs);
+
+  gni = _grid_numeric_get_internals(gn);
+  if (!gni) return -1;
+
+  rows = grid_size_get_height(gs);
+  cols = grid_size_get_width(gs);
+  if (rows < 0 || cols < 0) return -1;
+  if (!rows || !cols) rows = cols = 0;
+
+  height = grid_size_get_height(gni->size);
+  width = grid_size_get_width(gni->size);
+
+    // Grow first, so that nothing is lost when growing fails
+  if (rows > height && _grid_numeric_insert_rows(gni, height, rows - height))
+    return -1;
+  if (cols > width && _grid_numeric_insert_columns(gni, width, cols - width))
+  {
+    if (rows > height) _grid_numeric_remove_rows(gni, height, rows - height);
+    return -1;
+  }
+
+  if (cols < width)
+    _grid_numeric_remove_columns(gni, cols, width - cols);
+  if (rows < height)
+    _grid_numeric_remove_rows(gni, rows, height - rows);
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief Get size of numeric grid
+
+     @param gn    pointer to existing numeric grid
+
+     @retval "grid_size_s *" success
+     @retval NULL    failure
+
+  */
+
+grid_size_s *grid_numeric_get_size(grid_numeric_s *gn)
+{
+  _grid_numeric_internals *gni;
+
+    // Sanity check parameters.
+  assert(gn);
+
+  gni = _grid_numeric_get_internals(gn);
+  if (!gni) return NULL;
+
+    // Return "grid_size_s *"
+  return gni->size;
+}
+
+  /*!
+
+     @brief Create a new row in numeric grid
+
+     Inserts an empty row before the given row.  A negative row appends the
+     new row after the current last row.  If the row is greater than the
+     number of rows, nothing is done.
+
+     @param gn    pointer to existing numeric grid
+     @param row    row before which to insert new row
+
+     @retval NONE
+
+  */
+
+void grid_numeric_create_row(grid_numeric_s *gn, int row)
+{
+  _grid_numeric_internals *gni;
+  int height;
+
+    // Sanity check parameters.
+  assert(gn);
+
+  gni = _grid_numeric_get_internals(gn);
+  if (!gni) return;
+
+  height = grid_size_get_height(gni->size);
+
+  if (row > height) return;
+  if (row < 0) row = height;
+
+  _grid_numeric_insert_rows(gni, row, 1);
+}
+
+  /*!
+
+     @brief Create a new column in numeric grid
+
+     Inserts an empty column before the given column.  A negative column
+     appends the new column after the current last column.  If the column is
+     greater than the number of columns, nothing is done.
+
+     @param gn    pointer to existing numeric grid
+     @param col    column before which to insert new column
+
+     @retval NONE
+
+  */
+
+void grid_numeric_create_column(grid_numeric_s *gn, int col)
+{
+  _grid_numeric_internals *gni;
+  int width;
+
+    // Sanity check parameters.
+  assert(gn);
+
+  gni = _grid_numeric_get_internals(gn);
+  if (!gni) return;
+
+  width = grid_size_get_width(gni->size);
+
+  if (col > width) return;
+  if (col < 0) col = width;
+
+  _grid_numeric_insert_columns(gni, col, 1);
+}
+
+  /*!
+
+     @brief Destroy a row of numeric grid
+
+     @param gn    pointer to existing numeric grid
+     @param row    row to remove
+
+     @retval NONE
+
+  */
+
+void grid_numeric_destroy_row(grid_numeric_s *gn, int row)
+{
+  _grid_numeric_internals *gni;
+
+    // Sanity check parameters.
+  assert(gn);
+
+  gni = _grid_numeric_get_internals(gn);
+  if (!gni) return;
+
+  if (row < 0 || row >= grid_size_get_height(gni->size)) return;
+
+  _grid_numeric_remove_rows(gni, row, 1);
+}
+
+  /*!
+
+     @brief Destroy a column of numeric grid
+
+     @param gn    pointer to existing numeric grid
+     @param col    column to remove
+
+     @retval NONE
+
+  */
+
+void grid_numeric_destroy_column(grid_numeric_s *gn, int col)
+{
+  _grid_numeric_internals *gni;
+
+    // Sanity check parameters.
+  assert(gn);
+
+  gni = _grid_numeric_get_internals(gn);
+  if (!gni) return;
+
+  if (col < 0 || col >= grid_size_get_width(gni->size)) return;
+
+  _grid_numeric_remove_columns(gni, col, 1);
+}
+
+  /*!
+
+     @brief Clear a cell of numeric grid
+
+     @param gn    pointer to existing numeric grid
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval NONE
+
+  */
+
+void grid_numeric_clear_cell(grid_numeric_s *gn, int row, int col)
+{
+  _grid_numeric_internals *gni;
+  _grid_numeric_column *c;
+
+    // Sanity check parameters.
+  assert(gn);
+
+  gni = _grid_numeric_get_internals(gn);
+  if (!gni || !_grid_numeric_in_grid(gni, row, col)) return;
+
+  c = &gni->cols[col];
+  c->set[row] = 0;
+  if (gni->type == grid_numeric_double)
+    ((double *)c->values)[row] = 0.0;
+  else
+    ((int64_t *)c->values)[row] = 0;
+}
+
+  /*!
+
+     @brief Get whether a cell of numeric grid holds a number
+
+     @param gn    pointer to existing numeric grid
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval 1    cell holds a number
+     @retval 0    cell is empty, or outside grid
+
+  */
+
+int grid_numeric_is_set(grid_numeric_s *gn, int row, int col)
+{
+  _grid_numeric_internals *gni;
+
+    // Sanity check parameters.
+  assert(gn);
+
+  gni = _grid_numeric_get_internals(gn);
+  if (!gni || !_grid_numeric_in_grid(gni, row, col)) return 0;
+
+    // Return "int"
+  return gni->cols[col].set[row] ? 1 : 0;
+}
+
+  /*!
+
+     @brief Get a cell of numeric grid as double
+
+     @param gn    pointer to existing numeric grid
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval "double" number held by cell, or zero
+
+  */
+
+double grid_numeric_get_double(grid_numeric_s *gn, int row, int col)
+{
+  _grid_numeric_internals *gni;
+
+    // Sanity check parameters.
+  assert(gn);
+
+  gni = _grid_numeric_get_internals(gn);
+  if (!gni || !_grid_numeric_in_grid(gni, row, col)) return 0.0;
+
+  if (gni->type == grid_numeric_int64)
+    return (double)((int64_t *)gni->cols[col].values)[row];
+
+    // Return "double"
+  return ((double *)gni->cols[col].values)[row];
+}
+
+  /*!
+
+     @brief Set a cell of numeric grid from double
+
+     The number is truncated toward zero when the grid holds int64 numbers.
+     A number that is not a number, or whose whole part is out of the int64
+     range, is rejected for such a grid.  Cells outside the grid are ignored.
+
+     @param gn    pointer to existing numeric grid
+     @param row    row of cell
+     @param col    column of cell
+     @param value    number to set
+
+     @retval 0    success
+     @retval -1    failure, cell is outside grid or number is rejected
+
+  */
+
+int grid_numeric_set_double(grid_numeric_s *gn,
+                            int row,
+                            int col,
+                            double value)
+{
+  _grid_numeric_internals *gni;
+  _grid_numeric_column *c;
+
+    // Sanity check parameters.
+  assert(gn);
+
+  gni = _grid_numeric_get_internals(gn);
+  if (!gni || !_grid_numeric_in_grid(gni, row, col)) return -1;
+
+  if (gni->type == grid_numeric_int64 && !_grid_numeric_fits_int64(value))
+    return -1;
+
+  c = &gni->cols[col];
+  c->set[row] = 1;
+  if (gni->type == grid_numeric_double)
+    ((double *)c->values)[row] = value;
+  else
+    ((int64_t *)c->values)[row] = (int64_t)value;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief Get a cell of numeric grid as int64
+
+     @param gn    pointer to existing numeric grid
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval "int64_t" number held by cell, or zero when it does not fit
+
+  */
+
+int64_t grid_numeric_get_int64(grid_numeric_s *gn, int row, int col)
+{
+  _grid_numeric_internals *gni;
+  double value;
+
+    // Sanity check parameters.
+  assert(gn);
+
+  gni = _grid_numeric_get_internals(gn);
+  if (!gni || !_grid_numeric_in_grid(gni, row, col)) return 0;
+
+  if (gni->type == grid_numeric_double)
+  {
+    value = ((double *)gni->cols[col].values)[row];
+    return (_grid_numeric_fits_int64(value)) ? (int64_t)value : 0;
+  }
+
+    // Return "int64_t"
+  return ((int64_t *)gni->cols[col].values)[row];
+}
+
+  /*!
+
+     @brief Set a cell of numeric grid from int64
+
+     Cells outside the grid are ignored.
+
+     @param gn    pointer to existing numeric grid
+     @param row    row of cell
+     @param col    column of cell
+     @param value    number to set
+
+     @retval NONE
+
+  */
+
+void grid_numeric_set_int64(grid_numeric_s *gn,
+                            int row,
+                            int col,
+                            int64_t value)
+{
+  _grid_numeric_internals *gni;
+  _grid_numeric_column *c;
+
+    // Sanity check parameters.
+  assert(gn);
+
+  gni = _grid_numeric_get_internals(gn);
+  if (!gni || !_grid_numeric_in_grid(gni, row, col)) return;
+
+  c = &gni->cols[col];
+  c->set[row] = 1;
+  if (gni->type == grid_numeric_int64)
+    ((int64_t *)c->values)[row] = value;
+  else
+    ((double *)c->values)[row] = (double)value;
+}
+
+  /*!
+
+     @brief Summarize a rectangular range of numeric grid
+
+     Computes the count, sum, smallest, largest and mean of the non-empty
+     cells in a range of rows and columns.  The range is clipped to the grid.
+     The sum of an int64 grid is exact, so that summarizing fails when the
+     sum, added up column by column, does not fit in an int64.
+
+     @param gn    pointer to existing numeric grid
+     @param row    first row of range
+     @param col    first column of range
+     @param rows    number of rows in range
+     @param cols    number of columns in range
+     @param stats    pointer to summary structure to fill
+
+     @retval 0    success
+     @retval -1    failure, or the sum of int64 cells overflowed
+
+  */
+
+int grid_numeric_stats(grid_numeric_s *gn,
+                       int row,
+                       int col,
+                       int rows,
+                       int cols,
+                       grid_numeric_stats_s *stats)
+{
+  _grid_numeric_internals *gni;
+  _grid_numeric_acc acc;
+  int height, width;
+  int c;
+
+    // Sanity check parameters.
+  assert(gn);
+  assert(stats);
+
+  gni = _grid_numeric_get_internals(gn);
+  if (!gni) return -1;
+
+  if (row < 0 || col < 0 || rows < 0 || cols < 0) return -1;
+
+  height = grid_size_get_height(gni->size);
+  width = grid_size_get_width(gni->size);
+
+  if (rows > height - row) rows = height - row;
+  if (cols > width - col) cols = width - col;
+
+  memset(&acc, 0, sizeof(_grid_numeric_acc));
+  acc.min = HUGE_VAL;
+  acc.max = -HUGE_VAL;
+  acc.imin = INT64_MAX;
+  acc.imax = INT64_MIN;
+
+  for (c = col; c < col + cols && rows > 0; ++c)
+  {
+    if (gni->type == grid_numeric_double)
+      _grid_numeric_sum_double((double *)gni->cols[c].values + row,
+                               gni->cols[c].set + row,
+                               rows,
+                               &acc);
+    else
+      _grid_numeric_sum_int64((int64_t *)gni->cols[c].values + row,
+                              gni->cols[c].set + row,
+                              rows,
+                              &acc);
+  }
+
+  memset(stats, 0, sizeof(grid_numeric_stats_s));
+
+  if (acc.overflow) return -1;
+
+  stats->count = acc.count;
+  if (!acc.count) return 0;
+
+  if (gni->type == grid_numeric_int64)
+  {
+    stats->isum = acc.isum;
+    stats->imin = acc.imin;
+    stats->imax = acc.imax;
+    acc.sum = (double)acc.isum;
+    acc.min = (double)acc.imin;
+    acc.max = (double)acc.imax;
+  }
+
+  stats->sum = acc.sum;
+  stats->min = acc.min;
+  stats->max = acc.max;
+  stats->mean = acc.sum / (double)acc.count;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief Summarize a row of numeric grid
+
+     @param gn    pointer to existing numeric grid
+     @param row    row to summarize
+     @param stats    pointer to summary structure to fill
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+int grid_numeric_row_stats(grid_numeric_s *gn,
+                           int row,
+                           grid_numeric_stats_s *stats)
+{
+  grid_size_s *gs;
+
+    // Sanity check parameters.
+  assert(gn);
+  assert(stats);
+
+  gs = grid_numeric_get_size(gn);
+  if (!gs) return -1;
+
+    // Return "int"
+  return grid_numeric_stats(gn, row, 0, 1, grid_size_get_width(gs), stats);
+}
+
+  /*!
+
+     @brief Summarize a column of numeric grid
+
+     @param gn    pointer to existing numeric grid
+     @param col    column to summarize
+     @param stats    pointer to summary structure to fill
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+int grid_numeric_column_stats(grid_numeric_s *gn,
+                              int col,
+                              grid_numeric_stats_s *stats)
+{
+  grid_size_s *gs;
+
+    // Sanity check parameters.
+  assert(gn);
+  assert(stats);
+
+  gs = grid_numeric_get_size(gn);
+  if (!gs) return -1;
+
+    // Return "int"
+  return grid_numeric_stats(gn, 0, col, grid_size_get_height(gs), 1, stats);
+}
+
+// STATIC functions
+
+  /*!
+
+     @brief INTERNAL:  Get numeric grid internals
+
+     @param gn    pointer to existing numeric grid
+
+     @retval "_grid_numeric_internals *" success
+     @retval NULL    failure
+
+  */
+
+static _grid_numeric_internals *_grid_numeric_get_internals(grid_numeric_s *gn)
+{
+    // Sanity check parameters.
+  assert(gn);
+
+    // Return "_grid_numeric_internals *"
+  return (_grid_numeric_internals *)gn->_internals;
+}
+
+  /*!
+
+     @brief INTERNAL:  Reserve room for rows in every column
+
+     New room is zeroed, so that new cells are empty.
+
+     @param gni    pointer to numeric grid internals
+     @param rows    number of rows needed
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_numeric_reserve_rows(_grid_numeric_internals *gni, int rows)
+{
+  _grid_numeric_column *c;
+  void *values;
+  unsigned char *set;
+  int cap;
+  int i;
+
+    // Sanity check parameters.
+  assert(gni);
+
+  if (rows <= gni->rcap) return 0;
+
+  cap = (gni->rcap < NUMERIC_MIN_ROWS) ? NUMERIC_MIN_ROWS : gni->rcap;
+  while (cap < rows) cap *= 2;
+
+  for (i = 0; i < gni->ccap; ++i)
+  {
+    c = &gni->cols[i];
+
+    values = realloc(c->values, (size_t)cap * sizeof(double));
+    if (!values) return -1;
+    c->values = values;
+
+    set = (unsigned char *)realloc(c->set, (size_t)cap);
+    if (!set) return -1;
+    c->set = set;
+
+    memset((char *)c->values + (size_t)gni->rcap * sizeof(double),
+           0,
+           (size_t)(cap - gni->rcap) * sizeof(double));
+    memset(c->set + gni->rcap, 0, (size_t)(cap - gni->rcap));
+  }
+
+  gni->rcap = cap;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Reserve room for columns
+
+     Every column of the array, used or not, has room for rcap rows.
+
+     @param gni    pointer to numeric grid internals
+     @param cols    number of columns needed
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_numeric_reserve_columns(_grid_numeric_internals *gni,
+                                         int cols)
+{
+  _grid_numeric_column *c;
+  int cap;
+
+    // Sanity check parameters.
+  assert(gni);
+
+  if (cols <= gni->ccap) return 0;
+
+  cap = (gni->ccap < 4) ? 4 : gni->ccap;
+  while (cap < cols) cap *= 2;
+
+  c = (_grid_numeric_column *)realloc(gni->cols,
+                                      (size_t)cap *
+                                        sizeof(_grid_numeric_column));
+  if (!c) return -1;
+  gni->cols = c;
+
+  for (; gni->ccap < cap; ++gni->ccap)
+  {
+    c = &gni->cols[gni->ccap];
+    c->values = calloc((size_t)gni->rcap + 1, sizeof(double));
+    c->set = (unsigned char *)calloc((size_t)gni->rcap + 1, 1);
+    if (!c->values || !c->set)
+    {
+      free(c->values);
+      free(c->set);
+      return -1;
+    }
+  }
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Insert empty rows
+
+     @param gni    pointer to numeric grid internals
+     @param row    row before which to insert, no greater than height
+     @param count    number of rows to insert
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_numeric_insert_rows(_grid_numeric_internals *gni,
+                                     int row, int count)
+{
+  _grid_numeric_column *c;
+  int height, width;
+  int i;
+
+    // Sanity check parameters.
+  assert(gni);
+
+  height = grid_size_get_height(gni->size);
+  width = grid_size_get_width(gni->size);
+
+  if (count < 1) return 0;
+  if (_grid_numeric_reserve_rows(gni, height + count)) return -1;
+
+  for (i = 0; i < width; ++i)
+  {
+    c = &gni->cols[i];
+
+    memmove((double *)c->values + row + count,
+            (double *)c->values + row,
+            (size_t)(height - row) * sizeof(double));
+    memset((double *)c->values + row, 0, (size_t)count * sizeof(double));
+
+    memmove(c->set + row + count, c->set + row, (size_t)(height - row));
+    memset(c->set + row, 0, (size_t)count);
+  }
+
+  grid_size_set_height(gni->size, height + count);
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Insert empty columns
+
+     Spare columns past the width are always empty, so inserting columns only
+     rotates spare columns into place.
+
+     @param gni    pointer to numeric grid internals
+     @param col    column before which to insert, no greater than width
+     @param count    number of columns to insert
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_numeric_insert_columns(_grid_numeric_internals *gni,
+                                        int col, int count)
+{
+  _grid_numeric_column *spare;
+  int width;
+
+    // Sanity check parameters.
+  assert(gni);
+
+  width = grid_size_get_width(gni->size);
+
+  if (count < 1) return 0;
+  if (_grid_numeric_reserve_columns(gni, width + count)) return -1;
+
+  if (col < width)
+  {
+    spare = (_grid_numeric_column *)malloc((size_t)count *
+                                           sizeof(_grid_numeric_column));
+    if (!spare) return -1;
+
+    memcpy(spare, gni->cols + width, (size_t)count * sizeof(*spare));
+    memmove(gni->cols + col + count,
+            gni->cols + col,
+            (size_t)(width - col) * sizeof(*spare));
+    memcpy(gni->cols + col, spare, (size_t)count * sizeof(*spare));
+
+    free(spare);
+  }
+
+  grid_size_set_width(gni->size, width + count);
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Remove rows
+
+     @param gni    pointer to numeric grid internals
+     @param row    first row to remove, within grid
+     @param count    number of rows to remove, within grid
+
+     @retval NONE
+
+  */
+
+static void _grid_numeric_remove_rows(_grid_numeric_internals *gni,
+                                      int row, int count)
+{
+  _grid_numeric_column *c;
+  int height, width;
+  int i;
+
+    // Sanity check parameters.
+  assert(gni);
+
+  height = grid_size_get_height(gni->size);
+  width = grid_size_get_width(gni->size);
+
+  for (i = 0; i < width; ++i)
+  {
+    c = &gni->cols[i];
+
+    memmove((double *)c->values + row,
+            (double *)c->values + row + count,
+            (size_t)(height - row - count) * sizeof(double));
+    memset((double *)c->values + height - count,
+           0,
+           (size_t)count * sizeof(double));
+
+    memmove(c->set + row, c->set + row + count,
+            (size_t)(height - row - count));
+    memset(c->set + height - count, 0, (size_t)count);
+  }
+
+  grid_size_set_height(gni->size, height - count);
+}
+
+  /*!
+
+     @brief INTERNAL:  Remove columns
+
+     The removed columns are cleared, and rotated past the width to be reused.
+
+     @param gni    pointer to numeric grid internals
+     @param col    first column to remove, within grid
+     @param count    number of columns to remove, within grid
+
+     @retval NONE
+
+  */
+
+static void _grid_numeric_remove_columns(_grid_numeric_internals *gni,
+                                         int col, int count)
+{
+  _grid_numeric_column c;
+  int height, width;
+  int i;
+
+    // Sanity check parameters.
+  assert(gni);
+
+  height = grid_size_get_height(gni->size);
+  width = grid_size_get_width(gni->size);
+
+  for (i = 0; i < count; ++i)
+  {
+    c = gni->cols[col];
+
+    memset(c.values, 0, (size_t)height * sizeof(double));
+    memset(c.set, 0, (size_t)height);
+
+    memmove(gni->cols + col,
+            gni->cols + col + 1,
+            (size_t)(width - i - col - 1) * sizeof(_grid_numeric_column));
+    gni->cols[width - i - 1] = c;
+  }
+
+  grid_size_set_width(gni->size, width - count);
+}
+
+  /*!
+
+     @brief INTERNAL:  Check that a cell lies within numeric grid
+
+     @param gni    pointer to numeric grid internals
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval 1    cell within grid
+     @retval 0    cell outside grid
+
+  */
+
+static int _grid_numeric_in_grid(_grid_numeric_internals *gni,
+                                 int row, int col)
+{
+    // Sanity check parameters.
+  assert(gni);
+
+  if (row < 0 || row >= grid_size_get_height(gni->size)) return 0;
+  if (col < 0 || col >= grid_size_get_width(gni->size)) return 0;
+
+    // Return "int"
+  return 1;
+}
+
+  /*!
+
+     @brief INTERNAL:  Check that a double truncates to an int64
+
+     @param value    number to check
+
+     @retval 1    whole part of number is within int64 range
+     @retval 0    number is not a number, or is out of range
+
+  */
+
+static int _grid_numeric_fits_int64(double value)
+{
+    // Return "int"
+  return value >= -9223372036854775808.0 && value < 9223372036854775808.0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Accumulate a run of double cells
+
+     Works through the run a block at a time, so that each block is still in
+     cache for the later passes over it.  Empty cells hold zero, so the sum
+     needs no test of the flags.
+
+     @param v    pointer to first number
+     @param set    pointer to first flag
+     @param n    number of cells
+     @param acc    pointer to accumulator
+
+     @retval NONE
+
+  */
+
+static void _grid_numeric_sum_double(const double *v,
+                                     const unsigned char *set,
+                                     int n,
+                                     _grid_numeric_acc *acc)
+{
+  double sum[NUMERIC_LANES];
+  long count = 0;
+  int b, m, i, j;
+
+    // Sanity check parameters.
+  assert(v);
+  assert(set);
+  assert(acc);
+
+  for (j = 0; j < NUMERIC_LANES; ++j) sum[j] = 0.0;
+
+  for (b = 0; b < n; b += m, v += m, set += m)
+  {
+    m = (n - b < NUMERIC_BLOCK) ? n - b : NUMERIC_BLOCK;
+
+    for (i = 0; i + NUMERIC_LANES <= m; i += NUMERIC_LANES)
+      for (j = 0; j < NUMERIC_LANES; ++j) sum[j] += v[i + j];
+    for (; i < m; ++i) sum[0] += v[i];
+
+    for (i = 0; i < m; ++i) count += set[i];
+
+    for (i = 0; i < m; ++i)
+    {
+      if (!set[i]) continue;
+      if (v[i] < acc->min) acc->min = v[i];
+      if (v[i] > acc->max) acc->max = v[i];
+    }
+  }
+
+  for (j = 0; j < NUMERIC_LANES; ++j) acc->sum += sum[j];
+  acc->count += count;
+}
+
+  /*!
+
+     @brief INTERNAL:  Accumulate a run of int64 cells
+
+     As for _grid_numeric_sum_double().  The accumulator is marked when the
+     sum overflows.
+
+     @param v    pointer to first number
+     @param set    pointer to first flag
+     @param n    number of cells
+     @param acc    pointer to accumulator
+
+     @retval NONE
+
+  */
+
+static void _grid_numeric_sum_int64(const int64_t *v,
+                                    const unsigned char *set,
+                                    int n,
+                                    _grid_numeric_acc *acc)
+{
+  int64_t sum = 0;
+  long count = 0;
+  int b, m, i;
+
+    // Sanity check parameters.
+  assert(v);
+  assert(set);
+  assert(acc);
+
+  for (b = 0; b < n; b += m, v += m, set += m)
+  {
+    m = (n - b < NUMERIC_BLOCK) ? n - b : NUMERIC_BLOCK;
+
+    for (i = 0; i < m; ++i)
+      if (__builtin_add_overflow(sum, v[i], &sum)) acc->overflow = 1;
+
+    for (i = 0; i < m; ++i) count += set[i];
+
+    for (i = 0; i < m; ++i)
+    {
+      if (!set[i]) continue;
+      if (v[i] < acc->imin) acc->imin = v[i];
+      if (v[i] > acc->imax) acc->imax = v[i];
+    }
+  }
+
+  if (__builtin_add_overflow(acc->isum, sum, &acc->isum)) acc->overflow = 1;
+  acc->count += count;
+}
+
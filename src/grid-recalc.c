@@ -0,0 +1,1103 @@
+/*!
+    @file grid-recalc.c
+
+    @brief Source file for grid recalculation
+
+    @timestamp Sat, 17 Oct 2026 02:57:12 +0000
+
+    @author Patrick Head  mailto:patrickhead@gmail.com
+
+    @copyright Copyright (C) 2014  Patrick Head
+
+    @license
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.@n
+    @n
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.@n
+    @n
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+  /*!
+
+    @file grid-recalc.c
+
+    Source file for dependency tracked recalculation of grid cells
+
+    Every cell a computed cell depends on alone is kept in a hash table,
+    with the list of computed cells depending on it.  Ranges of more than
+    one cell are kept in a separate list, which is scanned for the cells
+    depending on a changed cell.  grid_recalc_run() evaluates the dirty
+    cells in waves: each wave holds the dirty cells whose dirty dependencies
+    have all been computed by earlier waves, and is run on the thread pool.
+
+  */
+
+  // Required system headers
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+  // Project related headers
+
+#include "grid-recalc.h"
+
+  /*!
+    @brief INTERNAL: rectangular range of cells
+  */
+
+typedef struct
+{
+    /*! @brief: first row of range */
+  int row;
+    /*! @brief: first column of range */
+  int col;
+    /*! @brief: number of rows in range */
+  int rows;
+    /*! @brief: number of columns in range */
+  int cols;
+} _grid_recalc_range;
+
+  /*!
+    @brief INTERNAL: cell table entry
+  */
+
+typedef struct
+{
+    /*! @brief: row of cell, -1 for an unused entry */
+  int row;
+    /*! @brief: column of cell */
+  int col;
+    /*! @brief: computed cell at cell, or -1 */
+  int node;
+    /*! @brief: computed cells depending on cell alone */
+  int *watchers;
+    /*! @brief: number of computed cells in watchers */
+  int nwatch;
+    /*! @brief: capacity of watchers */
+  int wcap;
+} _grid_recalc_cell;
+
+  /*!
+    @brief INTERNAL: computed cell
+  */
+
+typedef struct
+{
+    /*! @brief: row of cell, -1 for an unused computed cell */
+  int row;
+    /*! @brief: column of cell */
+  int col;
+    /*! @brief: non-zero when cell must be computed */
+  int dirty;
+    /*! @brief: number of dirty cells to compute first, during a run */
+  int pending;
+    /*! @brief: cells and ranges cell depends on */
+  _grid_recalc_range *deps;
+    /*! @brief: number of entries in deps */
+  int ndeps;
+    /*! @brief: capacity of deps */
+  int dcap;
+} _grid_recalc_node;
+
+  /*!
+    @brief INTERNAL: computed cell depending on a range of cells
+  */
+
+typedef struct
+{
+    /*! @brief: range depended on */
+  _grid_recalc_range range;
+    /*! @brief: computed cell */
+  int node;
+} _grid_recalc_watch;
+
+  /*!
+    @brief INTERNAL: list of computed cells
+  */
+
+typedef struct
+{
+    /*! @brief: computed cells */
+  int *ids;
+    /*! @brief: number of computed cells */
+  int count;
+    /*! @brief: capacity of ids */
+  int cap;
+} _grid_recalc_list;
+
+  /*!
+    @brief INTERNAL: grid recalculation details structure
+  */
+
+typedef struct
+{
+    /*! @brief: grid recalculated */
+  grid_s *grid;
+    /*! @brief: user cell computation function */
+  grid_recalc_eval func;
+    /*! @brief: user data for computation function */
+  void *data;
+    /*! @brief: open addressing (linear probing) table of cells */
+  _grid_recalc_cell *slots;
+    /*! @brief: number of slots, zero or a power of two */
+  int capacity;
+    /*! @brief: number of used slots */
+  int count;
+    /*! @brief: computed cells */
+  _grid_recalc_node *nodes;
+    /*! @brief: number of computed cells allocated */
+  int nnodes;
+    /*! @brief: capacity of nodes */
+  int ncap;
+    /*! @brief: unused computed cells, available for re-use */
+  _grid_recalc_list spare;
+    /*! @brief: computed cells depending on ranges */
+  _grid_recalc_watch *ranges;
+    /*! @brief: number of entries in ranges */
+  int nranges;
+    /*! @brief: capacity of ranges */
+  int rcap;
+    /*! @brief: dirty computed cells */
+  _grid_recalc_list dirty;
+} _grid_recalc_internals;
+
+  /*!
+    @brief INTERNAL: wave of computed cells, run on a thread pool
+  */
+
+typedef struct
+{
+    /*! @brief: grid recalculation internals */
+  _grid_recalc_internals *ri;
+    /*! @brief: computed cells of wave */
+  int *ids;
+    /*! @brief: payload data of each computed cell of wave */
+  void **payloads;
+} _grid_recalc_wave;
+
+  // INTERNAL: utility function prototypes for module
+
+static _grid_recalc_internals *_grid_recalc_get_internals(grid_recalc_s *gr);
+static unsigned int _grid_recalc_hash(int row, int col);
+static _grid_recalc_cell *_grid_recalc_find(_grid_recalc_internals *ri,
+                                            int row, int col);
+static _grid_recalc_cell *_grid_recalc_cell_get(_grid_recalc_internals *ri,
+                                                int row, int col);
+static int _grid_recalc_rehash(_grid_recalc_internals *ri, int capacity);
+static int _grid_recalc_node_get(_grid_recalc_internals *ri, int row, int col);
+static void _grid_recalc_node_clear(_grid_recalc_internals *ri, int id);
+static int _grid_recalc_list_add(_grid_recalc_list *list, int id);
+static void _grid_recalc_list_remove(_grid_recalc_list *list, int id);
+static int _grid_recalc_dependents(_grid_recalc_internals *ri,
+                                   int row, int col,
+                                   _grid_recalc_list *list);
+static void _grid_recalc_eval_job(int index, void *data);
+
+  /*!
+
+     @brief Create a recalculation layer for a grid
+
+     No cell is computed until declared with grid_recalc_set() or
+     grid_recalc_depend().  The grid must outlive the recalculation layer.
+
+     @param g    pointer to existing grid
+     @param func    pointer to user cell computation function
+     @param data    pointer to user data for computation function, or NULL
+
+     @retval "grid_recalc_s *" success
+     @retval NULL    failure
+
+  */
+
+grid_recalc_s *grid_recalc_create(grid_s *g, grid_recalc_eval func, void *data)
+{
+  grid_recalc_s *gr;
+  _grid_recalc_internals *ri;
+
+    // Sanity check parameters.
+  assert(g);
+  assert(func);
+
+  gr = malloc(sizeof(grid_recalc_s));
+  if (!gr) return NULL;
+
+  ri = (void*)malloc(sizeof(_grid_recalc_internals));
+  if (!ri)
+  {
+    free(gr);
+    return NULL;
+  }
+  memset(ri, 0, sizeof(_grid_recalc_internals));
+  gr->_internals = ri;
+
+  ri->grid = g;
+  ri->func = func;
+  ri->data = data;
+
+    // Return "grid_recalc_s *"
+  return gr;
+}
+
+  /*!
+
+     @brief Destroy a recalculation layer
+
+     The grid, and its payload data, are left intact.
+
+     @param gr    pointer to existing recalculation layer
+
+     @retval NONE
+
+  */
+
+void grid_recalc_destroy(grid_recalc_s *gr)
+{
+  _grid_recalc_internals *ri;
+  int i;
+
+    // Sanity check parameters.
+  assert(gr);
+
+  ri = _grid_recalc_get_internals(gr);
+  if (ri)
+  {
+    for (i = 0; i < ri->capacity; ++i)
+      free(ri->slots[i].watchers);
+    free(ri->slots);
+
+    for (i = 0; i < ri->nnodes; ++i)
+      free(ri->nodes[i].deps);
+    free(ri->nodes);
+
+    free(ri->spare.ids);
+    free(ri->ranges);
+    free(ri->dirty.ids);
+
+    free(ri);
+  }
+
+  free(gr);
+}
+
+  /*!
+
+     @brief Declare a computed cell
+
+     Declares the cell computed, forgetting any cells it depended on, as
+     when its formula is replaced.  The cell, and every cell depending on
+     it, is marked dirty.
+
+     @param gr    pointer to existing recalculation layer
+     @param row    row of cell
+     @param column    column of cell
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+int grid_recalc_set(grid_recalc_s *gr, int row, int column)
+{
+  _grid_recalc_internals *ri;
+  int id;
+
+    // Sanity check parameters.
+  assert(gr);
+
+  ri = _grid_recalc_get_internals(gr);
+  if (!ri || row < 0 || column < 0) return -1;
+
+  id = _grid_recalc_node_get(ri, row, column);
+  if (id < 0) return -1;
+
+  _grid_recalc_node_clear(ri, id);
+
+    // Return "int"
+  return grid_recalc_mark(gr, row, column);
+}
+
+  /*!
+
+     @brief Stop computing a cell
+
+     Forgets the cells the cell depended on.  Every cell depending on it is
+     marked dirty.
+
+     @param gr    pointer to existing recalculation layer
+     @param row    row of cell
+     @param column    column of cell
+
+     @retval NONE
+
+  */
+
+void grid_recalc_unset(grid_recalc_s *gr, int row, int column)
+{
+  _grid_recalc_internals *ri;
+  _grid_recalc_cell *cell;
+  int id;
+
+    // Sanity check parameters.
+  assert(gr);
+
+  ri = _grid_recalc_get_internals(gr);
+  if (!ri) return;
+
+  cell = _grid_recalc_find(ri, row, column);
+  if (!cell || cell->node < 0) return;
+
+  id = cell->node;
+  cell->node = -1;
+
+  _grid_recalc_node_clear(ri, id);
+  if (ri->nodes[id].dirty) _grid_recalc_list_remove(&ri->dirty, id);
+  ri->nodes[id].dirty = 0;
+  ri->nodes[id].row = -1;
+
+    // An unused computed cell is simply never re-used if it can not be kept
+  _grid_recalc_list_add(&ri->spare, id);
+
+  grid_recalc_mark(gr, row, column);
+}
+
+  /*!
+
+     @brief Declare a cell, or range of cells, a computed cell depends on
+
+     The computed cell is declared, if it was not, and is marked dirty with
+     every cell depending on it.  A range is clipped at the top and left
+     edges of the grid.
+
+     @param gr    pointer to existing recalculation layer
+     @param row    row of computed cell
+     @param column    column of computed cell
+     @param dep_row    first row of range depended on
+     @param dep_column    first column of range depended on
+     @param rows    number of rows in range
+     @param columns    number of columns in range
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+int grid_recalc_depend(grid_recalc_s *gr,
+                       int row,
+                       int column,
+                       int dep_row,
+                       int dep_column,
+                       int rows,
+                       int columns)
+{
+  _grid_recalc_internals *ri;
+  _grid_recalc_node *node;
+  _grid_recalc_range range;
+  _grid_recalc_cell *cell;
+  void *p;
+  int id, n;
+
+    // Sanity check parameters.
+  assert(gr);
+
+  ri = _grid_recalc_get_internals(gr);
+  if (!ri || row < 0 || column < 0) return -1;
+
+  if (dep_row < 0)
+  {
+    rows += dep_row;
+    dep_row = 0;
+  }
+  if (dep_column < 0)
+  {
+    columns += dep_column;
+    dep_column = 0;
+  }
+  if (rows < 1 || columns < 1) return -1;
+
+  id = _grid_recalc_node_get(ri, row, column);
+  if (id < 0) return -1;
+
+  range.row = dep_row;
+  range.col = dep_column;
+  range.rows = rows;
+  range.cols = columns;
+
+  node = &ri->nodes[id];
+  if (node->ndeps == node->dcap)
+  {
+    n = (node->dcap) ? 2 * node->dcap : 4;
+    p = realloc(node->deps, (size_t)n * sizeof(_grid_recalc_range));
+    if (!p) return -1;
+    node->deps = (_grid_recalc_range *)p;
+    node->dcap = n;
+  }
+
+  if (rows == 1 && columns == 1)
+  {
+    cell = _grid_recalc_cell_get(ri, dep_row, dep_column);
+    if (!cell) return -1;
+
+    if (cell->nwatch == cell->wcap)
+    {
+      n = (cell->wcap) ? 2 * cell->wcap : 4;
+      p = realloc(cell->watchers, (size_t)n * sizeof(int));
+      if (!p) return -1;
+      cell->watchers = (int *)p;
+      cell->wcap = n;
+    }
+    cell->watchers[cell->nwatch++] = id;
+  }
+  else
+  {
+    if (ri->nranges == ri->rcap)
+    {
+      n = (ri->rcap) ? 2 * ri->rcap : 16;
+      p = realloc(ri->ranges, (size_t)n * sizeof(_grid_recalc_watch));
+      if (!p) return -1;
+      ri->ranges = (_grid_recalc_watch *)p;
+      ri->rcap = n;
+    }
+    ri->ranges[ri->nranges].range = range;
+    ri->ranges[ri->nranges].node = id;
+    ++ri->nranges;
+  }
+
+  node->deps[node->ndeps++] = range;
+
+    // Return "int"
+  return grid_recalc_mark(gr, row, column);
+}
+
+  /*!
+
+     @brief Mark a cell as changed
+
+     Marks the cell, if computed, and every computed cell depending on it,
+     directly or indirectly, as dirty.  Call after changing the payload data
+     of a cell.
+
+     @param gr    pointer to existing recalculation layer
+     @param row    row of cell
+     @param column    column of cell
+
+     @retval 0    success
+     @retval -1    failure, some cells may not be marked
+
+  */
+
+int grid_recalc_mark(grid_recalc_s *gr, int row, int column)
+{
+  _grid_recalc_internals *ri;
+  _grid_recalc_cell *cell;
+  _grid_recalc_node *node;
+  _grid_recalc_list work;
+  int rc = 0;
+  int id;
+
+    // Sanity check parameters.
+  assert(gr);
+
+  ri = _grid_recalc_get_internals(gr);
+  if (!ri) return -1;
+
+  memset(&work, 0, sizeof(_grid_recalc_list));
+
+  cell = _grid_recalc_find(ri, row, column);
+  if (cell && cell->node >= 0)
+  {
+    node = &ri->nodes[cell->node];
+    if (node->dirty) return 0;
+    if (_grid_recalc_list_add(&ri->dirty, cell->node)) return -1;
+    node->dirty = 1;
+  }
+
+  rc = _grid_recalc_dependents(ri, row, column, &work);
+
+    // Dependents of a cell already dirty are already dirty
+  while (!rc && work.count)
+  {
+    id = work.ids[--work.count];
+    node = &ri->nodes[id];
+    if (node->dirty) continue;
+
+    if (_grid_recalc_list_add(&ri->dirty, id))
+    {
+      rc = -1;
+      break;
+    }
+    node->dirty = 1;
+
+    rc = _grid_recalc_dependents(ri, node->row, node->col, &work);
+  }
+
+  free(work.ids);
+
+    // Return "int"
+  return rc;
+}
+
+  /*!
+
+     @brief Check whether a cell must be computed
+
+     @param gr    pointer to existing recalculation layer
+     @param row    row of cell
+     @param column    column of cell
+
+     @retval 1    cell is a dirty computed cell
+     @retval 0    cell is clean, or not computed
+
+  */
+
+int grid_recalc_is_dirty(grid_recalc_s *gr, int row, int column)
+{
+  _grid_recalc_internals *ri;
+  _grid_recalc_cell *cell;
+
+    // Sanity check parameters.
+  assert(gr);
+
+  ri = _grid_recalc_get_internals(gr);
+  if (!ri) return 0;
+
+  cell = _grid_recalc_find(ri, row, column);
+  if (!cell || cell->node < 0) return 0;
+
+    // Return "int"
+  return ri->nodes[cell->node].dirty;
+}
+
+  /*!
+
+     @brief Compute every dirty cell
+
+     Calls the user computation function for every dirty computed cell,
+     after the dirty cells it depends on, and marks it clean.  Dirty cells
+     that do not depend on each other are computed at once by the threads of
+     a thread pool.  Cells depending on themselves, directly or indirectly,
+     are not computed, and stay dirty.
+
+     NOTE:  The grid must not be changed during the run.
+
+     @param gr    pointer to existing recalculation layer
+     @param pool    pointer to existing thread pool, or NULL to compute
+                   serially
+
+     @retval "int" number of cells computed
+     @retval -1    failure, or cells left dirty by a cycle
+
+  */
+
+int grid_recalc_run(grid_recalc_s *gr, thread_pool_s *pool)
+{
+  _grid_recalc_internals *ri;
+  _grid_recalc_node *node;
+  _grid_recalc_wave wave;
+  _grid_recalc_list deps;
+  grid_cursor_s *gc;
+  int *next;
+  int height, width;
+  int nwave, nnext;
+  int done = 0;
+  int failed = 0;
+  int i, j, id;
+
+    // Sanity check parameters.
+  assert(gr);
+
+  ri = _grid_recalc_get_internals(gr);
+  if (!ri) return -1;
+
+  if (!ri->dirty.count) return 0;
+
+  memset(&deps, 0, sizeof(_grid_recalc_list));
+
+  wave.ri = ri;
+  wave.ids = (int *)malloc((size_t)ri->dirty.count * sizeof(int));
+  wave.payloads = (void **)malloc((size_t)ri->dirty.count * sizeof(void *));
+  next = (int *)malloc((size_t)ri->dirty.count * sizeof(int));
+  gc = grid_cursor_create(ri->grid);
+  if (!wave.ids || !wave.payloads || !next || !gc) failed = 1;
+
+    // Count the dirty cells each dirty cell must wait for
+  for (i = 0; i < ri->dirty.count; ++i)
+    ri->nodes[ri->dirty.ids[i]].pending = 0;
+
+  for (i = 0; i < ri->dirty.count && !failed; ++i)
+  {
+    node = &ri->nodes[ri->dirty.ids[i]];
+    deps.count = 0;
+    if (_grid_recalc_dependents(ri, node->row, node->col, &deps))
+      failed = 1;
+    for (j = 0; j < deps.count; ++j)
+      if (ri->nodes[deps.ids[j]].dirty) ++ri->nodes[deps.ids[j]].pending;
+  }
+
+  nwave = 0;
+  for (i = 0; i < ri->dirty.count && !failed; ++i)
+    if (!ri->nodes[ri->dirty.ids[i]].pending)
+      wave.ids[nwave++] = ri->dirty.ids[i];
+
+  height = grid_size_get_height(grid_get_size(ri->grid));
+  width = grid_size_get_width(grid_get_size(ri->grid));
+
+  while (nwave && !failed)
+  {
+      // A cursor stops at the edges of the grid, cells beyond are empty
+    for (i = 0; i < nwave; ++i)
+    {
+      node = &ri->nodes[wave.ids[i]];
+      wave.payloads[i] = (node->row < height && node->col < width) ?
+                           grid_cursor_goto(gc, node->row, node->col) : NULL;
+    }
+
+    thread_pool_run(pool, nwave, _grid_recalc_eval_job, &wave);
+
+    nnext = 0;
+    for (i = 0; i < nwave; ++i)
+    {
+      node = &ri->nodes[wave.ids[i]];
+      node->dirty = 0;
+      ++done;
+
+      deps.count = 0;
+      if (_grid_recalc_dependents(ri, node->row, node->col, &deps))
+        failed = 1;
+      for (j = 0; j < deps.count; ++j)
+      {
+        id = deps.ids[j];
+        if (ri->nodes[id].dirty && !--ri->nodes[id].pending) next[nnext++] = id;
+      }
+    }
+
+    memcpy(wave.ids, next, (size_t)nnext * sizeof(int));
+    nwave = nnext;
+  }
+
+    // Keep only the cells left dirty
+  j = 0;
+  for (i = 0; i < ri->dirty.count; ++i)
+    if (ri->nodes[ri->dirty.ids[i]].dirty)
+      ri->dirty.ids[j++] = ri->dirty.ids[i];
+  ri->dirty.count = j;
+
+  if (gc) grid_cursor_destroy(gc);
+  free(next);
+  free(wave.payloads);
+  free(wave.ids);
+  free(deps.ids);
+
+  if (failed || ri->dirty.count) return -1;
+
+    // Return "int"
+  return done;
+}
+
+// STATIC functions
+
+  /*!
+
+     @brief INTERNAL:  Get grid recalculation internals
+
+     @param gr    pointer to existing recalculation layer
+
+     @retval "_grid_recalc_internals *" success
+     @retval NULL    failure
+
+  */
+
+static _grid_recalc_internals *_grid_recalc_get_internals(grid_recalc_s *gr)
+{
+    // Sanity check parameters.
+  assert(gr);
+    // Return "_grid_recalc_internals *"
+  return (_grid_recalc_internals *)gr->_internals;
+}
+
+  /*!
+
+     @brief INTERNAL:  Hash a cell position
+
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval "unsigned int" hash value
+
+  */
+
+static unsigned int _grid_recalc_hash(int row, int col)
+{
+  uint64_t k;
+
+  k = ((uint64_t)(unsigned int)row << 32) | (unsigned int)col;
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+
+    // Return "unsigned int"
+  return (unsigned int)k;
+}
+
+  /*!
+
+     @brief INTERNAL:  Find cell table entry of a cell
+
+     @param ri    pointer to grid recalculation internals
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval "_grid_recalc_cell *" success
+     @retval NULL    cell not in table
+
+  */
+
+static _grid_recalc_cell *_grid_recalc_find(_grid_recalc_internals *ri,
+                                            int row, int col)
+{
+  _grid_recalc_cell *cell;
+  unsigned int i;
+
+    // Sanity check parameters.
+  assert(ri);
+
+  if (!ri->capacity || row < 0) return NULL;
+
+  i = _grid_recalc_hash(row, col) & (unsigned int)(ri->capacity - 1);
+
+  for (;;)
+  {
+    cell = &ri->slots[i];
+    if (cell->row < 0) return NULL;
+    if (cell->row == row && cell->col == col) return cell;
+    i = (i + 1) & (unsigned int)(ri->capacity - 1);
+  }
+}
+
+  /*!
+
+     @brief INTERNAL:  Find or add cell table entry of a cell
+
+     Entries are kept until the recalculation layer is destroyed.
+
+     @param ri    pointer to grid recalculation internals
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval "_grid_recalc_cell *" success
+     @retval NULL    failure
+
+  */
+
+static _grid_recalc_cell *_grid_recalc_cell_get(_grid_recalc_internals *ri,
+                                                int row, int col)
+{
+  _grid_recalc_cell *cell;
+  unsigned int i;
+
+    // Sanity check parameters.
+  assert(ri);
+
+  cell = _grid_recalc_find(ri, row, col);
+  if (cell) return cell;
+
+  if (2 * (ri->count + 1) > ri->capacity &&
+      _grid_recalc_rehash(ri, (ri->capacity) ? 2 * ri->capacity : 64))
+    return NULL;
+
+  i = _grid_recalc_hash(row, col) & (unsigned int)(ri->capacity - 1);
+  while (ri->slots[i].row >= 0)
+    i = (i + 1) & (unsigned int)(ri->capacity - 1);
+
+  cell = &ri->slots[i];
+  cell->row = row;
+  cell->col = col;
+  cell->node = -1;
+  ++ri->count;
+
+    // Return "_grid_recalc_cell *"
+  return cell;
+}
+
+  /*!
+
+     @brief INTERNAL:  Re-size the cell table
+
+     @param ri    pointer to grid recalculation internals
+     @param capacity    new number of slots, a power of two
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_recalc_rehash(_grid_recalc_internals *ri, int capacity)
+{
+  _grid_recalc_cell *slots;
+  unsigned int j;
+  int i;
+
+    // Sanity check parameters.
+  assert(ri);
+
+  slots = (_grid_recalc_cell *)calloc((size_t)capacity,
+                                      sizeof(_grid_recalc_cell));
+  if (!slots) return -1;
+
+  for (i = 0; i < capacity; ++i) slots[i].row = -1;
+
+  for (i = 0; i < ri->capacity; ++i)
+  {
+    if (ri->slots[i].row < 0) continue;
+    j = _grid_recalc_hash(ri->slots[i].row, ri->slots[i].col) &
+          (unsigned int)(capacity - 1);
+    while (slots[j].row >= 0) j = (j + 1) & (unsigned int)(capacity - 1);
+    slots[j] = ri->slots[i];
+  }
+
+  free(ri->slots);
+  ri->slots = slots;
+  ri->capacity = capacity;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Find or add the computed cell at a cell
+
+     @param ri    pointer to grid recalculation internals
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval "int" index of computed cell
+     @retval -1    failure
+
+  */
+
+static int _grid_recalc_node_get(_grid_recalc_internals *ri, int row, int col)
+{
+  _grid_recalc_cell *cell;
+  _grid_recalc_node *node;
+  void *p;
+  int id, n;
+
+    // Sanity check parameters.
+  assert(ri);
+
+  cell = _grid_recalc_cell_get(ri, row, col);
+  if (!cell) return -1;
+  if (cell->node >= 0) return cell->node;
+
+  if (ri->spare.count)
+    id = ri->spare.ids[--ri->spare.count];
+  else
+  {
+    if (ri->nnodes == ri->ncap)
+    {
+      n = (ri->ncap) ? 2 * ri->ncap : 64;
+      p = realloc(ri->nodes, (size_t)n * sizeof(_grid_recalc_node));
+      if (!p) return -1;
+      ri->nodes = (_grid_recalc_node *)p;
+      ri->ncap = n;
+    }
+    id = ri->nnodes++;
+    memset(&ri->nodes[id], 0, sizeof(_grid_recalc_node));
+  }
+
+  node = &ri->nodes[id];
+  node->row = row;
+  node->col = col;
+  node->dirty = 0;
+  node->ndeps = 0;
+
+  cell->node = id;
+
+    // Return "int"
+  return id;
+}
+
+  /*!
+
+     @brief INTERNAL:  Forget every cell a computed cell depends on
+
+     @param ri    pointer to grid recalculation internals
+     @param id    index of computed cell
+
+     @retval NONE
+
+  */
+
+static void _grid_recalc_node_clear(_grid_recalc_internals *ri, int id)
+{
+  _grid_recalc_node *node;
+  _grid_recalc_range *r;
+  _grid_recalc_cell *cell;
+  int i, j;
+
+    // Sanity check parameters.
+  assert(ri);
+
+  node = &ri->nodes[id];
+
+  for (i = 0; i < node->ndeps; ++i)
+  {
+    r = &node->deps[i];
+    if (r->rows != 1 || r->cols != 1) continue;
+
+    cell = _grid_recalc_find(ri, r->row, r->col);
+    if (!cell) continue;
+
+    for (j = 0; j < cell->nwatch && cell->watchers[j] != id; ++j) ;
+    if (j < cell->nwatch) cell->watchers[j] = cell->watchers[--cell->nwatch];
+  }
+
+  for (i = 0; i < ri->nranges; )
+    if (ri->ranges[i].node == id)
+      ri->ranges[i] = ri->ranges[--ri->nranges];
+    else
+      ++i;
+
+  node->ndeps = 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Add a computed cell to a list
+
+     @param list    pointer to list
+     @param id    index of computed cell
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_recalc_list_add(_grid_recalc_list *list, int id)
+{
+  void *p;
+  int n;
+
+    // Sanity check parameters.
+  assert(list);
+
+  if (list->count == list->cap)
+  {
+    n = (list->cap) ? 2 * list->cap : 64;
+    p = realloc(list->ids, (size_t)n * sizeof(int));
+    if (!p) return -1;
+    list->ids = (int *)p;
+    list->cap = n;
+  }
+
+  list->ids[list->count++] = id;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Remove a computed cell from a list
+
+     @param list    pointer to list
+     @param id    index of computed cell
+
+     @retval NONE
+
+  */
+
+static void _grid_recalc_list_remove(_grid_recalc_list *list, int id)
+{
+  int i;
+
+    // Sanity check parameters.
+  assert(list);
+
+  for (i = 0; i < list->count && list->ids[i] != id; ++i) ;
+  if (i < list->count) list->ids[i] = list->ids[--list->count];
+}
+
+  /*!
+
+     @brief INTERNAL:  Add the computed cells depending on a cell to a list
+
+     A computed cell depending on the cell more than once is added as many
+     times.
+
+     @param ri    pointer to grid recalculation internals
+     @param row    row of cell
+     @param col    column of cell
+     @param list    pointer to list
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_recalc_dependents(_grid_recalc_internals *ri,
+                                   int row, int col,
+                                   _grid_recalc_list *list)
+{
+  _grid_recalc_cell *cell;
+  _grid_recalc_range *r;
+  int i;
+
+    // Sanity check parameters.
+  assert(ri);
+  assert(list);
+
+  cell = _grid_recalc_find(ri, row, col);
+  if (cell)
+    for (i = 0; i < cell->nwatch; ++i)
+      if (_grid_recalc_list_add(list, cell->watchers[i])) return -1;
+
+  for (i = 0; i < ri->nranges; ++i)
+  {
+    r = &ri->ranges[i].range;
+    if (row >= r->row && row - r->row < r->rows &&
+        col >= r->col && col - r->col < r->cols &&
+        _grid_recalc_list_add(list, ri->ranges[i].node))
+      return -1;
+  }
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Compute one cell of a wave
+
+     Thread pool job function.
+
+     @param index    index of computed cell within wave
+     @param data    pointer to wave
+
+     @retval NONE
+
+  */
+
+static void _grid_recalc_eval_job(int index, void *data)
+{
+  _grid_recalc_wave *wave;
+  _grid_recalc_node *node;
+
+    // Sanity check parameters.
+  assert(data);
+
+  wave = (_grid_recalc_wave *)data;
+  node = &wave->ri->nodes[wave->ids[index]];
+
+  wave->ri->func(wave->ri->grid, node->row, node->col,
+                 wave->payloads[index], wave->ri->data);
+}
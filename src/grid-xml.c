@@ -41,6 +41,8 @@
 #include <assert.h>
 #include <libxml/parser.h>
 #include <libxml/tree.h>
+#include <libxml/xmlreader.h>
+#include <libxml/xmlwriter.h>
 
   // Project related headers
 
@@ -53,6 +55,84 @@
   // Common constants
 
 #define MAX_SN 40
+#define XML_INDENT "  "
+#define BAND_CELLS 16384
+
+  /*!
+    @brief INTERNAL: XML export details structure
+  */
+
+typedef struct
+{
+    /*! @brief: "rows" node of grid */
+  xmlNodePtr rows_node;
+    /*! @brief: "columns" node of current row */
+  xmlNodePtr cols_node;
+    /*! @brief: user cell conversion function */
+  grid_cell_to_xml_node func;
+} _grid_xml_export;
+
+  /*!
+    @brief INTERNAL: XML streaming export details structure
+  */
+
+typedef struct
+{
+    /*! @brief: XML text writer receiving the grid */
+  xmlTextWriterPtr writer;
+    /*! @brief: non-zero while a "row" element is open */
+  int row_open;
+    /*! @brief: user cell conversion function */
+  grid_cell_to_xml_writer func;
+} _grid_xml_stream;
+
+  /*!
+    @brief INTERNAL: XML output of one band of rows
+  */
+
+typedef struct
+{
+    /*! @brief: buffer holding XML output of band */
+  xmlBufferPtr buf;
+    /*! @brief: offset of first "row" element in buffer */
+  int offset;
+    /*! @brief: non-zero when rendering the band failed */
+  int failed;
+} _grid_xml_band;
+
+  /*!
+    @brief INTERNAL: parallel XML export details structure
+  */
+
+typedef struct
+{
+    /*! @brief: grid being exported */
+  grid_s *g;
+    /*! @brief: user cell conversion function */
+  grid_cell_to_xml_writer func;
+    /*! @brief: first row of current window of bands */
+  int start;
+    /*! @brief: number of rows in each band */
+  int rows;
+    /*! @brief: output of each band of current window */
+  _grid_xml_band *bands;
+} _grid_xml_bands;
+
+  // INTERNAL: utility function prototypes for module
+
+static int _grid_xml_export_span(void * const *payloads, int row, int col,
+                                 int count, void *data);
+static int _grid_xml_stream_span(void * const *payloads, int row, int col,
+                                 int count, void *data);
+static int _grid_xml_stream_end_row(_grid_xml_stream *st);
+static int _grid_xml_stream_bands(_grid_xml_stream *st, grid_s *g,
+                                  thread_pool_s *pool);
+static void _grid_xml_stream_band(int index, void *data);
+static int _grid_xml_read_file(void *context, char *buffer, int len);
+static int _grid_xml_read_element(xmlTextReaderPtr reader);
+static grid_s *_grid_xml_read_size(xmlTextReaderPtr reader);
+static int _grid_xml_read_rows(xmlTextReaderPtr reader, grid_s *g,
+                               grid_cell_from_xml_reader func);
 
   /*!
 
@@ -103,12 +183,8 @@ xmlNodePtr grid_to_xml_node(grid_s *g, grid_cell_to_xml_node func)
 {
   xmlNodePtr node;
   xmlNodePtr size_node;
-  xmlNodePtr rows_node;
-  xmlNodePtr row_node;
-  xmlNodePtr cols_node;
-  xmlNodePtr cell_node;
+  _grid_xml_export ex;
   char sn[MAX_SN];
-  int y, x;
 
     // Sanity check parameters.
   assert(g);
@@ -122,24 +198,102 @@ xmlNodePtr grid_to_xml_node(grid_s *g, grid_cell_to_xml_node func)
   sprintf(sn, "%d", grid_size_get_height(grid_get_size(g)));
   xmlNewProp(size_node, BAD_CAST "height", BAD_CAST sn);
 
-  rows_node = xmlNewChild(node, NULL, BAD_CAST "rows", NULL);
+  ex.rows_node = xmlNewChild(node, NULL, BAD_CAST "rows", NULL);
+  ex.cols_node = NULL;
+  ex.func = func;
 
-  for (y = 0; y < grid_size_get_height(grid_get_size(g)); y++)
-  {
-    row_node = xmlNewChild(rows_node, NULL, BAD_CAST "row", NULL);
+  grid_foreach_row(g, _grid_xml_export_span, &ex);
 
-    cols_node = xmlNewChild(row_node, NULL, BAD_CAST "columns", NULL);
+    // Return "xmlNodePtr"
+  return node;
+}
 
-    for (x = 0; x < grid_size_get_width(grid_get_size(g)); x++)
-    {
-      cell_node = xmlNewChild(cols_node, NULL, (const xmlChar*)"cell", NULL);
-      grid_goto(g, y, x);
-      xmlAddChild(cell_node, func(grid_get_cell(g)));
-    }
+  /*!
+
+     @brief Stream grid data to a file as XML
+
+     Writes the grid to a file as an XML document, using the same vocabulary
+     as grid_to_xml_doc(), without building a document tree in memory.  The
+     grid is walked once in row order and the output is produced as it goes,
+     so memory use does not depend on the size of the grid.  The user
+     function writes the content of each "cell" element, including those of
+     empty cells, and returns a negative value on failure.
+
+     Given a thread pool, bands of rows are rendered into separate buffers
+     on the pool, a window of bands at a time, and written out in order.
+     The output is identical to that of a serial export, but the user
+     function is then called from several threads at once.
+
+     NOTE:  The grid must not be changed while it is written.
+
+     @param g    pointer to grid data structure
+     @param file    pointer to open output file
+     @param func    pointer to user cell writer function
+     @param pool    pointer to existing thread pool, or NULL
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+int grid_write_xml(grid_s *g, FILE *file, grid_cell_to_xml_writer func,
+                   thread_pool_s *pool)
+{
+  xmlOutputBufferPtr out;
+  _grid_xml_stream st;
+  int width, height;
+  int rc = 0;
+
+    // Sanity check parameters.
+  assert(g);
+  assert(file);
+  assert(func);
+
+  out = xmlOutputBufferCreateFile(file, NULL);
+  if (!out) return -1;
+
+  st.writer = xmlNewTextWriter(out);
+  if (!st.writer)
+  {
+    xmlOutputBufferClose(out);
+    return -1;
+  }
+  st.row_open = 0;
+  st.func = func;
+
+  width = grid_size_get_width(grid_get_size(g));
+  height = grid_size_get_height(grid_get_size(g));
+
+  xmlTextWriterSetIndent(st.writer, 1);
+  xmlTextWriterSetIndentString(st.writer, BAD_CAST XML_INDENT);
+
+  if (xmlTextWriterStartDocument(st.writer, NULL, "UTF-8", NULL) < 0 ||
+      xmlTextWriterStartElement(st.writer, BAD_CAST "grid") < 0 ||
+      xmlTextWriterStartElement(st.writer, BAD_CAST "size") < 0 ||
+      xmlTextWriterWriteFormatAttribute(st.writer, BAD_CAST "width", "%d",
+                                        width) < 0 ||
+      xmlTextWriterWriteFormatAttribute(st.writer, BAD_CAST "height", "%d",
+                                        height) < 0 ||
+      xmlTextWriterEndElement(st.writer) < 0 ||
+      xmlTextWriterStartElement(st.writer, BAD_CAST "rows") < 0)
+    rc = -1;
+
+  if (!rc)
+  {
+    if (pool && width > 0 && height > 0)
+      rc = _grid_xml_stream_bands(&st, g, pool);
+    else if (grid_foreach_row(g, _grid_xml_stream_span, &st) ||
+             _grid_xml_stream_end_row(&st) < 0)
+      rc = -1;
   }
 
-    // Return "xmlNodePtr"
-  return node;
+  if (!rc && xmlTextWriterEndDocument(st.writer) < 0) rc = -1;
+
+    // Freeing the writer flushes and releases the output buffer
+  xmlFreeTextWriter(st.writer);
+
+    // Return "int"
+  return rc;
 }
 
   /*!
@@ -230,8 +384,10 @@ grid_s *grid_from_xml_node(xmlNodePtr node, grid_cell_from_xml_node func)
 
   s = (char *)xmlGetProp(size_node, BAD_CAST "width");
   if (s) col = atoi(s);
+  xmlFree(s);
   s = (char *)xmlGetProp(size_node, BAD_CAST "height");
   if (s) row = atoi(s);
+  xmlFree(s);
 
   gs = grid_size_create();
   if (!gs)
@@ -239,9 +395,10 @@ grid_s *grid_from_xml_node(xmlNodePtr node, grid_cell_from_xml_node func)
     grid_destroy(g);
     return NULL;
   }
-  grid_size_set(gs, row, col);
+  grid_size_set(gs, col, row);
 
   grid_set_size(g, gs);
+  grid_size_destroy(gs);
 
   if (!size_node->next || !size_node->next->next) return g;
 
@@ -277,3 +434,546 @@ grid_s *grid_from_xml_node(xmlNodePtr node, grid_cell_from_xml_node func)
   return g;
 }
 
+  /*!
+
+     @brief Stream XML grid data from a file into a grid data structure
+
+     Reads an XML document containing grid data, as written by
+     grid_write_xml(), through an xmlTextReader without building a document
+     tree.  The grid is sized once from the "size" element and then filled
+     in row order, so import takes time linear in the size of the document
+     and no memory beyond the grid itself.  The user function is called with
+     the reader positioned on each "cell" element and returns the payload
+     for that cell; it must not move the reader, but may expand the cell
+     with xmlTextReaderExpand().  Cells beyond the declared size of the grid
+     are skipped.
+
+     @param file    pointer to open input file
+     @param func    pointer to user cell reader function
+
+     @retval "grid_s *" success
+     @retval NULL    failure
+
+  */
+
+grid_s *grid_read_xml(FILE *file, grid_cell_from_xml_reader func)
+{
+  xmlTextReaderPtr reader;
+  grid_s *g;
+
+    // Sanity check parameters.
+  assert(file);
+  assert(func);
+
+  reader = xmlReaderForIO(_grid_xml_read_file, NULL, file, NULL, NULL, 0);
+  if (!reader) return NULL;
+
+  g = _grid_xml_read_size(reader);
+  if (g && _grid_xml_read_rows(reader, g, func))
+  {
+    grid_destroy(g);
+    g = NULL;
+  }
+
+  xmlFreeTextReader(reader);
+
+    // Return "grid_s *"
+  return g;
+}
+
+// STATIC functions
+
+  /*!
+
+     @brief INTERNAL:  Convert a span of grid cells to XML nodes
+
+     Starts a new "row" node at the first column of each row.
+
+     @param payloads    pointer to payload data of span
+     @param row    row of span
+     @param col    first column of span
+     @param count    number of cells in span
+     @param data    pointer to XML export details
+
+     @retval 0    success
+
+  */
+
+static int _grid_xml_export_span(void * const *payloads, int row, int col,
+                                 int count, void *data)
+{
+  _grid_xml_export *ex;
+  xmlNodePtr row_node;
+  xmlNodePtr cell_node;
+  int i;
+
+    // Sanity check parameters.
+  assert(payloads);
+  assert(data);
+
+  (void)row;
+
+  ex = (_grid_xml_export *)data;
+
+  if (!col)
+  {
+    row_node = xmlNewChild(ex->rows_node, NULL, BAD_CAST "row", NULL);
+    ex->cols_node = xmlNewChild(row_node, NULL, BAD_CAST "columns", NULL);
+  }
+
+  for (i = 0; i < count; ++i)
+  {
+    cell_node = xmlNewChild(ex->cols_node, NULL, (const xmlChar*)"cell", NULL);
+    xmlAddChild(cell_node, ex->func(payloads[i]));
+  }
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Stream a span of grid cells to an XML writer
+
+     Closes the previous "row" element and starts a new one at the first
+     column of each row.
+
+     @param payloads    pointer to payload data of span
+     @param row    row of span
+     @param col    first column of span
+     @param count    number of cells in span
+     @param data    pointer to XML streaming export details
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_xml_stream_span(void * const *payloads, int row, int col,
+                                 int count, void *data)
+{
+  _grid_xml_stream *st;
+  int i;
+
+    // Sanity check parameters.
+  assert(payloads);
+  assert(data);
+
+  (void)row;
+
+  st = (_grid_xml_stream *)data;
+
+  if (!col)
+  {
+    if (_grid_xml_stream_end_row(st) < 0 ||
+        xmlTextWriterStartElement(st->writer, BAD_CAST "row") < 0 ||
+        xmlTextWriterStartElement(st->writer, BAD_CAST "columns") < 0)
+      return -1;
+    st->row_open = 1;
+  }
+
+  for (i = 0; i < count; ++i)
+  {
+    if (xmlTextWriterStartElement(st->writer, BAD_CAST "cell") < 0 ||
+        st->func(st->writer, payloads[i]) < 0 ||
+        xmlTextWriterEndElement(st->writer) < 0)
+      return -1;
+  }
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Close the open "row" element of a streaming export
+
+     @param st    pointer to XML streaming export details
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_xml_stream_end_row(_grid_xml_stream *st)
+{
+    // Sanity check parameters.
+  assert(st);
+
+  if (!st->row_open) return 0;
+
+  st->row_open = 0;
+
+  if (xmlTextWriterEndElement(st->writer) < 0 ||
+      xmlTextWriterEndElement(st->writer) < 0)
+    return -1;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Read input for an XML text reader from a file
+
+     @param context    pointer to open input file
+     @param buffer    pointer to buffer to fill
+     @param len    size of buffer
+
+     @retval "int" number of bytes read, 0 at end of file
+     @retval -1    failure
+
+  */
+
+static int _grid_xml_read_file(void *context, char *buffer, int len)
+{
+  FILE *file;
+  size_t n;
+
+    // Sanity check parameters.
+  assert(context);
+  assert(buffer);
+
+  file = (FILE *)context;
+
+  n = fread(buffer, 1, (size_t)len, file);
+  if (!n && ferror(file)) return -1;
+
+    // Return "int"
+  return (int)n;
+}
+
+  /*!
+
+     @brief INTERNAL:  Advance an XML text reader to the next element
+
+     @param reader    pointer to XML text reader
+
+     @retval 0    success
+     @retval -1    failure, or end of document
+
+  */
+
+static int _grid_xml_read_element(xmlTextReaderPtr reader)
+{
+    // Sanity check parameters.
+  assert(reader);
+
+  do
+  {
+    if (xmlTextReaderRead(reader) != 1) return -1;
+  } while (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT);
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Read the "grid" and "size" elements of a stream
+
+     Creates a grid with the size declared by the first element within the
+     "grid" root element, which must be "size".
+
+     @param reader    pointer to XML text reader at start of document
+
+     @retval "grid_s *" success
+     @retval NULL    failure
+
+  */
+
+static grid_s *_grid_xml_read_size(xmlTextReaderPtr reader)
+{
+  grid_s *g;
+  grid_size_s *gs;
+  xmlChar *s;
+  int width = 1, height = 1;
+
+    // Sanity check parameters.
+  assert(reader);
+
+  if (_grid_xml_read_element(reader) ||
+      strcmp((char *)xmlTextReaderConstName(reader), "grid"))
+    return NULL;
+
+  if (_grid_xml_read_element(reader) ||
+      strcmp((char *)xmlTextReaderConstName(reader), "size"))
+    return NULL;
+
+  s = xmlTextReaderGetAttribute(reader, BAD_CAST "width");
+  if (s) width = atoi((char *)s);
+  xmlFree(s);
+  s = xmlTextReaderGetAttribute(reader, BAD_CAST "height");
+  if (s) height = atoi((char *)s);
+  xmlFree(s);
+
+  g = grid_create();
+  if (!g) return NULL;
+
+  gs = grid_size_create();
+  if (!gs)
+  {
+    grid_destroy(g);
+    return NULL;
+  }
+  grid_size_set(gs, width, height);
+
+  grid_set_size(g, gs);
+  grid_size_destroy(gs);
+
+    // Return "grid_s *"
+  return g;
+}
+
+  /*!
+
+     @brief INTERNAL:  Read the "row" and "cell" elements of a stream
+
+     Fills the grid in row order, moving the current cell one step to the
+     right per cell instead of seeking to every cell from scratch.
+
+     @param reader    pointer to XML text reader positioned on "size"
+     @param g    pointer to grid sized from the stream
+     @param func    pointer to user cell reader function
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_xml_read_rows(xmlTextReaderPtr reader, grid_s *g,
+                               grid_cell_from_xml_reader func)
+{
+  const char *name;
+  int width, height;
+  int row = -1, col = 0;
+  int rc;
+
+    // Sanity check parameters.
+  assert(reader);
+  assert(g);
+  assert(func);
+
+  width = grid_size_get_width(grid_get_size(g));
+  height = grid_size_get_height(grid_get_size(g));
+
+  rc = xmlTextReaderNext(reader);
+
+  while (rc == 1)
+  {
+    if (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT)
+    {
+      rc = xmlTextReaderRead(reader);
+      continue;
+    }
+
+    name = (const char *)xmlTextReaderConstName(reader);
+
+    if (!strcmp(name, "row"))
+    {
+      ++row;
+      col = 0;
+    }
+    else if (!strcmp(name, "cell") && row >= 0)
+    {
+      if (row < height && col < width)
+      {
+        if (col)
+          grid_right(g);
+        else
+          grid_goto(g, row, 0);
+        grid_set_cell(g, func(reader));
+      }
+      ++col;
+
+        // Skip the content of the cell, whatever the user function read
+      rc = xmlTextReaderNext(reader);
+      continue;
+    }
+
+    rc = xmlTextReaderRead(reader);
+  }
+
+  grid_origin(g);
+
+    // Return "int"
+  return rc ? -1 : 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Stream the rows of a grid to an XML writer in parallel
+
+     Renders windows of bands of rows on a thread pool, and copies the
+     output of each band to the writer in order.  The writer must have just
+     started the "rows" element, which is left open, indented for closing.
+
+     @param st    pointer to XML streaming export details
+     @param g    pointer to grid data structure, with at least one cell
+     @param pool    pointer to existing thread pool
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_xml_stream_bands(_grid_xml_stream *st, grid_s *g,
+                                  thread_pool_s *pool)
+{
+  _grid_xml_bands ex;
+  _grid_xml_band *band;
+  int width, height;
+  int nbands, n, b;
+  int rc = 0;
+
+    // Sanity check parameters.
+  assert(st);
+  assert(g);
+  assert(pool);
+
+  width = grid_size_get_width(grid_get_size(g));
+  height = grid_size_get_height(grid_get_size(g));
+
+  ex.g = g;
+  ex.func = st->func;
+  ex.rows = BAND_CELLS / width;
+  if (ex.rows < 1) ex.rows = 1;
+
+    // libxml2 must be initialized before it is used from several threads
+  xmlInitParser();
+
+    // A few bands per thread, while only a window of output is held
+  nbands = 4 * (thread_pool_get_size(pool) + 1);
+
+  ex.bands = (_grid_xml_band *)calloc((size_t)nbands, sizeof(_grid_xml_band));
+  if (!ex.bands) return -1;
+
+    // Bands start with the first "row" element, after the "rows" start tag
+  if (xmlTextWriterWriteRaw(st->writer, BAD_CAST "\n") < 0) rc = -1;
+
+  for (ex.start = 0; ex.start < height && !rc; ex.start += nbands * ex.rows)
+  {
+    n = (height - ex.start + ex.rows - 1) / ex.rows;
+    if (n > nbands) n = nbands;
+
+    thread_pool_run(pool, n, _grid_xml_stream_band, &ex);
+
+    for (b = 0; b < n; ++b)
+    {
+      band = &ex.bands[b];
+
+      if (!rc &&
+          (band->failed ||
+           xmlTextWriterWriteRawLen(st->writer,
+                                    xmlBufferContent(band->buf) + band->offset,
+                                    xmlBufferLength(band->buf) -
+                                      band->offset) < 0))
+        rc = -1;
+
+      if (band->buf) xmlBufferFree(band->buf);
+      memset(band, 0, sizeof(_grid_xml_band));
+    }
+  }
+
+  free(ex.bands);
+
+  if (!rc && xmlTextWriterWriteRaw(st->writer, BAD_CAST XML_INDENT) < 0)
+    rc = -1;
+
+    // Return "int"
+  return rc;
+}
+
+  /*!
+
+     @brief INTERNAL:  Render one band of rows of a grid as XML
+
+     Thread pool job function.  The band is written inside "grid" and "rows"
+     elements of its own, so that it is indented as in a serial export, and
+     its output is kept from the first "row" element on.
+
+     @param index    index of band in current window
+     @param data    pointer to parallel XML export details
+
+     @retval NONE
+
+  */
+
+static void _grid_xml_stream_band(int index, void *data)
+{
+  _grid_xml_bands *ex;
+  _grid_xml_band *band;
+  _grid_xml_stream st;
+  grid_cursor_s *gc;
+  void *pl;
+  int width, height;
+  int y, x;
+  int rc = 0;
+
+    // Sanity check parameters.
+  assert(data);
+
+  ex = (_grid_xml_bands *)data;
+  band = &ex->bands[index];
+
+  band->failed = 1;
+
+  band->buf = xmlBufferCreate();
+  if (!band->buf) return;
+
+  st.writer = xmlNewTextWriterMemory(band->buf, 0);
+  if (!st.writer) return;
+  st.func = ex->func;
+
+  gc = grid_cursor_create(ex->g);
+  if (!gc)
+  {
+    xmlFreeTextWriter(st.writer);
+    return;
+  }
+
+  xmlTextWriterSetIndent(st.writer, 1);
+  xmlTextWriterSetIndentString(st.writer, BAD_CAST XML_INDENT);
+
+  width = grid_size_get_width(grid_get_size(ex->g));
+  height = ex->start + (index + 1) * ex->rows;
+  if (height > grid_size_get_height(grid_get_size(ex->g)))
+    height = grid_size_get_height(grid_get_size(ex->g));
+
+  if (xmlTextWriterStartElement(st.writer, BAD_CAST "grid") < 0 ||
+      xmlTextWriterStartElement(st.writer, BAD_CAST "rows") < 0 ||
+      xmlTextWriterFlush(st.writer) < 0)
+    rc = -1;
+
+    // The "rows" start tag is closed by ">" and a new line
+  band->offset = xmlBufferLength(band->buf) + 2;
+
+  for (y = ex->start + index * ex->rows; y < height && !rc; ++y)
+  {
+    if (xmlTextWriterStartElement(st.writer, BAD_CAST "row") < 0 ||
+        xmlTextWriterStartElement(st.writer, BAD_CAST "columns") < 0)
+      rc = -1;
+
+    for (x = 0; x < width && !rc; ++x)
+    {
+      pl = (x) ? grid_cursor_right(gc) : grid_cursor_goto(gc, y, 0);
+
+      if (xmlTextWriterStartElement(st.writer, BAD_CAST "cell") < 0 ||
+          st.func(st.writer, pl) < 0 ||
+          xmlTextWriterEndElement(st.writer) < 0)
+        rc = -1;
+    }
+
+    if (!rc &&
+        (xmlTextWriterEndElement(st.writer) < 0 ||
+         xmlTextWriterEndElement(st.writer) < 0))
+      rc = -1;
+  }
+
+  if (!rc && xmlTextWriterFlush(st.writer) < 0) rc = -1;
+
+  grid_cursor_destroy(gc);
+  xmlFreeTextWriter(st.writer);
+
+  if (!rc && xmlBufferLength(band->buf) >= band->offset) band->failed = 0;
+}
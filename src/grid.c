@@ -47,14 +47,24 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <limits.h>
+#include <pthread.h>
 #include <assert.h>
 
   // Project related headers
 
 #include "grid.h"
 
+  // Common constants
+
+#define MESH_SLAB_CELLS 256
+#define TILE_SIZE 64
+#define SPAN_CELLS 256
+
   /*!
-    @brief INTERNAL: cell data structure
+    @brief INTERNAL: cell data structure (mesh storage)
   */
 
 typedef struct _cell
@@ -72,44 +82,874 @@ typedef struct _cell
 } _cell;
 
   /*!
-    @brief INTERNAL: grid details structure
+    @brief INTERNAL: block of contiguous cells (mesh storage)
+  */
+
+typedef struct _cell_slab
+{
+    /*! @brief Pointer to next slab allocated for grid */
+  struct _cell_slab *next;
+    /*! @brief Number of cells in slab */
+  int count;
+    /*! @brief Number of cells handed out from slab */
+  int used;
+    /*! @brief Cells */
+  _cell cells[];
+} _cell_slab;
+
+  /*!
+    @brief INTERNAL: mesh storage details structure
   */
 
 typedef struct
 {
-    /*! @brief: pointer to first cell in grid (upper-left) */
-  _cell *origin;
-    /*! @brief: pointer to current cell in grid */
-  _cell *current;
+    /*! @brief: table of first cell in each row */
+  _cell **rows;
+    /*! @brief: table of first cell in each column */
+  _cell **cols;
+    /*! @brief: number of entries allocated in row table */
+  int rcap;
+    /*! @brief: number of entries allocated in column table */
+  int ccap;
     /*! @brief: pointer to last cell in grid (lower-right) */
   _cell *end;
+    /*! @brief: list of cell slabs, most recent first */
+  _cell_slab *slabs;
+    /*! @brief: list of recycled cells, linked through right pointer */
+  _cell *spare;
+    /*! @brief: number of recycled cells */
+  int nspare;
+    /*! @brief: pointer to most recently located cell, if any */
+  _cell *finger;
+    /*! @brief: row of most recently located cell */
+  int frow;
+    /*! @brief: column of most recently located cell */
+  int fcol;
+} _mesh_store;
+
+  /*!
+    @brief INTERNAL: dense storage details structure
+  */
+
+typedef struct
+{
+    /*! @brief: row-major array of payload pointers */
+  void **cells;
+    /*! @brief: number of payload pointers allocated per row */
+  int stride;
+    /*! @brief: number of rows allocated */
+  int capacity;
+} _dense_store;
+
+  /*!
+    @brief INTERNAL: row or column id table
+
+    Keys cells by stable row and column ids rather than by position, so that
+    inserting or removing a row or column only shifts this table.
+  */
+
+typedef struct
+{
+    /*! @brief: id of each row or column, by position */
+  int *ids;
+    /*! @brief: position of each id, or -1 for an unused id */
+  int *pos;
+    /*! @brief: ids available for re-use */
+  int *spare;
+    /*! @brief: number of ids available for re-use */
+  int nspare;
+    /*! @brief: next never used id */
+  int next;
+    /*! @brief: number of entries allocated in ids, pos and spare */
+  int cap;
+} _grid_axis;
+
+  /*!
+    @brief INTERNAL: reference index entry
+  */
+
+typedef struct
+{
+    /*! @brief: payload data, NULL for an unused entry */
+  void *pl;
+    /*! @brief: row id of a cell holding payload, or -1 if unknown */
+  int row;
+    /*! @brief: column id of a cell holding payload */
+  int col;
+    /*! @brief: number of cells holding payload */
+  int count;
+} _grid_index_entry;
+
+  /*!
+    @brief INTERNAL: reference index details structure
+
+    Maps payload data to the cell holding it.  A payload held by more than
+    one cell is counted, but its first cell is found by scanning the grid.
+  */
+
+typedef struct
+{
+    /*! @brief: open addressing (linear probing) table of payloads */
+  _grid_index_entry *slots;
+    /*! @brief: number of slots, zero or a power of two */
+  int capacity;
+    /*! @brief: number of payloads */
+  int count;
+    /*! @brief: row id table */
+  _grid_axis rows;
+    /*! @brief: column id table */
+  _grid_axis cols;
+} _grid_index;
+
+  /*!
+    @brief INTERNAL: sparse table entry
+  */
+
+typedef struct
+{
+    /*! @brief: row id of cell */
+  int row;
+    /*! @brief: column id of cell */
+  int col;
+    /*! @brief: pointer to payload data, NULL for an unused entry */
+  void *payload;
+} _sparse_entry;
+
+  /*!
+    @brief INTERNAL: sparse storage details structure
+  */
+
+typedef struct
+{
+    /*! @brief: open addressing (linear probing) table of non-empty cells */
+  _sparse_entry *slots;
+    /*! @brief: number of slots, zero or a power of two */
+  int capacity;
+    /*! @brief: number of non-empty cells */
+  int count;
+    /*! @brief: row id table */
+  _grid_axis rows;
+    /*! @brief: column id table */
+  _grid_axis cols;
+} _sparse_store;
+
+  /*!
+    @brief INTERNAL: tile of payload pointers, row-major
+  */
+
+typedef struct
+{
+    /*! @brief: number of other stores sharing tile, zero when private */
+  atomic_int refs;
+    /*! @brief: TILE_SIZE rows of TILE_SIZE payload pointers */
+  void *cells[TILE_SIZE * TILE_SIZE];
+} _tile;
+
+  /*!
+    @brief INTERNAL: band of tiles, holding up to TILE_SIZE whole rows
+  */
+
+typedef struct
+{
+    /*! @brief: number of rows in use */
+  int rows;
+    /*! @brief: tiles of band, left to right */
+  _tile **tiles;
+} _tile_band;
+
+  /*!
+    @brief INTERNAL: tiled storage details structure
+
+    Rows are grouped into bands of tiles, so that inserting or removing rows
+    only shifts rows within one band.  Bands may hold fewer than TILE_SIZE
+    rows; columns always map directly onto tiles.
+
+    A store may be shared with grid snapshots.  A grid copies a shared store,
+    sharing the tiles, before changing it, and copies a shared tile before
+    changing its cells.
+  */
+
+typedef struct
+{
+    /*! @brief: number of other grids sharing store, zero when private */
+  atomic_int refs;
+    /*! @brief: bands of tiles, top to bottom */
+  _tile_band *bands;
+    /*! @brief: first row of each band */
+  int *first;
+    /*! @brief: number of bands in use */
+  int nbands;
+    /*! @brief: number of bands allocated */
+  int bcap;
+    /*! @brief: number of tiles in use per band */
+  int ntiles;
+    /*! @brief: number of tile pointers allocated per band */
+  int tcap;
+} _tiled_store;
+
+  /*!
+    @brief INTERNAL: mapped storage details structure
+
+    Payload data is located, relative to a base address, through a row-major
+    table of offsets, zero for an empty cell.  The payload data of a cell is
+    preceded by its size.
+  */
+
+typedef struct
+{
+    /*! @brief: payload offset of each cell, row-major */
+  const uint64_t *offsets;
+    /*! @brief: address offsets are relative to */
+  const char *base;
+    /*! @brief: payload data beyond limit makes a cell empty */
+  uint64_t limit;
+    /*! @brief: user release function, or NULL */
+  grid_mapped_release func;
+    /*! @brief: user data for release function */
+  void *data;
+} _mapped_store;
+
+  /*!
+    @brief INTERNAL: payload data retired while snapshots may refer to it
+  */
+
+typedef struct
+{
+    /*! @brief: payload data */
+  void *pl;
+    /*! @brief: payload destructor */
+  grid_payload_free fpl;
+    /*! @brief: newest snapshot epoch when retired */
+  unsigned int epoch;
+} _grid_retired;
+
+  /*!
+    @brief INTERNAL: snapshot tracking structure, shared by a grid and its
+           snapshots
+
+    Each snapshot has an epoch, newer snapshots having greater epochs.  Once
+    a grid has snapshots, payload data it would de-allocate is retired
+    instead, and only de-allocated once every snapshot older than the
+    payload's retirement has been destroyed.
+  */
+
+typedef struct
+{
+    /*! @brief: lock for all following members */
+  pthread_mutex_t lock;
+    /*! @brief: number of grids, including snapshots, sharing structure */
+  int refs;
+    /*! @brief: epoch of newest snapshot */
+  unsigned int epoch;
+    /*! @brief: epochs of live snapshots, oldest first */
+  unsigned int *live;
+    /*! @brief: number of live snapshots */
+  int nlive;
+    /*! @brief: capacity of live */
+  int lcap;
+    /*! @brief: retired payload data, oldest first */
+  _grid_retired *retired;
+    /*! @brief: number of retired payloads */
+  int nretired;
+    /*! @brief: capacity of retired */
+  int rcap;
+} _grid_snapshots;
+
+struct _grid_storage;
+
+  /*!
+    @brief INTERNAL: grid details structure
+  */
+
+typedef struct
+{
+    /*! @brief: storage engine operations */
+  const struct _grid_storage *storage;
+    /*! @brief: storage engine private data */
+  void *store;
+    /*! @brief: row of current cell */
+  int row;
+    /*! @brief: column of current cell */
+  int col;
     /*! @brief current size of grid */
   grid_size_s *size;
     /*! @brief x,y coordinates of current cell */
   vertex_s *location;
     /*! @brief user supplied payload de-allocation function pointer */
   grid_payload_free grid_pl_free;
+    /*! @brief: count of changes to rows and columns */
+  unsigned int generation;
+    /*! @brief: reference index, or NULL if not enabled */
+  _grid_index *index;
+    /*! @brief: snapshot tracking, or NULL if no snapshot was ever taken */
+  _grid_snapshots *snapshots;
+    /*! @brief: epoch of a snapshot, zero for a grid that may be changed */
+  unsigned int epoch;
+    /*! @brief: reclaimer for de-allocated payload data, or NULL if none */
+  reclaim_s *reclaim;
+    /*! @brief: user change function, or NULL if none */
+  grid_change_notify notify;
+    /*! @brief: user data for change function */
+  void *notify_data;
 } _grid_internals;
 
+  /*!
+    @brief INTERNAL: caller held position within storage
+
+    Lets a storage engine resume a walk from a previously located cell,
+    without recording anything in the grid itself.  The hint is only valid
+    while the grid generation is unchanged.
+  */
+
+typedef struct
+{
+    /*! @brief: row of position */
+  int row;
+    /*! @brief: column of position */
+  int col;
+    /*! @brief: engine specific hint for position, or NULL */
+  void *hint;
+    /*! @brief: grid generation hint belongs to */
+  unsigned int generation;
+} _grid_position;
+
+  /*!
+    @brief INTERNAL: view storage details structure
+
+    A view keeps no cells of its own, only the window of the grid it shows.
+  */
+
+typedef struct
+{
+    /*! @brief: grid shown by view */
+  grid_s *grid;
+    /*! @brief: first row of window */
+  int row;
+    /*! @brief: first column of window */
+  int col;
+    /*! @brief: non-zero when rows and columns of window are exchanged */
+  int transpose;
+    /*! @brief: position of most recently got cell */
+  _grid_position pos;
+} _view_store;
+
+  /*!
+    @brief INTERNAL: grid cursor details structure
+  */
+
+typedef struct
+{
+    /*! @brief: grid traversed by cursor */
+  grid_s *grid;
+    /*! @brief: position of cursor */
+  _grid_position pos;
+} _grid_cursor_internals;
+
+  /*!
+    @brief INTERNAL: storage engine operations structure
+
+    Every storage engine reads the grid dimensions, as they are before the
+    operation, from the grid internals size structure.  The generic grid
+    functions validate all coordinates, and update the size and the cursor
+    after the engine operation completes.  The seek and span operations must
+    not modify the storage, so that any number of readers may share a grid.
+    Before any operation changing a grid whose storage is shared with a
+    snapshot, the own operation is given the range of cells to be changed.
+  */
+
+typedef struct _grid_storage
+{
+    /*! @brief storage engine type */
+  grid_storage_t type;
+    /*! @brief allocate engine private data */
+  int (*init)(_grid_internals *gin);
+    /*! @brief de-allocate all cells, and engine private data */
+  void (*release)(_grid_internals *gin, grid_payload_free fpl);
+    /*! @brief get payload data of cell */
+  void *(*get)(_grid_internals *gin, int row, int col);
+    /*! @brief set payload data of cell */
+  void (*set)(_grid_internals *gin, int row, int col, void *pl);
+    /*! @brief change number of rows and columns, truncating or extending */
+  int (*resize)(_grid_internals *gin, int rows, int cols,
+                grid_payload_free fpl);
+    /*! @brief insert empty rows before row, returns rows inserted */
+  int (*insert_rows)(_grid_internals *gin, int row, int count);
+    /*! @brief insert empty columns before column, returns columns inserted */
+  int (*insert_columns)(_grid_internals *gin, int col, int count);
+    /*! @brief remove rows starting at row */
+  void (*remove_rows)(_grid_internals *gin, int row, int count,
+                      grid_payload_free fpl);
+    /*! @brief remove columns starting at column */
+  void (*remove_columns)(_grid_internals *gin, int col, int count,
+                         grid_payload_free fpl);
+    /*! @brief reorder rows, so that row i holds the cells of row perm[i] */
+  int (*permute_rows)(_grid_internals *gin, const int *perm);
+    /*! @brief get payload data of cell from position, or NULL to use get */
+  void *(*seek)(_grid_internals *gin, _grid_position *pos, int row, int col);
+    /*! @brief get payloads of row from column, in place or copied to buf */
+  void **(*span)(_grid_internals *gin, _grid_position *pos, int row, int col,
+                 int *count, void **buf, int size);
+    /*! @brief share storage with a snapshot, or NULL to copy cells instead */
+  int (*share)(_grid_internals *gin, _grid_internals *snap);
+    /*! @brief make range private before changing it, or NULL if never shared */
+  int (*own)(_grid_internals *gin, int row, int col, int rows, int cols);
+} _grid_storage;
+
+  /*!
+    @brief INTERNAL: cell search details structure
+  */
+
+typedef struct
+{
+    /*! @brief: payload data, or value, to find */
+  void *pl;
+    /*! @brief: compare function, or NULL to find by reference */
+  grid_payload_compare cf;
+    /*! @brief: payload data of found cell */
+  void *found;
+    /*! @brief: row of found cell */
+  int row;
+    /*! @brief: column of found cell */
+  int col;
+} _grid_search;
+
+  /*!
+    @brief INTERNAL: cell iteration details structure
+  */
+
+typedef struct
+{
+    /*! @brief: user iteration function */
+  grid_cell_visit func;
+    /*! @brief: user data for iteration function */
+  void *data;
+} _grid_visit;
+
+  /*!
+    @brief INTERNAL: parallel search results for a band of rows
+  */
+
+typedef struct
+{
+    /*! @brief: payload data of first found cell */
+  void *found;
+    /*! @brief: row, column pairs of found cells */
+  int *cells;
+    /*! @brief: number of found cells */
+  int count;
+    /*! @brief: capacity of cells, in pairs */
+  int cap;
+    /*! @brief: non-zero when out of memory */
+  int failed;
+} _grid_band;
+
+  /*!
+    @brief INTERNAL: parallel search details structure
+  */
+
+typedef struct
+{
+    /*! @brief: grid internals */
+  _grid_internals *gin;
+    /*! @brief: value to find */
+  void *pl;
+    /*! @brief: compare function */
+  grid_payload_compare cf;
+    /*! @brief: non-zero to find every matching cell */
+  int all;
+    /*! @brief: number of rows in each band */
+  int rows;
+    /*! @brief: number of bands */
+  int nbands;
+    /*! @brief: lowest band holding a match, when finding first match */
+  atomic_int first;
+    /*! @brief: results of each band */
+  _grid_band *bands;
+} _grid_find;
+
+  /*!
+    @brief INTERNAL: row sort details structure
+  */
+
+typedef struct
+{
+    /*! @brief: grid internals */
+  _grid_internals *gin;
+    /*! @brief: key columns, most significant first */
+  const int *keys;
+    /*! @brief: number of key columns */
+  int nkeys;
+    /*! @brief: compare function */
+  grid_payload_compare cf;
+    /*! @brief: payload data of key columns, nkeys per row */
+  void **kv;
+    /*! @brief: rows in sorted order */
+  int *perm;
+    /*! @brief: scratch space for merging, one entry per row */
+  int *tmp;
+    /*! @brief: number of rows */
+  int rows;
+    /*! @brief: number of runs sorted at once */
+  int nruns;
+    /*! @brief: number of runs already merged into each run of a round */
+  int width;
+} _grid_sort;
+
   // INTERNAL: utility function prototypes for module
-static _cell *_cell_new(void *pl);
-static void _cell_free(_cell *c, grid_payload_free fpl);
 
 static grid_payload_free _grid_get_pl_free(grid_s *gs);
 static _grid_internals *_grid_get_internals(grid_s *gs);
-static void *_grid_get_payload(_cell *c);
-static _cell *_grid_find_by_reference(grid_s *gs, void *pl);
-static _cell *_grid_find_by_value(grid_s *gs,
-                                  void *pl,
-                                  grid_payload_compare cf);
-static _cell *_grid_get_cell(grid_s *grid);
+static const _grid_storage *_grid_get_storage(grid_storage_t storage);
+static int _grid_is_empty(_grid_internals *gin);
+static int _grid_is_read_only(_grid_internals *gin);
+static void _grid_set_cursor(_grid_internals *gin, int row, int col);
+static int _grid_resize(grid_s *grid, int rows, int cols,
+                        grid_payload_free fpl);
+static void _grid_insert_rows(grid_s *grid, int row, int count);
+static void _grid_insert_columns(grid_s *grid, int col, int count);
+static void _grid_remove_rows(grid_s *grid, int row, int count,
+                              grid_payload_free fpl);
+static void _grid_remove_columns(grid_s *grid, int col, int count,
+                                 grid_payload_free fpl);
+static void *_grid_find_by_reference(grid_s *gs, void *pl,
+                                     int *row, int *col);
+static void *_grid_find_by_value(grid_s *gs,
+                                 void *pl,
+                                 grid_payload_compare cf,
+                                 int *row, int *col);
+static int _grid_foreach_span(_grid_internals *gin,
+                              grid_span_visit func,
+                              void *data);
+static void *_grid_seek(_grid_internals *gin, _grid_position *pos,
+                        int row, int col);
+static _grid_cursor_internals *_grid_cursor_get_internals(grid_cursor_s *gc);
+static int _grid_store(_grid_internals *gin, int row, int col, void *pl);
+static int _grid_own(_grid_internals *gin, int row, int col, int rows, int cols);
+static int _grid_permute_rows(_grid_internals *gin, const int *perm);
+static void _grid_notify(_grid_internals *gin, grid_change_t change,
+                         int row, int col, int count);
+static void _grid_release(_grid_internals *gin, grid_payload_free fpl);
+
+  // INTERNAL: row and column id table prototypes
+static int _grid_axis_insert(_grid_axis *axis, int at, int count, int len);
+static void _grid_axis_remove(_grid_axis *axis, int at, int count, int len);
+static void _grid_axis_free(_grid_axis *axis);
+static int _grid_axis_permute(_grid_axis *axis, const int *perm, int len);
+
+  // INTERNAL: snapshot prototypes
+static int _grid_snapshot_copy(_grid_internals *gin, _grid_internals *sin);
+static int _grid_snapshots_join(_grid_internals *gin, _grid_internals *sin);
+static void _grid_snapshots_leave(_grid_internals *gin);
+static void _grid_retired_add(_grid_snapshots *gs, void *pl,
+                              grid_payload_free fpl);
+static void _grid_retire(_grid_internals *gin, void *pl, grid_payload_free fpl);
+static void _grid_retire_range(_grid_internals *gin, int row, int col,
+                               int rows, int cols, grid_payload_free fpl);
+
+  // INTERNAL: reference index prototypes
+static int _grid_index_create(_grid_internals *gin);
+static void _grid_index_destroy(_grid_internals *gin);
+static unsigned int _grid_index_hash(void *pl);
+static int _grid_index_find(_grid_index *gi, void *pl);
+static int _grid_index_add(_grid_internals *gin, void *pl, int row, int col);
+static void _grid_index_remove(_grid_internals *gin, void *pl,
+                               int row, int col);
+static int _grid_index_lookup(_grid_internals *gin, void *pl,
+                              int *row, int *col);
+static void _grid_index_note(_grid_internals *gin, void *pl, int row, int col);
+static void _grid_index_drop(_grid_internals *gin, int row, int rows,
+                             int col, int cols);
+static void _grid_index_truncate(_grid_internals *gin, int rows, int cols);
+static int _grid_index_extend(_grid_internals *gin, int height, int width,
+                              int rows, int cols);
+static int _grid_search_span(void * const *payloads, int row, int col,
+                             int count, void *data);
+static int _grid_visit_span(void * const *payloads, int row, int col,
+                            int count, void *data);
+static int _grid_find_parallel(_grid_internals *gin, _grid_find *find,
+                               thread_pool_s *pool);
+static void _grid_find_band(int index, void *data);
+static int _grid_sort_bound(_grid_sort *sort, int run);
+static int _grid_sort_compare(_grid_sort *sort, int a, int b);
+static void _grid_sort_run(int index, void *data);
+static void _grid_sort_pair(int index, void *data);
+static void _grid_sort_range(_grid_sort *sort, int lo, int hi);
+static void _grid_sort_merge(_grid_sort *sort, int lo, int mid, int hi);
+static int _grid_band_add(_grid_band *band, int row, int col);
+
+  // INTERNAL: mesh storage engine prototypes
+static int _mesh_init(_grid_internals *gin);
+static void _mesh_release(_grid_internals *gin, grid_payload_free fpl);
+static void *_mesh_get(_grid_internals *gin, int row, int col);
+static void _mesh_set(_grid_internals *gin, int row, int col, void *pl);
+static int _mesh_resize(_grid_internals *gin, int rows, int cols,
+                        grid_payload_free fpl);
+static int _mesh_insert_rows(_grid_internals *gin, int row, int count);
+static int _mesh_insert_columns(_grid_internals *gin, int col, int count);
+static void _mesh_remove_rows(_grid_internals *gin, int row, int count,
+                              grid_payload_free fpl);
+static void _mesh_remove_columns(_grid_internals *gin, int col, int count,
+                                 grid_payload_free fpl);
+static int _mesh_permute_rows(_grid_internals *gin, const int *perm);
+static void *_mesh_seek(_grid_internals *gin, _grid_position *pos,
+                        int row, int col);
+static void **_mesh_span(_grid_internals *gin, _grid_position *pos,
+                         int row, int col, int *count, void **buf, int size);
+static _cell *_mesh_cell(_grid_internals *gin, int row, int col);
+static _cell *_mesh_walk(_grid_internals *gin, int row, int col,
+                         _cell *from, int frow, int fcol);
+static int _mesh_reserve(_mesh_store *ms, int rows, int cols);
+static void _mesh_truncate_rows(_mesh_store *ms, int rows, int chgt,
+                                grid_payload_free fpl);
+static void _mesh_truncate_columns(_mesh_store *ms, int cols,
+                                   grid_payload_free fpl);
+static int _mesh_extend(_mesh_store *ms, int rows, int cols,
+                        int chgt, int cwid);
+static void _mesh_clear(_mesh_store *ms, grid_payload_free fpl);
+static int _mesh_reserve_cells(_mesh_store *ms, int count);
+static _cell *_cell_new(_mesh_store *ms, void *pl);
+static void _cell_free(_mesh_store *ms, _cell *c, grid_payload_free fpl);
+static int _mesh_create_rows(_mesh_store *ms, int row, int count,
+                             int chgt, int cwid);
+static int _mesh_create_columns(_mesh_store *ms, int col, int count,
+                                int chgt, int cwid);
+static void _mesh_free_rows(_mesh_store *ms, int row, int count, int chgt,
+                            grid_payload_free fpl);
+static void _mesh_free_columns(_mesh_store *ms, int col, int count, int cwid,
+                               grid_payload_free fpl);
+
+  // INTERNAL: dense storage engine prototypes
+static int _dense_init(_grid_internals *gin);
+static void _dense_release(_grid_internals *gin, grid_payload_free fpl);
+static void *_dense_get(_grid_internals *gin, int row, int col);
+static void _dense_set(_grid_internals *gin, int row, int col, void *pl);
+static int _dense_resize(_grid_internals *gin, int rows, int cols,
+                         grid_payload_free fpl);
+static int _dense_insert_rows(_grid_internals *gin, int row, int count);
+static int _dense_insert_columns(_grid_internals *gin, int col, int count);
+static void _dense_remove_rows(_grid_internals *gin, int row, int count,
+                               grid_payload_free fpl);
+static void _dense_remove_columns(_grid_internals *gin, int col, int count,
+                                  grid_payload_free fpl);
+static int _dense_permute_rows(_grid_internals *gin, const int *perm);
+static void **_dense_span(_grid_internals *gin, _grid_position *pos,
+                          int row, int col, int *count, void **buf, int size);
+static int _dense_reserve(_grid_internals *gin, int rows, int cols);
+
+  // INTERNAL: sparse storage engine prototypes
+static int _sparse_init(_grid_internals *gin);
+static void _sparse_release(_grid_internals *gin, grid_payload_free fpl);
+static void *_sparse_get(_grid_internals *gin, int row, int col);
+static void _sparse_set(_grid_internals *gin, int row, int col, void *pl);
+static int _sparse_resize(_grid_internals *gin, int rows, int cols,
+                          grid_payload_free fpl);
+static int _sparse_insert_rows(_grid_internals *gin, int row, int count);
+static int _sparse_insert_columns(_grid_internals *gin, int col, int count);
+static void _sparse_remove_rows(_grid_internals *gin, int row, int count,
+                                grid_payload_free fpl);
+static void _sparse_remove_columns(_grid_internals *gin, int col, int count,
+                                   grid_payload_free fpl);
+static int _sparse_permute_rows(_grid_internals *gin, const int *perm);
+static void **_sparse_span(_grid_internals *gin, _grid_position *pos,
+                           int row, int col, int *count, void **buf, int size);
+static unsigned int _sparse_hash(int rid, int cid);
+static int _sparse_find(_sparse_store *ss, int rid, int cid);
+static void *_sparse_take(_sparse_store *ss, int i);
+static int _sparse_rehash(_sparse_store *ss, int capacity);
+static void _sparse_drop(_sparse_store *ss, int rows, int at, int count,
+                         int other, grid_payload_free fpl);
+static void _sparse_clear(_sparse_store *ss, grid_payload_free fpl);
+
+  // INTERNAL: tiled storage engine prototypes
+static int _tiled_init(_grid_internals *gin);
+static void _tiled_release(_grid_internals *gin, grid_payload_free fpl);
+static void *_tiled_get(_grid_internals *gin, int row, int col);
+static void _tiled_set(_grid_internals *gin, int row, int col, void *pl);
+static int _tiled_resize(_grid_internals *gin, int rows, int cols,
+                         grid_payload_free fpl);
+static int _tiled_insert_rows(_grid_internals *gin, int row, int count);
+static int _tiled_insert_columns(_grid_internals *gin, int col, int count);
+static void _tiled_remove_rows(_grid_internals *gin, int row, int count,
+                               grid_payload_free fpl);
+static void _tiled_remove_columns(_grid_internals *gin, int col, int count,
+                                  grid_payload_free fpl);
+static int _tiled_permute_rows(_grid_internals *gin, const int *perm);
+static void **_tiled_span(_grid_internals *gin, _grid_position *pos,
+                          int row, int col, int *count, void **buf, int size);
+static int _tiled_band_of(_tiled_store *ts, int row, int *off);
+static void **_tiled_cell(_tile_band *band, int off, int col);
+static void _tiled_reindex(_tiled_store *ts, int b);
+static int _tiled_band_new(_tiled_store *ts, _tile_band *band, int rows);
+static void _tiled_band_free(_tiled_store *ts, _tile_band *band,
+                             grid_payload_free fpl);
+static int _tiled_reserve_bands(_tiled_store *ts, int count);
+static int _tiled_widen(_tiled_store *ts, int ntiles);
+static void _tiled_narrow(_tiled_store *ts, int cols, grid_payload_free fpl);
+static int _tiled_add_rows(_tiled_store *ts, int b, int off, int count);
+static void _tiled_drop_rows(_tiled_store *ts, int row, int count,
+                             grid_payload_free fpl);
+static void _tiled_merge(_tiled_store *ts, int b);
+static void _tiled_clear(_tiled_store *ts, grid_payload_free fpl);
+static int _tiled_share(_grid_internals *gin, _grid_internals *snap);
+static int _tiled_own(_grid_internals *gin, int row, int col,
+                      int rows, int cols);
+static int _tiled_own_store(_grid_internals *gin);
+static int _tiled_own_tile(_tile_band *band, int t);
+static void _tiled_tile_free(_tile *tile);
+static void _tiled_copy_row(_tiled_store *ts, int to, int from, void **buf);
+
+  // INTERNAL: view storage engine prototypes
+static void _view_release(_grid_internals *gin, grid_payload_free fpl);
+static void *_view_get(_grid_internals *gin, int row, int col);
+static void *_view_seek(_grid_internals *gin, _grid_position *pos,
+                        int row, int col);
+static void **_view_span(_grid_internals *gin, _grid_position *pos,
+                         int row, int col, int *count, void **buf, int size);
+static void _view_map(_view_store *vs, int *row, int *col);
+static void _view_unmap(_view_store *vs, int *row, int *col);
+
+  // INTERNAL: mapped storage engine prototypes
+static void _mapped_release(_grid_internals *gin, grid_payload_free fpl);
+static void *_mapped_get(_grid_internals *gin, int row, int col);
+static void **_mapped_span(_grid_internals *gin, _grid_position *pos,
+                           int row, int col, int *count, void **buf, int size);
+static void *_mapped_payload(_mapped_store *ms, uint64_t off);
+
+  /*!
+    @brief INTERNAL: table of storage engines, indexed by grid_storage_t
+  */
+
+static const _grid_storage _grid_storages[] =
+{
+  {
+    grid_storage_mesh,
+    _mesh_init,
+    _mesh_release,
+    _mesh_get,
+    _mesh_set,
+    _mesh_resize,
+    _mesh_insert_rows,
+    _mesh_insert_columns,
+    _mesh_remove_rows,
+    _mesh_remove_columns,
+    _mesh_permute_rows,
+    _mesh_seek,
+    _mesh_span,
+    NULL,
+    NULL
+  },
+  {
+    grid_storage_dense,
+    _dense_init,
+    _dense_release,
+    _dense_get,
+    _dense_set,
+    _dense_resize,
+    _dense_insert_rows,
+    _dense_insert_columns,
+    _dense_remove_rows,
+    _dense_remove_columns,
+    _dense_permute_rows,
+    NULL,
+    _dense_span,
+    NULL,
+    NULL
+  },
+  {
+    grid_storage_sparse,
+    _sparse_init,
+    _sparse_release,
+    _sparse_get,
+    _sparse_set,
+    _sparse_resize,
+    _sparse_insert_rows,
+    _sparse_insert_columns,
+    _sparse_remove_rows,
+    _sparse_remove_columns,
+    _sparse_permute_rows,
+    NULL,
+    _sparse_span,
+    NULL,
+    NULL
+  },
+  {
+    grid_storage_tiled,
+    _tiled_init,
+    _tiled_release,
+    _tiled_get,
+    _tiled_set,
+    _tiled_resize,
+    _tiled_insert_rows,
+    _tiled_insert_columns,
+    _tiled_remove_rows,
+    _tiled_remove_columns,
+    _tiled_permute_rows,
+    NULL,
+    _tiled_span,
+    _tiled_share,
+    _tiled_own
+  }
+};
+
+  /*!
+    @brief INTERNAL: storage engine of views
+
+    Views are only ever read, so that the operations changing cells are
+    never called.  Views are made by grid_view_create(), rather than by
+    grid_create_storage().
+  */
+
+static const _grid_storage _grid_view_storage =
+{
+  grid_storage_view,
+  NULL,
+  _view_release,
+  _view_get,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  _view_seek,
+  _view_span,
+  NULL,
+  NULL
+};
+
+  /*!
+    @brief INTERNAL: storage engine of mapped grids
+
+    Mapped grids are only ever read.  They are made by grid_create_mapped(),
+    rather than by grid_create_storage().
+  */
+
+static const _grid_storage _grid_mapped_storage =
+{
+  grid_storage_mapped,
+  NULL,
+  _mapped_release,
+  _mapped_get,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  _mapped_span,
+  NULL,
+  NULL
+};
 
   /*!
 
      @brief Create a new grid
 
      Creates a new grid, allocationg all necessary components, and setting
-     reasonable defaults.
+     reasonable defaults.  The grid uses the default "mesh" storage engine.
 
      @retval "grid_s *" success
      @retval NULL    failure
@@ -117,6 +957,29 @@ static _cell *_grid_get_cell(grid_s *grid);
   */
 
 grid_s *grid_create(void)
+{
+    // Return "grid_s *"
+  return grid_create_storage(grid_storage_mesh);
+}
+
+  /*!
+
+     @brief Create a new grid with a specific storage engine
+
+     Creates a new grid, allocationg all necessary components, and setting
+     reasonable defaults.  The cells of the grid are kept in the requested
+     storage engine for the lifetime of the grid.
+
+     The new grid contains one empty cell.
+
+     @param storage    storage engine to use for grid cells
+
+     @retval "grid_s *" success
+     @retval NULL    failure
+
+  */
+
+grid_s *grid_create_storage(grid_storage_t storage)
 {
   grid_s *g;
   _grid_internals *gi;
@@ -150,14 +1013,54 @@ grid_s *grid_create(void)
     grid_destroy(g);
     return NULL;
   }
-  grid_size_set(gi->size, 1, 1);
+  grid_size_set(gi->size, 0, 0);
+
+  gi->storage = _grid_get_storage(storage);
+  if (!gi->storage || gi->storage->init(gi))
+  {
+    grid_destroy(g);
+    return NULL;
+  }
 
   grid_set_free(g, free);
 
+    // Start with a single empty cell
+  if (_grid_resize(g, 1, 1, NULL))
+  {
+    grid_destroy(g);
+    return NULL;
+  }
+
     // Return "grid_s *"
   return g;
 }
 
+  /*!
+
+     @brief Get storage engine of grid
+
+     Returns the storage engine selected when the grid was created.
+
+     @param grid    pointer to existing grid
+
+     @retval "grid_storage_t" storage engine
+
+  */
+
+grid_storage_t grid_get_storage(grid_s *grid)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin || !gin->storage) return grid_storage_mesh;
+
+    // Return "grid_storage_t"
+  return gin->storage->type;
+}
+
   /*!
 
      @brief Destroy grid, leaving user data
@@ -179,11 +1082,14 @@ void grid_free(grid_s *grid)
   assert(grid);
 
   gi = _grid_get_internals(grid);
-  if (!gi) return;
+  if (!gi)
+  {
+    free(grid);
+    return;
+  }
 
-  if (gi->size)
-    while (grid_size_get_height(gi->size))
-      grid_free_row(grid, 0);
+  _grid_index_destroy(gi);
+  _grid_release(gi, NULL);
 
   if (gi->size) grid_size_destroy(gi->size);
   if (gi->location) vertex_destroy(gi->location);
@@ -213,11 +1119,14 @@ void grid_destroy(grid_s *grid)
   assert(grid);
 
   gi = _grid_get_internals(grid);
-  if (!gi) return;
+  if (!gi)
+  {
+    free(grid);
+    return;
+  }
 
-  if (gi->size)
-    while (grid_size_get_height(gi->size))
-      grid_destroy_row(grid, 0);
+  _grid_index_destroy(gi);
+  _grid_release(gi, gi->grid_pl_free);
 
   if (gi->size) grid_size_destroy(gi->size);
   if (gi->location) vertex_destroy(gi->location);
@@ -247,1426 +1156,8418 @@ void grid_set_free(grid_s *grid, grid_payload_free func)
   assert(grid);
 
   gin = _grid_get_internals(grid);
-  if (gin) gin->grid_pl_free = func;
+  if (gin && !_grid_is_read_only(gin)) gin->grid_pl_free = func;
 }
 
   /*!
 
-     @brief Set size of grid
+     @brief Set reclaimer for payload data de-allocated by grid
 
-     Explicitly set size of grid.  If size is smaller than current size, then
-     remove necessary cells.  If size is greater that current, then add new
-     empty cells.
+     Payload data the grid would de-allocate, when clearing cells, destroying
+     rows or columns, resizing or destroying the grid, is handed to the
+     reclaimer instead, and de-allocated later, possibly from another thread.
+     The reclaimer must outlive the grid, or be flushed before the payload
+     de-allocation function stops being safe to call.  Read-only grids ignore
+     the reclaimer.
 
-     @param grid    pointer to existing grid
-     @param gs    pointer to "grid size" structure containing desired grid size
+     @param grid    pointer to grid data structure
+     @param r    pointer to reclaimer, or NULL to de-allocate payload data
+                 at once
 
-     @retval NONE    failure
+     @retval NONE
 
   */
 
-void grid_set_size(grid_s *grid, grid_size_s *gs)
+void grid_set_reclaim(grid_s *grid, reclaim_s *r)
 {
-  grid_size_s *size;
-  int rows, cols;
-  int width, height;
-  int i;
+  _grid_internals *gin;
 
     // Sanity check parameters.
   assert(grid);
-  assert(gs);
 
-  size = grid_get_size(grid);
-  if (!size) return;
+  gin = _grid_get_internals(grid);
+  if (gin && !_grid_is_read_only(gin)) gin->reclaim = r;
+}
+
+  /*!
+
+     @brief Set user defined change function
+
+     The function is called after every change to the cells or structure of
+     the grid: setting or clearing a cell, resizing the grid, inserting or
+     removing rows or columns, and sorting rows.  Changes that fail are not
+     reported, except for resizing, which reports whatever size results.
+     Read-only grids ignore the change function.
 
-  cols = grid_size_get_width(gs);
-  rows = grid_size_get_height(gs);
+     @param grid    pointer to grid data structure
+     @param func    pointer to change function, or NULL for none
+     @param data    pointer to user data for change function
 
-  width = grid_size_get_width(size);
-  height = grid_size_get_height(size);
+     @retval NONE
+
+  */
 
-    // If rows is greater than current size, insert needed rows at end
-  for (i = height; i < rows; ++i)
-    grid_create_row(grid, -1);
+void grid_set_notify(grid_s *grid, grid_change_notify func, void *data)
+{
+  _grid_internals *gin;
 
-    // If rows is less than current size, delete rows from end
-  for (i = height - 1; rows < (i + 1); --i)
-    grid_destroy_row(grid, -1);
+    // Sanity check parameters.
+  assert(grid);
 
-    // If cols is greater than current size, insert cols at end
-  for (i = width; i < cols; ++i)
-    grid_create_column(grid, -1);
+  gin = _grid_get_internals(grid);
+  if (!gin || _grid_is_read_only(gin)) return;
 
-    // If cols is less than current size, delete cols from end
-  for (i = width - 1; cols < (i + 1); --i)
-    grid_destroy_column(grid, -1);
+  gin->notify = func;
+  gin->notify_data = data;
+}
+
+  /*!
+
+     @brief Take a snapshot of grid
+
+     Creates a read-only grid holding the cells of a grid as they are now.
+     The snapshot is not affected by later changes to the grid, and may be
+     read, by grid_foreach(), grid cursors or grid_to_xml_node() for example,
+     from another thread while the grid keeps being changed.  Functions that
+     would change a snapshot do nothing.
+
+     The snapshot refers to the same payload data as the grid.  Payload data
+     the grid would de-allocate while a snapshot may refer to it is kept
+     until every such snapshot is destroyed.  Snapshots are destroyed with
+     grid_destroy(), or grid_free(), which never de-allocate payload data.
+
+     Snapshots of tiled grids share the tiles of the grid, and tiles are only
+     copied when the grid next changes them, so that taking a snapshot takes
+     constant time.  Snapshots of grids in other storage engines copy the
+     payload pointers of every cell into a new dense store.
+
+     NOTE:  The grid must not be changed while the snapshot is being taken.
+
+     @param grid    pointer to existing grid, or snapshot
+
+     @retval "grid_s *" success
+     @retval NULL    failure
+
+  */
+
+grid_s *grid_snapshot(grid_s *grid)
+{
+  _grid_internals *gin;
+  _grid_internals *sin;
+  grid_s *snap;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return NULL;
+
+  snap = malloc(sizeof(grid_s));
+  if (!snap) return NULL;
+
+  sin = (void*)malloc(sizeof(_grid_internals));
+  if (!sin)
+  {
+    free(snap);
+    return NULL;
+  }
+  memset(sin, 0, sizeof(_grid_internals));
+  snap->_internals = sin;
+
+  sin->location = vertex_create();
+  sin->size = grid_size_create();
+  if (!sin->location || !sin->size)
+  {
+    grid_destroy(snap);
+    return NULL;
+  }
+  vertex_set_y(sin->location, 0);
+  vertex_set_x(sin->location, 0);
+
+  if (gin->storage->share)
+  {
+    sin->storage = gin->storage;
+    if (gin->storage->share(gin, sin))
+    {
+      grid_destroy(snap);
+      return NULL;
+    }
+    grid_size_set(sin->size,
+                  grid_size_get_width(gin->size),
+                  grid_size_get_height(gin->size));
+  }
+  else if (_grid_snapshot_copy(gin, sin))
+  {
+    grid_destroy(snap);
+    return NULL;
+  }
+
+  if (_grid_snapshots_join(gin, sin))
+  {
+    grid_destroy(snap);
+    return NULL;
+  }
+
+    // Return "grid_s *"
+  return snap;
+}
+
+  /*!
+
+     @brief Get whether grid is a snapshot
+
+     @param grid    pointer to existing grid
+
+     @retval 1    grid is a read-only snapshot
+     @retval 0    grid may be changed
+
+  */
+
+int grid_is_snapshot(grid_s *grid)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return 0;
+
+    // Return "int"
+  return (gin->epoch) ? 1 : 0;
+}
+
+  /*!
+
+     @brief Create a view of grid
+
+     Creates a read-only grid showing a rectangular window onto the cells of
+     a grid, without copying any cells.  The window is clipped to the grid.
+     A transposed view shows the rows of the window as columns, and the
+     columns as rows.  Functions that would change a view do nothing, and
+     grid_get_storage() of a view returns grid_storage_view.
+
+     Reading a view reads the cells of the grid as they are at that time.
+     Should the grid shrink, cells of the view outside the grid are empty.
+
+     NOTE:  The grid must not be destroyed while a view of it exists.
+
+     @param grid    pointer to existing grid, or view
+     @param row    first row of window
+     @param column    first column of window
+     @param rows    number of rows in window
+     @param columns    number of columns in window
+     @param transpose    non-zero to exchange rows and columns of window
+
+     @retval "grid_view_s *" success
+     @retval NULL    failure
+
+  */
+
+grid_view_s *grid_view_create(grid_s *grid,
+                              int row,
+                              int column,
+                              int rows,
+                              int columns,
+                              int transpose)
+{
+  _grid_internals *gin;
+  _grid_internals *vin;
+  _view_store *vs;
+  grid_view_s *view;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return NULL;
+
+  if (row < 0 || column < 0 || rows < 0 || columns < 0) return NULL;
+
+  if (rows > grid_size_get_height(gin->size) - row)
+    rows = grid_size_get_height(gin->size) - row;
+  if (columns > grid_size_get_width(gin->size) - column)
+    columns = grid_size_get_width(gin->size) - column;
+  if (rows < 0) rows = 0;
+  if (columns < 0) columns = 0;
+
+  view = malloc(sizeof(grid_view_s));
+  if (!view) return NULL;
+
+  vin = (void*)malloc(sizeof(_grid_internals));
+  if (!vin)
+  {
+    free(view);
+    return NULL;
+  }
+  memset(vin, 0, sizeof(_grid_internals));
+  view->_internals = vin;
+
+  vin->location = vertex_create();
+  vin->size = grid_size_create();
+  vs = (_view_store *)malloc(sizeof(_view_store));
+  if (!vin->location || !vin->size || !vs)
+  {
+    free(vs);
+    grid_free(view);
+    return NULL;
+  }
+  vertex_set_y(vin->location, 0);
+  vertex_set_x(vin->location, 0);
+
+  vs->grid = grid;
+  vs->row = row;
+  vs->col = column;
+  vs->transpose = (transpose) ? 1 : 0;
+  memset(&vs->pos, 0, sizeof(_grid_position));
+
+  vin->storage = &_grid_view_storage;
+  vin->store = vs;
+
+  if (transpose)
+    grid_size_set(vin->size, rows, columns);
+  else
+    grid_size_set(vin->size, columns, rows);
+
+    // Return "grid_view_s *"
+  return view;
+}
+
+  /*!
+
+     @brief Destroy view of grid
+
+     De-allocates a view, leaving the grid and its payload data intact.
+
+     @param view    pointer to existing view
+
+     @retval NONE
+
+  */
+
+void grid_view_destroy(grid_view_s *view)
+{
+    // Sanity check parameters.
+  assert(view);
+
+  grid_free(view);
+}
+
+  /*!
+
+     @brief Create a read-only grid over payload data in memory
+
+     Creates a grid whose cells are located through a row-major table of
+     offsets, one per cell, relative to a base address.  The payload data of
+     a cell is at base + offset, is 8 byte aligned, and is preceded by its
+     size in bytes, as a uint64_t.  A cell is empty when its offset is zero,
+     when its offset is not 8 byte aligned or leaves no room for the size, or
+     when its payload data would extend beyond limit, so that a damaged table
+     can not make a cell point outside of the payload data.  Neither the
+     table nor the payload data is copied, and no cell is allocated, so that
+     a grid held in a mapped file may be used at once.  Functions that would
+     change the grid do nothing, and grid_get_storage() returns
+     grid_storage_mapped.
+
+     The table and payload data must stay in place until the grid is
+     destroyed, when the user release function, if any, is called.  Views
+     and snapshots of the grid must be destroyed first.
+
+     @param rows    number of rows
+     @param columns    number of columns
+     @param offsets    pointer to table of rows * columns payload offsets
+     @param base    8 byte aligned address offsets are relative to
+     @param limit    first offset beyond payload data
+     @param func    pointer to user release function, or NULL
+     @param data    pointer to user data for release function
+
+     @retval "grid_s *" success
+     @retval NULL    failure, func is not called
+
+  */
+
+grid_s *grid_create_mapped(int rows,
+                           int columns,
+                           const uint64_t *offsets,
+                           const void *base,
+                           uint64_t limit,
+                           grid_mapped_release func,
+                           void *data)
+{
+  _grid_internals *gin;
+  _mapped_store *ms;
+  grid_s *grid;
+
+    // Sanity check parameters.
+  assert(offsets || !rows || !columns);
+  assert(base || !limit);
+
+  if (rows < 0 || columns < 0) return NULL;
+  if (!rows || !columns) rows = columns = 0;
+  if ((uintptr_t)base % sizeof(uint64_t)) return NULL;
+
+  grid = malloc(sizeof(grid_s));
+  if (!grid) return NULL;
+
+  gin = (void*)malloc(sizeof(_grid_internals));
+  if (!gin)
+  {
+    free(grid);
+    return NULL;
+  }
+  memset(gin, 0, sizeof(_grid_internals));
+  grid->_internals = gin;
+
+  gin->location = vertex_create();
+  gin->size = grid_size_create();
+  ms = (_mapped_store *)malloc(sizeof(_mapped_store));
+  if (!gin->location || !gin->size || !ms)
+  {
+    free(ms);
+    grid_free(grid);
+    return NULL;
+  }
+  vertex_set_y(gin->location, 0);
+  vertex_set_x(gin->location, 0);
+
+  ms->offsets = offsets;
+  ms->base = (const char *)base;
+  ms->limit = limit;
+  ms->func = func;
+  ms->data = data;
+
+  gin->storage = &_grid_mapped_storage;
+  gin->store = ms;
+
+  grid_size_set(gin->size, columns, rows);
+
+    // Return "grid_s *"
+  return grid;
+}
+
+  /*!
+
+     @brief Set size of grid
+
+     Explicitly set size of grid.  If size is smaller than current size, then
+     remove necessary cells.  If size is greater that current, then add new
+     empty cells.
+
+     @param grid    pointer to existing grid
+     @param gs    pointer to "grid size" structure containing desired grid size
+
+     @retval NONE    failure
+
+  */
+
+void grid_set_size(grid_s *grid, grid_size_s *gs)
+{
+    // Sanity check parameters.
+  assert(grid);
+  assert(gs);
+
+  _grid_resize(grid,
+               grid_size_get_height(gs),
+               grid_size_get_width(gs),
+               _grid_get_pl_free(grid));
 }
 
   /*!
 
      @brief Set size of grid, leaving user data
 
-     Explicitly set size of grid.  If size is smaller than current size, then
-     remove necessary cells, leaving user supplied data intact.  If size is
-     greater that current, then add new empty cells.
+     Explicitly set size of grid.  If size is smaller than current size, then
+     remove necessary cells, leaving user supplied data intact.  If size is
+     greater that current, then add new empty cells.
+
+     @param grid    pointer to existing grid
+     @param gs    pointer to "grid size" structure containing desired grid size
+
+     @retval NONE    failure
+
+  */
+
+void grid_set_size_free_only(grid_s *grid, grid_size_s *gs)
+{
+    // Sanity check parameters.
+  assert(grid);
+  assert(gs);
+
+  _grid_resize(grid,
+               grid_size_get_height(gs),
+               grid_size_get_width(gs),
+               NULL);
+}
+
+  /*!
+
+     @brief Get "grid size" structure from grid
+
+     Get "grid size" structure from grid
+
+     @param grid    pointer to exising grid
+
+     @retval "grid_size_s *" success
+     @retval NULL    failure
+
+  */
+
+grid_size_s *grid_get_size(grid_s *grid)
+{
+  _grid_internals *gi;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gi = _grid_get_internals(grid);
+  if (!gi) return NULL;
+
+    // Return "grid_size_s *"
+  return gi->size;
+}
+
+  /*!
+
+     @brief Get location structure from grid
+
+     Get location structure from grid
+
+     @param grid    pointer to exising grid
+
+     @retval "vertex_s *" success
+     @retval NULL    failure
+
+  */
+
+vertex_s *grid_get_location(grid_s *grid)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return NULL;
+
+    // Return "vertex *"
+  return gin->location;
+}
+
+  /*!
+
+     @brief Enable or disable reference index of grid
+
+     A reference index maps payload data back to the cell holding it, so that
+     grid_find_by_reference() need not scan the grid.  The index is kept up
+     to date by every function that changes the grid.  Should the index run
+     out of memory, it is disabled, and grid_find_by_reference() falls back
+     to scanning the grid.
+
+     @param grid    pointer to existing grid
+     @param enable    non-zero to enable index, zero to disable index
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+int grid_set_index(grid_s *grid, int enable)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return -1;
+
+  if (!enable)
+  {
+    _grid_index_destroy(gin);
+    return 0;
+  }
+
+  if (gin->index) return 0;
+
+    // A view would not see the grid change
+  if (gin->storage->type == grid_storage_view) return -1;
+
+    // Return "int"
+  return _grid_index_create(gin);
+}
+
+  /*!
+
+     @brief Get whether reference index of grid is enabled
+
+     @param grid    pointer to existing grid
+
+     @retval 1    index enabled
+     @retval 0    index disabled
+
+  */
+
+int grid_get_index(grid_s *grid)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return 0;
+
+    // Return "int"
+  return (gin->index) ? 1 : 0;
+}
+
+  /*!
+
+     @brief Create a new row in grid
+
+     Creates a new row, with no cell payload data.  The row will contain the 
+     current numer of columns as is set by the grid width.  The user supplied row
+     parameter determines where the new row will be created.   If the row
+     parameter is negative, the new row will be created after the current last
+     row.  For a non-negative row parameter, the new row will be inserted before
+     the row parameter value.  One exception, if the row parameter contains
+     a value greater than the last row, then it will be set to the last row.
+
+     @param grid    pointer to existing grid
+     @param row     row AFTER which to add new row
+
+     @retval NONE    failure
+
+  */
+
+void grid_create_row(grid_s *grid, int row)
+{
+    // Sanity check parameters.
+  assert(grid);
+
+  _grid_insert_rows(grid, row, 1);
+}
+
+  /*!
+
+     @brief Create a new column in grid
+
+     Creates a new column of cells in grid.  The new column contains a
+     number of cells equal to the current height of the grid.  If a the
+     requested column insertion number is greater than the current width
+     of the grid is passed to this function, then the function returns
+     with no effect.  If the column insertion number is the current width
+     of the grid plus one, then the column is appended to the end of the
+     grid.  If the column number is negative, the new column is also appended
+     to the end of the grid.  Otherwise, the new column is inserted before
+     the column insert number.
+
+     @param grid    pointer to existing grid
+     @param col    column insertion number
+
+     @retval NONE
+
+  */
+
+void grid_create_column(grid_s *grid, int col)
+{
+    // Sanity check parameters.
+  assert(grid);
+
+  _grid_insert_columns(grid, col, 1);
+}
+
+  /*!
+
+     @brief De-allocates a row in a grid, leaving data intact
+
+     De-allocates all memory associated with all cells in a row, while
+     leaving the memory associated with the cell payload data intact.
+
+     @param grid    pointer to existing grid
+     @param row    row number to free
+
+     @retval NONE
+
+  */
+
+void grid_free_row(grid_s *grid, int row)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return;
+
+  if (row < 0) row = grid_size_get_height(gin->size) - 1;
+
+  _grid_remove_rows(grid, row, 1, NULL);
+}
+
+  /*!
+
+     @brief De-allocates a column in a grid, leaving data intact
+
+     De-allocates all memory associated with all cells in a column, while
+     leaving the memory associated with the cell payload data intact.
+
+     @param grid    pointer to existing grid
+     @param col    column number to free
+
+     @retval NONE
+
+  */
+
+void grid_free_column(grid_s *grid, int col)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return;
+
+  if (col < 0) col = grid_size_get_width(gin->size) - 1;
+
+  _grid_remove_columns(grid, col, 1, NULL);
+}
+
+  /*!
+
+     @brief De-allocates a row in a grid
+
+     De-allocates all memory associated with all cells in a row, including
+     the memory associated with the cell payload.
+
+     @param grid    pointer to existing grid
+     @param row    row number to free
+
+     @retval NONE
+
+  */
+
+void grid_destroy_row(grid_s *grid, int row)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return;
+
+  if (row < 0) row = grid_size_get_height(gin->size) - 1;
+
+  _grid_remove_rows(grid, row, 1, _grid_get_pl_free(grid));
+}
+
+  /*!
+
+     @brief De-allocates a column in a grid
+
+     De-allocates all memory associated with all cells in a column, including
+     the memory associated with the cell payload.
+
+     @param grid    pointer to existing grid
+     @param col    column number to free
+
+     @retval NONE
+
+  */
+
+void grid_destroy_column(grid_s *grid, int col)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return;
+
+  if (col < 0) col = grid_size_get_width(gin->size) - 1;
+
+  _grid_remove_columns(grid, col, 1, _grid_get_pl_free(grid));
+}
+
+  /*!
+
+     @brief Create new rows in grid
+
+     Creates a band of new rows, with no cell payload data, in a single pass
+     over the grid.  The rows are placed as grid_create_row() places a single
+     row:  before the row parameter, or after the current last row if the row
+     parameter is negative.  If the row parameter is greater than the number
+     of rows, nothing is done.  The current cell remains the same cell.
+
+     @param grid    pointer to existing grid
+     @param row    row before which to insert
+     @param count    number of rows to create
+
+     @retval NONE
+
+  */
+
+void grid_create_rows(grid_s *grid, int row, int count)
+{
+    // Sanity check parameters.
+  assert(grid);
+
+  _grid_insert_rows(grid, row, count);
+}
+
+  /*!
+
+     @brief Create new columns in grid
+
+     Creates a band of new columns, with no cell payload data, in a single
+     pass over the grid.  The columns are placed as grid_create_column()
+     places a single column.  The current cell remains the same cell.
+
+     @param grid    pointer to existing grid
+     @param col    column before which to insert
+     @param count    number of columns to create
+
+     @retval NONE
+
+  */
+
+void grid_create_columns(grid_s *grid, int col, int count)
+{
+    // Sanity check parameters.
+  assert(grid);
+
+  _grid_insert_columns(grid, col, count);
+}
+
+  /*!
+
+     @brief De-allocates rows in a grid
+
+     De-allocates a band of rows, including the cell payload data, in a
+     single pass over the grid.  The band is clipped to the end of the grid.
+     A negative first row removes the last count rows.  The current cell is
+     set to the origin.
+
+     @param grid    pointer to existing grid
+     @param row    first row to remove
+     @param count    number of rows to remove
+
+     @retval NONE
+
+  */
+
+void grid_destroy_rows(grid_s *grid, int row, int count)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return;
+
+  if (row < 0) row = grid_size_get_height(gin->size) - count;
+  if (row < 0) row = 0;
+
+  _grid_remove_rows(grid, row, count, _grid_get_pl_free(grid));
+}
+
+  /*!
+
+     @brief De-allocates columns in a grid
+
+     De-allocates a band of columns, including the cell payload data, in a
+     single pass over the grid.  The band is clipped to the end of the grid.
+     A negative first column removes the last count columns.  The current
+     cell is set to the origin.
+
+     @param grid    pointer to existing grid
+     @param col    first column to remove
+     @param count    number of columns to remove
+
+     @retval NONE
+
+  */
+
+void grid_destroy_columns(grid_s *grid, int col, int count)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return;
+
+  if (col < 0) col = grid_size_get_width(gin->size) - count;
+  if (col < 0) col = 0;
+
+  _grid_remove_columns(grid, col, count, _grid_get_pl_free(grid));
+}
+
+  /*!
+
+     @brief De-allocate the payload data of the current cell
+
+     De-allocates the data payload for the current cell in the grid.
+
+     @param grid    pointer to existing grid
+
+     @retval NONE
+
+  */
+
+void grid_clear_cell(grid_s *grid)
+{
+  _grid_internals *gin;
+  grid_payload_free fpl;
+  void *pl;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return;
+
+  if (_grid_is_empty(gin)) return;
+
+  fpl = _grid_get_pl_free(grid);
+
+  pl = gin->storage->get(gin, gin->row, gin->col);
+
+  if (_grid_store(gin, gin->row, gin->col, NULL)) return;
+
+  if (fpl && pl) _grid_retire(gin, pl, fpl);
+}
+
+  /*!
+
+     @brief Get current cell in grid
+
+     Returns a pointer to the data payload in the current cell of a grid
+
+     @param grid    pointer to existing grid
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+void *grid_get_cell(grid_s *grid)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return NULL;
+
+  if (_grid_is_empty(gin)) return NULL;
+
+    // Return "void *"
+  return gin->storage->get(gin, gin->row, gin->col);
+}
+
+  /*!
+
+     @brief Assign payload data to a cell
+
+     Assigns, or re-assigns the payload data for a cell in a grid.
+
+     NOTE:  The current cell payload data, if any, will be de-allocated.
+
+     @param grid    pointer to exising grid
+     @param payload    pointer to new payload data
+
+     @retval NONE
+
+  */
+
+void grid_set_cell(grid_s *grid, void *payload)
+{
+  _grid_internals *gin;
+  grid_payload_free fpl;
+  void *pl;
+  
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return;
+
+  if (_grid_is_empty(gin)) return;
+
+  fpl = _grid_get_pl_free(grid);
+
+  pl = gin->storage->get(gin, gin->row, gin->col);
+
+    // Replace in one store, so that a single change is reported
+  if (_grid_store(gin, gin->row, gin->col, payload)) return;
+
+  if (fpl && pl && pl != payload) _grid_retire(gin, pl, fpl);
+}
+
+  /*!
+
+     @brief Find a cell by reference
+
+     Locates a cell in a grid based on a reference pointer value.  If the 
+     cell is located, the current grid cell is set to the found cell,
+     and the cell payload data is returned.
+
+     @param grid    pointer to existing grid
+     @param reference    pointer to payload data that may exist in grid
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+void *grid_find_by_reference(grid_s *grid, void *reference)
+{
+  _grid_internals *gin;
+  void *pl;
+  int row, col;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return NULL;
+
+  pl = _grid_find_by_reference(grid, reference, &row, &col);
+  if (pl)
+  {
+    _grid_set_cursor(gin, row, col);
+      // Return "void *"
+    return pl;
+  }
+
+    // Return NULL
+  return NULL;
+}
+
+  /*!
+
+     @brief Find a cell by value
+
+     Locates a cell in a grid by value.  If the cell is located, the
+     current grid cell is set to the found cell, and the payload data is
+     returned.
+
+     NOTE:  A user defined cell compare function must be supplied.
+
+     @param grid    pointer to existing grid
+     @param value    pointer to value to find
+     @param func    pointer to function to compare cell values
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+void *grid_find_by_value(grid_s *grid,
+                         void *value,
+                         grid_payload_compare func)
+{
+  _grid_internals *gin;
+  void *pl;
+  int row, col;
+
+    // Sanity check parameters.
+  assert(grid);
+  assert(value);
+  assert(func);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return NULL;
+
+  pl = _grid_find_by_value(grid, value, func, &row, &col);
+  if (pl)
+  {
+    _grid_set_cursor(gin, row, col);
+      // Return "void *"
+    return pl;
+  }
+
+    // Return NULL
+  return NULL;
+}
+
+  /*!
+
+     @brief Find first cell of grid holding a value, in parallel
+
+     Searches the grid, in row-major order, for the first cell whose payload
+     data the user compare function reports as equal to value.  The rows of
+     the grid are split into bands, which are searched at once by the threads
+     of a thread pool.  The cell found is always the one grid_find_by_value()
+     would find, however many threads are used.  The current grid cell is not
+     changed.
+
+     NOTE:  The compare function must be safe to call from several threads
+            at once, and the grid must not be changed during the search.
+
+     @param grid    pointer to existing grid
+     @param value    pointer to value to find
+     @param func    pointer to user compare function
+     @param pool    pointer to existing thread pool, or NULL to search serially
+     @param row    pointer to row of found cell, or NULL
+     @param column    pointer to column of found cell, or NULL
+
+     @retval "void *" success
+     @retval NULL    failure, or value not found
+
+  */
+
+void *grid_find_first_by_value(grid_s *grid,
+                               void *value,
+                               grid_payload_compare func,
+                               thread_pool_s *pool,
+                               int *row,
+                               int *column)
+{
+  _grid_internals *gin;
+  _grid_find find;
+  _grid_band *band;
+  void *pl = NULL;
+  int b;
+
+    // Sanity check parameters.
+  assert(grid);
+  assert(value);
+  assert(func);
+
+  gin = _grid_get_internals(grid);
+  if (!gin || _grid_is_empty(gin)) return NULL;
+
+  memset(&find, 0, sizeof(_grid_find));
+  find.pl = value;
+  find.cf = func;
+
+  if (_grid_find_parallel(gin, &find, pool)) return NULL;
+
+  b = atomic_load(&find.first);
+  if (b < find.nbands)
+  {
+    band = &find.bands[b];
+    pl = band->found;
+    if (row) *row = band->cells[0];
+    if (column) *column = band->cells[1];
+  }
+
+  for (b = 0; b < find.nbands; ++b) free(find.bands[b].cells);
+  free(find.bands);
+
+    // Return "void *"
+  return pl;
+}
+
+  /*!
+
+     @brief Find every cell of grid holding a value, in parallel
+
+     Searches the grid for every cell whose payload data the user compare
+     function reports as equal to value.  The rows of the grid are split into
+     bands, which are searched at once by the threads of a thread pool.  The
+     location of each cell found is returned as a vertex, with the column in
+     X and the row in Y, in row-major order.  The current grid cell is not
+     changed.
+
+     NOTE:  The compare function must be safe to call from several threads
+            at once, and the grid must not be changed during the search.
+
+     @param grid    pointer to existing grid
+     @param value    pointer to value to find
+     @param func    pointer to user compare function
+     @param pool    pointer to existing thread pool, or NULL to search serially
+
+     @retval "vertices_s *" success, empty when value not found
+     @retval NULL    failure
+
+  */
+
+vertices_s *grid_find_all_by_value(grid_s *grid,
+                                   void *value,
+                                   grid_payload_compare func,
+                                   thread_pool_s *pool)
+{
+  _grid_internals *gin;
+  _grid_find find;
+  _grid_band *band;
+  vertices_s *vs;
+  vertex_s v;
+  int b, i;
+
+    // Sanity check parameters.
+  assert(grid);
+  assert(value);
+  assert(func);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return NULL;
+
+  vs = vertices_create();
+  if (!vs) return NULL;
+
+  if (_grid_is_empty(gin)) return vs;
+
+  memset(&find, 0, sizeof(_grid_find));
+  find.pl = value;
+  find.cf = func;
+  find.all = 1;
+
+  if (_grid_find_parallel(gin, &find, pool))
+  {
+    vertices_destroy(vs);
+    return NULL;
+  }
+
+  memset(&v, 0, sizeof(vertex_s));
+
+  for (b = 0; b < find.nbands; ++b)
+  {
+    band = &find.bands[b];
+    for (i = 0; i < band->count; ++i)
+    {
+      vertex_set_y(&v, band->cells[2 * i]);
+      vertex_set_x(&v, band->cells[2 * i + 1]);
+      vertices_add_vertex(vs, &v);
+    }
+    free(band->cells);
+  }
+  free(find.bands);
+
+    // Return "vertices_s *"
+  return vs;
+}
+
+  /*!
+
+     @brief Sort rows of grid by one or more key columns
+
+     Reorders the rows of a grid so that the payload data of their key
+     columns is in ascending order.  Rows are compared by the first key
+     column, then by the next key column when the compare function reports
+     the payload data of one key column as equal (zero), and so on.  Empty
+     key cells, which the compare function is never given, sort after every
+     non-empty key cell.  The sort is stable, so that equal rows keep their
+     order, and the result does not depend on the number of threads used.
+
+     The order is found by a merge sort whose runs are sorted, and then
+     merged, by the threads of a thread pool.  The rows are then moved into
+     place by the storage engine, relinking or moving the existing cells,
+     without allocating any new cell.  The current cell keeps its row and
+     column.
+
+     NOTE:  The compare function must be safe to call from several threads
+            at once, and must return a negative, zero or positive value when
+            pl1 sorts before, with, or after pl2.
+
+     @param grid    pointer to existing grid
+     @param keys    pointer to array of key columns, most significant first
+     @param nkeys    number of key columns
+     @param func    pointer to user compare function
+     @param pool    pointer to existing thread pool, or NULL to sort serially
+
+     @retval 0    success
+     @retval -1    failure, grid not changed
+
+  */
+
+int grid_sort_rows(grid_s *grid,
+                   const int *keys,
+                   int nkeys,
+                   grid_payload_compare func,
+                   thread_pool_s *pool)
+{
+  _grid_internals *gin;
+  _grid_sort sort;
+  int height, width;
+  int rc;
+  int i;
+
+    // Sanity check parameters.
+  assert(grid);
+  assert(keys);
+  assert(func);
+
+  gin = _grid_get_internals(grid);
+  if (!gin || _grid_is_read_only(gin) || nkeys < 1) return -1;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+  for (i = 0; i < nkeys; ++i)
+    if (keys[i] < 0 || keys[i] >= width) return -1;
+
+  if (height < 2) return 0;
+
+  memset(&sort, 0, sizeof(_grid_sort));
+  sort.gin = gin;
+  sort.keys = keys;
+  sort.nkeys = nkeys;
+  sort.cf = func;
+  sort.rows = height;
+
+  sort.kv = (void **)malloc((size_t)height * nkeys * sizeof(void *));
+  sort.perm = (int *)malloc((size_t)height * sizeof(int));
+  sort.tmp = (int *)malloc((size_t)height * sizeof(int));
+  if (!sort.kv || !sort.perm || !sort.tmp)
+  {
+    free(sort.kv);
+    free(sort.perm);
+    free(sort.tmp);
+    return -1;
+  }
+
+  sort.nruns = thread_pool_get_size(pool) + 1;
+  if (sort.nruns > height) sort.nruns = height;
+
+  thread_pool_run(pool, sort.nruns, _grid_sort_run, &sort);
+
+  for (sort.width = 1; sort.width < sort.nruns; sort.width *= 2)
+    thread_pool_run(pool,
+                    (sort.nruns + 2 * sort.width - 1) / (2 * sort.width),
+                    _grid_sort_pair,
+                    &sort);
+
+  free(sort.kv);
+  free(sort.tmp);
+
+  for (i = 0; i < height && sort.perm[i] == i; ++i) ;
+
+  rc = (i < height) ? _grid_permute_rows(gin, sort.perm) : 0;
+
+  free(sort.perm);
+
+    // Return "int"
+  return rc;
+}
+
+  /*!
+
+     @brief Visit every cell of a grid
+
+     Calls a user function for the payload data of every cell, in row-major
+     or column-major order, until the function returns non-zero.  The current
+     grid cell is not changed.
+
+     NOTE:  The grid must not be changed during the iteration.
+
+     @param grid    pointer to existing grid
+     @param order    grid_order_rows, or grid_order_columns
+     @param func    pointer to function to call for each cell
+     @param data    pointer to user data passed to func
+
+     @retval 0    every cell visited
+     @retval "int" non-zero value returned by func
+
+  */
+
+int grid_foreach(grid_s *grid,
+                 grid_order_t order,
+                 grid_cell_visit func,
+                 void *data)
+{
+  _grid_internals *gin;
+  _grid_visit visit;
+  _grid_position pos;
+  int height, width;
+  int x, y;
+  int rc;
+
+    // Sanity check parameters.
+  assert(grid);
+  assert(func);
+
+  gin = _grid_get_internals(grid);
+  if (!gin || _grid_is_empty(gin)) return 0;
+
+  if (order == grid_order_rows)
+  {
+    visit.func = func;
+    visit.data = data;
+      // Return "int"
+    return _grid_foreach_span(gin, _grid_visit_span, &visit);
+  }
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+    // Walk with a position of our own, leaving the grid untouched
+  memset(&pos, 0, sizeof(_grid_position));
+
+  for (x = 0; x < width; ++x)
+    for (y = 0; y < height; ++y)
+    {
+      rc = func(_grid_seek(gin, &pos, y, x), y, x, data);
+      if (rc) return rc;
+    }
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief Visit every row of a grid, a span of cells at a time
+
+     Calls a user function for consecutive spans of payload data, covering
+     every row from left to right and top to bottom, until the function
+     returns non-zero.  A row may be handed out in several spans, and spans
+     point directly into the grid storage where the storage engine allows.
+     The current grid cell is not changed.
+
+     NOTE:  The grid must not be changed during the iteration.
+
+     @param grid    pointer to existing grid
+     @param func    pointer to function to call for each span
+     @param data    pointer to user data passed to func
+
+     @retval 0    every cell visited
+     @retval "int" non-zero value returned by func
+
+  */
+
+int grid_foreach_row(grid_s *grid, grid_span_visit func, void *data)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+  assert(func);
+
+  gin = _grid_get_internals(grid);
+  if (!gin || _grid_is_empty(gin)) return 0;
+
+    // Return "int"
+  return _grid_foreach_span(gin, func, data);
+}
+
+  /*!
+
+     @brief Located first cell in grid
+
+     Locates the first cell in the grid, and returns the payload data of
+     the origin cell.  The current grid cell is set to the origin cell.
+
+     @param grid    pointer to existing grid
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+void *grid_origin(grid_s *grid)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return NULL;
+
+  if (_grid_is_empty(gin)) return NULL;
+
+  _grid_set_cursor(gin, 0, 0);
+
+    // Return "void *"
+  return gin->storage->get(gin, 0, 0);
+}
+
+  /*!
+
+     @brief Locate current cell in grid
+
+     Returns the payload data of the current cell in a grid.
+
+     @param grid    pointer to existing grid
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+void *grid_current(grid_s *grid)
+{
+    // Sanity check parameters.
+  assert(grid);
+
+    // Return "void *"
+  return grid_get_cell(grid);
+}
+
+  /*!
+
+     @brief Locate the last (lower, right) cell in a grid
+
+     Locates the last cell in a grid.   The last cell is the lower, right
+     most cell in the grid.  Returns the payload data of that cell.  The
+     current grid cell is set to the last cell.
+
+     @param grid    pointer to existing cell
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+void *grid_end(grid_s *grid)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return NULL;
+
+  if (_grid_is_empty(gin)) return NULL;
+
+  _grid_set_cursor(gin,
+                   grid_size_get_height(gin->size) - 1,
+                   grid_size_get_width(gin->size) - 1);
+
+    // Return "void *"
+  return gin->storage->get(gin, gin->row, gin->col);
+}
+
+  /*!
+
+     @brief Move one cell to the left in a grid
+
+     Moves the current cell location in a grid one cell to the left.  Returns
+     the payload data of that cell.  If the current cell location is already
+     a the left most position, then no action is taken, and nothing is
+     returned.
+
+     @param grid    pointer to existing grid
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+void *grid_left(grid_s *grid)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return NULL;
+
+  if (_grid_is_empty(gin)) return NULL;
+
+  if (gin->col < 1) return NULL;
+
+  _grid_set_cursor(gin, gin->row, gin->col - 1);
+
+    // Return "void *"
+  return gin->storage->get(gin, gin->row, gin->col);
+}
+
+  /*!
+
+     @brief Move one cell to the right in a grid
+
+     Moves the current cell location in a grid one cell to the right.  Returns
+     the payload data of that cell.  If the current cell location is already
+     a the right most position, then no action is taken, and nothing is
+     returned.
+
+     @param grid    pointer to existing grid
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+void *grid_right(grid_s *grid)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return NULL;
+
+  if (_grid_is_empty(gin)) return NULL;
+
+  if (gin->col >= grid_size_get_width(gin->size) - 1) return NULL;
+
+  _grid_set_cursor(gin, gin->row, gin->col + 1);
+
+    // Return "void *"
+  return gin->storage->get(gin, gin->row, gin->col);
+}
+
+  /*!
+
+     @brief Move up one cell in a grid
+
+     Moves the current cell location in a grid up one cell.  Returns
+     the payload data of that cell.  If the current cell location is already
+     a the top most position, then no action is taken, and nothing is
+     returned.
+
+     @param grid    pointer to existing grid
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+void *grid_up(grid_s *grid)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return NULL;
+
+  if (_grid_is_empty(gin)) return NULL;
+
+  if (gin->row < 1) return NULL;
+
+  _grid_set_cursor(gin, gin->row - 1, gin->col);
+
+    // Return "void *"
+  return gin->storage->get(gin, gin->row, gin->col);
+}
+
+  /*!
+
+     @brief Move down one one cell in a grid
+
+     Moves the current cell location in a grid down one cell.  Returns
+     the payload data of that cell.  If the current cell location is already
+     a the bottom most position, then no action is taken, and nothing is
+     returned.
+
+     @param grid    pointer to existing grid
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+void *grid_down(grid_s *grid)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return NULL;
+
+  if (_grid_is_empty(gin)) return NULL;
+
+  if (gin->row >= grid_size_get_height(gin->size) - 1) return NULL;
+
+  _grid_set_cursor(gin, gin->row + 1, gin->col);
+
+    // Return "void *"
+  return gin->storage->get(gin, gin->row, gin->col);
+}
+
+  /*!
+
+     @brief Move to specific cell location in a grid
+
+     Moves current cell location in a grid to a specific row and column.  The
+     payload data of that cell is returned.  Locations outside the current
+     grid boundaries are clamped to the nearest edge of the grid.
+
+     NOTE:  Cell locations in a grid are based at 0, therefore the first
+            (origin) cell location is 0, 0.
+
+     NOTE:  With the dense storage engine this is a constant time operation.
+
+     @param grid    pointer to existing grid
+     @param row    row number of new cell location
+     @param col    column number of new cell location
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+void *grid_goto(grid_s *grid, int row, int col)
+{
+  _grid_internals *gin;
+  int height, width;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return NULL;
+
+  if (_grid_is_empty(gin)) return NULL;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+  if (row < 0) row = 0;
+  if (row > height - 1) row = height - 1;
+  if (col < 0) col = 0;
+  if (col > width - 1) col = width - 1;
+
+  _grid_set_cursor(gin, row, col);
+
+    // Return "void *"
+  return gin->storage->get(gin, row, col);
+}
+
+  /*!
+
+     @brief Create an independent cursor for a grid
+
+     Creates a cursor located at the origin cell of a grid.  A cursor has its
+     own location, and moving it, or reading through it, does not change the
+     grid or its current cell.
+
+     NOTE:  A cursor must be destroyed before its grid.  A cursor left outside
+            the grid after rows or columns are removed reads nothing until
+            it is moved back inside.
+
+     @param grid    pointer to existing grid
+
+     @retval "grid_cursor_s *" success
+     @retval NULL    failure
+
+  */
+
+grid_cursor_s *grid_cursor_create(grid_s *grid)
+{
+  grid_cursor_s *gc;
+  _grid_cursor_internals *ci;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gc = malloc(sizeof(grid_cursor_s));
+  if (!gc) return NULL;
+
+  ci = (void*)malloc(sizeof(_grid_cursor_internals));
+  if (!ci)
+  {
+    free(gc);
+    return NULL;
+  }
+  memset(ci, 0, sizeof(_grid_cursor_internals));
+  ci->grid = grid;
+
+  gc->_internals = ci;
+
+    // Return "grid_cursor_s *"
+  return gc;
+}
+
+  /*!
+
+     @brief Copy a grid cursor
+
+     Creates a new cursor for the same grid, at the same location.
+
+     @param gc    pointer to existing cursor
+
+     @retval "grid_cursor_s *" success
+     @retval NULL    failure
+
+  */
+
+grid_cursor_s *grid_cursor_copy(grid_cursor_s *gc)
+{
+  _grid_cursor_internals *ci;
+  grid_cursor_s *copy;
+
+    // Sanity check parameters.
+  assert(gc);
+
+  ci = _grid_cursor_get_internals(gc);
+  if (!ci) return NULL;
+
+  copy = grid_cursor_create(ci->grid);
+  if (!copy) return NULL;
+
+  memcpy(copy->_internals, ci, sizeof(_grid_cursor_internals));
+
+    // Return "grid_cursor_s *"
+  return copy;
+}
+
+  /*!
+
+     @brief Destroy a grid cursor
+
+     @param gc    pointer to existing cursor
+
+     @retval NONE
+
+  */
+
+void grid_cursor_destroy(grid_cursor_s *gc)
+{
+    // Sanity check parameters.
+  assert(gc);
+
+  free(gc->_internals);
+  free(gc);
+}
+
+  /*!
+
+     @brief Get location of a grid cursor
+
+     @param gc    pointer to existing cursor
+     @param row    pointer to storage for row of cursor
+     @param col    pointer to storage for column of cursor
+
+     @retval NONE
+
+  */
+
+void grid_cursor_get_location(grid_cursor_s *gc, int *row, int *col)
+{
+  _grid_cursor_internals *ci;
+
+    // Sanity check parameters.
+  assert(gc);
+  assert(row);
+  assert(col);
+
+  ci = _grid_cursor_get_internals(gc);
+  if (!ci) return;
+
+  *row = ci->pos.row;
+  *col = ci->pos.col;
+}
+
+  /*!
+
+     @brief Get payload data of cell at a grid cursor
+
+     @param gc    pointer to existing cursor
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+void *grid_cursor_get_cell(grid_cursor_s *gc)
+{
+  _grid_cursor_internals *ci;
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(gc);
+
+  ci = _grid_cursor_get_internals(gc);
+  if (!ci) return NULL;
+
+  gin = _grid_get_internals(ci->grid);
+  if (!gin) return NULL;
+
+  if (ci->pos.row >= grid_size_get_height(gin->size) ||
+      ci->pos.col >= grid_size_get_width(gin->size))
+    return NULL;
+
+    // Return "void *"
+  return _grid_seek(gin, &ci->pos, ci->pos.row, ci->pos.col);
+}
+
+  /*!
+
+     @brief Move a grid cursor to the first cell
+
+     @param gc    pointer to existing cursor
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+void *grid_cursor_origin(grid_cursor_s *gc)
+{
+    // Sanity check parameters.
+  assert(gc);
+
+    // Return "void *"
+  return grid_cursor_goto(gc, 0, 0);
+}
+
+  /*!
+
+     @brief Move a grid cursor one cell to the left
+
+     If the cursor is already at the left most position, then no action is
+     taken, and nothing is returned.
+
+     @param gc    pointer to existing cursor
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+void *grid_cursor_left(grid_cursor_s *gc)
+{
+  _grid_cursor_internals *ci;
+
+    // Sanity check parameters.
+  assert(gc);
+
+  ci = _grid_cursor_get_internals(gc);
+  if (!ci || ci->pos.col < 1) return NULL;
+
+    // Return "void *"
+  return grid_cursor_goto(gc, ci->pos.row, ci->pos.col - 1);
+}
+
+  /*!
+
+     @brief Move a grid cursor one cell to the right
+
+     If the cursor is already at the right most position, then no action is
+     taken, and nothing is returned.
+
+     @param gc    pointer to existing cursor
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+void *grid_cursor_right(grid_cursor_s *gc)
+{
+  _grid_cursor_internals *ci;
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(gc);
+
+  ci = _grid_cursor_get_internals(gc);
+  if (!ci) return NULL;
+
+  gin = _grid_get_internals(ci->grid);
+  if (!gin) return NULL;
+
+  if (ci->pos.col >= grid_size_get_width(gin->size) - 1) return NULL;
+
+    // Return "void *"
+  return grid_cursor_goto(gc, ci->pos.row, ci->pos.col + 1);
+}
+
+  /*!
+
+     @brief Move a grid cursor one cell up
+
+     If the cursor is already at the top most position, then no action is
+     taken, and nothing is returned.
+
+     @param gc    pointer to existing cursor
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+void *grid_cursor_up(grid_cursor_s *gc)
+{
+  _grid_cursor_internals *ci;
+
+    // Sanity check parameters.
+  assert(gc);
+
+  ci = _grid_cursor_get_internals(gc);
+  if (!ci || ci->pos.row < 1) return NULL;
+
+    // Return "void *"
+  return grid_cursor_goto(gc, ci->pos.row - 1, ci->pos.col);
+}
+
+  /*!
+
+     @brief Move a grid cursor one cell down
+
+     If the cursor is already at the bottom most position, then no action is
+     taken, and nothing is returned.
+
+     @param gc    pointer to existing cursor
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+void *grid_cursor_down(grid_cursor_s *gc)
+{
+  _grid_cursor_internals *ci;
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(gc);
+
+  ci = _grid_cursor_get_internals(gc);
+  if (!ci) return NULL;
+
+  gin = _grid_get_internals(ci->grid);
+  if (!gin) return NULL;
+
+  if (ci->pos.row >= grid_size_get_height(gin->size) - 1) return NULL;
+
+    // Return "void *"
+  return grid_cursor_goto(gc, ci->pos.row + 1, ci->pos.col);
+}
+
+  /*!
+
+     @brief Move a grid cursor to a specific cell
+
+     Moves a cursor to a cell, limiting the row and column to the size of the
+     grid, and returns the payload data of that cell.
+
+     @param gc    pointer to existing cursor
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+void *grid_cursor_goto(grid_cursor_s *gc, int row, int col)
+{
+  _grid_cursor_internals *ci;
+  _grid_internals *gin;
+  int height, width;
+
+    // Sanity check parameters.
+  assert(gc);
+
+  ci = _grid_cursor_get_internals(gc);
+  if (!ci) return NULL;
+
+  gin = _grid_get_internals(ci->grid);
+  if (!gin || _grid_is_empty(gin)) return NULL;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+  if (row < 0) row = 0;
+  if (row > height - 1) row = height - 1;
+  if (col < 0) col = 0;
+  if (col > width - 1) col = width - 1;
+
+    // Return "void *"
+  return _grid_seek(gin, &ci->pos, row, col);
+}
+
+// STATIC functions
+
+  /*!
+
+     @brief INTERNAL: Get payload data destructor function
+
+     Returns the previously assigned payload data destructor.
+
+     @param grid    pointer to existing grid
+
+     @retval "grid_payload_free *" success
+
+  */
+
+static grid_payload_free _grid_get_pl_free(grid_s *grid)
+{
+  _grid_internals *gin;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return NULL;
+
+    // Return "grid_payload_free *"
+  return gin->grid_pl_free;
+}
+
+  /*!
+
+     @brief INTERNAL:  Get grid internals structure
+
+     Returns the internals structure associated with a grid
+
+     @param grid    pointer to existing grid
+
+     @retval "_grid_internals *" success
+
+  */
+
+static _grid_internals *_grid_get_internals(grid_s *grid)
+{
+    // Sanity check parameters.
+  assert(grid);
+    // Return "_grid_internals *"
+  return (_grid_internals *)grid->_internals;
+}
+
+  /*!
+
+     @brief INTERNAL:  Get storage engine operations
+
+     Returns the operations table for a storage engine type.
+
+     @param storage    storage engine type
+
+     @retval "_grid_storage *" success
+     @retval NULL    failure
+
+  */
+
+static const _grid_storage *_grid_get_storage(grid_storage_t storage)
+{
+  int n;
+
+  n = sizeof(_grid_storages) / sizeof(_grid_storages[0]);
+  if ((int)storage < 0 || (int)storage >= n) return NULL;
+
+    // Return "_grid_storage *"
+  return &_grid_storages[storage];
+}
+
+  /*!
+
+     @brief INTERNAL:  Test for grid without cells
+
+     @param gin    pointer to grid internals
+
+     @retval 1    grid has no cells
+     @retval 0    grid has cells
+
+  */
+
+static int _grid_is_empty(_grid_internals *gin)
+{
+    // Sanity check parameters.
+  assert(gin);
+    // Return "int"
+  return (grid_size_get_height(gin->size) < 1) ||
+         (grid_size_get_width(gin->size) < 1);
+}
+
+  /*!
+
+     @brief INTERNAL:  Test for grid that may not be changed
+
+     @param gin    pointer to grid internals
+
+     @retval 1    grid is a snapshot, a view or a mapped grid
+     @retval 0    grid may be changed
+
+  */
+
+static int _grid_is_read_only(_grid_internals *gin)
+{
+    // Sanity check parameters.
+  assert(gin);
+    // Return "int"
+  return (gin->epoch ||
+          gin->storage->type == grid_storage_view ||
+          gin->storage->type == grid_storage_mapped) ? 1 : 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Set current cell location
+
+     Sets the current cell coordinates, and the public location vertex.
+
+     @param gin    pointer to grid internals
+     @param row    row of new current cell
+     @param col    column of new current cell
+
+     @retval NONE
+
+  */
+
+static void _grid_set_cursor(_grid_internals *gin, int row, int col)
+{
+    // Sanity check parameters.
+  assert(gin);
+
+  gin->row = row;
+  gin->col = col;
+  vertex_set_y(gin->location, row);
+  vertex_set_x(gin->location, col);
+}
+
+  /*!
+
+     @brief INTERNAL:  Change size of grid
+
+     Changes the number of rows and columns of a grid, truncating or
+     extending at the bottom and right edges.  A grid with no rows or no
+     columns has no cells at all.  When the grid shrinks, or was empty, the
+     current cell is set to the origin.  If the grid can not grow, it is left
+     truncated to the requested size.
+
+     @param grid    pointer to existing grid
+     @param rows    new number of rows
+     @param cols    new number of columns
+     @param fpl    pointer to payload destructor for truncated cells, or NULL
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_resize(grid_s *grid, int rows, int cols,
+                        grid_payload_free fpl)
+{
+  _grid_internals *gin;
+  int height, width;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return -1;
+
+  if (rows < 1 || cols < 1) rows = cols = 0;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+  if (rows == height && cols == width) return 0;
+
+  if (_grid_is_read_only(gin)) return -1;
+
+  if (_grid_own(gin, 0, 0, 0, 0) ||
+      (rows < height && _grid_own(gin, rows, 0, height - rows, width)) ||
+      (cols < width && _grid_own(gin, 0, cols, height, width - cols)) ||
+      (rows > height && _grid_own(gin, height - 1, 0, 1, width)))
+    return -1;
+
+  if (fpl && (gin->snapshots || gin->reclaim))
+  {
+    if (!rows)
+      _grid_retire_range(gin, 0, 0, height, width, fpl);
+    else
+    {
+      _grid_retire_range(gin, rows, 0, height - rows, width, fpl);
+      _grid_retire_range(gin, 0, cols, rows, width - cols, fpl);
+    }
+    fpl = NULL;
+  }
+
+  ++gin->generation;
+
+  if (gin->index) _grid_index_truncate(gin, rows, cols);
+
+  if (gin->storage->resize(gin, rows, cols, fpl))
+  {
+      // Storage engines keep the truncated part of the grid on failure
+    if (rows > height) rows = height;
+    if (cols > width) cols = width;
+    if (rows < 1 || cols < 1) rows = cols = 0;
+    grid_size_set(gin->size, cols, rows);
+    _grid_set_cursor(gin, 0, 0);
+    _grid_notify(gin, grid_change_size, rows, cols, 0);
+    return -1;
+  }
+
+  if (gin->index &&
+      _grid_index_extend(gin,
+                         (rows < height) ? rows : height,
+                         (cols < width) ? cols : width,
+                         rows,
+                         cols))
+    _grid_index_destroy(gin);
+
+  grid_size_set(gin->size, cols, rows);
+
+  if (rows < height || cols < width || !height)
+    _grid_set_cursor(gin, 0, 0);
+
+  _grid_notify(gin, grid_change_size, rows, cols, 0);
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Insert empty rows
+
+     Inserts empty rows before a row.  A negative row appends the new rows
+     after the current last row.  If the row is greater than the number of
+     rows, nothing is done.  Inserting before the first row moves the current
+     cell to the origin, otherwise the current cell remains the same cell.
+
+     @param grid    pointer to existing grid
+     @param row    row before which to insert
+     @param count    number of rows to insert
+
+     @retval NONE
+
+  */
+
+static void _grid_insert_rows(grid_s *grid, int row, int count)
+{
+  _grid_internals *gin;
+  int height, width;
+  int n;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+  if (_grid_is_read_only(gin) || row > height || count < 1) return;
+  if (row < 0) row = height;
+
+    // An empty grid becomes a single column
+  if (!height)
+  {
+    _grid_resize(grid, count, (width < 1) ? 1 : width, NULL);
+    return;
+  }
+
+  if (_grid_own(gin, row - 1, 0, 2, width)) return;
+
+  ++gin->generation;
+
+  n = gin->storage->insert_rows(gin, row, count);
+  if (n < 1) return;
+
+  if (gin->index && _grid_axis_insert(&gin->index->rows, row, n, height))
+    _grid_index_destroy(gin);
+
+  grid_size_set_height(gin->size, height + n);
+
+  if (!row)
+    _grid_set_cursor(gin, 0, 0);
+  else if (gin->row >= row)
+    _grid_set_cursor(gin, gin->row + n, gin->col);
+
+  _grid_notify(gin, grid_change_insert_rows, row, 0, n);
+}
+
+  /*!
+
+     @brief INTERNAL:  Insert empty columns
+
+     Inserts empty columns before a column.  A negative column appends the
+     new columns after the current last column.  If the column is greater than
+     the number of columns, nothing is done.  Inserting before the first
+     column moves the current cell to the origin, otherwise the current cell
+     remains the same cell.
+
+     @param grid    pointer to existing grid
+     @param col    column before which to insert
+     @param count    number of columns to insert
+
+     @retval NONE
+
+  */
+
+static void _grid_insert_columns(grid_s *grid, int col, int count)
+{
+  _grid_internals *gin;
+  int height, width;
+  int n;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+  if (_grid_is_read_only(gin) || col > width || count < 1) return;
+  if (col < 0) col = width;
+
+    // An empty grid becomes a single row
+  if (!width)
+  {
+    _grid_resize(grid, (height < 1) ? 1 : height, count, NULL);
+    return;
+  }
+
+  if (_grid_own(gin, 0, col, height, width - col)) return;
+
+  ++gin->generation;
+
+  n = gin->storage->insert_columns(gin, col, count);
+  if (n < 1) return;
+
+  if (gin->index && _grid_axis_insert(&gin->index->cols, col, n, width))
+    _grid_index_destroy(gin);
+
+  grid_size_set_width(gin->size, width + n);
+
+  if (!col)
+    _grid_set_cursor(gin, 0, 0);
+  else if (gin->col >= col)
+    _grid_set_cursor(gin, gin->row, gin->col + n);
+
+  _grid_notify(gin, grid_change_insert_columns, 0, col, n);
+}
+
+  /*!
+
+     @brief INTERNAL:  Remove rows
+
+     Removes rows starting at a row, clipped to the end of the grid.  Removing
+     every row leaves a grid with no cells.  The current cell is set to the
+     origin.
+
+     @param grid    pointer to existing grid
+     @param row    first row to remove
+     @param count    number of rows to remove
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _grid_remove_rows(grid_s *grid, int row, int count,
+                              grid_payload_free fpl)
+{
+  _grid_internals *gin;
+  int height;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return;
+
+  height = grid_size_get_height(gin->size);
+
+  if (_grid_is_read_only(gin) || row < 0 || row >= height || count < 1)
+    return;
+  if (count > height - row) count = height - row;
+
+  if (count == height)
+  {
+    _grid_resize(grid, 0, 0, fpl);
+    return;
+  }
+
+  if (_grid_own(gin, row, 0, count, grid_size_get_width(gin->size))) return;
+
+  if (fpl && (gin->snapshots || gin->reclaim))
+  {
+    _grid_retire_range(gin, row, 0, count, grid_size_get_width(gin->size),
+                       fpl);
+    fpl = NULL;
+  }
+
+  ++gin->generation;
+
+  if (gin->index)
+  {
+    _grid_index_drop(gin, row, count, 0, grid_size_get_width(gin->size));
+    _grid_axis_remove(&gin->index->rows, row, count, height);
+  }
+
+  gin->storage->remove_rows(gin, row, count, fpl);
+
+  grid_size_set_height(gin->size, height - count);
+  _grid_set_cursor(gin, 0, 0);
+
+  _grid_notify(gin, grid_change_remove_rows, row, 0, count);
+}
+
+  /*!
+
+     @brief INTERNAL:  Remove columns
+
+     Removes columns starting at a column, clipped to the end of the grid.
+     Removing every column leaves a grid with no cells.  The current cell is
+     set to the origin.
+
+     @param grid    pointer to existing grid
+     @param col    first column to remove
+     @param count    number of columns to remove
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _grid_remove_columns(grid_s *grid, int col, int count,
+                                 grid_payload_free fpl)
+{
+  _grid_internals *gin;
+  int width;
+
+    // Sanity check parameters.
+  assert(grid);
+
+  gin = _grid_get_internals(grid);
+  if (!gin) return;
+
+  width = grid_size_get_width(gin->size);
+
+  if (_grid_is_read_only(gin) || col < 0 || col >= width || count < 1)
+    return;
+  if (count > width - col) count = width - col;
+
+  if (count == width)
+  {
+    _grid_resize(grid, 0, 0, fpl);
+    return;
+  }
+
+  if (_grid_own(gin, 0, col, grid_size_get_height(gin->size), width - col))
+    return;
+
+  if (fpl && (gin->snapshots || gin->reclaim))
+  {
+    _grid_retire_range(gin, 0, col, grid_size_get_height(gin->size), count,
+                       fpl);
+    fpl = NULL;
+  }
+
+  ++gin->generation;
+
+  if (gin->index)
+  {
+    _grid_index_drop(gin, 0, grid_size_get_height(gin->size), col, count);
+    _grid_axis_remove(&gin->index->cols, col, count, width);
+  }
+
+  gin->storage->remove_columns(gin, col, count, fpl);
+
+  grid_size_set_width(gin->size, width - count);
+  _grid_set_cursor(gin, 0, 0);
+
+  _grid_notify(gin, grid_change_remove_columns, 0, col, count);
+}
+
+  /*!
+
+     @brief INTERNAL:  Find a cell by reference
+
+     Locates a cell in a grid based on a reference pointer value, scanning
+     in row-major order.
+
+     NOTE:  This function does the actual work of finding a cell by
+            reference.  The public API function above is a wrapper around
+            this function.
+
+     @param grid    pointer to existing grid
+     @param pl    pointer to payload data that may exist in grid
+     @param row    pointer to storage for row of found cell
+     @param col    pointer to storage for column of found cell
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+static void *_grid_find_by_reference(grid_s *grid, void *pl,
+                                     int *row, int *col)
+{
+  _grid_internals *gin;
+  _grid_search search;
+
+    // Sanity check parameters.
+  assert(grid);
+  assert(pl);
+  assert(row);
+  assert(col);
+
+  gin = _grid_get_internals(grid);
+  if (!gin || _grid_is_empty(gin)) return NULL;
+
+  if (gin->index)
+    switch (_grid_index_lookup(gin, pl, row, col))
+    {
+      case 0:
+        return NULL;
+      case 1:
+        return pl;
+    }
+
+  memset(&search, 0, sizeof(_grid_search));
+  search.pl = pl;
+
+  if (!_grid_foreach_span(gin, _grid_search_span, &search)) return NULL;
+
+  *row = search.row;
+  *col = search.col;
+
+  if (gin->index) _grid_index_note(gin, pl, *row, *col);
+
+    // Return "void *"
+  return search.found;
+}
+
+  /*!
+
+     @brief INTERNAL:  Find a cell by value
+
+     Locates a cell in a grid by value, scanning in row-major order.
+
+     NOTE:  A user defined cell compare function must be supplied.
+
+     NOTE:  This function does the actual work of finding a cell by
+            value.  The public API function above is a wrapper around
+            this function.
+
+     @param grid    pointer to existing grid
+     @param pl    pointer to payload data that may exist in grid
+     @param cf    pointer to function to compare cell values
+     @param row    pointer to storage for row of found cell
+     @param col    pointer to storage for column of found cell
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+static void *_grid_find_by_value(grid_s *grid,
+                                 void *pl,
+                                 grid_payload_compare cf,
+                                 int *row, int *col)
+{
+  _grid_internals *gin;
+  _grid_search search;
+
+    // Sanity check parameters.
+  assert(grid);
+  assert(pl);
+  assert(cf);
+  assert(row);
+  assert(col);
+
+  gin = _grid_get_internals(grid);
+  if (!gin || _grid_is_empty(gin)) return NULL;
+
+  memset(&search, 0, sizeof(_grid_search));
+  search.pl = pl;
+  search.cf = cf;
+
+  if (!_grid_foreach_span(gin, _grid_search_span, &search)) return NULL;
+
+  *row = search.row;
+  *col = search.col;
+
+    // Return "void *"
+  return search.found;
+}
+
+  /*!
+
+     @brief INTERNAL:  Visit every row of a grid, a span of cells at a time
+
+     @param gin    pointer to grid internals
+     @param func    pointer to function to call for each span
+     @param data    pointer to user data passed to func
+
+     @retval 0    every cell visited
+     @retval "int" non-zero value returned by func
+
+  */
+
+static int _grid_foreach_span(_grid_internals *gin,
+                              grid_span_visit func,
+                              void *data)
+{
+  _grid_position pos;
+  void *buf[SPAN_CELLS];
+  void **p;
+  int height, width;
+  int y, x, n;
+  int rc;
+
+    // Sanity check parameters.
+  assert(gin);
+  assert(func);
+
+  memset(&pos, 0, sizeof(_grid_position));
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+  for (y = 0; y < height; ++y)
+    for (x = 0; x < width; x += n)
+    {
+      p = gin->storage->span(gin, &pos, y, x, &n, buf, SPAN_CELLS);
+      rc = func(p, y, x, n, data);
+      if (rc) return rc;
+    }
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Search a span of cells
+
+     @param payloads    pointer to payload data of span
+     @param row    row of span
+     @param col    first column of span
+     @param count    number of cells in span
+     @param data    pointer to search details
+
+     @retval 0    cell not found in span
+     @retval 1    cell found
+
+  */
+
+static int _grid_search_span(void * const *payloads, int row, int col,
+                             int count, void *data)
+{
+  _grid_search *search;
+  int i;
+
+    // Sanity check parameters.
+  assert(payloads);
+  assert(data);
+
+  search = (_grid_search *)data;
+
+  for (i = 0; i < count; ++i)
+  {
+    if (search->cf)
+    {
+      if (search->cf(payloads[i], search->pl)) continue;
+    }
+    else if (payloads[i] != search->pl)
+      continue;
+
+    search->found = payloads[i];
+    search->row = row;
+    search->col = col + i;
+      // Return "int"
+    return 1;
+  }
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Visit each cell of a span
+
+     @param payloads    pointer to payload data of span
+     @param row    row of span
+     @param col    first column of span
+     @param count    number of cells in span
+     @param data    pointer to cell iteration details
+
+     @retval 0    continue iteration
+     @retval "int" non-zero value returned by user function
+
+  */
+
+static int _grid_visit_span(void * const *payloads, int row, int col,
+                            int count, void *data)
+{
+  _grid_visit *visit;
+  int i;
+  int rc;
+
+    // Sanity check parameters.
+  assert(payloads);
+  assert(data);
+
+  visit = (_grid_visit *)data;
+
+  for (i = 0; i < count; ++i)
+  {
+    rc = visit->func(payloads[i], row, col + i, visit->data);
+    if (rc) return rc;
+  }
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Search bands of rows of a grid on a thread pool
+
+     Splits the rows of the grid into bands, and searches every band.  On
+     success, the caller must free the cells of each band, and the bands.
+
+     @param gin    pointer to grid internals
+     @param find    pointer to search details, with pl, cf and all set
+     @param pool    pointer to existing thread pool, or NULL
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_find_parallel(_grid_internals *gin, _grid_find *find,
+                               thread_pool_s *pool)
+{
+  int height;
+  int b;
+
+    // Sanity check parameters.
+  assert(gin);
+  assert(find);
+
+  height = grid_size_get_height(gin->size);
+
+    // A few bands per thread, so that early matches stop work sooner
+  find->nbands = 4 * (thread_pool_get_size(pool) + 1);
+  if (find->nbands > height) find->nbands = height;
+  find->rows = (height + find->nbands - 1) / find->nbands;
+  find->nbands = (height + find->rows - 1) / find->rows;
+
+  find->gin = gin;
+  atomic_init(&find->first, find->nbands);
+
+  find->bands = (_grid_band *)calloc((size_t)find->nbands, sizeof(_grid_band));
+  if (!find->bands) return -1;
+
+  thread_pool_run(pool, find->nbands, _grid_find_band, find);
+
+  for (b = 0; b < find->nbands; ++b)
+    if (find->bands[b].failed) break;
+
+  if (b < find->nbands)
+  {
+    for (b = 0; b < find->nbands; ++b) free(find->bands[b].cells);
+    free(find->bands);
+    return -1;
+  }
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Search one band of rows of a grid
+
+     Thread pool job function.  When finding the first match only, the band
+     stops at its own first match, or once a lower band has found a match.
+
+     @param index    index of band
+     @param data    pointer to search details
+
+     @retval NONE
+
+  */
+
+static void _grid_find_band(int index, void *data)
+{
+  _grid_find *find;
+  _grid_internals *gin;
+  _grid_band *band;
+  _grid_position pos;
+  void *buf[SPAN_CELLS];
+  void **p;
+  int height, width;
+  int y, x, n, i;
+  int first;
+
+    // Sanity check parameters.
+  assert(data);
+
+  find = (_grid_find *)data;
+  gin = find->gin;
+  band = &find->bands[index];
+
+  memset(&pos, 0, sizeof(_grid_position));
+
+  height = index * find->rows + find->rows;
+  if (height > grid_size_get_height(gin->size))
+    height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+  for (y = index * find->rows; y < height; ++y)
+  {
+    if (!find->all && atomic_load(&find->first) < index) return;
+
+    for (x = 0; x < width; x += n)
+    {
+      p = gin->storage->span(gin, &pos, y, x, &n, buf, SPAN_CELLS);
+
+      for (i = 0; i < n; ++i)
+      {
+        if (find->cf(p[i], find->pl)) continue;
+
+        if (_grid_band_add(band, y, x + i)) return;
+
+        if (find->all) continue;
+
+        band->found = p[i];
+
+        first = atomic_load(&find->first);
+        while (index < first &&
+               !atomic_compare_exchange_weak(&find->first, &first, index)) ;
+        return;
+      }
+    }
+  }
+}
+
+  /*!
+
+     @brief INTERNAL:  Add location of a found cell to a band
+
+     @param band    pointer to band results
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval 0    success
+     @retval -1    failure, band marked as failed
+
+  */
+
+static int _grid_band_add(_grid_band *band, int row, int col)
+{
+  int *cells;
+  int cap;
+
+    // Sanity check parameters.
+  assert(band);
+
+  if (band->count == band->cap)
+  {
+    cap = (band->cap) ? 2 * band->cap : 16;
+    cells = (int *)realloc(band->cells, 2 * (size_t)cap * sizeof(int));
+    if (!cells)
+    {
+      band->failed = 1;
+      return -1;
+    }
+    band->cells = cells;
+    band->cap = cap;
+  }
+
+  band->cells[2 * band->count] = row;
+  band->cells[2 * band->count + 1] = col;
+  ++band->count;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Get first row of a sorted run
+
+     @param sort    pointer to row sort details
+     @param run    index of run, runs past the last one start after the grid
+
+     @retval "int" first row of run
+
+  */
+
+static int _grid_sort_bound(_grid_sort *sort, int run)
+{
+    // Sanity check parameters.
+  assert(sort);
+
+  if (run >= sort->nruns) return sort->rows;
+
+    // Return "int"
+  return (int)((long long)run * sort->rows / sort->nruns);
+}
+
+  /*!
+
+     @brief INTERNAL:  Compare two rows by their key columns
+
+     @param sort    pointer to row sort details
+     @param a    first row
+     @param b    second row
+
+     @retval "int" negative, zero or positive as row a sorts before, with or
+                   after row b
+
+  */
+
+static int _grid_sort_compare(_grid_sort *sort, int a, int b)
+{
+  void **ka, **kb;
+  int k, rc;
+
+    // Sanity check parameters.
+  assert(sort);
+
+  ka = sort->kv + (size_t)a * sort->nkeys;
+  kb = sort->kv + (size_t)b * sort->nkeys;
+
+  for (k = 0; k < sort->nkeys; ++k)
+  {
+    if (!ka[k] || !kb[k])
+    {
+      if (ka[k] != kb[k]) return (ka[k]) ? -1 : 1;
+      continue;
+    }
+
+    rc = sort->cf(ka[k], kb[k]);
+    if (rc) return rc;
+  }
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Sort one run of rows of a grid
+
+     Thread pool job function.  Collects the payload data of the key columns
+     of the rows of the run, then sorts the run.
+
+     @param index    index of run
+     @param data    pointer to row sort details
+
+     @retval NONE
+
+  */
+
+static void _grid_sort_run(int index, void *data)
+{
+  _grid_sort *sort;
+  _grid_position pos;
+  int lo, hi;
+  int y, k;
+
+    // Sanity check parameters.
+  assert(data);
+
+  sort = (_grid_sort *)data;
+
+  lo = _grid_sort_bound(sort, index);
+  hi = _grid_sort_bound(sort, index + 1);
+
+  for (k = 0; k < sort->nkeys; ++k)
+  {
+    memset(&pos, 0, sizeof(_grid_position));
+    for (y = lo; y < hi; ++y)
+      sort->kv[(size_t)y * sort->nkeys + k] =
+        _grid_seek(sort->gin, &pos, y, sort->keys[k]);
+  }
+
+  for (y = lo; y < hi; ++y) sort->perm[y] = y;
+
+  _grid_sort_range(sort, lo, hi);
+}
+
+  /*!
+
+     @brief INTERNAL:  Merge a pair of sorted runs of rows
+
+     Thread pool job function.  Each round merges pairs of runs, each made
+     of width runs already merged by the previous rounds.
+
+     @param index    index of pair
+     @param data    pointer to row sort details
+
+     @retval NONE
+
+  */
+
+static void _grid_sort_pair(int index, void *data)
+{
+  _grid_sort *sort;
+  int lo, mid, hi;
+
+    // Sanity check parameters.
+  assert(data);
+
+  sort = (_grid_sort *)data;
+
+  lo = _grid_sort_bound(sort, 2 * index * sort->width);
+  mid = _grid_sort_bound(sort, (2 * index + 1) * sort->width);
+  hi = _grid_sort_bound(sort, (2 * index + 2) * sort->width);
+
+  if (mid < hi) _grid_sort_merge(sort, lo, mid, hi);
+}
+
+  /*!
+
+     @brief INTERNAL:  Merge sort a range of sorted rows
+
+     Short ranges are sorted by insertion.
+
+     @param sort    pointer to row sort details
+     @param lo    first index of range
+     @param hi    index past the end of range
+
+     @retval NONE
+
+  */
+
+static void _grid_sort_range(_grid_sort *sort, int lo, int hi)
+{
+  int mid;
+  int i, j, r;
+
+    // Sanity check parameters.
+  assert(sort);
+
+  if (hi - lo <= 16)
+  {
+    for (i = lo + 1; i < hi; ++i)
+    {
+      r = sort->perm[i];
+      for (j = i; j > lo && _grid_sort_compare(sort, sort->perm[j - 1], r) > 0;
+           --j)
+        sort->perm[j] = sort->perm[j - 1];
+      sort->perm[j] = r;
+    }
+    return;
+  }
+
+  mid = lo + (hi - lo) / 2;
+
+  _grid_sort_range(sort, lo, mid);
+  _grid_sort_range(sort, mid, hi);
+  _grid_sort_merge(sort, lo, mid, hi);
+}
+
+  /*!
+
+     @brief INTERNAL:  Merge two adjacent sorted ranges of rows
+
+     Rows of the first range are taken first when rows compare equal, so
+     that the merge is stable.
+
+     @param sort    pointer to row sort details
+     @param lo    first index of first range
+     @param mid    first index of second range
+     @param hi    index past the end of second range
+
+     @retval NONE
+
+  */
+
+static void _grid_sort_merge(_grid_sort *sort, int lo, int mid, int hi)
+{
+  int *src;
+  int i, j, k;
+
+    // Sanity check parameters.
+  assert(sort);
+
+    // Already in order
+  if (_grid_sort_compare(sort, sort->perm[mid - 1], sort->perm[mid]) <= 0)
+    return;
+
+  src = sort->tmp;
+  memcpy(src + lo, sort->perm + lo, (size_t)(hi - lo) * sizeof(int));
+
+  i = lo;
+  j = mid;
+  k = lo;
+
+  while (i < mid && j < hi)
+  {
+    if (_grid_sort_compare(sort, src[j], src[i]) < 0)
+      sort->perm[k++] = src[j++];
+    else
+      sort->perm[k++] = src[i++];
+  }
+
+  while (i < mid) sort->perm[k++] = src[i++];
+  while (j < hi) sort->perm[k++] = src[j++];
+}
+
+  /*!
+
+     @brief INTERNAL:  Get payload data of cell from a position
+
+     Uses the storage engine seek operation when there is one, so that the
+     walk to the cell may resume from the position.  The position is moved
+     to the cell.
+
+     @param gin    pointer to grid internals
+     @param pos    pointer to position
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval "void *" success
+     @retval NULL    cell is empty
+
+  */
+
+static void *_grid_seek(_grid_internals *gin, _grid_position *pos,
+                        int row, int col)
+{
+    // Sanity check parameters.
+  assert(gin);
+  assert(pos);
+
+  if (gin->storage->seek)
+      // Return "void *"
+    return gin->storage->seek(gin, pos, row, col);
+
+  pos->row = row;
+  pos->col = col;
+
+    // Return "void *"
+  return gin->storage->get(gin, row, col);
+}
+
+  /*!
+
+     @brief INTERNAL:  Get grid cursor internals
+
+     @param gc    pointer to existing cursor
+
+     @retval "_grid_cursor_internals *" success
+     @retval NULL    failure
+
+  */
+
+static _grid_cursor_internals *_grid_cursor_get_internals(grid_cursor_s *gc)
+{
+    // Sanity check parameters.
+  assert(gc);
+
+    // Return "_grid_cursor_internals *"
+  return (_grid_cursor_internals *)gc->_internals;
+}
+
+// STATIC functions: row and column id tables
+
+  /*!
+
+     @brief INTERNAL:  Insert new ids into a row or column id table
+
+     Recycled ids are used first.  An id is only recycled after every cell
+     using it has been removed.
+
+     @param axis    pointer to row or column id table
+     @param at    index before which to insert
+     @param count    number of ids to insert
+     @param len    current number of ids in table
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_axis_insert(_grid_axis *axis, int at, int count, int len)
+{
+  int *p;
+  int n;
+  int i;
+
+    // Sanity check parameters.
+  assert(axis);
+
+  if (len + count > axis->cap)
+  {
+    n = (len + count > axis->cap * 2) ? len + count : axis->cap * 2;
+
+    p = (int *)realloc(axis->ids, (size_t)n * sizeof(int));
+    if (!p) return -1;
+    axis->ids = p;
+
+    p = (int *)realloc(axis->pos, (size_t)n * sizeof(int));
+    if (!p) return -1;
+    axis->pos = p;
+
+    p = (int *)realloc(axis->spare, (size_t)n * sizeof(int));
+    if (!p) return -1;
+    axis->spare = p;
+
+    axis->cap = n;
+  }
+
+  memmove(axis->ids + at + count,
+          axis->ids + at,
+          (size_t)(len - at) * sizeof(int));
+
+  for (i = at; i < at + count; ++i)
+    axis->ids[i] = (axis->nspare) ? axis->spare[--axis->nspare] : axis->next++;
+
+  for (i = at; i < len + count; ++i)
+    axis->pos[axis->ids[i]] = i;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Remove ids from a row or column id table
+
+     @param axis    pointer to row or column id table
+     @param at    index of first id to remove
+     @param count    number of ids to remove
+     @param len    current number of ids in table
+
+     @retval NONE
+
+  */
+
+static void _grid_axis_remove(_grid_axis *axis, int at, int count, int len)
+{
+  int i;
+
+    // Sanity check parameters.
+  assert(axis);
+
+  for (i = at; i < at + count; ++i)
+  {
+    axis->pos[axis->ids[i]] = -1;
+    axis->spare[axis->nspare++] = axis->ids[i];
+  }
+
+  memmove(axis->ids + at,
+          axis->ids + at + count,
+          (size_t)(len - at - count) * sizeof(int));
+
+  for (i = at; i < len - count; ++i)
+    axis->pos[axis->ids[i]] = i;
+}
+
+  /*!
+
+     @brief INTERNAL:  De-allocate a row or column id table
+
+     @param axis    pointer to row or column id table
+
+     @retval NONE
+
+  */
+
+static void _grid_axis_free(_grid_axis *axis)
+{
+    // Sanity check parameters.
+  assert(axis);
+
+  free(axis->ids);
+  free(axis->pos);
+  free(axis->spare);
+
+  memset(axis, 0, sizeof(_grid_axis));
+}
+
+  /*!
+
+     @brief INTERNAL:  Reorder a row or column id table
+
+     Position i takes the id of position perm[i].
+
+     @param axis    pointer to row or column id table
+     @param perm    pointer to permutation, one entry per id
+     @param len    current number of ids in table
+
+     @retval 0    success
+     @retval -1    failure, nothing changed
+
+  */
+
+static int _grid_axis_permute(_grid_axis *axis, const int *perm, int len)
+{
+  int *ids;
+  int i;
+
+    // Sanity check parameters.
+  assert(axis);
+  assert(perm);
+
+  ids = (int *)malloc((size_t)len * sizeof(int));
+  if (!ids) return -1;
+
+  for (i = 0; i < len; ++i)
+    ids[i] = axis->ids[perm[i]];
+
+  memcpy(axis->ids, ids, (size_t)len * sizeof(int));
+  free(ids);
+
+  for (i = 0; i < len; ++i)
+    axis->pos[axis->ids[i]] = i;
+
+    // Return "int"
+  return 0;
+}
+
+// STATIC functions: snapshots
+
+  /*!
+
+     @brief INTERNAL:  Copy cells of a grid into a new snapshot
+
+     Used for storage engines that can not share their storage.  The payload
+     pointers of every cell are copied into a dense store.
+
+     @param gin    pointer to grid internals
+     @param sin    pointer to snapshot internals, with empty size
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_snapshot_copy(_grid_internals *gin, _grid_internals *sin)
+{
+  _grid_position pos;
+  void *buf[SPAN_CELLS];
+  void **p;
+  int height, width;
+  int y, x, n, i;
+
+    // Sanity check parameters.
+  assert(gin);
+  assert(sin);
+
+  sin->storage = _grid_get_storage(grid_storage_dense);
+  if (sin->storage->init(sin)) return -1;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+  if (!height || !width) return 0;
+
+  if (sin->storage->resize(sin, height, width, NULL)) return -1;
+  grid_size_set(sin->size, width, height);
+
+  memset(&pos, 0, sizeof(_grid_position));
+
+  for (y = 0; y < height; ++y)
+    for (x = 0; x < width; x += n)
+    {
+      p = gin->storage->span(gin, &pos, y, x, &n, buf, SPAN_CELLS);
+      for (i = 0; i < n; ++i)
+        if (p[i]) sin->storage->set(sin, y, x + i, p[i]);
+    }
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Register a new snapshot of a grid
+
+     A snapshot of a snapshot shares the epoch of the snapshot it was taken
+     from, since it holds the same cells.
+
+     @param gin    pointer to grid internals
+     @param sin    pointer to snapshot internals
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_snapshots_join(_grid_internals *gin, _grid_internals *sin)
+{
+  _grid_snapshots *gs;
+  unsigned int *live;
+  int n, i;
+
+    // Sanity check parameters.
+  assert(gin);
+  assert(sin);
+
+  if (!gin->snapshots)
+  {
+    gs = (_grid_snapshots *)calloc(1, sizeof(_grid_snapshots));
+    if (!gs) return -1;
+    pthread_mutex_init(&gs->lock, NULL);
+    gs->refs = 1;
+    gin->snapshots = gs;
+  }
+
+  gs = gin->snapshots;
+
+  pthread_mutex_lock(&gs->lock);
+
+  if (gs->nlive == gs->lcap)
+  {
+    n = (gs->lcap) ? 2 * gs->lcap : 4;
+    live = (unsigned int *)realloc(gs->live, (size_t)n * sizeof(unsigned int));
+    if (!live)
+    {
+      pthread_mutex_unlock(&gs->lock);
+      return -1;
+    }
+    gs->live = live;
+    gs->lcap = n;
+  }
+
+  sin->epoch = (gin->epoch) ? gin->epoch : ++gs->epoch;
+
+  for (i = gs->nlive; i > 0 && gs->live[i - 1] > sin->epoch; --i)
+    gs->live[i] = gs->live[i - 1];
+  gs->live[i] = sin->epoch;
+  ++gs->nlive;
+
+  ++gs->refs;
+  sin->snapshots = gs;
+
+  pthread_mutex_unlock(&gs->lock);
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Leave snapshot tracking of a grid
+
+     A snapshot leaving de-allocates the retired payload data no remaining
+     snapshot may refer to.  The last grid leaving de-allocates the tracking
+     structure.
+
+     @param gin    pointer to grid, or snapshot, internals
+
+     @retval NONE
+
+  */
+
+static void _grid_snapshots_leave(_grid_internals *gin)
+{
+  _grid_snapshots *gs;
+  int last;
+  int i, n;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  gs = gin->snapshots;
+  if (!gs) return;
+  gin->snapshots = NULL;
+
+  pthread_mutex_lock(&gs->lock);
+
+  if (gin->epoch)
+  {
+    for (i = 0; i < gs->nlive && gs->live[i] != gin->epoch; ++i) ;
+    if (i < gs->nlive)
+    {
+      memmove(gs->live + i,
+              gs->live + i + 1,
+              (size_t)(gs->nlive - i - 1) * sizeof(unsigned int));
+      --gs->nlive;
+    }
+
+      // Payload data is retired in epoch order
+    for (n = 0;
+         n < gs->nretired &&
+           (!gs->nlive || gs->retired[n].epoch < gs->live[0]);
+         ++n)
+      gs->retired[n].fpl(gs->retired[n].pl);
+
+    if (n)
+    {
+      memmove(gs->retired,
+              gs->retired + n,
+              (size_t)(gs->nretired - n) * sizeof(_grid_retired));
+      gs->nretired -= n;
+    }
+  }
+
+  last = !--gs->refs;
+
+  pthread_mutex_unlock(&gs->lock);
+
+  if (!last) return;
+
+  for (n = 0; n < gs->nretired; ++n) gs->retired[n].fpl(gs->retired[n].pl);
+
+  pthread_mutex_destroy(&gs->lock);
+  free(gs->live);
+  free(gs->retired);
+  free(gs);
+}
+
+  /*!
+
+     @brief INTERNAL:  Add payload data to retired list
+
+     NOTE:  The snapshot tracking lock must be held.  Should the list not
+            grow, the payload data is never de-allocated, rather than being
+            de-allocated while a snapshot may refer to it.
+
+     @param gs    pointer to snapshot tracking
+     @param pl    pointer to payload data
+     @param fpl    pointer to payload destructor
+
+     @retval NONE
+
+  */
+
+static void _grid_retired_add(_grid_snapshots *gs, void *pl,
+                              grid_payload_free fpl)
+{
+  _grid_retired *retired;
+  int n;
+
+    // Sanity check parameters.
+  assert(gs);
+
+  if (gs->nretired == gs->rcap)
+  {
+    n = (gs->rcap) ? 2 * gs->rcap : 64;
+    retired = (_grid_retired *)realloc(gs->retired,
+                                       (size_t)n * sizeof(_grid_retired));
+    if (!retired) return;
+    gs->retired = retired;
+    gs->rcap = n;
+  }
+
+  gs->retired[gs->nretired].pl = pl;
+  gs->retired[gs->nretired].fpl = fpl;
+  gs->retired[gs->nretired].epoch = gs->epoch;
+  ++gs->nretired;
+}
+
+  /*!
+
+     @brief INTERNAL:  De-allocate payload data, or retire it
+
+     Payload data is retired while any snapshot of the grid is live, and
+     de-allocated at once otherwise.
+
+     @param gin    pointer to grid internals
+     @param pl    pointer to payload data
+     @param fpl    pointer to payload destructor
+
+     @retval NONE
+
+  */
+
+static void _grid_retire(_grid_internals *gin, void *pl, grid_payload_free fpl)
+{
+  _grid_snapshots *gs;
+
+    // Sanity check parameters.
+  assert(gin);
+  assert(pl);
+  assert(fpl);
+
+  gs = gin->snapshots;
+  if (gs)
+  {
+    pthread_mutex_lock(&gs->lock);
+    if (gs->nlive)
+    {
+      _grid_retired_add(gs, pl, fpl);
+      pthread_mutex_unlock(&gs->lock);
+      return;
+    }
+    pthread_mutex_unlock(&gs->lock);
+  }
+
+  if (gin->reclaim)
+    reclaim_add(gin->reclaim, pl, fpl);
+  else
+    fpl(pl);
+}
+
+  /*!
+
+     @brief INTERNAL:  De-allocate payload data of a range, or retire it
+
+     As for _grid_retire(), for every non-empty cell in a range of cells.
+     The range is clipped to the grid.
+
+     @param gin    pointer to grid internals
+     @param row    first row of range
+     @param col    first column of range
+     @param rows    number of rows in range
+     @param cols    number of columns in range
+     @param fpl    pointer to payload destructor
+
+     @retval NONE
+
+  */
+
+static void _grid_retire_range(_grid_internals *gin, int row, int col,
+                               int rows, int cols, grid_payload_free fpl)
+{
+  _grid_snapshots *gs;
+  _grid_position pos;
+  void *buf[SPAN_CELLS];
+  void **p;
+  int retiring = 0;
+  int y, x, n, i;
+
+    // Sanity check parameters.
+  assert(gin);
+  assert(fpl);
+
+  if (rows > grid_size_get_height(gin->size) - row)
+    rows = grid_size_get_height(gin->size) - row;
+  if (cols > grid_size_get_width(gin->size) - col)
+    cols = grid_size_get_width(gin->size) - col;
+  if (row < 0 || col < 0 || rows < 1 || cols < 1) return;
+
+  gs = gin->snapshots;
+  if (gs)
+  {
+    pthread_mutex_lock(&gs->lock);
+    retiring = (gs->nlive > 0);
+    if (!retiring) pthread_mutex_unlock(&gs->lock);
+  }
+
+  memset(&pos, 0, sizeof(_grid_position));
+
+  for (y = row; y < row + rows; ++y)
+    for (x = col; x < col + cols; x += n)
+    {
+      p = gin->storage->span(gin, &pos, y, x, &n, buf,
+                             (col + cols - x < SPAN_CELLS) ?
+                               col + cols - x : SPAN_CELLS);
+      if (n > col + cols - x) n = col + cols - x;
+      if (!retiring && gin->reclaim)
+      {
+        reclaim_add_many(gin->reclaim, p, n, fpl);
+        continue;
+      }
+      for (i = 0; i < n; ++i)
+      {
+        if (!p[i]) continue;
+        if (retiring)
+          _grid_retired_add(gs, p[i], fpl);
+        else
+          fpl(p[i]);
+      }
+    }
+
+  if (retiring) pthread_mutex_unlock(&gs->lock);
+}
+
+// STATIC functions: reference index
+
+  /*!
+
+     @brief INTERNAL:  Build reference index of grid
+
+     @param gin    pointer to grid internals
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_index_create(_grid_internals *gin)
+{
+  _grid_position pos;
+  void *buf[SPAN_CELLS];
+  void **p;
+  int height, width;
+  int y, x, n, i;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  gin->index = (_grid_index *)malloc(sizeof(_grid_index));
+  if (!gin->index) return -1;
+  memset(gin->index, 0, sizeof(_grid_index));
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+  if (_grid_index_extend(gin, 0, 0, height, width))
+  {
+    _grid_index_destroy(gin);
+    return -1;
+  }
+
+  memset(&pos, 0, sizeof(_grid_position));
+
+  for (y = 0; y < height; ++y)
+    for (x = 0; x < width; x += n)
+    {
+      p = gin->storage->span(gin, &pos, y, x, &n, buf, SPAN_CELLS);
+      for (i = 0; i < n; ++i)
+        if (p[i] && _grid_index_add(gin, p[i], y, x + i))
+        {
+          _grid_index_destroy(gin);
+          return -1;
+        }
+    }
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  De-allocate reference index of grid
+
+     @param gin    pointer to grid internals
+
+     @retval NONE
+
+  */
+
+static void _grid_index_destroy(_grid_internals *gin)
+{
+    // Sanity check parameters.
+  assert(gin);
+
+  if (!gin->index) return;
+
+  free(gin->index->slots);
+  _grid_axis_free(&gin->index->rows);
+  _grid_axis_free(&gin->index->cols);
+
+  free(gin->index);
+  gin->index = NULL;
+}
+
+  /*!
+
+     @brief INTERNAL:  Hash a payload data pointer
+
+     @param pl    pointer to payload data
+
+     @retval "unsigned int" hash value
+
+  */
+
+static unsigned int _grid_index_hash(void *pl)
+{
+  uint64_t k;
+
+  k = (uint64_t)(uintptr_t)pl;
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+
+    // Return "unsigned int"
+  return (unsigned int)k;
+}
+
+  /*!
+
+     @brief INTERNAL:  Find slot of payload data in reference index
+
+     @param gi    pointer to reference index
+     @param pl    pointer to payload data
+
+     @retval "int" slot index
+     @retval -1    payload data not indexed
+
+  */
+
+static int _grid_index_find(_grid_index *gi, void *pl)
+{
+  unsigned int mask;
+  unsigned int i;
+
+    // Sanity check parameters.
+  assert(gi);
+
+  if (!gi->count) return -1;
+
+  mask = (unsigned int)gi->capacity - 1;
+
+  for (i = _grid_index_hash(pl) & mask; gi->slots[i].pl; i = (i + 1) & mask)
+    if (gi->slots[i].pl == pl)
+        // Return "int"
+      return (int)i;
+
+    // Return "int"
+  return -1;
+}
+
+  /*!
+
+     @brief INTERNAL:  Add a cell to reference index
+
+     @param gin    pointer to grid internals
+     @param pl    pointer to payload data of cell
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_index_add(_grid_internals *gin, void *pl, int row, int col)
+{
+  _grid_index *gi;
+  _grid_index_entry *slots;
+  unsigned int mask;
+  unsigned int j;
+  int capacity;
+  int i;
+
+    // Sanity check parameters.
+  assert(gin);
+  assert(pl);
+
+  gi = gin->index;
+
+  i = _grid_index_find(gi, pl);
+  if (i >= 0)
+  {
+    ++gi->slots[i].count;
+    return 0;
+  }
+
+    // Keep load factor under 3/4
+  if ((gi->count + 1) * 4 > gi->capacity * 3)
+  {
+    capacity = (gi->capacity) ? gi->capacity * 2 : 64;
+    slots = (_grid_index_entry *)calloc((size_t)capacity,
+                                        sizeof(_grid_index_entry));
+    if (!slots) return -1;
+
+    mask = (unsigned int)capacity - 1;
+    for (i = 0; i < gi->capacity; ++i)
+    {
+      if (!gi->slots[i].pl) continue;
+      for (j = _grid_index_hash(gi->slots[i].pl) & mask;
+           slots[j].pl;
+           j = (j + 1) & mask) ;
+      slots[j] = gi->slots[i];
+    }
+
+    free(gi->slots);
+    gi->slots = slots;
+    gi->capacity = capacity;
+  }
+
+  mask = (unsigned int)gi->capacity - 1;
+  for (j = _grid_index_hash(pl) & mask; gi->slots[j].pl; j = (j + 1) & mask) ;
+
+  gi->slots[j].pl = pl;
+  gi->slots[j].row = gi->rows.ids[row];
+  gi->slots[j].col = gi->cols.ids[col];
+  gi->slots[j].count = 1;
+  ++gi->count;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Remove a cell from reference index
+
+     Empties a slot once no cell holds the payload data, shifting back any
+     following entries of the same probe sequence.
+
+     @param gin    pointer to grid internals
+     @param pl    pointer to payload data of cell
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval NONE
+
+  */
+
+static void _grid_index_remove(_grid_internals *gin, void *pl,
+                               int row, int col)
+{
+  _grid_index *gi;
+  _grid_index_entry *e;
+  unsigned int mask;
+  unsigned int hole, j, k;
+  int i;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  gi = gin->index;
+
+  i = _grid_index_find(gi, pl);
+  if (i < 0) return;
+
+  e = &gi->slots[i];
+  if (--e->count)
+  {
+    if (e->row == gi->rows.ids[row] && e->col == gi->cols.ids[col])
+      e->row = -1;
+    return;
+  }
+
+  mask = (unsigned int)gi->capacity - 1;
+
+  for (hole = (unsigned int)i, j = hole; ; )
+  {
+    j = (j + 1) & mask;
+    if (!gi->slots[j].pl) break;
+
+    k = _grid_index_hash(gi->slots[j].pl) & mask;
+
+      // Entry stays if its home slot lies cyclically in (hole, j]
+    if ((hole <= j) ? (hole < k && k <= j) : (hole < k || k <= j)) continue;
+
+    gi->slots[hole] = gi->slots[j];
+    hole = j;
+  }
+
+  gi->slots[hole].pl = NULL;
+  --gi->count;
+}
+
+  /*!
+
+     @brief INTERNAL:  Look up the cell holding payload data
+
+     @param gin    pointer to grid internals
+     @param pl    pointer to payload data
+     @param row    pointer to storage for row of cell
+     @param col    pointer to storage for column of cell
+
+     @retval 1    cell found
+     @retval 0    no cell holds payload data
+     @retval -1    unknown, the grid must be scanned
+
+  */
+
+static int _grid_index_lookup(_grid_internals *gin, void *pl,
+                              int *row, int *col)
+{
+  _grid_index *gi;
+  int i;
+
+    // Sanity check parameters.
+  assert(gin);
+  assert(row);
+  assert(col);
+
+  gi = gin->index;
+
+  i = _grid_index_find(gi, pl);
+  if (i < 0) return 0;
+
+  if (gi->slots[i].count > 1 || gi->slots[i].row < 0) return -1;
+
+  *row = gi->rows.pos[gi->slots[i].row];
+  *col = gi->cols.pos[gi->slots[i].col];
+
+    // Return "int"
+  return 1;
+}
+
+  /*!
+
+     @brief INTERNAL:  Record the cell holding payload data, found by a scan
+
+     @param gin    pointer to grid internals
+     @param pl    pointer to payload data
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval NONE
+
+  */
+
+static void _grid_index_note(_grid_internals *gin, void *pl, int row, int col)
+{
+  _grid_index *gi;
+  int i;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  gi = gin->index;
+
+  i = _grid_index_find(gi, pl);
+  if (i < 0 || gi->slots[i].count > 1) return;
+
+  gi->slots[i].row = gi->rows.ids[row];
+  gi->slots[i].col = gi->cols.ids[col];
+}
+
+  /*!
+
+     @brief INTERNAL:  Remove a block of cells from reference index
+
+     @param gin    pointer to grid internals
+     @param row    first row of block
+     @param rows    number of rows in block
+     @param col    first column of block
+     @param cols    number of columns in block
+
+     @retval NONE
+
+  */
+
+static void _grid_index_drop(_grid_internals *gin, int row, int rows,
+                             int col, int cols)
+{
+  _grid_position pos;
+  void *buf[SPAN_CELLS];
+  void **p;
+  int y, x, n, i;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  memset(&pos, 0, sizeof(_grid_position));
+
+  for (y = row; y < row + rows && gin->index->count; ++y)
+    for (x = col; x < col + cols; x += n)
+    {
+      n = col + cols - x;
+      p = gin->storage->span(gin, &pos, y, x, &n, buf,
+                             (n < SPAN_CELLS) ? n : SPAN_CELLS);
+      if (n > col + cols - x) n = col + cols - x;
+      for (i = 0; i < n; ++i)
+        if (p[i]) _grid_index_remove(gin, p[i], y, x + i);
+    }
+}
+
+  /*!
+
+     @brief INTERNAL:  Truncate reference index to new grid size
+
+     @param gin    pointer to grid internals
+     @param rows    new number of rows
+     @param cols    new number of columns
+
+     @retval NONE
+
+  */
+
+static void _grid_index_truncate(_grid_internals *gin, int rows, int cols)
+{
+  int height, width;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+  if (rows > height) rows = height;
+  if (cols > width) cols = width;
+  if (rows < 1 || cols < 1) rows = cols = 0;
+
+  _grid_index_drop(gin, rows, height - rows, 0, width);
+  _grid_index_drop(gin, 0, rows, cols, width - cols);
+
+  if (rows < height)
+    _grid_axis_remove(&gin->index->rows, rows, height - rows, height);
+  if (cols < width)
+    _grid_axis_remove(&gin->index->cols, cols, width - cols, width);
+}
+
+  /*!
+
+     @brief INTERNAL:  Extend reference index to new grid size
+
+     @param gin    pointer to grid internals
+     @param height    current number of rows
+     @param width    current number of columns
+     @param rows    new number of rows
+     @param cols    new number of columns
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _grid_index_extend(_grid_internals *gin, int height, int width,
+                              int rows, int cols)
+{
+    // Sanity check parameters.
+  assert(gin);
+
+  if (rows > height &&
+      _grid_axis_insert(&gin->index->rows, height, rows - height, height))
+    return -1;
+
+  if (cols > width &&
+      _grid_axis_insert(&gin->index->cols, width, cols - width, width))
+    return -1;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Store payload data in a cell
+
+     Keeps the reference index, if any, up to date.  The reference index is
+     dropped if it can not be updated.
+
+     @param gin    pointer to grid internals
+     @param row    row of cell
+     @param col    column of cell
+     @param pl    pointer to payload data
+
+     @retval 0    success
+     @retval -1    failure, grid is a snapshot or storage can not be copied
+
+  */
+
+static int _grid_store(_grid_internals *gin, int row, int col, void *pl)
+{
+  void *old;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  if (_grid_is_read_only(gin) || _grid_own(gin, row, col, 1, 1)) return -1;
+
+  if (gin->index)
+  {
+    old = gin->storage->get(gin, row, col);
+    if (old != pl)
+    {
+      if (old) _grid_index_remove(gin, old, row, col);
+      if (pl && _grid_index_add(gin, pl, row, col)) _grid_index_destroy(gin);
+    }
+  }
+
+  gin->storage->set(gin, row, col, pl);
+
+  _grid_notify(gin, grid_change_cell, row, col, 1);
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Make a range of cells private to a grid
+
+     Called before a storage engine operation changes a range of cells, so
+     that storage shared with snapshots can be copied first.  Engines may
+     copy more than the range, but never less.
+
+     @param gin    pointer to grid internals
+     @param row    first row of range
+     @param col    first column of range
+     @param rows    number of rows in range
+     @param cols    number of columns in range
+
+     @retval 0    success
+     @retval -1    failure, nothing may be changed
+
+  */
+
+static int _grid_own(_grid_internals *gin, int row, int col, int rows, int cols)
+{
+  int height, width;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  if (!gin->snapshots || !gin->storage->own) return 0;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+  if (row < 0)
+  {
+    rows += row;
+    row = 0;
+  }
+  if (col < 0)
+  {
+    cols += col;
+    col = 0;
+  }
+  if (rows > height - row) rows = height - row;
+  if (cols > width - col) cols = width - col;
+  if (rows < 0) rows = 0;
+  if (cols < 0) cols = 0;
+
+    // Return "int"
+  return gin->storage->own(gin, row, col, rows, cols);
+}
+
+  /*!
+
+     @brief INTERNAL:  Reorder rows of grid
+
+     Row i of the grid takes the cells of row perm[i].  The reference index,
+     if any, follows the cells.
+
+     @param gin    pointer to grid internals
+     @param perm    pointer to permutation, one entry per row
+
+     @retval 0    success
+     @retval -1    failure, nothing changed
+
+  */
+
+static int _grid_permute_rows(_grid_internals *gin, const int *perm)
+{
+  int height;
+
+    // Sanity check parameters.
+  assert(gin);
+  assert(perm);
+
+  height = grid_size_get_height(gin->size);
+
+  if (_grid_own(gin, 0, 0, height, grid_size_get_width(gin->size)))
+    return -1;
+
+  if (gin->storage->permute_rows(gin, perm)) return -1;
+
+  ++gin->generation;
+
+  if (gin->index && _grid_axis_permute(&gin->index->rows, perm, height))
+    _grid_index_destroy(gin);
+
+  _grid_notify(gin, grid_change_order, 0, 0, height);
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Report a change to the user change function, if any
+
+     @param gin    pointer to grid internals
+     @param change    kind of change
+     @param row    row argument of change
+     @param col    column argument of change
+     @param count    count argument of change
+
+     @retval NONE
+
+  */
+
+static void _grid_notify(_grid_internals *gin, grid_change_t change,
+                         int row, int col, int count)
+{
+    // Sanity check parameters.
+  assert(gin);
+
+  if (gin->notify) gin->notify(change, row, col, count, gin->notify_data);
+}
+
+  /*!
+
+     @brief INTERNAL:  Release storage of grid, and leave its snapshots
+
+     While snapshots may refer to the payload data, it is retired rather
+     than de-allocated.  A snapshot releases its storage before leaving, so
+     that once no snapshot is live, no storage is shared.
+
+     @param gin    pointer to grid internals
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _grid_release(_grid_internals *gin, grid_payload_free fpl)
+{
+  int height, width;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  if (gin->store)
+  {
+    height = grid_size_get_height(gin->size);
+    width = grid_size_get_width(gin->size);
+
+    if (fpl && (gin->snapshots || gin->reclaim))
+    {
+      _grid_retire_range(gin, 0, 0, height, width, fpl);
+      fpl = NULL;
+    }
+
+    gin->storage->release(gin, fpl);
+  }
+
+  _grid_snapshots_leave(gin);
+}
+
+// STATIC functions: mesh storage engine
+
+  /*!
+
+     @brief INTERNAL:  Allocate mesh storage
+
+     @param gin    pointer to grid internals
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _mesh_init(_grid_internals *gin)
+{
+  _mesh_store *ms;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ms = (_mesh_store *)malloc(sizeof(_mesh_store));
+  if (!ms) return -1;
+  memset(ms, 0, sizeof(_mesh_store));
+
+  gin->store = ms;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  De-allocate mesh storage
+
+     De-allocates every cell of the mesh, a whole slab at a time, and
+     possibly the payload data.
+
+     @param gin    pointer to grid internals
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _mesh_release(_grid_internals *gin, grid_payload_free fpl)
+{
+  _mesh_store *ms;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ms = (_mesh_store *)gin->store;
+  if (!ms) return;
+
+  _mesh_clear(ms, fpl);
+
+  free(ms->rows);
+  free(ms->cols);
+  free(ms);
+  gin->store = NULL;
+}
+
+  /*!
+
+     @brief INTERNAL:  Get payload data of mesh cell
+
+     @param gin    pointer to grid internals
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+static void *_mesh_get(_grid_internals *gin, int row, int col)
+{
+  _cell *c;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  c = _mesh_cell(gin, row, col);
+  if (!c) return NULL;
+
+    // Return "void *"
+  return c->payload;
+}
+
+  /*!
+
+     @brief INTERNAL:  Set payload data of mesh cell
+
+     @param gin    pointer to grid internals
+     @param row    row of cell
+     @param col    column of cell
+     @param pl    pointer to payload data
+
+     @retval NONE
+
+  */
+
+static void _mesh_set(_grid_internals *gin, int row, int col, void *pl)
+{
+  _cell *c;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  c = _mesh_cell(gin, row, col);
+  if (c) c->payload = pl;
+}
+
+  /*!
+
+     @brief INTERNAL:  Change size of mesh
+
+     Truncates surplus rows and then surplus columns, each in a single pass,
+     and then builds and links every new cell in a single row-major sweep.
+     All new cells are reserved in one slab before any are linked.
+
+     @param gin    pointer to grid internals
+     @param rows    new number of rows
+     @param cols    new number of columns
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _mesh_resize(_grid_internals *gin, int rows, int cols,
+                        grid_payload_free fpl)
+{
+  _mesh_store *ms;
+  int height, width;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ms = (_mesh_store *)gin->store;
+  ms->finger = NULL;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+    // Dropping every cell releases whole slabs
+  if (!rows || !cols)
+  {
+    _mesh_clear(ms, fpl);
+    return 0;
+  }
+
+  if (!height) width = 0;
+
+  if (rows < height)
+  {
+    _mesh_truncate_rows(ms, rows, height, fpl);
+    height = rows;
+  }
+
+  if (cols < width)
+  {
+    _mesh_truncate_columns(ms, cols, fpl);
+    width = cols;
+  }
+
+  if (rows == height && cols == width) return 0;
+
+    // Return "int"
+  return _mesh_extend(ms, rows, cols, height, width);
+}
+
+  /*!
+
+     @brief INTERNAL:  Remove mesh rows from the bottom
+
+     @param ms    pointer to mesh storage
+     @param rows    number of rows to keep, at least one
+     @param chgt    current number of rows
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _mesh_truncate_rows(_mesh_store *ms, int rows, int chgt,
+                                grid_payload_free fpl)
+{
+  _cell *c;
+  _cell *n;
+  int y;
+
+    // Sanity check parameters.
+  assert(ms);
+  assert(rows > 0);
+
+  for (c = ms->rows[rows - 1]; c; c = c->right)
+  {
+    c->down = NULL;
+    ms->end = c;
+  }
+
+  for (y = rows; y < chgt; ++y)
+    for (c = ms->rows[y]; c; c = n)
+    {
+      n = c->right;
+      _cell_free(ms, c, fpl);
+    }
+}
+
+  /*!
+
+     @brief INTERNAL:  Remove mesh columns from the right
+
+     @param ms    pointer to mesh storage
+     @param cols    number of columns to keep, at least one
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _mesh_truncate_columns(_mesh_store *ms, int cols,
+                                   grid_payload_free fpl)
+{
+  _cell *c;
+  _cell *d;
+  _cell *n;
+
+    // Sanity check parameters.
+  assert(ms);
+  assert(cols > 0);
+
+  for (c = ms->cols[cols - 1]; c; c = c->down)
+  {
+    for (d = c->right; d; d = n)
+    {
+      n = d->right;
+      _cell_free(ms, d, fpl);
+    }
+    c->right = NULL;
+    ms->end = c;
+  }
+}
+
+  /*!
+
+     @brief INTERNAL:  Add mesh rows and columns at the bottom and right
+
+     Builds every new cell in one row-major sweep.  Each row extends the
+     existing cells of that row, if any, and links each new cell to the cell
+     above it as it goes.
+
+     @param ms    pointer to mesh storage
+     @param rows    new number of rows
+     @param cols    new number of columns
+     @param chgt    current number of rows
+     @param cwid    current number of columns
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _mesh_extend(_mesh_store *ms, int rows, int cols,
+                        int chgt, int cwid)
+{
+  _cell *tail;  // Last existing cell in this row
+  _cell *ptail; // Last existing cell in row above
+  _cell *above;
+  _cell *left;
+  _cell *c;
+  int start;
+  int y, x;
+
+    // Sanity check parameters.
+  assert(ms);
+
+  if (_mesh_reserve(ms, rows, cols)) return -1;
+  if (_mesh_reserve_cells(ms, rows * cols - chgt * cwid)) return -1;
+
+  tail = (chgt && cwid) ? ms->cols[cwid - 1] : NULL;
+  ptail = NULL;
+
+  for (y = 0; y < rows; ++y)
+  {
+    start = (y < chgt) ? cwid : 0;
+
+    if (!y)
+      above = NULL;
+    else if (start)
+      above = ptail->right;
+    else
+      above = ms->rows[y - 1];
+
+    left = (y < chgt) ? tail : NULL;
+
+    for (x = start; x < cols; ++x)
+    {
+      c = _cell_new(ms, NULL);
+      if (left)
+      {
+        left->right = c;
+        c->left = left;
+      }
+      if (above)
+      {
+        above->down = c;
+        c->up = above;
+        above = above->right;
+      }
+      if (!x) ms->rows[y] = c;
+      if (!y) ms->cols[x] = c;
+      left = c;
+    }
+
+    ms->end = left;
+
+    ptail = tail;
+    if (tail) tail = tail->down;
+  }
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Insert empty rows into mesh
+
+     @param gin    pointer to grid internals
+     @param row    row before which to insert
+     @param count    number of rows to insert
+
+     @retval "int" number of rows inserted
+
+  */
+
+static int _mesh_insert_rows(_grid_internals *gin, int row, int count)
+{
+  _mesh_store *ms;
+  int height, width;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ms = (_mesh_store *)gin->store;
+  ms->finger = NULL;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+    // Return "int"
+  return _mesh_create_rows(ms, row, count, height, width);
+}
+
+  /*!
+
+     @brief INTERNAL:  Insert empty columns into mesh
+
+     @param gin    pointer to grid internals
+     @param col    column before which to insert
+     @param count    number of columns to insert
+
+     @retval "int" number of columns inserted
+
+  */
+
+static int _mesh_insert_columns(_grid_internals *gin, int col, int count)
+{
+  _mesh_store *ms;
+  int height, width;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ms = (_mesh_store *)gin->store;
+  ms->finger = NULL;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+    // Return "int"
+  return _mesh_create_columns(ms, col, count, height, width);
+}
+
+  /*!
+
+     @brief INTERNAL:  Remove rows from mesh
+
+     @param gin    pointer to grid internals
+     @param row    first row to remove
+     @param count    number of rows to remove
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _mesh_remove_rows(_grid_internals *gin, int row, int count,
+                              grid_payload_free fpl)
+{
+  _mesh_store *ms;
+  int height;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ms = (_mesh_store *)gin->store;
+  ms->finger = NULL;
+
+  height = grid_size_get_height(gin->size);
+
+  _mesh_free_rows(ms, row, count, height, fpl);
+}
+
+  /*!
+
+     @brief INTERNAL:  Remove columns from mesh
+
+     @param gin    pointer to grid internals
+     @param col    first column to remove
+     @param count    number of columns to remove
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _mesh_remove_columns(_grid_internals *gin, int col, int count,
+                                 grid_payload_free fpl)
+{
+  _mesh_store *ms;
+  int width;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ms = (_mesh_store *)gin->store;
+  ms->finger = NULL;
+
+  width = grid_size_get_width(gin->size);
+
+  _mesh_free_columns(ms, col, count, width, fpl);
+}
+
+  /*!
+
+     @brief INTERNAL:  Reorder rows of mesh
+
+     Only the up and down links, and the row and column tables, are changed;
+     every cell keeps its payload data and its left and right neighbors.
+
+     @param gin    pointer to grid internals
+     @param perm    pointer to permutation, one entry per row
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _mesh_permute_rows(_grid_internals *gin, const int *perm)
+{
+  _mesh_store *ms;
+  _cell **cur;
+  _cell *prev;
+  int height;
+  int y, x;
+
+    // Sanity check parameters.
+  assert(gin);
+  assert(perm);
+
+  ms = (_mesh_store *)gin->store;
+
+  height = grid_size_get_height(gin->size);
+
+  cur = (_cell **)malloc((size_t)height * sizeof(_cell *));
+  if (!cur) return -1;
+
+  for (y = 0; y < height; ++y)
+    cur[y] = ms->rows[perm[y]];
+  memcpy(ms->rows, cur, (size_t)height * sizeof(_cell *));
+
+  ms->finger = NULL;
+
+    // Relink one column at a time, moving along the rows
+  for (x = 0; cur[0]; ++x)
+  {
+    ms->cols[x] = cur[0];
+
+    prev = NULL;
+    for (y = 0; y < height; ++y)
+    {
+      cur[y]->up = prev;
+      cur[y]->down = (y < height - 1) ? cur[y + 1] : NULL;
+      prev = cur[y];
+      cur[y] = cur[y]->right;
+    }
+
+    ms->end = prev;
+  }
+
+  free(cur);
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Get payloads of part of a mesh row
+
+     Payloads are copied to the supplied buffer, walking right from the
+     first cell.
+
+     @param gin    pointer to grid internals
+     @param pos    pointer to position to walk from
+     @param row    row of cells
+     @param col    first column of cells
+     @param count    pointer to storage for number of payloads
+     @param buf    pointer to buffer for payloads
+     @param size    number of payloads buffer holds
+
+     @retval "void **" pointer to payloads
+
+  */
+
+static void **_mesh_span(_grid_internals *gin, _grid_position *pos,
+                         int row, int col, int *count, void **buf, int size)
+{
+  _cell *c;
+  int n;
+  int i;
+
+    // Sanity check parameters.
+  assert(gin);
+  assert(count);
+  assert(buf);
+
+  n = grid_size_get_width(gin->size) - col;
+  if (n > size) n = size;
+
+  _mesh_seek(gin, pos, row, col);
+
+  c = (_cell *)pos->hint;
+  for (i = 0; i < n - 1; ++i, c = c->right)
+    buf[i] = c->payload;
+  buf[i] = c->payload;
+
+    // Leave position on last cell of span
+  pos->hint = c;
+  pos->col = col + n - 1;
+
+  *count = n;
+
+    // Return "void **"
+  return buf;
+}
+
+  /*!
+
+     @brief INTERNAL:  Locate a mesh cell
+
+     Locates a cell, starting from the most recently located cell when that
+     is nearer, and records the cell as most recently located.  Stepping to
+     a neighboring cell is therefore a constant time operation.
+
+     @param gin    pointer to grid internals
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval "_cell *" success
+     @retval NULL    failure
+
+  */
+
+static _cell *_mesh_cell(_grid_internals *gin, int row, int col)
+{
+  _mesh_store *ms;
+  _cell *c;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ms = (_mesh_store *)gin->store;
+  if (!ms) return NULL;
+
+  c = _mesh_walk(gin, row, col, ms->finger, ms->frow, ms->fcol);
+  if (!c) return NULL;
+
+  ms->finger = c;
+  ms->frow = row;
+  ms->fcol = col;
+
+    // Return "_cell *"
+  return c;
+}
+
+  /*!
+
+     @brief INTERNAL:  Get payload data of mesh cell from a position
+
+     Locates a cell, starting from the cell of a caller held position when
+     that is nearer, and moves the position to the cell.  Nothing in the
+     mesh is modified.
+
+     @param gin    pointer to grid internals
+     @param pos    pointer to position to walk from
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval "void *" success
+     @retval NULL    cell is empty
+
+  */
+
+static void *_mesh_seek(_grid_internals *gin, _grid_position *pos,
+                        int row, int col)
+{
+  _cell *c;
+
+    // Sanity check parameters.
+  assert(gin);
+  assert(pos);
+
+  if (pos->generation != gin->generation) pos->hint = NULL;
+
+  c = _mesh_walk(gin, row, col, (_cell *)pos->hint, pos->row, pos->col);
+
+  pos->hint = c;
+  pos->row = row;
+  pos->col = col;
+  pos->generation = gin->generation;
+
+    // Return "void *"
+  return (c) ? c->payload : NULL;
+}
+
+  /*!
+
+     @brief INTERNAL:  Walk the mesh to a cell
+
+     Walks the mesh to a cell, starting from whichever of the row head, the
+     column head, the last cell, or a supplied starting cell is nearest.
+
+     @param gin    pointer to grid internals
+     @param row    row of cell
+     @param col    column of cell
+     @param from    pointer to starting cell, or NULL
+     @param frow    row of starting cell
+     @param fcol    column of starting cell
+
+     @retval "_cell *" success
+     @retval NULL    failure
+
+  */
+
+static _cell *_mesh_walk(_grid_internals *gin, int row, int col,
+                         _cell *from, int frow, int fcol)
+{
+  _mesh_store *ms;
+  _cell *c;
+  int y, x;
+  int d, dn;
+  int height, width;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ms = (_mesh_store *)gin->store;
+  if (!ms || !ms->end) return NULL;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+    // Start from row head
+  c = ms->rows[row];
+  y = row;
+  x = 0;
+  d = col;
+
+    // Column head may be nearer
+  if (row < d)
+  {
+    c = ms->cols[col];
+    y = 0;
+    x = col;
+    d = row;
+  }
+
+    // Last cell may be nearer
+  dn = (height - 1 - row) + (width - 1 - col);
+  if (dn < d)
+  {
+    c = ms->end;
+    y = height - 1;
+    x = width - 1;
+    d = dn;
+  }
+
+    // Starting cell may be nearer
+  if (from)
+  {
+    dn = abs(frow - row) + abs(fcol - col);
+    if (dn < d)
+    {
+      c = from;
+      y = frow;
+      x = fcol;
+    }
+  }
+
+  for ( ; c && y < row; ++y) c = c->down;
+  for ( ; c && y > row; --y) c = c->up;
+  for ( ; c && x < col; ++x) c = c->right;
+  for ( ; c && x > col; --x) c = c->left;
+
+    // Return "_cell *"
+  return c;
+}
+
+  /*!
+
+     @brief INTERNAL:  Reserve mesh row and column head tables
+
+     Makes sure the row head and column head tables can hold at least the
+     requested number of entries.  Capacity grows geometrically.
+
+     @param ms    pointer to mesh storage
+     @param rows    number of row heads required
+     @param cols    number of column heads required
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _mesh_reserve(_mesh_store *ms, int rows, int cols)
+{
+  _cell **p;
+  int n;
+
+    // Sanity check parameters.
+  assert(ms);
+
+  if (rows > ms->rcap)
+  {
+    n = (rows > ms->rcap * 2) ? rows : ms->rcap * 2;
+    p = (_cell **)realloc(ms->rows, (size_t)n * sizeof(_cell *));
+    if (!p) return -1;
+    ms->rows = p;
+    ms->rcap = n;
+  }
+
+  if (cols > ms->ccap)
+  {
+    n = (cols > ms->ccap * 2) ? cols : ms->ccap * 2;
+    p = (_cell **)realloc(ms->cols, (size_t)n * sizeof(_cell *));
+    if (!p) return -1;
+    ms->cols = p;
+    ms->ccap = n;
+  }
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Create and link new mesh rows
+
+     Creates a band of rows of empty cells, and links it into the mesh before
+     the requested row, shifting the row head table once for the whole band.
+     Should cells run out, the rows created so far are kept.
+
+     @param ms    pointer to mesh storage
+     @param row    row before which to insert
+     @param count    number of rows to insert
+     @param chgt    current number of rows
+     @param cwid    current number of columns
+
+     @retval "int" number of rows created
+
+  */
+
+static int _mesh_create_rows(_mesh_store *ms, int row, int count,
+                             int chgt, int cwid)
+{
+  _cell *urow;  // Up row, row before new row
+  _cell *drow;  // Down row, row after new rows
+  int i, n;
+  _cell *nrow;  // New row
+  _cell *ncell; // A new cell
+  _cell *pcell; // Tracks most previous cell created
+
+    // Sanity check parameters.
+  assert(ms);
+
+  if (_mesh_reserve(ms, chgt + count, cwid)) return 0;
+
+  drow = (row < chgt) ? ms->rows[row] : NULL;
+
+  memmove(ms->rows + row + count,
+          ms->rows + row,
+          (size_t)(chgt - row) * sizeof(_cell *));
+
+  for (n = 0; n < count; n++)
+  {
+    if (_mesh_reserve_cells(ms, cwid)) break;
+
+      // Create new row with number of cells equal to width of grid
+    for (nrow = NULL, pcell = NULL, i = 0; i < cwid; i++)
+    {
+      ncell = _cell_new(ms, NULL);
+      if (!ncell) break;
+      if (!nrow)
+        nrow = ncell;
+      else
+      {
+        pcell->right = ncell;
+        ncell->left = pcell;
+      }
+      pcell = ncell;
+    }
+    if (i < cwid)
+    {
+      for ( ; nrow; nrow = pcell)
+      {
+        pcell = nrow->right;
+        _cell_free(ms, nrow, NULL);
+      }
+      break;
+    }
+
+      // Link new row below the row before it
+    urow = (row + n > 0) ? ms->rows[row + n - 1] : NULL;
+
+    for (pcell = nrow, i = 0; pcell; pcell = pcell->right, i++)
+    {
+      if (urow)
+      {
+        urow->down = pcell;
+        pcell->up = urow;
+        urow = urow->right;
+      }
+        // New top row becomes the column heads
+      if (!row && !n) ms->cols[i] = pcell;
+        // New bottom row holds the last cell
+      if (row == chgt) ms->end = pcell;
+    }
+
+    ms->rows[row + n] = nrow;
+  }
+
+  if (n < count)
+    memmove(ms->rows + row + n,
+            ms->rows + row + count,
+            (size_t)(chgt - row) * sizeof(_cell *));
+
+    // Link last new row above the row after the band
+  urow = (row + n > 0) ? ms->rows[row + n - 1] : NULL;
+
+  while (urow || drow)
+  {
+    if (urow) urow->down = drow;
+    if (drow) drow->up = urow;
+    if (urow) urow = urow->right;
+    if (drow) drow = drow->right;
+  }
+
+    // Return "int"
+  return n;
+}
+
+  /*!
+
+     @brief INTERNAL:  Create and link new mesh columns
+
+     Creates a band of columns of empty cells, and links it into the mesh
+     before the requested column, shifting the column head table once for the
+     whole band.  Should cells run out, the columns created so far are kept.
+
+     @param ms    pointer to mesh storage
+     @param col    column before which to insert
+     @param count    number of columns to insert
+     @param chgt    current number of rows
+     @param cwid    current number of columns
+
+     @retval "int" number of columns created
+
+  */
+
+static int _mesh_create_columns(_mesh_store *ms, int col, int count,
+                             int chgt, int cwid)
+{
+  _cell *lcol;  // Left col, col before new col
+  _cell *rcol;  // Right col, col after new cols
+  int i, n;
+  _cell *ncol;  // New col
+  _cell *ncell; // A new cell
+  _cell *pcell; // Tracks most previous cell created
+
+    // Sanity check parameters.
+  assert(ms);
+
+  if (_mesh_reserve(ms, chgt, cwid + count)) return 0;
+
+  rcol = (col < cwid) ? ms->cols[col] : NULL;
+
+  memmove(ms->cols + col + count,
+          ms->cols + col,
+          (size_t)(cwid - col) * sizeof(_cell *));
+
+  for (n = 0; n < count; n++)
+  {
+    if (_mesh_reserve_cells(ms, chgt)) break;
+
+      // Create new col with number of cells equal to height of grid
+    for (ncol = NULL, pcell = NULL, i = 0; i < chgt; i++)
+    {
+      ncell = _cell_new(ms, NULL);
+      if (!ncell) break;
+      if (!ncol)
+        ncol = ncell;
+      else
+      {
+        pcell->down = ncell;
+        ncell->up = pcell;
+      }
+      pcell = ncell;
+    }
+    if (i < chgt)
+    {
+      for ( ; ncol; ncol = pcell)
+      {
+        pcell = ncol->down;
+        _cell_free(ms, ncol, NULL);
+      }
+      break;
+    }
+
+      // Link new col right of the col before it
+    lcol = (col + n > 0) ? ms->cols[col + n - 1] : NULL;
+
+    for (pcell = ncol, i = 0; pcell; pcell = pcell->down, i++)
+    {
+      if (lcol)
+      {
+        lcol->right = pcell;
+        pcell->left = lcol;
+        lcol = lcol->down;
+      }
+        // New left column becomes the row heads
+      if (!col && !n) ms->rows[i] = pcell;
+        // New right column holds the last cell
+      if (col == cwid) ms->end = pcell;
+    }
+
+    ms->cols[col + n] = ncol;
+  }
+
+  if (n < count)
+    memmove(ms->cols + col + n,
+            ms->cols + col + count,
+            (size_t)(cwid - col) * sizeof(_cell *));
+
+    // Link last new col left of the col after the band
+  lcol = (col + n > 0) ? ms->cols[col + n - 1] : NULL;
+
+  while (lcol || rcol)
+  {
+    if (lcol) lcol->right = rcol;
+    if (rcol) rcol->left = lcol;
+    if (lcol) lcol = lcol->down;
+    if (rcol) rcol = rcol->down;
+  }
+
+    // Return "int"
+  return n;
+}
+
+  /*!
+
+     @brief INTERNAL:  Unlink and de-allocate mesh rows
+
+     Removes a band of rows, then links the rows either side of the band,
+     shifting the row head table once for the whole band.
+
+     @param ms    pointer to mesh storage
+     @param row    first row to remove
+     @param count    number of rows to remove
+     @param chgt    current number of rows
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _mesh_free_rows(_mesh_store *ms, int row, int count, int chgt,
+                            grid_payload_free fpl)
+{
+  _cell *urow;  // Up row, row before band
+  _cell *drow;  // Down row, row after band
+  _cell *c;
+  _cell *n;
+  _cell *e = NULL;
+  int r, i;
+
+    // Sanity check parameters.
+  assert(ms);
+
+  urow = (row > 0) ? ms->rows[row - 1] : NULL;
+  drow = (row + count < chgt) ? ms->rows[row + count] : NULL;
+
+  for (r = row; r < row + count; r++)
+    for (c = ms->rows[r]; c; c = n)
+    {
+      n = c->right;
+      _cell_free(ms, c, fpl);
+    }
+
+  for (i = 0; urow || drow; i++)
+  {
+    if (urow) urow->down = drow;
+    if (drow) drow->up = urow;
+
+      // Row below becomes the column heads
+    if (!row) ms->cols[i] = drow;
+
+    if (urow)
+    {
+      e = urow;
+      urow = urow->right;
+    }
+    if (drow) drow = drow->right;
+  }
+
+  memmove(ms->rows + row,
+          ms->rows + row + count,
+          (size_t)(chgt - row - count) * sizeof(_cell *));
+
+  if (row + count == chgt) ms->end = e;
+}
+
+  /*!
+
+     @brief INTERNAL:  Unlink and de-allocate mesh columns
+
+     Removes a band of columns, then links the columns either side of the
+     band, shifting the column head table once for the whole band.
+
+     @param ms    pointer to mesh storage
+     @param col    first column to remove
+     @param count    number of columns to remove
+     @param cwid    current number of columns
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _mesh_free_columns(_mesh_store *ms, int col, int count, int cwid,
+                               grid_payload_free fpl)
+{
+  _cell *lcol;  // Left col, col before band
+  _cell *rcol;  // Right col, col after band
+  _cell *c;
+  _cell *n;
+  _cell *e = NULL;
+  int x, i;
+
+    // Sanity check parameters.
+  assert(ms);
+
+  lcol = (col > 0) ? ms->cols[col - 1] : NULL;
+  rcol = (col + count < cwid) ? ms->cols[col + count] : NULL;
+
+  for (x = col; x < col + count; x++)
+    for (c = ms->cols[x]; c; c = n)
+    {
+      n = c->down;
+      _cell_free(ms, c, fpl);
+    }
+
+  for (i = 0; lcol || rcol; i++)
+  {
+    if (lcol) lcol->right = rcol;
+    if (rcol) rcol->left = lcol;
+
+      // Column to the right becomes the row heads
+    if (!col) ms->rows[i] = rcol;
+
+    if (lcol)
+    {
+      e = lcol;
+      lcol = lcol->down;
+    }
+    if (rcol) rcol = rcol->down;
+  }
+
+  memmove(ms->cols + col,
+          ms->cols + col + count,
+          (size_t)(cwid - col - count) * sizeof(_cell *));
+
+  if (col + count == cwid) ms->end = e;
+}
+
+  /*!
+
+     @brief INTERNAL:  De-allocate all mesh cells
+
+     Calls the payload destructor, if any, for every payload in the mesh by
+     scanning the cell slabs in memory order, then de-allocates the slabs
+     themselves.  Recycled cells never hold a payload.
+
+     @param ms    pointer to mesh storage
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _mesh_clear(_mesh_store *ms, grid_payload_free fpl)
+{
+  _cell_slab *slab;
+  _cell_slab *next;
+  int i;
+
+    // Sanity check parameters.
+  assert(ms);
+
+  for (slab = ms->slabs; slab; slab = next)
+  {
+    next = slab->next;
+    if (fpl)
+      for (i = 0; i < slab->used; ++i)
+        if (slab->cells[i].payload) fpl(slab->cells[i].payload);
+    free(slab);
+  }
+
+  ms->slabs = NULL;
+  ms->spare = NULL;
+  ms->nspare = 0;
+  ms->end = NULL;
+  ms->finger = NULL;
+}
+
+  /*!
+
+     @brief INTERNAL:  Reserve cells for a new row or column
+
+     Makes sure the next count cells can be handed out without another
+     allocation.  Recycled cells are used when there are enough of them,
+     otherwise a new slab large enough for the whole row or column is
+     allocated, so its cells are contiguous in memory.  Cells left over in
+     the previous slab are recycled.
+
+     @param ms    pointer to mesh storage
+     @param count    number of cells required
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _mesh_reserve_cells(_mesh_store *ms, int count)
+{
+  _cell_slab *slab;
+  _cell *c;
+  int n;
+
+    // Sanity check parameters.
+  assert(ms);
+
+  if (ms->slabs && (ms->slabs->count - ms->slabs->used) >= count) return 0;
+  if (ms->nspare >= count) return 0;
+
+  n = (count > MESH_SLAB_CELLS) ? count : MESH_SLAB_CELLS;
+
+  slab = (_cell_slab *)malloc(sizeof(_cell_slab) + (size_t)n * sizeof(_cell));
+  if (!slab) return -1;
+
+    // Recycle what is left of current slab
+  if (ms->slabs)
+    while (ms->slabs->used < ms->slabs->count)
+    {
+      c = &ms->slabs->cells[ms->slabs->used++];
+      c->payload = NULL;
+      c->right = ms->spare;
+      ms->spare = c;
+      ++ms->nspare;
+    }
+
+  slab->next = ms->slabs;
+  slab->count = n;
+  slab->used = 0;
+  ms->slabs = slab;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL: Create a new cell
+
+     Hands out a new cell from the current slab, or a recycled cell, or
+     failing both, from a newly allocated slab.
+
+     @param ms    pointer to mesh storage
+     @param pl    pointer to payload data for new cell
+
+     @retval "_cell *" success
+     @retval NULL    failure
+
+  */
+
+static _cell *_cell_new(_mesh_store *ms, void *pl)
+{
+  _cell *c;
+
+    // Sanity check parameters.
+  assert(ms);
+
+  if (ms->slabs && ms->slabs->used < ms->slabs->count)
+    c = &ms->slabs->cells[ms->slabs->used++];
+  else if (ms->spare)
+  {
+    c = ms->spare;
+    ms->spare = c->right;
+    --ms->nspare;
+  }
+  else
+  {
+    if (_mesh_reserve_cells(ms, 1)) return NULL;
+    c = &ms->slabs->cells[ms->slabs->used++];
+  }
+
+  memset(c, 0, sizeof(_cell));
+
+  c->payload = pl;
+
+    // Return "_cell *"
+  return c;
+}
+
+  /*!
+
+     @brief INTERNAL:  Recycle a cell and possibly payload data
+
+     Recycles an existing cell, and possibly de-allocates the payload data
+     associated with the cell.  If no payload data destructor function
+     is supplied, then the payload data is left intact.
+
+     @param ms    pointer to mesh storage
+     @param c    pointer to existing cell
+     @param fpl    pointer to user defined payload data destructor
+
+     @retval NONE
+
+  */
+
+static void _cell_free(_mesh_store *ms, _cell *c, grid_payload_free fpl)
+{
+    // Sanity check parameters.
+  assert(ms);
+  assert(c);
+
+  if (fpl && c->payload) fpl(c->payload);
+
+  c->payload = NULL;
+  c->right = ms->spare;
+  ms->spare = c;
+  ++ms->nspare;
+}
+
+// STATIC functions: dense storage engine
+
+  /*!
+
+     @brief INTERNAL:  Allocate dense storage
+
+     @param gin    pointer to grid internals
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _dense_init(_grid_internals *gin)
+{
+  _dense_store *ds;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ds = (_dense_store *)malloc(sizeof(_dense_store));
+  if (!ds) return -1;
+  memset(ds, 0, sizeof(_dense_store));
+
+  gin->store = ds;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  De-allocate dense storage
+
+     @param gin    pointer to grid internals
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _dense_release(_grid_internals *gin, grid_payload_free fpl)
+{
+  _dense_store *ds;
+  int height, width;
+  int y, x;
+  void *pl;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ds = (_dense_store *)gin->store;
+  if (!ds) return;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+  if (fpl && ds->cells)
+    for (y = 0; y < height; ++y)
+      for (x = 0; x < width; ++x)
+      {
+        pl = ds->cells[(size_t)y * ds->stride + x];
+        if (pl) fpl(pl);
+      }
+
+  free(ds->cells);
+  free(ds);
+  gin->store = NULL;
+}
+
+  /*!
+
+     @brief INTERNAL:  Get payload data of dense cell
+
+     @param gin    pointer to grid internals
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval "void *" success
+     @retval NULL    failure
+
+  */
+
+static void *_dense_get(_grid_internals *gin, int row, int col)
+{
+  _dense_store *ds;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ds = (_dense_store *)gin->store;
+  if (!ds->cells) return NULL;
+
+    // Return "void *"
+  return ds->cells[(size_t)row * ds->stride + col];
+}
+
+  /*!
+
+     @brief INTERNAL:  Set payload data of dense cell
+
+     @param gin    pointer to grid internals
+     @param row    row of cell
+     @param col    column of cell
+     @param pl    pointer to payload data
+
+     @retval NONE
+
+  */
+
+static void _dense_set(_grid_internals *gin, int row, int col, void *pl)
+{
+  _dense_store *ds;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ds = (_dense_store *)gin->store;
+  if (ds->cells) ds->cells[(size_t)row * ds->stride + col] = pl;
+}
+
+  /*!
+
+     @brief INTERNAL:  Change size of dense storage
+
+     Truncated cells are cleared, so that every unused slot of the array is
+     always NULL, and growing within the allocated capacity only needs to
+     adjust the grid size.
+
+     @param gin    pointer to grid internals
+     @param rows    new number of rows
+     @param cols    new number of columns
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _dense_resize(_grid_internals *gin, int rows, int cols,
+                         grid_payload_free fpl)
+{
+  _dense_store *ds;
+  int height, width;
+  int y, x;
+  void **p;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ds = (_dense_store *)gin->store;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+    // Clear truncated cells
+  for (y = 0; y < height; ++y)
+  {
+    p = ds->cells + (size_t)y * ds->stride;
+    for (x = (y < rows) ? cols : 0; x < width; ++x)
+    {
+      if (fpl && p[x]) fpl(p[x]);
+      p[x] = NULL;
+    }
+  }
+
+  if (!rows || !cols)
+  {
+    free(ds->cells);
+    memset(ds, 0, sizeof(_dense_store));
+    return 0;
+  }
+
+    // Return "int"
+  return _dense_reserve(gin, rows, cols);
+}
+
+  /*!
+
+     @brief INTERNAL:  Insert empty rows into dense storage
+
+     @param gin    pointer to grid internals
+     @param row    row before which to insert
+     @param count    number of rows to insert
+
+     @retval "int" number of rows inserted
+
+  */
+
+static int _dense_insert_rows(_grid_internals *gin, int row, int count)
+{
+  _dense_store *ds;
+  int height, width;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ds = (_dense_store *)gin->store;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+  if (_dense_reserve(gin, height + count, width)) return 0;
+
+  memmove(ds->cells + (size_t)(row + count) * ds->stride,
+          ds->cells + (size_t)row * ds->stride,
+          (size_t)(height - row) * ds->stride * sizeof(void *));
+  memset(ds->cells + (size_t)row * ds->stride,
+         0,
+         (size_t)count * ds->stride * sizeof(void *));
+
+    // Return "int"
+  return count;
+}
+
+  /*!
+
+     @brief INTERNAL:  Insert empty columns into dense storage
+
+     @param gin    pointer to grid internals
+     @param col    column before which to insert
+     @param count    number of columns to insert
+
+     @retval "int" number of columns inserted
+
+  */
+
+static int _dense_insert_columns(_grid_internals *gin, int col, int count)
+{
+  _dense_store *ds;
+  int height, width;
+  int y;
+  void **p;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ds = (_dense_store *)gin->store;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+  if (_dense_reserve(gin, height, width + count)) return 0;
+
+  for (y = 0; y < height; ++y)
+  {
+    p = ds->cells + (size_t)y * ds->stride;
+    memmove(p + col + count, p + col, (size_t)(width - col) * sizeof(void *));
+    memset(p + col, 0, (size_t)count * sizeof(void *));
+  }
+
+    // Return "int"
+  return count;
+}
+
+  /*!
+
+     @brief INTERNAL:  Remove rows from dense storage
+
+     @param gin    pointer to grid internals
+     @param row    first row to remove
+     @param count    number of rows to remove
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _dense_remove_rows(_grid_internals *gin, int row, int count,
+                               grid_payload_free fpl)
+{
+  _dense_store *ds;
+  int height, width;
+  int y, x;
+  void **p;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ds = (_dense_store *)gin->store;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+  if (fpl)
+    for (y = row; y < row + count; ++y)
+    {
+      p = ds->cells + (size_t)y * ds->stride;
+      for (x = 0; x < width; ++x)
+        if (p[x]) fpl(p[x]);
+    }
+
+  memmove(ds->cells + (size_t)row * ds->stride,
+          ds->cells + (size_t)(row + count) * ds->stride,
+          (size_t)(height - row - count) * ds->stride * sizeof(void *));
+  memset(ds->cells + (size_t)(height - count) * ds->stride,
+         0,
+         (size_t)count * ds->stride * sizeof(void *));
+}
+
+  /*!
+
+     @brief INTERNAL:  Remove columns from dense storage
+
+     @param gin    pointer to grid internals
+     @param col    first column to remove
+     @param count    number of columns to remove
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _dense_remove_columns(_grid_internals *gin, int col, int count,
+                                  grid_payload_free fpl)
+{
+  _dense_store *ds;
+  int height, width;
+  int y, x;
+  void **p;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ds = (_dense_store *)gin->store;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+  for (y = 0; y < height; ++y)
+  {
+    p = ds->cells + (size_t)y * ds->stride;
+    if (fpl)
+      for (x = col; x < col + count; ++x)
+        if (p[x]) fpl(p[x]);
+    memmove(p + col,
+            p + col + count,
+            (size_t)(width - col - count) * sizeof(void *));
+    memset(p + width - count, 0, (size_t)count * sizeof(void *));
+  }
+}
+
+  /*!
+
+     @brief INTERNAL:  Reorder rows of dense storage
+
+     Rows are moved in place, one cycle of the permutation at a time, so that
+     only one row is ever held aside.
+
+     @param gin    pointer to grid internals
+     @param perm    pointer to permutation, one entry per row
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _dense_permute_rows(_grid_internals *gin, const int *perm)
+{
+  _dense_store *ds;
+  void **row;
+  char *done;
+  size_t bytes;
+  int height;
+  int y, to, from;
+
+    // Sanity check parameters.
+  assert(gin);
+  assert(perm);
+
+  ds = (_dense_store *)gin->store;
+
+  height = grid_size_get_height(gin->size);
+  bytes = (size_t)grid_size_get_width(gin->size) * sizeof(void *);
+
+  row = (void **)malloc(bytes);
+  done = (char *)calloc((size_t)height, sizeof(char));
+  if (!row || !done)
+  {
+    free(row);
+    free(done);
+    return -1;
+  }
+
+  for (y = 0; y < height; ++y)
+  {
+    if (done[y] || perm[y] == y) continue;
+
+    memcpy(row, ds->cells + (size_t)y * ds->stride, bytes);
+
+    for (to = y; (from = perm[to]) != y; to = from)
+    {
+      memcpy(ds->cells + (size_t)to * ds->stride,
+             ds->cells + (size_t)from * ds->stride,
+             bytes);
+      done[to] = 1;
+    }
+
+    memcpy(ds->cells + (size_t)to * ds->stride, row, bytes);
+    done[to] = 1;
+  }
+
+  free(row);
+  free(done);
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Get payloads of part of a dense row
+
+     @param gin    pointer to grid internals
+     @param pos    unused
+     @param row    row of cells
+     @param col    first column of cells
+     @param count    pointer to storage for number of payloads
+     @param buf    unused
+     @param size    unused
+
+     @retval "void **" pointer to payloads
+
+  */
+
+static void **_dense_span(_grid_internals *gin, _grid_position *pos,
+                          int row, int col, int *count, void **buf, int size)
+{
+  _dense_store *ds;
+
+    // Sanity check parameters.
+  assert(gin);
+  assert(count);
+
+  (void)pos;
+  (void)buf;
+  (void)size;
+
+  ds = (_dense_store *)gin->store;
+
+  *count = grid_size_get_width(gin->size) - col;
+
+    // Return "void **"
+  return ds->cells + (size_t)row * ds->stride + col;
+}
+
+  /*!
+
+     @brief INTERNAL:  Reserve dense storage capacity
+
+     Makes sure the array can hold at least the requested number of rows and
+     columns, preserving the current cells.  Capacity grows geometrically, so
+     that appending rows or columns one at a time is amortized constant time
+     per cell.
+
+     @param gin    pointer to grid internals
+     @param rows    number of rows required
+     @param cols    number of columns required
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _dense_reserve(_grid_internals *gin, int rows, int cols)
+{
+  _dense_store *ds;
+  int height, width;
+  int capacity, stride;
+  void **cells;
+  int y;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ds = (_dense_store *)gin->store;
+
+  if (rows <= ds->capacity && cols <= ds->stride) return 0;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+  capacity = ds->capacity;
+  if (rows > capacity)
+    capacity = (rows > capacity + capacity / 2) ? rows : capacity + capacity / 2;
+
+  stride = ds->stride;
+  if (cols > stride)
+    stride = (cols > stride + stride / 2) ? cols : stride + stride / 2;
+
+  if (stride == ds->stride && ds->cells)
+  {
+      // Same row layout, just more rows
+    cells = (void **)realloc(ds->cells,
+                             (size_t)capacity * stride * sizeof(void *));
+    if (!cells) return -1;
+    memset(cells + (size_t)ds->capacity * stride,
+           0,
+           (size_t)(capacity - ds->capacity) * stride * sizeof(void *));
+  }
+  else
+  {
+      // New row layout, copy rows into place
+    cells = (void **)calloc((size_t)capacity * stride, sizeof(void *));
+    if (!cells) return -1;
+    if (ds->cells)
+      for (y = 0; y < height; ++y)
+        memcpy(cells + (size_t)y * stride,
+               ds->cells + (size_t)y * ds->stride,
+               (size_t)width * sizeof(void *));
+    free(ds->cells);
+  }
+
+  ds->cells = cells;
+  ds->capacity = capacity;
+  ds->stride = stride;
+
+    // Return "int"
+  return 0;
+}
+
+// STATIC functions: sparse storage engine
+
+  /*!
+
+     @brief INTERNAL:  Allocate sparse storage
+
+     @param gin    pointer to grid internals
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _sparse_init(_grid_internals *gin)
+{
+  _sparse_store *ss;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ss = (_sparse_store *)malloc(sizeof(_sparse_store));
+  if (!ss) return -1;
+  memset(ss, 0, sizeof(_sparse_store));
+
+  gin->store = ss;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  De-allocate sparse storage
+
+     @param gin    pointer to grid internals
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _sparse_release(_grid_internals *gin, grid_payload_free fpl)
+{
+  _sparse_store *ss;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ss = (_sparse_store *)gin->store;
+  if (!ss) return;
+
+  _sparse_clear(ss, fpl);
+
+  free(ss);
+  gin->store = NULL;
+}
+
+  /*!
+
+     @brief INTERNAL:  Get payload data of sparse cell
+
+     @param gin    pointer to grid internals
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval "void *" success
+     @retval NULL    cell is empty
+
+  */
+
+static void *_sparse_get(_grid_internals *gin, int row, int col)
+{
+  _sparse_store *ss;
+  int i;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ss = (_sparse_store *)gin->store;
+
+  i = _sparse_find(ss, ss->rows.ids[row], ss->cols.ids[col]);
+  if (i < 0) return NULL;
+
+    // Return "void *"
+  return ss->slots[i].payload;
+}
+
+  /*!
+
+     @brief INTERNAL:  Set payload data of sparse cell
+
+     Setting a NULL payload removes the cell from the table.
+
+     @param gin    pointer to grid internals
+     @param row    row of cell
+     @param col    column of cell
+     @param pl    pointer to payload data
+
+     @retval NONE
+
+  */
+
+static void _sparse_set(_grid_internals *gin, int row, int col, void *pl)
+{
+  _sparse_store *ss;
+  unsigned int mask;
+  int rid, cid;
+  int i;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ss = (_sparse_store *)gin->store;
+
+  rid = ss->rows.ids[row];
+  cid = ss->cols.ids[col];
+
+  i = _sparse_find(ss, rid, cid);
+  if (i >= 0)
+  {
+    if (pl)
+      ss->slots[i].payload = pl;
+    else
+      _sparse_take(ss, i);
+    return;
+  }
+
+  if (!pl) return;
+
+    // Keep load factor under 3/4, but use any free slot if growth fails
+  if ((ss->count + 1) * 4 > ss->capacity * 3)
+    if (_sparse_rehash(ss, ss->capacity ? ss->capacity * 2 : 16) &&
+        ss->count + 1 >= ss->capacity)
+      return;
+
+  mask = (unsigned int)ss->capacity - 1;
+  for (i = (int)(_sparse_hash(rid, cid) & mask);
+       ss->slots[i].payload;
+       i = (int)((i + 1) & mask)) ;
+
+  ss->slots[i].row = rid;
+  ss->slots[i].col = cid;
+  ss->slots[i].payload = pl;
+  ++ss->count;
+}
+
+  /*!
+
+     @brief INTERNAL:  Change size of sparse storage
+
+     @param gin    pointer to grid internals
+     @param rows    new number of rows
+     @param cols    new number of columns
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _sparse_resize(_grid_internals *gin, int rows, int cols,
+                          grid_payload_free fpl)
+{
+  _sparse_store *ss;
+  int height, width;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ss = (_sparse_store *)gin->store;
+
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
+
+  if (!rows || !cols)
+  {
+    _sparse_clear(ss, fpl);
+    return 0;
+  }
+
+  if (!height) width = 0;
+
+  if (rows < height)
+  {
+    _sparse_drop(ss, 1, rows, height - rows, width, fpl);
+    _grid_axis_remove(&ss->rows, rows, height - rows, height);
+    height = rows;
+  }
+
+  if (cols < width)
+  {
+    _sparse_drop(ss, 0, cols, width - cols, height, fpl);
+    _grid_axis_remove(&ss->cols, cols, width - cols, width);
+    width = cols;
+  }
+
+  if (rows > height &&
+      _grid_axis_insert(&ss->rows, height, rows - height, height))
+    return -1;
+
+  if (cols > width &&
+      _grid_axis_insert(&ss->cols, width, cols - width, width))
+  {
+    _grid_axis_remove(&ss->rows, height, rows - height, rows);
+    return -1;
+  }
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Insert empty rows into sparse storage
+
+     Only the row id table is shifted, no cell is touched.
+
+     @param gin    pointer to grid internals
+     @param row    row before which to insert
+     @param count    number of rows to insert
+
+     @retval "int" number of rows inserted
+
+  */
+
+static int _sparse_insert_rows(_grid_internals *gin, int row, int count)
+{
+  _sparse_store *ss;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ss = (_sparse_store *)gin->store;
+
+  if (_grid_axis_insert(&ss->rows,
+                          row,
+                          count,
+                          grid_size_get_height(gin->size)))
+    return 0;
+
+    // Return "int"
+  return count;
+}
+
+  /*!
+
+     @brief INTERNAL:  Insert empty columns into sparse storage
+
+     Only the column id table is shifted, no cell is touched.
+
+     @param gin    pointer to grid internals
+     @param col    column before which to insert
+     @param count    number of columns to insert
+
+     @retval "int" number of columns inserted
+
+  */
+
+static int _sparse_insert_columns(_grid_internals *gin, int col, int count)
+{
+  _sparse_store *ss;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ss = (_sparse_store *)gin->store;
+
+  if (_grid_axis_insert(&ss->cols,
+                          col,
+                          count,
+                          grid_size_get_width(gin->size)))
+    return 0;
+
+    // Return "int"
+  return count;
+}
+
+  /*!
+
+     @brief INTERNAL:  Remove rows from sparse storage
+
+     @param gin    pointer to grid internals
+     @param row    first row to remove
+     @param count    number of rows to remove
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _sparse_remove_rows(_grid_internals *gin, int row, int count,
+                                grid_payload_free fpl)
+{
+  _sparse_store *ss;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ss = (_sparse_store *)gin->store;
+
+  _sparse_drop(ss, 1, row, count, grid_size_get_width(gin->size), fpl);
+  _grid_axis_remove(&ss->rows, row, count, grid_size_get_height(gin->size));
+}
+
+  /*!
+
+     @brief INTERNAL:  Remove columns from sparse storage
+
+     @param gin    pointer to grid internals
+     @param col    first column to remove
+     @param count    number of columns to remove
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _sparse_remove_columns(_grid_internals *gin, int col, int count,
+                                   grid_payload_free fpl)
+{
+  _sparse_store *ss;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ss = (_sparse_store *)gin->store;
+
+  _sparse_drop(ss, 0, col, count, grid_size_get_height(gin->size), fpl);
+  _grid_axis_remove(&ss->cols, col, count, grid_size_get_width(gin->size));
+}
+
+  /*!
+
+     @brief INTERNAL:  Reorder rows of sparse storage
+
+     Only the row id table is reordered, no cell is touched.
+
+     @param gin    pointer to grid internals
+     @param perm    pointer to permutation, one entry per row
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _sparse_permute_rows(_grid_internals *gin, const int *perm)
+{
+  _sparse_store *ss;
+
+    // Sanity check parameters.
+  assert(gin);
+  assert(perm);
+
+  ss = (_sparse_store *)gin->store;
+
+    // Return "int"
+  return _grid_axis_permute(&ss->rows, perm, grid_size_get_height(gin->size));
+}
+
+  /*!
+
+     @brief INTERNAL:  Get payloads of part of a sparse row
+
+     @param gin    pointer to grid internals
+     @param pos    unused
+     @param row    row of cells
+     @param col    first column of cells
+     @param count    pointer to storage for number of payloads
+     @param buf    pointer to buffer for payloads
+     @param size    number of payloads buffer holds
+
+     @retval "void **" pointer to payloads
+
+  */
+
+static void **_sparse_span(_grid_internals *gin, _grid_position *pos,
+                           int row, int col, int *count, void **buf, int size)
+{
+  int n;
+  int i;
+
+    // Sanity check parameters.
+  assert(gin);
+  assert(count);
+  assert(buf);
+
+  (void)pos;
+
+  n = grid_size_get_width(gin->size) - col;
+  if (n > size) n = size;
+
+  for (i = 0; i < n; ++i)
+    buf[i] = _sparse_get(gin, row, col + i);
+
+  *count = n;
+
+    // Return "void **"
+  return buf;
+}
+
+  /*!
+
+     @brief INTERNAL:  Hash a sparse cell key
+
+     @param rid    row id
+     @param cid    column id
+
+     @retval "unsigned int" hash value
+
+  */
+
+static unsigned int _sparse_hash(int rid, int cid)
+{
+  uint64_t k;
+
+  k = ((uint64_t)(unsigned int)rid << 32) | (unsigned int)cid;
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+
+    // Return "unsigned int"
+  return (unsigned int)k;
+}
+
+  /*!
+
+     @brief INTERNAL:  Find slot of a sparse cell
+
+     @param ss    pointer to sparse storage
+     @param rid    row id
+     @param cid    column id
+
+     @retval "int" slot index
+     @retval -1    cell is empty
+
+  */
+
+static int _sparse_find(_sparse_store *ss, int rid, int cid)
+{
+  unsigned int mask;
+  unsigned int i;
+
+    // Sanity check parameters.
+  assert(ss);
+
+  if (!ss->count) return -1;
+
+  mask = (unsigned int)ss->capacity - 1;
+
+  for (i = _sparse_hash(rid, cid) & mask;
+       ss->slots[i].payload;
+       i = (i + 1) & mask)
+    if (ss->slots[i].row == rid && ss->slots[i].col == cid)
+        // Return "int"
+      return (int)i;
+
+    // Return "int"
+  return -1;
+}
+
+  /*!
+
+     @brief INTERNAL:  Remove a sparse cell from its slot
+
+     Empties a slot, shifting back any following entries of the same probe
+     sequence, so that no deleted markers are needed.
+
+     @param ss    pointer to sparse storage
+     @param i    slot index
+
+     @retval "void *" payload data of removed cell
+
+  */
+
+static void *_sparse_take(_sparse_store *ss, int i)
+{
+  unsigned int mask;
+  unsigned int hole, j, k;
+  void *pl;
+
+    // Sanity check parameters.
+  assert(ss);
+
+  mask = (unsigned int)ss->capacity - 1;
+  pl = ss->slots[i].payload;
+
+  for (hole = (unsigned int)i, j = hole; ; )
+  {
+    j = (j + 1) & mask;
+    if (!ss->slots[j].payload) break;
+
+    k = _sparse_hash(ss->slots[j].row, ss->slots[j].col) & mask;
+
+      // Entry stays if its home slot lies cyclically in (hole, j]
+    if ((hole <= j) ? (hole < k && k <= j) : (hole < k || k <= j)) continue;
+
+    ss->slots[hole] = ss->slots[j];
+    hole = j;
+  }
+
+  ss->slots[hole].payload = NULL;
+  --ss->count;
+
+    // Return "void *"
+  return pl;
+}
+
+  /*!
+
+     @brief INTERNAL:  Re-build sparse table with new capacity
+
+     @param ss    pointer to sparse storage
+     @param capacity    new number of slots, a power of two
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _sparse_rehash(_sparse_store *ss, int capacity)
+{
+  _sparse_entry *slots;
+  unsigned int mask;
+  unsigned int j;
+  int i;
+
+    // Sanity check parameters.
+  assert(ss);
+
+  slots = (_sparse_entry *)calloc((size_t)capacity, sizeof(_sparse_entry));
+  if (!slots) return -1;
+
+  mask = (unsigned int)capacity - 1;
+
+  for (i = 0; i < ss->capacity; ++i)
+  {
+    if (!ss->slots[i].payload) continue;
+    for (j = _sparse_hash(ss->slots[i].row, ss->slots[i].col) & mask;
+         slots[j].payload;
+         j = (j + 1) & mask) ;
+    slots[j] = ss->slots[i];
+  }
+
+  free(ss->slots);
+  ss->slots = slots;
+  ss->capacity = capacity;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Remove every sparse cell in a band of rows or columns
+
+     Removes cells either by probing for every cell of the band, or, when the
+     band is larger than the table, by a single scan of the table.
+
+     @param ss    pointer to sparse storage
+     @param rows    non-zero for a band of rows, zero for a band of columns
+     @param at    first row or column of band
+     @param count    number of rows or columns in band
+     @param other    number of columns or rows crossing the band
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _sparse_drop(_sparse_store *ss, int rows, int at, int count,
+                         int other, grid_payload_free fpl)
+{
+  _grid_axis *axis;
+  _grid_axis *cross;
+  unsigned char *flags;
+  void *pl;
+  int i, j, k;
+
+    // Sanity check parameters.
+  assert(ss);
+
+  if (!ss->count) return;
+
+  axis = (rows) ? &ss->rows : &ss->cols;
+  cross = (rows) ? &ss->cols : &ss->rows;
+
+  flags = NULL;
+  if ((double)count * other > ss->capacity)
+    flags = (unsigned char *)calloc((size_t)axis->next, 1);
+
+  if (!flags)
+  {
+      // Probe every cell of band
+    for (i = at; i < at + count; ++i)
+      for (j = 0; j < other && ss->count; ++j)
+      {
+        k = (rows) ? _sparse_find(ss, axis->ids[i], cross->ids[j])
+                   : _sparse_find(ss, cross->ids[j], axis->ids[i]);
+        if (k < 0) continue;
+        pl = _sparse_take(ss, k);
+        if (fpl) fpl(pl);
+      }
+    return;
+  }
+
+    // Scan whole table for ids of band
+  for (i = at; i < at + count; ++i)
+    flags[axis->ids[i]] = 1;
+
+  for (k = 0; k < ss->capacity; ++k)
+    while (ss->slots[k].payload &&
+           flags[(rows) ? ss->slots[k].row : ss->slots[k].col])
+    {
+      pl = _sparse_take(ss, k);
+      if (fpl) fpl(pl);
+    }
+
+  free(flags);
+}
+
+  /*!
+
+     @brief INTERNAL:  De-allocate all sparse cells and id tables
+
+     @param ss    pointer to sparse storage
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _sparse_clear(_sparse_store *ss, grid_payload_free fpl)
+{
+  int i;
+
+    // Sanity check parameters.
+  assert(ss);
+
+  if (fpl)
+    for (i = 0; i < ss->capacity; ++i)
+      if (ss->slots[i].payload) fpl(ss->slots[i].payload);
+
+  free(ss->slots);
+  _grid_axis_free(&ss->rows);
+  _grid_axis_free(&ss->cols);
+
+  memset(ss, 0, sizeof(_sparse_store));
+}
+
+// STATIC functions: tiled storage engine
+
+  /*!
+
+     @brief INTERNAL:  Allocate tiled storage
+
+     @param gin    pointer to grid internals
+
+     @retval 0    success
+     @retval -1    failure
+
+  */
+
+static int _tiled_init(_grid_internals *gin)
+{
+  _tiled_store *ts;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ts = (_tiled_store *)malloc(sizeof(_tiled_store));
+  if (!ts) return -1;
+  memset(ts, 0, sizeof(_tiled_store));
+
+  gin->store = ts;
+
+    // Return "int"
+  return 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  De-allocate tiled storage
+
+     @param gin    pointer to grid internals
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
+
+  */
+
+static void _tiled_release(_grid_internals *gin, grid_payload_free fpl)
+{
+  _tiled_store *ts;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ts = (_tiled_store *)gin->store;
+  if (!ts) return;
+
+  gin->store = NULL;
+
+    // A store shared with other grids is left to them
+  if (atomic_load(&ts->refs) > 0 && atomic_fetch_sub(&ts->refs, 1) > 0)
+    return;
+
+  _tiled_clear(ts, fpl);
+
+  free(ts);
+}
+
+  /*!
+
+     @brief INTERNAL:  Get payload data of tiled cell
+
+     @param gin    pointer to grid internals
+     @param row    row of cell
+     @param col    column of cell
+
+     @retval "void *" success
+     @retval NULL    cell is empty
+
+  */
+
+static void *_tiled_get(_grid_internals *gin, int row, int col)
+{
+  _tiled_store *ts;
+  int b, off;
+
+    // Sanity check parameters.
+  assert(gin);
+
+  ts = (_tiled_store *)gin->store;
+
+  b = _tiled_band_of(ts, row, &off);
+
+    // Return "void *"
+  return *_tiled_cell(&ts->bands[b], off, col);
+}
+
+  /*!
+
+     @brief INTERNAL:  Set payload data of tiled cell
+
+     @param gin    pointer to grid internals
+     @param row    row of cell
+     @param col    column of cell
+     @param pl    pointer to payload data
+
+     @retval NONE
+
+  */
+
+static void _tiled_set(_grid_internals *gin, int row, int col, void *pl)
+{
+  _tiled_store *ts;
+  int b, off;
+
+    // Sanity check parameters.
+  assert(gin);
 
-     @param grid    pointer to existing grid
-     @param gs    pointer to "grid size" structure containing desired grid size
+  ts = (_tiled_store *)gin->store;
 
-     @retval NONE    failure
+  b = _tiled_band_of(ts, row, &off);
+
+  *_tiled_cell(&ts->bands[b], off, col) = pl;
+}
+
+  /*!
+
+     @brief INTERNAL:  Change size of tiled storage
+
+     @param gin    pointer to grid internals
+     @param rows    new number of rows
+     @param cols    new number of columns
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval 0    success
+     @retval -1    failure
 
   */
 
-void grid_set_size_free_only(grid_s *grid, grid_size_s *gs)
+static int _tiled_resize(_grid_internals *gin, int rows, int cols,
+                         grid_payload_free fpl)
 {
-  grid_size_s *size;
-  int rows, cols;
-  int width, height;
-  int i;
+  _tiled_store *ts;
+  int height, width;
 
     // Sanity check parameters.
-  assert(grid);
-  assert(gs);
+  assert(gin);
 
-  size = grid_get_size(grid);
-  if (!size) return;
+  ts = (_tiled_store *)gin->store;
 
-  cols = grid_size_get_width(gs);
-  rows = grid_size_get_height(gs);
+  height = grid_size_get_height(gin->size);
+  width = grid_size_get_width(gin->size);
 
-  width = grid_size_get_width(size);
-  height = grid_size_get_height(size);
+  if (!rows || !cols)
+  {
+    _tiled_clear(ts, fpl);
+    return 0;
+  }
 
-    // If rows is greater than current size, insert needed rows at end
-  for (i = height; i < rows; ++i)
-    grid_create_row(grid, -1);
+  if (rows < height) _tiled_drop_rows(ts, rows, height - rows, fpl);
 
-    // If rows is less than current size, delete rows from end
-  for (i = height - 1; rows < (i + 1); --i)
-    grid_free_row(grid, -1);
+  if (cols < width) _tiled_narrow(ts, cols, fpl);
 
-    // If cols is greater than current size, insert cols at end
-  for (i = width; i < cols; ++i)
-    grid_create_column(grid, -1);
+  if (_tiled_widen(ts, (cols + TILE_SIZE - 1) / TILE_SIZE)) return -1;
 
-    // If cols is less than current size, delete cols from end
-  for (i = width - 1; cols < (i + 1); --i)
-    grid_free_column(grid, -1);
+  if (rows > height && !_tiled_add_rows(ts, -1, 0, rows - height))
+    return -1;
+
+    // Return "int"
+  return 0;
 }
 
   /*!
 
-     @brief Get "grid size" structure from grid
+     @brief INTERNAL:  Insert empty rows into tiled storage
 
-     Get "grid size" structure from grid
+     Only the band of tiles holding the insertion point is touched; a full
+     band is split in two rather than shifting every following row.
 
-     @param grid    pointer to exising grid
+     @param gin    pointer to grid internals
+     @param row    row before which to insert
+     @param count    number of rows to insert
 
-     @retval "grid_size_s *" success
-     @retval NULL    failure
+     @retval "int" number of rows inserted
 
   */
 
-grid_size_s *grid_get_size(grid_s *grid)
+static int _tiled_insert_rows(_grid_internals *gin, int row, int count)
 {
-  _grid_internals *gi;
+  _tiled_store *ts;
+  int b, off;
 
     // Sanity check parameters.
-  assert(grid);
+  assert(gin);
 
-  gi = _grid_get_internals(grid);
-  if (!gi) return NULL;
+  ts = (_tiled_store *)gin->store;
 
-    // Return "grid_size_s *"
-  return gi->size;
+  if (row == grid_size_get_height(gin->size))
+    return _tiled_add_rows(ts, -1, 0, count);
+
+  b = _tiled_band_of(ts, row, &off);
+
+    // Prefer the end of the previous band over the start of this one
+  if (!off && b && ts->bands[b - 1].rows + count <= TILE_SIZE)
+    off = ts->bands[--b].rows;
+
+    // Return "int"
+  return _tiled_add_rows(ts, b, off, count);
 }
 
   /*!
 
-     @brief Get location structure from grid
-
-     Get location structure from grid
+     @brief INTERNAL:  Insert empty columns into tiled storage
 
-     @param grid    pointer to exising grid
+     @param gin    pointer to grid internals
+     @param col    column before which to insert
+     @param count    number of columns to insert
 
-     @retval "vertex_s *" success
-     @retval NULL    failure
+     @retval "int" number of columns inserted
 
   */
 
-vertex_s *grid_get_location(grid_s *grid)
+static int _tiled_insert_columns(_grid_internals *gin, int col, int count)
 {
-  _grid_internals *gin;
+  _tiled_store *ts;
+  _tile_band *band;
+  int width;
+  int b, r, x;
 
     // Sanity check parameters.
-  assert(grid);
+  assert(gin);
 
-  gin = _grid_get_internals(grid);
-  if (!gin) return NULL;
+  ts = (_tiled_store *)gin->store;
 
-    // Return "vertex *"
-  return gin->location;
+  width = grid_size_get_width(gin->size);
+
+  if (_tiled_widen(ts, (width + count + TILE_SIZE - 1) / TILE_SIZE)) return 0;
+
+  for (b = 0; b < ts->nbands; ++b)
+  {
+    band = &ts->bands[b];
+    for (r = 0; r < band->rows; ++r)
+    {
+      for (x = width - 1; x >= col; --x)
+        *_tiled_cell(band, r, x + count) = *_tiled_cell(band, r, x);
+      for (x = col; x < col + count && x < width; ++x)
+        *_tiled_cell(band, r, x) = NULL;
+    }
+  }
+
+    // Return "int"
+  return count;
 }
 
   /*!
 
-     @brief Create a new row in grid
-
-     Creates a new row, with no cell payload data.  The row will contain the 
-     current numer of columns as is set by the grid width.  The user supplied row
-     parameter determines where the new row will be created.   If the row
-     parameter is negative, the new row will be created after the current last
-     row.  For a non-negative row parameter, the new row will be inserted before
-     the row parameter value.  One exception, if the row parameter contains
-     a value greater than the last row, then it will be set to the last row.
+     @brief INTERNAL:  Remove rows from tiled storage
 
-     @param grid    pointer to existing grid
-     @param row     row AFTER which to add new row
+     @param gin    pointer to grid internals
+     @param row    first row to remove
+     @param count    number of rows to remove
+     @param fpl    pointer to payload destructor, or NULL
 
-     @retval NONE    failure
+     @retval NONE
 
   */
 
-void grid_create_row(grid_s *grid, int row)
+static void _tiled_remove_rows(_grid_internals *gin, int row, int count,
+                               grid_payload_free fpl)
 {
-  _grid_internals *gin;
-  int chgt, cwid;
-  _cell *urow;  // Up row, row before new row
-  _cell *drow;  // Down row, row after new row
-  int i;
-  _cell *nrow;  // New row
-  _cell *ncell; // A new cell
-  _cell *pcell; // Tracks most previous cell created
-
     // Sanity check parameters.
-  assert(grid);
+  assert(gin);
 
-  gin = _grid_get_internals(grid);
-  if (!gin) return;
+  _tiled_drop_rows((_tiled_store *)gin->store, row, count, fpl);
+}
 
-    // Get width and height of grid
-  chgt = grid_size_get_height(gin->size);
-  cwid = grid_size_get_width(gin->size);
+  /*!
 
-    // Adding row outside of grid boundry plus one row is not allowed
-  if (row > chgt) return;
+     @brief INTERNAL:  Remove columns from tiled storage
 
-    // Any negative row, indicates to add row to end
-  if (row < 0) row = chgt;
+     @param gin    pointer to grid internals
+     @param col    first column to remove
+     @param count    number of columns to remove
+     @param fpl    pointer to payload destructor, or NULL
 
-    // Fix width, if none
-  if (cwid < 1) cwid = 1;
+     @retval NONE
 
-    // Create new row with number of cells equal to width of grid
-  for (nrow = NULL, i = 0; i < cwid; i++)
-  {
-    ncell = _cell_new(NULL);
-    if (!nrow)
-      nrow = ncell;
-    else
-    {
-      pcell->right = ncell;
-      ncell->left = pcell;
-    }
-    pcell = ncell;
-  }
+  */
 
-    // If this is the first row in the grid
-  if (!chgt)
-  {
-    gin->origin = nrow;
-    gin->current = nrow;
-    gin->end = ncell;
-    vertex_set_y(gin->location, 0);
-    vertex_set_x(gin->location, 0);
-    grid_size_set_height(gin->size, 1);
-    grid_size_set_width(gin->size, cwid);
-  }
-  else
-  {
-    if (!row) // Insert before all rows
-    {
-      drow = gin->origin;
-      for (pcell = nrow; drow && pcell; drow = drow->right, pcell = pcell->right)
-      {
-        drow->up = pcell;
-        pcell->down = drow;
-      }
+static void _tiled_remove_columns(_grid_internals *gin, int col, int count,
+                                  grid_payload_free fpl)
+{
+  _tiled_store *ts;
+  _tile_band *band;
+  void **p;
+  int width;
+  int b, r, x;
 
-      gin->origin = nrow;
-      gin->current = nrow;
-      vertex_set_y(gin->location, 0);
-      vertex_set_x(gin->location, 0);
-      grid_size_set_height(gin->size, chgt + 1);
-    }
-    else if (row == chgt) // Append after all rows
-    {
-      for (urow = gin->origin; urow->down; urow = urow->down) ;
-      for (pcell = nrow; urow && pcell; urow = urow->right, pcell = pcell->right)
-      {
-        urow->down = pcell;
-        pcell->up = urow;
-      }
+    // Sanity check parameters.
+  assert(gin);
 
-      gin->end = ncell;
-      grid_size_set_height(gin->size, chgt + 1);
-    }
-    else // Inserting in middle of rows somewhere
+  ts = (_tiled_store *)gin->store;
+
+  width = grid_size_get_width(gin->size);
+
+  for (b = 0; b < ts->nbands; ++b)
+  {
+    band = &ts->bands[b];
+    for (r = 0; r < band->rows; ++r)
     {
-      for (i = 0, drow = gin->origin;
-           (i < row) && drow->down;
-           i++, drow = drow->down) ;
-      urow = drow->up;
-      for (pcell = nrow;
-           drow && urow && pcell;
-           drow = drow->right, urow = urow->right, pcell = pcell->right)
+      for (x = col; x < col + count; ++x)
       {
-        urow->down = pcell;
-        drow->up = pcell;
-        pcell->up = urow;
-        pcell->down = drow;
+        p = _tiled_cell(band, r, x);
+        if (fpl && *p) fpl(*p);
       }
-
-      grid_size_set_height(gin->size, chgt + 1);
+      for (x = col + count; x < width; ++x)
+        *_tiled_cell(band, r, x - count) = *_tiled_cell(band, r, x);
+      for (x = width - count; x < width; ++x)
+        *_tiled_cell(band, r, x) = NULL;
     }
   }
+
+  _tiled_narrow(ts, width - count, NULL);
 }
 
   /*!
 
-     @brief Create a new column in grid
+     @brief INTERNAL:  Reorder rows of tiled storage
 
-     Creates a new column of cells in grid.  The new column contains a
-     number of cells equal to the current height of the grid.  If a the
-     requested column insertion number is greater than the current width
-     of the grid is passed to this function, then the function returns
-     with no effect.  If the column insertion number is the current width
-     of the grid plus one, then the column is appended to the end of the
-     grid.  If the column number is negative, the new column is also appended
-     to the end of the grid.  Otherwise, the new column is inserted before
-     the column insert number.
+     Rows are moved in place, one cycle of the permutation at a time, so that
+     only one row is ever held aside.  The bands keep their number of rows.
 
-     @param grid    pointer to existing grid
-     @param col    column insertion number
+     @param gin    pointer to grid internals
+     @param perm    pointer to permutation, one entry per row
 
-     @retval NONE
+     @retval 0    success
+     @retval -1    failure
 
   */
 
-void grid_create_column(grid_s *grid, int col)
+static int _tiled_permute_rows(_grid_internals *gin, const int *perm)
 {
-  _grid_internals *gin;
-  int chgt, cwid;
-  _cell *lcol;  // Left col, col before new col
-  _cell *rcol;  // Righ col, col after new col
-  int i;
-  _cell *ncol;  // New row
-  _cell *ncell; // A new cell
-  _cell *pcell; // Tracks most previous cell created
+  _tiled_store *ts;
+  void **row;
+  char *done;
+  int height;
+  int y, to, from;
 
     // Sanity check parameters.
-  assert(grid);
-
-  gin = _grid_get_internals(grid);
-  if (!gin) return;
-
-    // Get width and height of grid
-  chgt = grid_size_get_height(gin->size);
-  cwid = grid_size_get_width(gin->size);
+  assert(gin);
+  assert(perm);
 
-    // Adding col outside of grid boundry plus one col is not allowed
-  if (col > cwid) return;
+  ts = (_tiled_store *)gin->store;
 
-    // Any negative col, indicates to add col to end
-  if (col < 0) col = cwid;
+  height = grid_size_get_height(gin->size);
 
-    // Fix height, if none
-  if (chgt < 1) chgt = 1;
-
-    // Create new col with number of cells equal to height of grid
-  for (ncol = NULL, i = 0; i < chgt; i++)
+  row = (void **)malloc((size_t)ts->ntiles * TILE_SIZE * sizeof(void *));
+  done = (char *)calloc((size_t)height, sizeof(char));
+  if (!row || !done)
   {
-    ncell = _cell_new(NULL);
-    if (!ncol)
-      ncol = ncell;
-    else
-    {
-      pcell->down = ncell;
-      ncell->up = pcell;
-    }
-    pcell = ncell;
+    free(row);
+    free(done);
+    return -1;
   }
 
-    // If this is the first col in the grid
-  if (!cwid)
-  {
-    gin->origin = ncol;
-    gin->current = ncol;
-    gin->end = ncell;
-    vertex_set_y(gin->location, 0);
-    vertex_set_x(gin->location, 0);
-    grid_size_set_height(gin->size, chgt);
-    grid_size_set_width(gin->size, 1);
-  }
-  else
+  for (y = 0; y < height; ++y)
   {
-    if (!col) // Insert before all cols
-    {
-      rcol = gin->origin;
-      for (pcell = ncol; rcol && pcell; rcol = rcol->down, pcell = pcell->down)
-      {
-        rcol->left = pcell;
-        pcell->right = rcol;
-      }
+    if (done[y] || perm[y] == y) continue;
 
-      gin->origin = ncol;
-      gin->current = ncol;
-      vertex_set_y(gin->location, 0);
-      vertex_set_x(gin->location, 0);
-      grid_size_set_width(gin->size, cwid + 1);
-    }
-    else if (col == cwid) // Append after all cols
-    {
-      for (lcol = gin->origin; lcol->right; lcol = lcol->right) ;
-      for (pcell = ncol; lcol && pcell; lcol = lcol->down, pcell = pcell->down)
-      {
-        lcol->right = pcell;
-        pcell->left = lcol;
-      }
+    _tiled_copy_row(ts, -1, y, row);
 
-      gin->end = ncell;
-      grid_size_set_width(gin->size, cwid + 1);
-    }
-    else // Inserting in middle of rows somewhere
+    for (to = y; (from = perm[to]) != y; to = from)
     {
-      for (i = 0, rcol = gin->origin;
-           (i < col) && rcol->right;
-           i++, rcol = rcol->right) ;
-      lcol = rcol->left;
-      for (pcell = ncol;
-           rcol && lcol && pcell;
-           rcol = rcol->down, lcol = lcol->down, pcell = pcell->down)
-      {
-        lcol->right = pcell;
-        rcol->left = pcell;
-        pcell->left = lcol;
-        pcell->right = rcol;
-      }
-
-      grid_size_set_width(gin->size, cwid + 1);
+      _tiled_copy_row(ts, to, from, NULL);
+      done[to] = 1;
     }
+
+    _tiled_copy_row(ts, to, -1, row);
+    done[to] = 1;
   }
+
+  free(row);
+  free(done);
+
+    // Return "int"
+  return 0;
 }
 
   /*!
 
-     @brief De-allocates a row in a grid, leaving data intact
+     @brief INTERNAL:  Get payloads of part of a tiled row
 
-     De-allocates all memory associated with all cells in a row, while
-     leaving the memory associated with the cell payload data intact.
+     Spans end at the right edge of a tile.
 
-     @param grid    pointer to existing grid
-     @param row    row number to free
+     @param gin    pointer to grid internals
+     @param pos    unused
+     @param row    row of cells
+     @param col    first column of cells
+     @param count    pointer to storage for number of payloads
+     @param buf    unused
+     @param size    unused
 
-     @retval NONE
+     @retval "void **" pointer to payloads
 
   */
 
-void grid_free_row(grid_s *grid, int row)
+static void **_tiled_span(_grid_internals *gin, _grid_position *pos,
+                          int row, int col, int *count, void **buf, int size)
 {
-  _grid_internals *gin;
-  int chgt;
-  _cell *c;
-  _cell *n;
-  _cell *e;
-  int i;
+  _tiled_store *ts;
+  int b, off;
+  int n;
 
     // Sanity check parameters.
-  assert(grid);
+  assert(gin);
+  assert(count);
 
-  gin = _grid_get_internals(grid);
-  if (!gin) return;
+  (void)pos;
+  (void)buf;
+  (void)size;
 
-  chgt = grid_size_get_height(gin->size);
+  ts = (_tiled_store *)gin->store;
 
-    // Check row
-  if (row < 0) row = chgt - 1;
-  if (row >= chgt) return;
+  b = _tiled_band_of(ts, row, &off);
 
-    // Find row
-  for (i = 0, c = gin->origin; (i < row) && c->down; ++i, c = c->down) ;
+  n = grid_size_get_width(gin->size) - col;
+  if (n > TILE_SIZE - col % TILE_SIZE) n = TILE_SIZE - col % TILE_SIZE;
 
-  if (c == gin->origin) gin->origin = c->down;
+  *count = n;
 
-  while (c)
-  {
-      // Unlink cell
-    if (c->up) c->up->down = c->down;
-    if (c->down) c->down->up = c->up;
+    // Return "void **"
+  return _tiled_cell(&ts->bands[b], off, col);
+}
+
+  /*!
+
+     @brief INTERNAL:  Locate band of tiles holding a row
+
+     @param ts    pointer to tiled storage
+     @param row    row to locate
+     @param off    pointer to storage for row offset within band
+
+     @retval "int" band index
 
-    e = c->up;
+  */
+
+static int _tiled_band_of(_tiled_store *ts, int row, int *off)
+{
+  int lo, hi, mid;
+
+    // Sanity check parameters.
+  assert(ts);
+  assert(off);
+
+  lo = 0;
+  hi = ts->nbands - 1;
 
-      // Free cell
-    n = c->right;
-    _cell_free(c, NULL);
-    c = n;
+  while (lo < hi)
+  {
+    mid = (lo + hi + 1) / 2;
+    if (ts->first[mid] <= row)
+      lo = mid;
+    else
+      hi = mid - 1;
   }
 
-  gin->current = gin->origin;
-  vertex_set_y(gin->location, 0);
-  vertex_set_x(gin->location, 0);
-  grid_size_set_height(gin->size, chgt - 1);
-  if (row == (chgt - 1)) gin->end = e;
-  if (!gin->end) grid_size_set_width(gin->size, 0);
+  *off = row - ts->first[lo];
+
+    // Return "int"
+  return lo;
 }
 
   /*!
 
-     @brief De-allocates a row in a grid
+     @brief INTERNAL:  Locate payload pointer of a cell within a band
 
-     De-allocates all memory associated with all cells in a row, including
-     the memory associated with the cell payload.
+     @param band    pointer to band of tiles
+     @param off    row offset within band
+     @param col    column of cell
 
-     @param grid    pointer to existing grid
-     @param row    row number to free
+     @retval "void **" pointer to payload pointer
+
+  */
+
+static void **_tiled_cell(_tile_band *band, int off, int col)
+{
+    // Return "void **"
+  return &band->tiles[col / TILE_SIZE]->cells[off * TILE_SIZE +
+                                              col % TILE_SIZE];
+}
+
+  /*!
+
+     @brief INTERNAL:  Re-compute first row of bands
+
+     @param ts    pointer to tiled storage
+     @param b    first band to re-compute
 
      @retval NONE
 
   */
 
-void grid_free_column(grid_s *grid, int col)
+static void _tiled_reindex(_tiled_store *ts, int b)
 {
-  _grid_internals *gin;
-  int cwid;
-  _cell *c;
-  _cell *n;
-  _cell *e;
-  int i;
-
     // Sanity check parameters.
-  assert(grid);
+  assert(ts);
 
-  gin = _grid_get_internals(grid);
-  if (!gin) return;
+  if (b < 1)
+  {
+    if (ts->nbands) ts->first[0] = 0;
+    b = 1;
+  }
 
-  cwid = grid_size_get_width(gin->size);
+  for (; b < ts->nbands; ++b)
+    ts->first[b] = ts->first[b - 1] + ts->bands[b - 1].rows;
+}
+
+  /*!
 
-    // Check col
-  if (col < 0) col = cwid - 1;
-  if (col >= cwid) return;
+     @brief INTERNAL:  Allocate tiles of a new band
 
-    // Find col
-  for (i = 0, c = gin->origin; (i < col) && c->right; ++i, c = c->right) ;
+     @param ts    pointer to tiled storage
+     @param band    pointer to band to fill in
+     @param rows    number of rows in band
 
-  if (c == gin->origin) gin->origin = c->right;
+     @retval 0    success
+     @retval -1    failure
 
-  while (c)
-  {
-      // Unlink cell
-    if (c->left) c->left->right = c->right;
-    if (c->right) c->right->left = c->left;
+  */
+
+static int _tiled_band_new(_tiled_store *ts, _tile_band *band, int rows)
+{
+  int t;
+
+    // Sanity check parameters.
+  assert(ts);
+  assert(band);
 
-    e = c->left;
+  band->rows = rows;
+  band->tiles = (_tile **)calloc((size_t)(ts->tcap ? ts->tcap : 1),
+                                 sizeof(_tile *));
+  if (!band->tiles) return -1;
 
-      // Free cell
-    n = c->right;
-    _cell_free(c, NULL);
-    c = n;
+  for (t = 0; t < ts->ntiles; ++t)
+  {
+    band->tiles[t] = (_tile *)calloc(1, sizeof(_tile));
+    if (!band->tiles[t])
+    {
+      _tiled_band_free(ts, band, NULL);
+      return -1;
+    }
   }
 
-  gin->current = gin->origin;
-  vertex_set_y(gin->location, 0);
-  vertex_set_x(gin->location, 0);
-  grid_size_set_width(gin->size, cwid - 1);
-  if (col == (cwid - 1)) gin->end = e;
-  if (!gin->end) grid_size_set_height(gin->size, 0);
+    // Return "int"
+  return 0;
 }
 
   /*!
 
-     @brief De-allocates a row in a grid
-
-     De-allocates all memory associated with all cells in a row, including
-     the memory associated with the cell payload.
+     @brief INTERNAL:  De-allocate tiles of a band
 
-     @param grid    pointer to existing grid
-     @param row    row number to free
+     @param ts    pointer to tiled storage
+     @param band    pointer to band to free
+     @param fpl    pointer to payload destructor, or NULL
 
      @retval NONE
 
   */
 
-void grid_destroy_row(grid_s *grid, int row)
+static void _tiled_band_free(_tiled_store *ts, _tile_band *band,
+                             grid_payload_free fpl)
 {
-  _grid_internals *gin;
-  int chgt;
-  _cell *c;
-  _cell *n;
-  _cell *e;
-  grid_payload_free fpl;
-  int i;
+  int t, i;
 
     // Sanity check parameters.
-  assert(grid);
+  assert(ts);
+  assert(band);
+
+  for (t = 0; t < ts->ntiles && band->tiles[t]; ++t)
+  {
+    if (fpl)
+      for (i = 0; i < band->rows * TILE_SIZE; ++i)
+        if (band->tiles[t]->cells[i]) fpl(band->tiles[t]->cells[i]);
+    _tiled_tile_free(band->tiles[t]);
+  }
+
+  free(band->tiles);
+  band->tiles = NULL;
+  band->rows = 0;
+}
+
+  /*!
+
+     @brief INTERNAL:  Make room for more bands
+
+     @param ts    pointer to tiled storage
+     @param count    number of bands needed
 
-  gin = _grid_get_internals(grid);
-  if (!gin) return;
+     @retval 0    success
+     @retval -1    failure
 
-  chgt = grid_size_get_height(gin->size);
+  */
 
-    // Check row
-  if (row < 0) row = chgt - 1;
-  if (row >= chgt) return;
+static int _tiled_reserve_bands(_tiled_store *ts, int count)
+{
+  _tile_band *bands;
+  int *first;
+  int n;
 
-  fpl = _grid_get_pl_free(grid);
+    // Sanity check parameters.
+  assert(ts);
 
-    // Find row
-  for (i = 0, c = gin->origin; (i < row) && c->down; ++i, c = c->down) ;
+  if (count <= ts->bcap) return 0;
 
-  if (c == gin->origin) gin->origin = c->down;
+  n = (count > ts->bcap * 2) ? count : ts->bcap * 2;
 
-  while (c)
-  {
-      // Unlink cell
-    if (c->up) c->up->down = c->down;
-    if (c->down) c->down->up = c->up;
+  bands = (_tile_band *)realloc(ts->bands, (size_t)n * sizeof(_tile_band));
+  if (!bands) return -1;
+  ts->bands = bands;
 
-    e = c->up;
+  first = (int *)realloc(ts->first, (size_t)n * sizeof(int));
+  if (!first) return -1;
+  ts->first = first;
 
-      // Free cell
-    n = c->right;
-    _cell_free(c, fpl);
-    c = n;
-  }
+  ts->bcap = n;
 
-  gin->current = gin->origin;
-  vertex_set_y(gin->location, 0);
-  vertex_set_x(gin->location, 0);
-  grid_size_set_height(gin->size, chgt - 1);
-  if (row == (chgt - 1)) gin->end = e;
-  if (!gin->end) grid_size_set_width(gin->size, 0);
+    // Return "int"
+  return 0;
 }
 
   /*!
 
-     @brief De-allocates a column in a grid
-
-     De-allocates all memory associated with all cells in a column, including
-     the memory associated with the cell payload.
+     @brief INTERNAL:  Add columns of tiles to every band
 
-     @param grid    pointer to existing grid
-     @param col    column number to free
+     @param ts    pointer to tiled storage
+     @param ntiles    number of columns of tiles needed
 
-     @retval NONE
+     @retval 0    success
+     @retval -1    failure
 
   */
 
-void grid_destroy_column(grid_s *grid, int col)
+static int _tiled_widen(_tiled_store *ts, int ntiles)
 {
-  _grid_internals *gin;
-  int cwid;
-  _cell *c;
-  _cell *n;
-  _cell *e;
-  grid_payload_free fpl;
-  int i;
+  _tile **tiles;
+  int n;
+  int b, t;
 
     // Sanity check parameters.
-  assert(grid);
+  assert(ts);
 
-  gin = _grid_get_internals(grid);
-  if (!gin) return;
+  if (ntiles <= ts->ntiles) return 0;
+
+  if (ntiles > ts->tcap)
+  {
+    n = (ntiles > ts->tcap * 2) ? ntiles : ts->tcap * 2;
+    for (b = 0; b < ts->nbands; ++b)
+    {
+      tiles = (_tile **)realloc(ts->bands[b].tiles, (size_t)n * sizeof(_tile *));
+      if (!tiles) return -1;
+      ts->bands[b].tiles = tiles;
+    }
+    ts->tcap = n;
+  }
+
+  for (b = 0; b < ts->nbands; ++b)
+    for (t = ts->ntiles; t < ntiles; ++t)
+    {
+      ts->bands[b].tiles[t] = (_tile *)calloc(1, sizeof(_tile));
+      if (!ts->bands[b].tiles[t])
+      {
+          // Undo, leaving every band with the same tiles
+        while (b >= 0)
+        {
+          while (--t >= ts->ntiles) _tiled_tile_free(ts->bands[b].tiles[t]);
+          t = ntiles;
+          --b;
+        }
+        return -1;
+      }
+    }
 
-  cwid = grid_size_get_width(gin->size);
+  ts->ntiles = ntiles;
 
-    // Check col
-  if (col < 0) col = cwid - 1;
-  if (col >= cwid) return;
+    // Return "int"
+  return 0;
+}
 
-  fpl = _grid_get_pl_free(grid);
+  /*!
 
-    // Find col
-  for (i = 0, c = gin->origin; (i < col) && c->right; ++i, c = c->right) ;
+     @brief INTERNAL:  Truncate columns of every band
 
-  if (c == gin->origin) gin->origin = c->right;
+     @param ts    pointer to tiled storage
+     @param cols    number of columns to keep
+     @param fpl    pointer to payload destructor, or NULL
 
-  while (c)
-  {
-      // Unlink cell
-    if (c->left) c->left->right = c->right;
-    if (c->right) c->right->left = c->left;
+     @retval NONE
+
+  */
+
+static void _tiled_narrow(_tiled_store *ts, int cols, grid_payload_free fpl)
+{
+  _tile_band *band;
+  void **p;
+  int ntiles;
+  int b, r, x;
+
+    // Sanity check parameters.
+  assert(ts);
 
-    e = c->left;
+  ntiles = (cols + TILE_SIZE - 1) / TILE_SIZE;
 
-      // Free cell
-    n = c->right;
-    _cell_free(c, fpl);
-    c = n;
+  for (b = 0; b < ts->nbands; ++b)
+  {
+    band = &ts->bands[b];
+    for (r = 0; r < band->rows; ++r)
+      for (x = cols; x < ts->ntiles * TILE_SIZE; ++x)
+      {
+        p = _tiled_cell(band, r, x);
+        if (fpl && *p) fpl(*p);
+        *p = NULL;
+      }
+    for (x = ntiles; x < ts->ntiles; ++x)
+    {
+      _tiled_tile_free(band->tiles[x]);
+      band->tiles[x] = NULL;
+    }
   }
 
-  gin->current = gin->origin;
-  vertex_set_y(gin->location, 0);
-  vertex_set_x(gin->location, 0);
-  grid_size_set_width(gin->size, cwid - 1);
-  if (col == (cwid - 1)) gin->end = e;
-  if (!gin->end) grid_size_set_height(gin->size, 0);
+  ts->ntiles = ntiles;
 }
 
   /*!
 
-     @brief De-allocate the payload data of the current cell
+     @brief INTERNAL:  Add empty rows to tiled storage
 
-     De-allocates the data payload for the current cell in the grid.
+     Rows are added at a row offset within a band.  When the band lacks room,
+     it is split at that offset; inserted rows fill the head of the split
+     band, then new bands, and the rows following the offset move to a new
+     tail band.
 
-     @param grid    pointer to existing grid
+     @param ts    pointer to tiled storage
+     @param b    band in which to insert, or -1 to append rows
+     @param off    row offset within band
+     @param count    number of rows to add
 
-     @retval NONE
+     @retval "int" number of rows added
 
   */
 
-void grid_clear_cell(grid_s *grid)
+static int _tiled_add_rows(_tiled_store *ts, int b, int off, int count)
 {
-  _grid_internals *gin;
-  grid_payload_free fpl;
+  _tile_band *band;
+  _tile_band *added;
+  int head, tail, nnew;
+  int at;
+  int i, t;
 
     // Sanity check parameters.
-  assert(grid);
+  assert(ts);
 
-  gin = _grid_get_internals(grid);
-  if (!gin) return;
+  if (b < 0)
+  {
+    b = ts->nbands - 1;
+    off = (b < 0) ? 0 : ts->bands[b].rows;
+  }
 
-  fpl = _grid_get_pl_free(grid);
+  if (b >= 0)
+  {
+    band = &ts->bands[b];
 
-  if (fpl) fpl(_grid_get_payload(gin->current));
+      // Shift rows within band when there is room
+    if (band->rows + count <= TILE_SIZE)
+    {
+      for (t = 0; t < ts->ntiles; ++t)
+      {
+        memmove(band->tiles[t]->cells + (off + count) * TILE_SIZE,
+                band->tiles[t]->cells + off * TILE_SIZE,
+                (size_t)(band->rows - off) * TILE_SIZE * sizeof(void *));
+        memset(band->tiles[t]->cells + off * TILE_SIZE,
+               0,
+               (size_t)count * TILE_SIZE * sizeof(void *));
+      }
+      band->rows += count;
+      _tiled_reindex(ts, b);
+      return count;
+    }
 
-  gin->current->payload = NULL;
-}
+    head = (off) ? TILE_SIZE - off : 0;
+    if (head > count) head = count;
+    tail = band->rows - off;
+  }
+  else
+    head = tail = 0;
 
-  /*!
+  nnew = (count - head + TILE_SIZE - 1) / TILE_SIZE;
+  at = (off || b < 0) ? b + 1 : b;
 
-     @brief Get current cell in grid
+  if (_tiled_reserve_bands(ts, ts->nbands + nnew + (off && tail)))
+    return 0;
 
-     Returns a pointer to the data payload in the current cell of a grid
+  added = (_tile_band *)calloc((size_t)(nnew + 1), sizeof(_tile_band));
+  if (!added) return 0;
 
-     @param grid    pointer to existing grid
+  for (i = 0; i < nnew + (off && tail); ++i)
+  {
+    if (_tiled_band_new(ts,
+                        &added[i],
+                        (i < nnew) ? count - head - i * TILE_SIZE : tail))
+    {
+      while (--i >= 0) _tiled_band_free(ts, &added[i], NULL);
+      free(added);
+      return 0;
+    }
+    if (added[i].rows > TILE_SIZE) added[i].rows = TILE_SIZE;
+  }
 
-     @retval "void *" success
-     @retval NULL    failure
+    // Move rows after offset to tail band, and fill head with new rows
+  if (off && tail)
+  {
+    band = &ts->bands[b];
+    for (t = 0; t < ts->ntiles; ++t)
+    {
+      memcpy(added[nnew].tiles[t]->cells,
+             band->tiles[t]->cells + off * TILE_SIZE,
+             (size_t)tail * TILE_SIZE * sizeof(void *));
+      memset(band->tiles[t]->cells + off * TILE_SIZE,
+             0,
+             (size_t)tail * TILE_SIZE * sizeof(void *));
+    }
+    band->rows = off + head;
+  }
+  else if (off)
+    ts->bands[b].rows += head;
 
-  */
+  nnew += (off && tail);
 
-void *grid_get_cell(grid_s *grid)
-{
-  _cell *cell;
+  memmove(ts->bands + at + nnew,
+          ts->bands + at,
+          (size_t)(ts->nbands - at) * sizeof(_tile_band));
+  memcpy(ts->bands + at, added, (size_t)nnew * sizeof(_tile_band));
+  ts->nbands += nnew;
 
-    // Sanity check parameters.
-  assert(grid);
+  free(added);
 
-  cell = _grid_get_cell(grid);
-  if (!cell) return NULL;
+  _tiled_reindex(ts, (b < 0) ? 0 : b);
 
-    // Return "void *"
-  return _grid_get_payload(cell);
+    // Return "int"
+  return count;
 }
 
   /*!
 
-     @brief Assign payload data to a cell
-
-     Assigns, or re-assigns the payload data for a cell in a grid.
+     @brief INTERNAL:  Remove rows from tiled storage
 
-     NOTE:  The current cell payload data, if any, will be de-allocated.
+     Bands left empty are freed, and bands left small are merged with a
+     neighbour.
 
-     @param grid    pointer to exising grid
-     @param payload    pointer to new payload data
+     @param ts    pointer to tiled storage
+     @param row    first row to remove
+     @param count    number of rows to remove
+     @param fpl    pointer to payload destructor, or NULL
 
      @retval NONE
 
   */
 
-void grid_set_cell(grid_s *grid, void *payload)
+static void _tiled_drop_rows(_tiled_store *ts, int row, int count,
+                             grid_payload_free fpl)
 {
-  _grid_internals *gin;
-  
+  _tile_band *band;
+  void **p;
+  int b, off, n;
+  int t, i;
+
     // Sanity check parameters.
-  assert(grid);
+  assert(ts);
 
-  gin = _grid_get_internals(grid);
-  if (!gin) return;
+  while (count > 0)
+  {
+    b = _tiled_band_of(ts, row, &off);
+    band = &ts->bands[b];
+
+    n = band->rows - off;
+    if (n > count) n = count;
+
+    if (n == band->rows)
+    {
+      _tiled_band_free(ts, band, fpl);
+      memmove(ts->bands + b,
+              ts->bands + b + 1,
+              (size_t)(ts->nbands - b - 1) * sizeof(_tile_band));
+      --ts->nbands;
+    }
+    else
+    {
+      for (t = 0; t < ts->ntiles; ++t)
+      {
+        p = band->tiles[t]->cells;
+        if (fpl)
+          for (i = off * TILE_SIZE; i < (off + n) * TILE_SIZE; ++i)
+            if (p[i]) fpl(p[i]);
+        memmove(p + off * TILE_SIZE,
+                p + (off + n) * TILE_SIZE,
+                (size_t)(band->rows - off - n) * TILE_SIZE * sizeof(void *));
+        memset(p + (band->rows - n) * TILE_SIZE,
+               0,
+               (size_t)n * TILE_SIZE * sizeof(void *));
+      }
+      band->rows -= n;
+    }
+
+    _tiled_reindex(ts, b);
+    count -= n;
+  }
 
-  grid_clear_cell(grid);
+  if (!ts->nbands) return;
 
-  gin->current->payload = payload;
+  b = (row) ? _tiled_band_of(ts, row - 1, &off) : 0;
+  _tiled_merge(ts, b);
+  if (b) _tiled_merge(ts, b - 1);
 }
 
   /*!
 
-     @brief Find a cell by reference
-
-     Locates a cell in a grid based on a reference pointer value.  If the 
-     cell is located, the current grid cell is set to the found cell,
-     and the cell payload data is returned.
+     @brief INTERNAL:  Merge a band with the following band, if both fit
 
-     @param grid    pointer to existing grid
-     @param reference    pointer to payload data that may exist in grid
+     @param ts    pointer to tiled storage
+     @param b    band index
 
-     @retval "void *" success
-     @retval NULL    failure
+     @retval NONE
 
   */
 
-void *grid_find_by_reference(grid_s *grid, void *reference)
+static void _tiled_merge(_tiled_store *ts, int b)
 {
-  _grid_internals *gin;
-  _cell *c;
+  _tile_band *band;
+  _tile_band *next;
+  int t;
 
     // Sanity check parameters.
-  assert(grid);
+  assert(ts);
 
-  gin = _grid_get_internals(grid);
-  if (!gin) return NULL;
+  if (b < 0 || b + 1 >= ts->nbands) return;
 
-  c = _grid_find_by_reference(grid, reference);
-  if (c)
-  {
-    gin->current = c;
-      // Return "void *"
-  return c;
-  }
+  band = &ts->bands[b];
+  next = &ts->bands[b + 1];
 
-    // Return NULL
-  return NULL;
-}
+  if (band->rows + next->rows > TILE_SIZE) return;
 
-  /*!
+  for (t = 0; t < ts->ntiles; ++t)
+    memcpy(band->tiles[t]->cells + band->rows * TILE_SIZE,
+           next->tiles[t]->cells,
+           (size_t)next->rows * TILE_SIZE * sizeof(void *));
 
-     @brief Find a cell by value
+  band->rows += next->rows;
+  _tiled_band_free(ts, next, NULL);
 
-     Locates a cell in a grid by value.  If the cell is located, the
-     current grid cell is set to the found cell, and the payload data is
-     returned.
+  memmove(ts->bands + b + 1,
+          ts->bands + b + 2,
+          (size_t)(ts->nbands - b - 2) * sizeof(_tile_band));
+  --ts->nbands;
 
-     NOTE:  A user defined cell compare function must be supplied.
+  _tiled_reindex(ts, b);
+}
 
-     @param grid    pointer to existing grid
-     @param value    pointer to value to find
-     @param func    pointer to function to compare cell values
+  /*!
 
-     @retval "void *" success
-     @retval NULL    failure
+     @brief INTERNAL:  De-allocate all tiles and bands
+
+     @param ts    pointer to tiled storage
+     @param fpl    pointer to payload destructor, or NULL
+
+     @retval NONE
 
   */
 
-void *grid_find_by_value(grid_s *grid,
-                         void *value,
-                         grid_payload_compare func)
+static void _tiled_clear(_tiled_store *ts, grid_payload_free fpl)
 {
-  _grid_internals *gin;
-  _cell *c;
+  int b;
 
     // Sanity check parameters.
-  assert(grid);
-  assert(value);
-  assert(func);
+  assert(ts);
 
-  gin = _grid_get_internals(grid);
-  if (!gin) return NULL;
+  for (b = 0; b < ts->nbands; ++b)
+    _tiled_band_free(ts, &ts->bands[b], fpl);
 
-  c = _grid_find_by_value(grid, value, func);
-  if (c)
-  {
-    gin->current = c;
-      // Return "void *"
-  return c;
-  }
+  free(ts->bands);
+  free(ts->first);
 
-    // Return NULL
-  return NULL;
+  memset(ts, 0, sizeof(_tiled_store));
 }
 
   /*!
 
-     @brief Located first cell in grid
-
-     Locates the first cell in the grid, and returns the payload data of
-     the origin cell.  The current grid cell is set to the origin cell.
+     @brief INTERNAL:  Share tiled storage with a snapshot
 
-     @param grid    pointer to existing grid
+     @param gin    pointer to grid internals
+     @param snap    pointer to snapshot internals
 
-     @retval "void *" success
-     @retval NULL    failure
+     @retval 0    success
 
   */
 
-void *grid_origin(grid_s *grid)
+static int _tiled_share(_grid_internals *gin, _grid_internals *snap)
 {
-  _grid_internals *gin;
-  void *pl;
+  _tiled_store *ts;
 
     // Sanity check parameters.
-  assert(grid);
-
-  gin = _grid_get_internals(grid);
-  if (!gin) return NULL;
+  assert(gin);
+  assert(snap);
 
-  pl = _grid_get_payload(gin->origin);
+  ts = (_tiled_store *)gin->store;
 
-  gin->current = gin->origin;
-  vertex_set_y(gin->location, 0);
-  vertex_set_x(gin->location, 0);
+  atomic_fetch_add(&ts->refs, 1);
+  snap->store = ts;
 
-    // Return "void *"
-  return pl;
+    // Return "int"
+  return 0;
 }
 
   /*!
 
-     @brief Locate current cell in grid
+     @brief INTERNAL:  Make a range of tiled cells private to a grid
 
-     Returns the payload data of the current cell in a grid.
+     Copies the store when shared, then copies the shared tiles of the range.
+     Rows are widened by whole bands, to cover the bands that inserting,
+     removing or merging rows also changes.
 
-     @param grid    pointer to existing grid
+     @param gin    pointer to grid internals
+     @param row    first row of range
+     @param col    first column of range
+     @param rows    number of rows in range
+     @param cols    number of columns in range
 
-     @retval "void *" success
-     @retval NULL    failure
+     @retval 0    success
+     @retval -1    failure
 
   */
 
-void *grid_current(grid_s *grid)
+static int _tiled_own(_grid_internals *gin, int row, int col,
+                      int rows, int cols)
 {
-  _grid_internals *gin;
-  void *pl;
+  _tiled_store *ts;
+  int b0, b1, t0, t1;
+  int b, t, off;
 
     // Sanity check parameters.
-  assert(grid);
+  assert(gin);
 
-  gin = _grid_get_internals(grid);
-  if (!gin) return NULL;
+  if (_tiled_own_store(gin)) return -1;
 
-  pl = _grid_get_payload(gin->current);
+  ts = (_tiled_store *)gin->store;
 
-    // Return "void *"
-  return pl;
+  if (rows < 1 || cols < 1 || !ts->nbands || !ts->ntiles) return 0;
+
+  b0 = _tiled_band_of(ts, row, &off) - 2;
+  if (b0 < 0) b0 = 0;
+  b1 = _tiled_band_of(ts, row + rows - 1, &off) + 1;
+  if (b1 >= ts->nbands) b1 = ts->nbands - 1;
+
+  t0 = col / TILE_SIZE;
+  t1 = (col + cols - 1) / TILE_SIZE;
+  if (t1 >= ts->ntiles) t1 = ts->ntiles - 1;
+
+  for (b = b0; b <= b1; ++b)
+    for (t = t0; t <= t1; ++t)
+      if (_tiled_own_tile(&ts->bands[b], t)) return -1;
+
+    // Return "int"
+  return 0;
 }
 
   /*!
 
-     @brief Locate the last (lower, right) cell in a grid
-
-     Locates the last cell in a grid.   The last cell is the lower, right
-     most cell in the grid.  Returns the payload data of that cell.  The
-     current grid cell is set to the last cell.
+     @brief INTERNAL:  Copy shared tiled storage, sharing its tiles
 
-     @param grid    pointer to existing cell
+     @param gin    pointer to grid internals
 
-     @retval "void *" success
-     @retval NULL    failure
+     @retval 0    success
+     @retval -1    failure
 
   */
 
-void *grid_end(grid_s *grid)
+static int _tiled_own_store(_grid_internals *gin)
 {
-  _grid_internals *gin;
-  void *pl;
+  _tiled_store *ts;
+  _tiled_store *copy;
+  _tile *tile;
+  int b, t;
 
     // Sanity check parameters.
-  assert(grid);
+  assert(gin);
 
-  gin = _grid_get_internals(grid);
-  if (!gin) return NULL;
+  ts = (_tiled_store *)gin->store;
+  if (!atomic_load(&ts->refs)) return 0;
 
-  pl = _grid_get_payload(gin->end);
+  copy = (_tiled_store *)malloc(sizeof(_tiled_store));
+  if (!copy) return -1;
+  memset(copy, 0, sizeof(_tiled_store));
 
-  gin->current = gin->end;
-  vertex_set_y(gin->location, grid_size_get_height(gin->size) - 1);
-  vertex_set_x(gin->location, grid_size_get_width(gin->size) - 1);
+  if (_tiled_reserve_bands(copy, ts->nbands))
+  {
+    _tiled_clear(copy, NULL);
+    free(copy);
+    return -1;
+  }
 
-    // Return "void *"
-  return pl;
+  copy->tcap = ts->ntiles;
+
+  for (b = 0; b < ts->nbands; ++b)
+  {
+    copy->bands[b].rows = ts->bands[b].rows;
+    copy->bands[b].tiles = (_tile **)malloc((size_t)(ts->ntiles ?
+                                                       ts->ntiles : 1) *
+                                            sizeof(_tile *));
+    if (!copy->bands[b].tiles)
+    {
+      while (--b >= 0) free(copy->bands[b].tiles);
+      free(copy->bands);
+      free(copy->first);
+      free(copy);
+      return -1;
+    }
+    copy->first[b] = ts->first[b];
+  }
+
+  for (b = 0; b < ts->nbands; ++b)
+    for (t = 0; t < ts->ntiles; ++t)
+    {
+      tile = ts->bands[b].tiles[t];
+      atomic_fetch_add(&tile->refs, 1);
+      copy->bands[b].tiles[t] = tile;
+    }
+
+  copy->nbands = ts->nbands;
+  copy->ntiles = ts->ntiles;
+
+  gin->store = copy;
+
+    // The store was left to this grid, when the sharing snapshots went
+  if (!atomic_fetch_sub(&ts->refs, 1))
+  {
+    _tiled_clear(ts, NULL);
+    free(ts);
+  }
+
+    // Return "int"
+  return 0;
 }
 
   /*!
 
-     @brief Move one cell to the left in a grid
-
-     Moves the current cell location in a grid one cell to the left.  Returns
-     the payload data of that cell.  If the current cell location is already
-     a the left most position, then no action is taken, and nothing is
-     returned.
+     @brief INTERNAL:  Copy a shared tile of a band
 
-     @param grid    pointer to existing grid
+     @param band    pointer to band of tile
+     @param t    index of tile in band
 
-     @retval "void *" success
-     @retval NULL    failure
+     @retval 0    success
+     @retval -1    failure
 
   */
 
-void *grid_left(grid_s *grid)
-{
-  _grid_internals *gin;
-  _cell *c;
-  void *pl;
+static int _tiled_own_tile(_tile_band *band, int t)
+{
+  _tile *tile;
+  _tile *copy;
 
     // Sanity check parameters.
-  assert(grid);
-
-  gin = _grid_get_internals(grid);
-  if (!gin) return NULL;
+  assert(band);
 
-  c = _grid_get_cell(grid);
-  if (!c) return NULL;
+  tile = band->tiles[t];
+  if (!atomic_load(&tile->refs)) return 0;
 
-  if (!c->left) return NULL;
+  copy = (_tile *)malloc(sizeof(_tile));
+  if (!copy) return -1;
 
-  pl = _grid_get_payload(c->left);
+  atomic_init(&copy->refs, 0);
+  memcpy(copy->cells, tile->cells, sizeof(copy->cells));
 
-  gin->current = c->left;
-  vertex_set_x(gin->location, vertex_get_x(gin->location) - 1);
+  band->tiles[t] = copy;
+  _tiled_tile_free(tile);
 
-    // Return "void *"
-  return pl;
+    // Return "int"
+  return 0;
 }
 
   /*!
 
-     @brief Move one cell to the right in a grid
-
-     Moves the current cell location in a grid one cell to the right.  Returns
-     the payload data of that cell.  If the current cell location is already
-     a the right most position, then no action is taken, and nothing is
-     returned.
+     @brief INTERNAL:  De-allocate a tile, unless still shared
 
-     @param grid    pointer to existing grid
+     @param tile    pointer to tile
 
-     @retval "void *" success
-     @retval NULL    failure
+     @retval NONE
 
   */
 
-void *grid_right(grid_s *grid)
+static void _tiled_tile_free(_tile *tile)
 {
-  _grid_internals *gin;
-  _cell *c;
-  void *pl;
-
     // Sanity check parameters.
-  assert(grid);
+  assert(tile);
 
-  gin = _grid_get_internals(grid);
-  if (!gin) return NULL;
-
-  c = _grid_get_cell(grid);
-  if (!c) return NULL;
+  if (atomic_load(&tile->refs) > 0 && atomic_fetch_sub(&tile->refs, 1) > 0)
+    return;
 
-  if (!c->right) return NULL;
-
-  pl = _grid_get_payload(c->right);
-
-  gin->current = c->right;
-  vertex_set_x(gin->location, vertex_get_x(gin->location) + 1);
-
-    // Return "void *"
-  return pl;
+  free(tile);
 }
 
   /*!
 
-     @brief Move up one cell in a grid
+     @brief INTERNAL:  Copy the cells of a tiled row
 
-     Moves the current cell location in a grid up one cell.  Returns
-     the payload data of that cell.  If the current cell location is already
-     a the top most position, then no action is taken, and nothing is
-     returned.
+     Copies the cells of row from, or of buf when from is negative, to row
+     to, or to buf when to is negative.  The cells of every tile of the row
+     are copied.
 
-     @param grid    pointer to existing grid
+     @param ts    pointer to tiled storage
+     @param to    row to copy to, or -1
+     @param from    row to copy from, or -1
+     @param buf    pointer to a row of payload pointers, or NULL
 
-     @retval "void *" success
-     @retval NULL    failure
+     @retval NONE
 
   */
 
-void *grid_up(grid_s *grid)
+static void _tiled_copy_row(_tiled_store *ts, int to, int from, void **buf)
 {
-  _grid_internals *gin;
-  _cell *c;
-  void *pl;
+  _tile_band *tb = NULL, *fb = NULL;
+  int toff = 0, foff = 0;
+  void **dst, **src;
+  int t;
 
     // Sanity check parameters.
-  assert(grid);
+  assert(ts);
+  assert((to >= 0 && from >= 0) || buf);
 
-  gin = _grid_get_internals(grid);
-  if (!gin) return NULL;
+  if (to >= 0) tb = &ts->bands[_tiled_band_of(ts, to, &toff)];
+  if (from >= 0) fb = &ts->bands[_tiled_band_of(ts, from, &foff)];
 
-  c = _grid_get_cell(grid);
-  if (!c) return NULL;
+  for (t = 0; t < ts->ntiles; ++t)
+  {
+    dst = (tb) ? _tiled_cell(tb, toff, t * TILE_SIZE) : buf + t * TILE_SIZE;
+    src = (fb) ? _tiled_cell(fb, foff, t * TILE_SIZE) : buf + t * TILE_SIZE;
+    memcpy(dst, src, TILE_SIZE * sizeof(void *));
+  }
+}
 
-  if (!c->up) return NULL;
+// STATIC functions: view storage engine
 
-  pl = _grid_get_payload(c->up);
+  /*!
 
-  gin->current = c->up;
-  vertex_set_y(gin->location, vertex_get_y(gin->location) - 1);
+     @brief INTERNAL:  De-allocate view storage
 
-    // Return "void *"
-  return pl;
+     @param gin    pointer to view internals
+     @param fpl    unused, a view never owns payload data
+
+     @retval NONE
+
+  */
+
+static void _view_release(_grid_internals *gin, grid_payload_free fpl)
+{
+    // Sanity check parameters.
+  assert(gin);
+
+  (void)fpl;
+
+  free(gin->store);
+  gin->store = NULL;
 }
 
   /*!
 
-     @brief Move down one one cell in a grid
+     @brief INTERNAL:  Get payload data of view cell
 
-     Moves the current cell location in a grid down one cell.  Returns
-     the payload data of that cell.  If the current cell location is already
-     a the bottom most position, then no action is taken, and nothing is
-     returned.
+     Walks from the most recently got cell of the view, leaving the grid
+     shown by the view untouched.
 
-     @param grid    pointer to existing grid
+     @param gin    pointer to view internals
+     @param row    row of cell
+     @param col    column of cell
 
      @retval "void *" success
-     @retval NULL    failure
+     @retval NULL    cell is empty
 
   */
 
-void *grid_down(grid_s *grid)
+static void *_view_get(_grid_internals *gin, int row, int col)
 {
-  _grid_internals *gin;
-  _cell *c;
-  void *pl;
+  _view_store *vs;
 
     // Sanity check parameters.
-  assert(grid);
-
-  gin = _grid_get_internals(grid);
-  if (!gin) return NULL;
+  assert(gin);
 
-  c = _grid_get_cell(grid);
-  if (!c) return NULL;
-
-  if (!c->down) return NULL;
-
-  pl = _grid_get_payload(c->down);
-
-  gin->current = c->down;
-  vertex_set_y(gin->location, vertex_get_y(gin->location) + 1);
+  vs = (_view_store *)gin->store;
 
     // Return "void *"
-  return pl;
+  return _view_seek(gin, &vs->pos, row, col);
 }
 
   /*!
 
-     @brief Move to specific cell location in a grid
-
-     Moves current cell location in a grid to a specific row and column.  The
-     payload data of that cell is returned.  If the new location is outside
-     the current grid boundaries, then no action is taken, and nothing is
-     returned.
+     @brief INTERNAL:  Get payload data of view cell from a position
 
-     NOTE:  Cell locations in a grid are based at 1, therefore the first
-            (origin) cell location is 1, 1.
+     The position is kept in cells of the view, and is handed to the grid
+     shown by the view in cells of that grid, so that the grid may walk from
+     it without recording anything.
 
-     @param grid    pointer to existing grid
-     @param row    row number of new cell location
-     @param col    column number of new cell location
+     @param gin    pointer to view internals
+     @param pos    pointer to position to walk from
+     @param row    row of cell
+     @param col    column of cell
 
      @retval "void *" success
-     @retval NULL    failure
+     @retval NULL    cell is empty
 
   */
 
-void *grid_goto(grid_s *grid, int row, int col)
+static void *_view_seek(_grid_internals *gin, _grid_position *pos,
+                        int row, int col)
 {
-  _grid_internals *gin;
-  grid_size_s *size;
-  _cell *c;
-  int i;
-  int dir;
+  _view_store *vs;
+  _grid_internals *pin;
+  void *pl = NULL;
+  int prow = row, pcol = col;
 
     // Sanity check parameters.
-  assert(grid);
-
-  size = grid_get_size(grid);
-  if (!size) return NULL;
-
-  gin = _grid_get_internals(grid);
-  if (!gin) return NULL;
-
-  if (row < 0) row = 0;
-  if (row > grid_size_get_height(size) - 1) row = grid_size_get_height(size) - 1;
-  if (col < 0) col = 0;
-  if (col > grid_size_get_width(size) - 1) col = grid_size_get_width(size) - 1;
+  assert(gin);
+  assert(pos);
 
-  c = gin->current;
+  vs = (_view_store *)gin->store;
+  pin = _grid_get_internals(vs->grid);
 
-  for (i = vertex_get_y(gin->location), dir = (row > i) ? 1 : -1;
-       (i != row) && c;
-       i += dir, c = ((dir < 0) ? c->up : c->down)) ;
-  if (!c) return NULL;
+  _view_map(vs, &prow, &pcol);
 
-  for (i = vertex_get_x(gin->location), dir = (col > i) ? 1 : -1;
-       (i != col) && c;
-       i += dir, c = ((dir < 0) ? c->left : c->right)) ;
-  if (!c) return NULL;
+  if (prow >= grid_size_get_height(pin->size) ||
+      pcol >= grid_size_get_width(pin->size))
+    pos->hint = NULL;
+  else
+  {
+    _view_map(vs, &pos->row, &pos->col);
+    pl = _grid_seek(pin, pos, prow, pcol);
+  }
 
-  gin->current = c;
-  vertex_set_y(gin->location, row);
-  vertex_set_x(gin->location, col);
+  pos->row = row;
+  pos->col = col;
 
     // Return "void *"
-  return _grid_get_payload(c);
+  return pl;
 }
 
-// STATIC functions
-
   /*!
 
-     @brief INTERNAL: Create a new cell
+     @brief INTERNAL:  Get payloads of part of a view row
 
-     Allocates a new _cell structure.
+     Rows of a view that is not transposed are parts of rows of the grid, and
+     are handed out as the grid storage engine does.  Rows of a transposed
+     view are columns of the grid, and are copied to buf.
 
-     @param pl    pointer to payload data for new cell
+     @param gin    pointer to view internals
+     @param pos    pointer to position within grid storage
+     @param row    row of cells
+     @param col    first column of cells
+     @param count    pointer to storage for number of payloads
+     @param buf    pointer to storage for copied payloads
+     @param size    number of payloads buf can hold
 
-     @retval "_cell *" success
+     @retval "void **" pointer to payloads
 
   */
 
-static _cell *_cell_new(void *pl)
+static void **_view_span(_grid_internals *gin, _grid_position *pos,
+                         int row, int col, int *count, void **buf, int size)
 {
-  _cell *c;
+  _view_store *vs;
+  _grid_internals *pin;
+  void **p;
+  int height, width;
+  int n, i;
 
-  c = (_cell*)malloc(sizeof(_cell));
-  memset(c, 0, sizeof(_cell));
-
-  c->payload = pl;
-
-    // Return "_cell *"
-  return c;
-}
+    // Sanity check parameters.
+  assert(gin);
+  assert(count);
+  assert(buf);
 
-  /*!
+  vs = (_view_store *)gin->store;
+  pin = _grid_get_internals(vs->grid);
 
-     @brief INTERNAL:  De-allocate a cell and possibly payload data
+  height = grid_size_get_height(pin->size);
+  width = grid_size_get_width(pin->size);
 
-     De-allocates an existing cell, and possibly a the payload data
-     associated with the cell.  If no payload data destructor function
-     is supplied, then the payload data is left intact.
+  n = grid_size_get_width(gin->size) - col;
+  if (n > size) n = size;
 
-     @param c    pointer to existing cell
-     @param fpl    pointer to user defined payload data destructor
+  if (vs->transpose)
+  {
+    for (i = 0; i < n; ++i)
+      buf[i] = _view_seek(gin, pos, row, col + i);
+    *count = n;
+    return buf;
+  }
 
-     @retval "_cell *" success
+  if (vs->row + row >= height || vs->col + col >= width)
+  {
+    memset(buf, 0, (size_t)n * sizeof(void *));
+    *count = n;
+    return buf;
+  }
 
-  */
+  _view_map(vs, &pos->row, &pos->col);
+  p = pin->storage->span(pin, pos, vs->row + row, vs->col + col, count,
+                         buf, n);
+  _view_unmap(vs, &pos->row, &pos->col);
+  if (*count > grid_size_get_width(gin->size) - col)
+    *count = grid_size_get_width(gin->size) - col;
 
-static void _cell_free(_cell *c, grid_payload_free fpl)
-{
-    // Sanity check parameters.
-  assert(c);
-  if (fpl) fpl(c->payload);
-  free(c);
+    // Return "void **"
+  return p;
 }
 
   /*!
 
-     @brief INTERNAL: Get payload data destructor function
-
-     Returns the previously assigned payload data destructor.
+     @brief INTERNAL:  Map cell of view to cell of grid
 
-     @param grid    pointer to existing grid
+     @param vs    pointer to view storage
+     @param row    pointer to row of cell, mapped in place
+     @param col    pointer to column of cell, mapped in place
 
-     @retval "grid_payload_free *" success
+     @retval NONE
 
   */
 
-static grid_payload_free _grid_get_pl_free(grid_s *grid)
+static void _view_map(_view_store *vs, int *row, int *col)
 {
-  _grid_internals *gin;
+  int t;
 
     // Sanity check parameters.
-  assert(grid);
+  assert(vs);
+  assert(row);
+  assert(col);
 
-  gin = _grid_get_internals(grid);
-  if (!gin) return NULL;
+  if (vs->transpose)
+  {
+    t = *row;
+    *row = *col;
+    *col = t;
+  }
 
-    // Return "grid_payload_free *"
-  return gin->grid_pl_free;
+  *row += vs->row;
+  *col += vs->col;
 }
 
   /*!
 
-     @brief INTERNAL:  Get grid internals structure
-
-     Returns the internals structure associated with a grid
+     @brief INTERNAL:  Map cell of grid to cell of view
 
-     @param grid    pointer to existing grid
+     @param vs    pointer to view storage
+     @param row    pointer to row of cell, mapped in place
+     @param col    pointer to column of cell, mapped in place
 
-     @retval "_grid_internals *" success
+     @retval NONE
 
   */
 
-static _grid_internals *_grid_get_internals(grid_s *grid)
+static void _view_unmap(_view_store *vs, int *row, int *col)
 {
+  int t;
+
     // Sanity check parameters.
-  assert(grid);
-    // Return "_grid_internals *"
-  return (_grid_internals *)grid->_internals;
+  assert(vs);
+  assert(row);
+  assert(col);
+
+  *row -= vs->row;
+  *col -= vs->col;
+
+  if (vs->transpose)
+  {
+    t = *row;
+    *row = *col;
+    *col = t;
+  }
 }
 
+// STATIC functions: mapped storage engine
+
   /*!
 
-     @brief INTERNAL:  Get payload data from a cell
+     @brief INTERNAL:  De-allocate mapped storage
 
-     Returns the payload data associated with a cell.
+     Calls the user release function, which owns the table and payload data.
 
-     @param c    pointer to existing cell
+     @param gin    pointer to grid internals
+     @param fpl    unused, a mapped grid never owns payload data
 
-     @retval "void *" success
+     @retval NONE
 
   */
 
-static void *_grid_get_payload(_cell *c)
+static void _mapped_release(_grid_internals *gin, grid_payload_free fpl)
 {
+  _mapped_store *ms;
+
     // Sanity check parameters.
-  assert(c);
-    // Return "void *"
-  return c->payload;
-}
+  assert(gin);
 
-  /*!
+  (void)fpl;
 
-     @brief INTERNAL:  Find a cell by reference
+  ms = (_mapped_store *)gin->store;
+  if (ms && ms->func) ms->func(ms->data);
 
-     Locates a cell in a grid based on a reference pointer value.  If the 
-     cell is located, the current grid cell is set to the found cell,
-     and the cell payload data is returned.
+  free(ms);
+  gin->store = NULL;
+}
 
-     NOTE:  This function does the actual work of finding a cell by
-            reference.  The public API function above is a wrapper around
-            this function.
+  /*!
 
-     NOTE:  This function differs from the public API version by returning
-            the entire internal cell structure, not just the payload data.
+     @brief INTERNAL:  Get payload data of mapped cell
 
-     @param grid    pointer to existing grid
-     @param pl    pointer to payload data that may exist in grid
+     @param gin    pointer to grid internals
+     @param row    row of cell
+     @param col    column of cell
 
-     @retval "_cell *" success
-     @retval NULL    failure
+     @retval "void *" success
+     @retval NULL    cell is empty
 
   */
 
-static _cell *_grid_find_by_reference(grid_s *grid, void *pl)
+static void *_mapped_get(_grid_internals *gin, int row, int col)
 {
-  _cell *c;
-  _cell *c2;
-  _grid_internals *gin;
-  int x, y;
+  _mapped_store *ms;
+  uint64_t off;
 
     // Sanity check parameters.
-  assert(grid);
-  assert(pl);
+  assert(gin);
 
-  gin = _grid_get_internals(grid);
-  if (!gin) return NULL;
+  ms = (_mapped_store *)gin->store;
 
-  for (c = gin->origin, y = 0; c; c = grid_down(grid), ++y)
-  {
-    for (c2 = c, x = 0; c2; c2 = grid_right(grid), ++x)
-      if (_grid_get_payload(c2) == pl)
-      {
-        vertex_set_y(gin->location, y);
-        vertex_set_x(gin->location, x);
-          // Return "_cell *"
-        return c2;
-      }
-  }
+  off = ms->offsets[(size_t)row * grid_size_get_width(gin->size) + col];
 
-    // Return NULL
-  return NULL;
+    // Return "void *"
+  return _mapped_payload(ms, off);
 }
 
   /*!
 
-     @brief INTERNAL:  Find a cell by value
-
-     Locates a cell in a grid by value.  If the cell is located, the
-     current grid cell is set to the found cell, and the payload data is
-     returned.
-
-     NOTE:  A user defined cell compare function must be supplied.
-
-     NOTE:  This function does the actual work of finding a cell by
-            value.  The public API function above is a wrapper around
-            this function.
+     @brief INTERNAL:  Get payloads of part of a mapped row
 
-     NOTE:  This function differs from the public API version by returning
-            the entire internal cell structure, not just the payload data.
+     Payload addresses are computed from the offsets, into buf.
 
-     @param grid    pointer to existing grid
-     @param pl    pointer to payload data that may exist in grid
-     @param cf    pointer to function to compare cell values
+     @param gin    pointer to grid internals
+     @param pos    unused
+     @param row    row of cells
+     @param col    first column of cells
+     @param count    pointer to storage for number of payloads
+     @param buf    pointer to storage for payloads
+     @param size    number of payloads buf can hold
 
-     @retval "_cell *" success
-     @retval NULL    failure
+     @retval "void **" pointer to payloads
 
   */
 
-static _cell *_grid_find_by_value(grid_s *grid,
-                                  void *pl,
-                                  grid_payload_compare cf)
+static void **_mapped_span(_grid_internals *gin, _grid_position *pos,
+                           int row, int col, int *count, void **buf, int size)
 {
-  _cell *c;
-  _cell *c2;
-  _grid_internals *gin;
-  int x, y;
+  _mapped_store *ms;
+  const uint64_t *off;
+  int n;
+  int i;
 
     // Sanity check parameters.
-  assert(grid);
-  assert(pl);
-  assert(cf);
+  assert(gin);
+  assert(count);
+  assert(buf);
 
-  gin = _grid_get_internals(grid);
-  if (!gin) return NULL;
+  (void)pos;
 
-  for (c = gin->origin, y = 0; c; c = grid_down(grid), ++y)
-  {
-    for (c2 = c, x = 0; c2; c2 = grid_right(grid), ++x)
-      if (cf(_grid_get_payload(c2), pl) == 0)
-      {
-        vertex_set_y(gin->location, y);
-        vertex_set_x(gin->location, x);
-          // Return "_cell *"
-        return c2;
-      }
-  }
+  ms = (_mapped_store *)gin->store;
 
-    // Return NULL
-  return NULL;
+  n = grid_size_get_width(gin->size) - col;
+  if (n > size) n = size;
+
+  off = ms->offsets + (size_t)row * grid_size_get_width(gin->size) + col;
+  for (i = 0; i < n; ++i)
+    buf[i] = _mapped_payload(ms, off[i]);
+
+  *count = n;
+
+    // Return "void **"
+  return buf;
 }
 
   /*!
 
-     @brief INTERNAL:  Get current cell
+     @brief INTERNAL:  Get payload data at an offset of mapped storage
 
-     Returns the cell structure at the current grid cell location.
+     The offset, and the size preceding the payload data, are checked
+     against the payload data limit before the payload data is handed out.
 
-     @param grid    pointer to existing grid
+     @param ms    pointer to mapped storage
+     @param off    offset of payload data
 
-     @retval "_cell *" success
+     @retval "void *" success
+     @retval NULL    cell is empty, or offset or size is out of bounds
 
   */
 
-static _cell *_grid_get_cell(grid_s *grid)
+static void *_mapped_payload(_mapped_store *ms, uint64_t off)
 {
-  _grid_internals *gin;
+  uint64_t size;
 
     // Sanity check parameters.
-  assert(grid);
+  assert(ms);
 
-  gin = _grid_get_internals(grid);
-  if (!gin) return NULL;
+  if (off < sizeof(uint64_t) || off % sizeof(uint64_t) || off > ms->limit)
+    return NULL;
 
-    // Return "_cell *"
-  return gin->current;
-}
+  size = ((const uint64_t *)(ms->base + off))[-1];
+  if (size > ms->limit - off) return NULL;
 
+    // Return "void *"
+  return (void *)(ms->base + off);
+}
@@ -48,6 +48,10 @@
 
 #include "list.h"
 
+  // Common constants
+
+#define LIST_RECLAIM_BATCH 256
+
   /*!
     @brief INTERNAL: list object(item) structure
   */
@@ -78,6 +82,8 @@ typedef struct
   int len;
     /*! @brief list object data payload de-allocation function */
   list_payload_free list_pl_free;
+    /*! @brief reclaimer for de-allocated items, or NULL if none */
+  reclaim_s *reclaim;
 } _list_internals;
 
   // INTERNAL: utility function prototypes for module
@@ -85,6 +91,7 @@ typedef struct
 static _list_obj *_list_obj_create(void * const pl);
 static void *_list_obj_free(_list_obj *const lo);
 static void _list_obj_destroy(_list_obj *const lo, list_payload_free fpl);
+static void _list_reclaim(_list_internals *lin, list_payload_free fpl);
 
 static list_payload_free _list_get_pl_free(list_s * const l);
 static _list_internals* _list_get_internals(list_s * const l);
@@ -153,6 +160,14 @@ void list_destroy(list_s * const list)
   if (!lin) return;
 
   fpl = _list_get_pl_free(list);
+
+  if (lin->reclaim)
+  {
+    _list_reclaim(lin, fpl);
+    free(lin);
+    free(list);
+    return;
+  }
   
   lo = lin->h;
   while (lo)
@@ -231,6 +246,32 @@ void list_set_free(list_s * const list, list_payload_free func)
   if (lin) lin->list_pl_free = func;
 }
 
+  /*!
+
+     @brief Set reclaimer for list
+
+     Payload data and items the list would de-allocate, in list_destroy() and
+     list_delete(), are handed to the reclaimer instead, and de-allocated
+     later, possibly from another thread.
+
+     @param list    pointer to existing list
+     @param r    pointer to reclaimer, or NULL to de-allocate at once
+
+     @retval NONE
+
+  */
+
+void list_set_reclaim(list_s * const list, reclaim_s * const r)
+{
+  _list_internals *lin;
+
+    // Sanity check parameters.
+  assert(list);
+
+  lin = _list_get_internals(list);
+  if (lin) lin->reclaim = r;
+}
+
   /*!
 
      @brief Get count of items in list
@@ -372,16 +413,22 @@ void list_insert(list_s * const list, void * const payload, void * const whence)
 
 void list_delete(list_s * const list, void * const whence)
 {
+  _list_internals* lin = NULL;
   void *pl = NULL;
   list_payload_free fpl = NULL;
 
   assert(list);
 
+  lin = _list_get_internals(list);
+
   pl = list_remove(list, whence);
   if (pl)
   {
     fpl = _list_get_pl_free(list);
-    if (fpl) fpl(pl);
+    if (fpl && lin && lin->reclaim)
+      reclaim_add(lin->reclaim, pl, fpl);
+    else if (fpl)
+      fpl(pl);
   }
 }
 
@@ -912,6 +959,58 @@ static void _list_obj_destroy(_list_obj *const lo, list_payload_free fpl)
   if (pl) fpl(pl);
 }
 
+  /*!
+
+     @brief INTERNAL:  Hand all list objects to the list reclaimer
+
+     Payload data (when fpl is not NULL) and list objects are handed over in
+     batches, so that the reclaimer lock is taken once per batch.  All payload
+     data is handed over before any list object, so that consecutive batches
+     share a free function and fill whole reclaimer chunks.
+
+     @param lin    pointer to list internals
+     @param fpl    payload data free function, or NULL
+
+     @retval NONE
+
+  */
+
+static void _list_reclaim(_list_internals *lin, list_payload_free fpl)
+{
+  void *pls[LIST_RECLAIM_BATCH];
+  void *los[LIST_RECLAIM_BATCH];
+  _list_obj *lo;
+  _list_obj *next;
+  int n = 0;
+
+    // Sanity check parameters.
+  assert(lin);
+  assert(lin->reclaim);
+
+  if (fpl)
+  {
+    for (lo = lin->h; lo; lo = lo->n)
+    {
+      pls[n] = lo->_pl;
+      if (++n < LIST_RECLAIM_BATCH && lo->n) continue;
+
+      reclaim_add_many(lin->reclaim, pls, n, fpl);
+      n = 0;
+    }
+  }
+
+    // A list object may be de-allocated as soon as it is handed over
+  for (lo = lin->h; lo; lo = next)
+  {
+    next = lo->n;
+    los[n] = lo;
+    if (++n < LIST_RECLAIM_BATCH && next) continue;
+
+    reclaim_add_many(lin->reclaim, los, n, free);
+    n = 0;
+  }
+}
+
   /*!
 
      @brief INTERNAL:  Get payload data free function
@@ -0,0 +1,499 @@
+/*!
+    @file reclaim.c
+
+    @brief Source file for deferred payload reclamation
+
+    @timestamp Sat, 17 Oct 2026 02:57:12 +0000
+
+    @author Patrick Head  mailto:patrickhead@gmail.com
+
+    @copyright Copyright (C) 2014  Patrick Head
+
+    @license
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.@n
+    @n
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.@n
+    @n
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+  /*!
+
+    @file reclaim.c
+
+    Source file for deferred payload reclamation
+
+    Payload data is added to the chunk being filled.  A full chunk, or the
+    chunk being filled when flushing, joins a queue of chunks.  The queue is
+    emptied by the background thread, if any, or by reclaim_flush().  The
+    payload data of a chunk is de-allocated without holding the lock.
+
+  */
+
+  // Required system headers
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+
+  // Project related headers
+
+#include "reclaim.h"
+
+  // Common constants
+
+#define RECLAIM_CHUNK 1024
+
+  /*!
+    @brief INTERNAL: chunk of payload data sharing a de-allocation function
+  */
+
+typedef struct _reclaim_chunk
+{
+    /*! @brief: next chunk in queue */
+  struct _reclaim_chunk *link;
+    /*! @brief: payload de-allocation function */
+  reclaim_free func;
+    /*! @brief: number of payloads in chunk */
+  int count;
+    /*! @brief: payload data */
+  void *payloads[RECLAIM_CHUNK];
+} _reclaim_chunk;
+
+  /*!
+    @brief INTERNAL: reclaimer details structure
+  */
+
+typedef struct
+{
+    /*! @brief: lock for all following members */
+  pthread_mutex_t lock;
+    /*! @brief: signalled when a chunk is queued, or the reclaimer stops */
+  pthread_cond_t queued;
+    /*! @brief: signalled when the background thread runs out of chunks */
+  pthread_cond_t idle;
+    /*! @brief: background thread */
+  pthread_t thread;
+    /*! @brief: non-zero when the background thread was started */
+  int background;
+    /*! @brief: non-zero while the background thread empties a chunk */
+  int busy;
+    /*! @brief: non-zero when the reclaimer is stopping */
+  int stop;
+    /*! @brief: number of payloads not yet de-allocated */
+  long pending;
+    /*! @brief: chunk being filled, or NULL */
+  _reclaim_chunk *fill;
+    /*! @brief: first full chunk in queue */
+  _reclaim_chunk *head;
+    /*! @brief: last full chunk in queue */
+  _reclaim_chunk *tail;
+} _reclaim_internals;
+
+  // INTERNAL: utility function prototypes for module
+
+static _reclaim_internals *_reclaim_get_internals(reclaim_s *r);
+static void *_reclaim_worker(void *arg);
+static void _reclaim_queue(_reclaim_internals *ri);
+static void _reclaim_chunk_free(_reclaim_chunk *chunk);
+
+  /*!
+
+     @brief Create a new reclaimer
+
+     Creates a reclaimer, optionally starting a background thread which
+     de-allocates payload data as chunks of it fill.
+
+     @param background    non-zero to de-allocate in a background thread,
+                          zero to de-allocate only in reclaim_flush()
+
+     @retval "reclaim_s *" success
+     @retval NULL    failure
+
+  */
+
+reclaim_s *reclaim_create(int background)
+{
+  reclaim_s *r;
+  _reclaim_internals *ri;
+
+  r = malloc(sizeof(reclaim_s));
+  if (!r) return NULL;
+
+  ri = (void*)malloc(sizeof(_reclaim_internals));
+  if (!ri)
+  {
+    free(r);
+    return NULL;
+  }
+  memset(ri, 0, sizeof(_reclaim_internals));
+  r->_internals = ri;
+
+  pthread_mutex_init(&ri->lock, NULL);
+  pthread_cond_init(&ri->queued, NULL);
+  pthread_cond_init(&ri->idle, NULL);
+
+  if (background)
+  {
+    if (pthread_create(&ri->thread, NULL, _reclaim_worker, ri))
+    {
+      reclaim_destroy(r);
+      return NULL;
+    }
+    ri->background = 1;
+  }
+
+    // Return "reclaim_s *"
+  return r;
+}
+
+  /*!
+
+     @brief Destroy a reclaimer
+
+     De-allocates all payload data still held, stops the background thread,
+     if any, and de-allocates the reclaimer.
+
+     @param r    pointer to existing reclaimer
+
+     @retval NONE
+
+  */
+
+void reclaim_destroy(reclaim_s *r)
+{
+  _reclaim_internals *ri;
+
+    // Sanity check parameters.
+  assert(r);
+
+  ri = _reclaim_get_internals(r);
+  if (ri)
+  {
+    reclaim_flush(r);
+
+    if (ri->background)
+    {
+      pthread_mutex_lock(&ri->lock);
+      ri->stop = 1;
+      pthread_cond_broadcast(&ri->queued);
+      pthread_mutex_unlock(&ri->lock);
+
+      pthread_join(ri->thread, NULL);
+    }
+
+    pthread_cond_destroy(&ri->idle);
+    pthread_cond_destroy(&ri->queued);
+    pthread_mutex_destroy(&ri->lock);
+
+    free(ri);
+  }
+
+  free(r);
+}
+
+  /*!
+
+     @brief Get number of payloads not yet de-allocated
+
+     @param r    pointer to existing reclaimer
+
+     @retval "long" number of payloads
+
+  */
+
+long reclaim_get_pending(reclaim_s *r)
+{
+  _reclaim_internals *ri;
+  long n;
+
+    // Sanity check parameters.
+  assert(r);
+
+  ri = _reclaim_get_internals(r);
+  if (!ri) return 0;
+
+  pthread_mutex_lock(&ri->lock);
+  n = ri->pending;
+  pthread_mutex_unlock(&ri->lock);
+
+    // Return "long"
+  return n;
+}
+
+  /*!
+
+     @brief Add payload data to a reclaimer
+
+     The payload data is de-allocated later, by calling func from the
+     background thread, or from reclaim_flush().  Should the reclaimer run
+     out of memory, the payload data is de-allocated at once.
+
+     @param r    pointer to existing reclaimer
+     @param payload    pointer to payload data
+     @param func    pointer to payload de-allocation function
+
+     @retval NONE
+
+  */
+
+void reclaim_add(reclaim_s *r, void *payload, reclaim_free func)
+{
+    // Sanity check parameters.
+  assert(r);
+  assert(func);
+
+  if (payload) reclaim_add_many(r, &payload, 1, func);
+}
+
+  /*!
+
+     @brief Add an array of payload data to a reclaimer
+
+     As for reclaim_add(), for every non-NULL payload of an array, taking
+     the reclaimer lock once.
+
+     @param r    pointer to existing reclaimer
+     @param payloads    pointer to array of payload data
+     @param count    number of payloads in array
+     @param func    pointer to payload de-allocation function
+
+     @retval NONE
+
+  */
+
+void reclaim_add_many(reclaim_s *r,
+                      void * const *payloads,
+                      int count,
+                      reclaim_free func)
+{
+  _reclaim_internals *ri;
+  _reclaim_chunk *chunk;
+  int i;
+
+    // Sanity check parameters.
+  assert(r);
+  assert(payloads);
+  assert(func);
+
+  ri = _reclaim_get_internals(r);
+  if (!ri) return;
+
+  pthread_mutex_lock(&ri->lock);
+
+  for (i = 0; i < count; ++i)
+  {
+    if (!payloads[i]) continue;
+
+    chunk = ri->fill;
+    if (chunk && (chunk->func != func || chunk->count == RECLAIM_CHUNK))
+    {
+      _reclaim_queue(ri);
+      chunk = NULL;
+    }
+
+    if (!chunk)
+    {
+      chunk = (_reclaim_chunk *)malloc(sizeof(_reclaim_chunk));
+      if (!chunk)
+      {
+        pthread_mutex_unlock(&ri->lock);
+        for ( ; i < count; ++i)
+          if (payloads[i]) func(payloads[i]);
+        return;
+      }
+      chunk->link = NULL;
+      chunk->func = func;
+      chunk->count = 0;
+      ri->fill = chunk;
+    }
+
+    chunk->payloads[chunk->count++] = payloads[i];
+    ++ri->pending;
+  }
+
+  pthread_mutex_unlock(&ri->lock);
+}
+
+  /*!
+
+     @brief De-allocate all payload data held by a reclaimer
+
+     Returns once every payload added before the call has been de-allocated,
+     so that the reclaimer may serve as a barrier before shutting down.
+     Without a background thread, the payload data is de-allocated in the
+     calling thread.
+
+     @param r    pointer to existing reclaimer
+
+     @retval NONE
+
+  */
+
+void reclaim_flush(reclaim_s *r)
+{
+  _reclaim_internals *ri;
+  _reclaim_chunk *chunk;
+  _reclaim_chunk *link;
+
+    // Sanity check parameters.
+  assert(r);
+
+  ri = _reclaim_get_internals(r);
+  if (!ri) return;
+
+  pthread_mutex_lock(&ri->lock);
+
+  if (ri->fill) _reclaim_queue(ri);
+
+  if (ri->background)
+  {
+    while (ri->head || ri->busy)
+      pthread_cond_wait(&ri->idle, &ri->lock);
+    pthread_mutex_unlock(&ri->lock);
+    return;
+  }
+
+  chunk = ri->head;
+  ri->head = ri->tail = NULL;
+  ri->pending = 0;
+
+  pthread_mutex_unlock(&ri->lock);
+
+  for ( ; chunk; chunk = link)
+  {
+    link = chunk->link;
+    _reclaim_chunk_free(chunk);
+    free(chunk);
+  }
+}
+
+// STATIC functions
+
+  /*!
+
+     @brief INTERNAL:  Get reclaimer internals
+
+     @param r    pointer to existing reclaimer
+
+     @retval "_reclaim_internals *" success
+     @retval NULL    failure
+
+  */
+
+static _reclaim_internals *_reclaim_get_internals(reclaim_s *r)
+{
+    // Sanity check parameters.
+  assert(r);
+    // Return "_reclaim_internals *"
+  return (_reclaim_internals *)r->_internals;
+}
+
+  /*!
+
+     @brief INTERNAL:  Background thread, de-allocating queued chunks
+
+     @param arg    pointer to reclaimer internals
+
+     @retval NULL    always
+
+  */
+
+static void *_reclaim_worker(void *arg)
+{
+  _reclaim_internals *ri;
+  _reclaim_chunk *chunk;
+
+    // Sanity check parameters.
+  assert(arg);
+
+  ri = (_reclaim_internals *)arg;
+
+  pthread_mutex_lock(&ri->lock);
+
+  for (;;)
+  {
+    while (!ri->head && !ri->stop)
+      pthread_cond_wait(&ri->queued, &ri->lock);
+    if (!ri->head) break;
+
+    chunk = ri->head;
+    ri->head = chunk->link;
+    if (!ri->head) ri->tail = NULL;
+    ri->busy = 1;
+
+    pthread_mutex_unlock(&ri->lock);
+    _reclaim_chunk_free(chunk);
+    pthread_mutex_lock(&ri->lock);
+
+    ri->pending -= chunk->count;
+    ri->busy = 0;
+    free(chunk);
+
+    if (!ri->head) pthread_cond_broadcast(&ri->idle);
+  }
+
+  pthread_mutex_unlock(&ri->lock);
+
+    // Return "void *"
+  return NULL;
+}
+
+  /*!
+
+     @brief INTERNAL:  Queue the chunk being filled
+
+     NOTE:  The reclaimer lock must be held.
+
+     @param ri    pointer to reclaimer internals
+
+     @retval NONE
+
+  */
+
+static void _reclaim_queue(_reclaim_internals *ri)
+{
+    // Sanity check parameters.
+  assert(ri);
+  assert(ri->fill);
+
+  if (ri->tail)
+    ri->tail->link = ri->fill;
+  else
+    ri->head = ri->fill;
+  ri->tail = ri->fill;
+  ri->fill = NULL;
+
+  if (ri->background) pthread_cond_signal(&ri->queued);
+}
+
+  /*!
+
+     @brief INTERNAL:  De-allocate the payload data of a chunk
+
+     The chunk itself is left for the caller.
+
+     @param chunk    pointer to chunk
+
+     @retval NONE
+
+  */
+
+static void _reclaim_chunk_free(_reclaim_chunk *chunk)
+{
+  int i;
+
+    // Sanity check parameters.
+  assert(chunk);
+
+  for (i = 0; i < chunk->count; ++i)
+    chunk->func(chunk->payloads[i]);
+}
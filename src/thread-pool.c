@@ -0,0 +1,444 @@
+/*!
+    @file thread-pool.c
+
+    @brief Source file for thread pool management
+
+    @timestamp Sat, 17 Oct 2026 02:57:12 +0000
+
+    @author Patrick Head  mailto:patrickhead@gmail.com
+
+    @copyright Copyright (C) 2014  Patrick Head
+
+    @license
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.@n
+    @n
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.@n
+    @n
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+  /*!
+
+    @file thread-pool.c
+
+    Source file for thread pool management
+
+    Jobs waiting to be run are kept in a queue.  Each worker thread, and each
+    thread calling thread_pool_run(), repeatedly claims the next unclaimed
+    index of the job at the head of the queue.  A job leaves the queue once
+    its last index is claimed, and thread_pool_run() returns once its last
+    index has finished.
+
+  */
+
+  // Required system headers
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <unistd.h>
+
+  // Project related headers
+
+#include "thread-pool.h"
+
+  /*!
+    @brief INTERNAL: job structure, owned by the thread running the job
+  */
+
+typedef struct _thread_pool_work
+{
+    /*! @brief: user job function */
+  thread_pool_job func;
+    /*! @brief: user data for job function */
+  void *data;
+    /*! @brief: number of indices in job */
+  int count;
+    /*! @brief: next index to claim */
+  int next;
+    /*! @brief: number of indices finished */
+  int done;
+    /*! @brief: next job in queue */
+  struct _thread_pool_work *link;
+} _thread_pool_work;
+
+  /*!
+    @brief INTERNAL: thread pool details structure
+  */
+
+typedef struct
+{
+    /*! @brief: lock for all following members */
+  pthread_mutex_t lock;
+    /*! @brief: signalled when a job is queued, or the pool is stopping */
+  pthread_cond_t queued;
+    /*! @brief: signalled when a job finishes */
+  pthread_cond_t finished;
+    /*! @brief: worker threads */
+  pthread_t *threads;
+    /*! @brief: number of worker threads */
+  int nthreads;
+    /*! @brief: non-zero when the pool is stopping */
+  int stop;
+    /*! @brief: first job in queue */
+  _thread_pool_work *head;
+    /*! @brief: last job in queue */
+  _thread_pool_work *tail;
+} _thread_pool_internals;
+
+  // INTERNAL: utility function prototypes for module
+
+static _thread_pool_internals *_thread_pool_get_internals(thread_pool_s *tp);
+static void *_thread_pool_worker(void *arg);
+static int _thread_pool_claim(_thread_pool_internals *tpi,
+                              _thread_pool_work *work);
+static void _thread_pool_finish(_thread_pool_internals *tpi,
+                                _thread_pool_work *work);
+
+  /*!
+
+     @brief Create a new thread pool
+
+     Creates a thread pool, and starts its worker threads.
+
+     @param threads    number of worker threads, or less than 1 for one per
+                       online processor
+
+     @retval "thread_pool_s *" success
+     @retval NULL    failure
+
+  */
+
+thread_pool_s *thread_pool_create(int threads)
+{
+  thread_pool_s *tp;
+  _thread_pool_internals *tpi;
+  long n;
+
+  if (threads < 1)
+  {
+    n = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = (n < 1) ? 1 : (int)n;
+  }
+
+  tp = malloc(sizeof(thread_pool_s));
+  if (!tp) return NULL;
+
+  tpi = (void*)malloc(sizeof(_thread_pool_internals));
+  if (!tpi)
+  {
+    free(tp);
+    return NULL;
+  }
+  memset(tpi, 0, sizeof(_thread_pool_internals));
+  tp->_internals = tpi;
+
+  pthread_mutex_init(&tpi->lock, NULL);
+  pthread_cond_init(&tpi->queued, NULL);
+  pthread_cond_init(&tpi->finished, NULL);
+
+  tpi->threads = (pthread_t *)malloc((size_t)threads * sizeof(pthread_t));
+  if (!tpi->threads)
+  {
+    thread_pool_destroy(tp);
+    return NULL;
+  }
+
+  for (tpi->nthreads = 0; tpi->nthreads < threads; ++tpi->nthreads)
+    if (pthread_create(&tpi->threads[tpi->nthreads],
+                       NULL,
+                       _thread_pool_worker,
+                       tpi))
+    {
+      thread_pool_destroy(tp);
+      return NULL;
+    }
+
+    // Return "thread_pool_s *"
+  return tp;
+}
+
+  /*!
+
+     @brief Destroy a thread pool
+
+     Stops and joins the worker threads, and de-allocates the pool.
+
+     NOTE:  No job may be running on the pool.
+
+     @param tp    pointer to existing thread pool
+
+     @retval NONE
+
+  */
+
+void thread_pool_destroy(thread_pool_s *tp)
+{
+  _thread_pool_internals *tpi;
+  int i;
+
+    // Sanity check parameters.
+  assert(tp);
+
+  tpi = _thread_pool_get_internals(tp);
+  if (tpi)
+  {
+    pthread_mutex_lock(&tpi->lock);
+    tpi->stop = 1;
+    pthread_cond_broadcast(&tpi->queued);
+    pthread_mutex_unlock(&tpi->lock);
+
+    for (i = 0; i < tpi->nthreads; ++i)
+      pthread_join(tpi->threads[i], NULL);
+
+    pthread_cond_destroy(&tpi->finished);
+    pthread_cond_destroy(&tpi->queued);
+    pthread_mutex_destroy(&tpi->lock);
+
+    free(tpi->threads);
+    free(tpi);
+  }
+
+  free(tp);
+}
+
+  /*!
+
+     @brief Get number of worker threads of a thread pool
+
+     @param tp    pointer to existing thread pool, or NULL
+
+     @retval "int" number of worker threads
+
+  */
+
+int thread_pool_get_size(thread_pool_s *tp)
+{
+  _thread_pool_internals *tpi;
+
+  if (!tp) return 0;
+
+  tpi = _thread_pool_get_internals(tp);
+  if (!tpi) return 0;
+
+    // Return "int"
+  return tpi->nthreads;
+}
+
+  /*!
+
+     @brief Run a job on a thread pool
+
+     Calls a user function once for each index from 0 to count - 1, spread
+     over the worker threads and the calling thread, and returns once every
+     call has returned.  The order of the calls is not defined.
+
+     @param tp    pointer to existing thread pool, or NULL to run serially
+     @param count    number of indices
+     @param func    pointer to job function
+     @param data    pointer to user data passed to func
+
+     @retval NONE
+
+  */
+
+void thread_pool_run(thread_pool_s *tp,
+                     int count,
+                     thread_pool_job func,
+                     void *data)
+{
+  _thread_pool_internals *tpi;
+  _thread_pool_work work;
+  int i;
+
+    // Sanity check parameters.
+  assert(func);
+
+  if (count < 1) return;
+
+  tpi = (tp) ? _thread_pool_get_internals(tp) : NULL;
+
+  if (!tpi || !tpi->nthreads || count == 1)
+  {
+    for (i = 0; i < count; ++i) func(i, data);
+    return;
+  }
+
+  memset(&work, 0, sizeof(_thread_pool_work));
+  work.func = func;
+  work.data = data;
+  work.count = count;
+
+  pthread_mutex_lock(&tpi->lock);
+
+  if (tpi->tail)
+    tpi->tail->link = &work;
+  else
+    tpi->head = &work;
+  tpi->tail = &work;
+
+  pthread_cond_broadcast(&tpi->queued);
+
+    // Help run the job, then wait for indices claimed by workers
+  while ((i = _thread_pool_claim(tpi, &work)) >= 0)
+  {
+    pthread_mutex_unlock(&tpi->lock);
+    func(i, data);
+    pthread_mutex_lock(&tpi->lock);
+    _thread_pool_finish(tpi, &work);
+  }
+
+  while (work.done < work.count)
+    pthread_cond_wait(&tpi->finished, &tpi->lock);
+
+  pthread_mutex_unlock(&tpi->lock);
+}
+
+// STATIC functions
+
+  /*!
+
+     @brief INTERNAL:  Get thread pool internals
+
+     @param tp    pointer to existing thread pool
+
+     @retval "_thread_pool_internals *" success
+     @retval NULL    failure
+
+  */
+
+static _thread_pool_internals *_thread_pool_get_internals(thread_pool_s *tp)
+{
+    // Sanity check parameters.
+  assert(tp);
+
+    // Return "_thread_pool_internals *"
+  return (_thread_pool_internals *)tp->_internals;
+}
+
+  /*!
+
+     @brief INTERNAL:  Worker thread
+
+     Runs indices of queued jobs until the pool is stopping.
+
+     @param arg    pointer to thread pool internals
+
+     @retval NULL
+
+  */
+
+static void *_thread_pool_worker(void *arg)
+{
+  _thread_pool_internals *tpi;
+  _thread_pool_work *work;
+  int i;
+
+    // Sanity check parameters.
+  assert(arg);
+
+  tpi = (_thread_pool_internals *)arg;
+
+  pthread_mutex_lock(&tpi->lock);
+
+  for (;;)
+  {
+    while (!tpi->stop && !tpi->head)
+      pthread_cond_wait(&tpi->queued, &tpi->lock);
+
+    if (!tpi->head) break;
+
+    work = tpi->head;
+    i = _thread_pool_claim(tpi, work);
+
+    pthread_mutex_unlock(&tpi->lock);
+    work->func(i, work->data);
+    pthread_mutex_lock(&tpi->lock);
+
+    _thread_pool_finish(tpi, work);
+  }
+
+  pthread_mutex_unlock(&tpi->lock);
+
+    // Return NULL
+  return NULL;
+}
+
+  /*!
+
+     @brief INTERNAL:  Claim next index of a job
+
+     Removes the job from the queue once its last index is claimed.
+
+     NOTE:  The pool lock must be held.
+
+     @param tpi    pointer to thread pool internals
+     @param work    pointer to job
+
+     @retval "int" index claimed
+     @retval -1    every index already claimed
+
+  */
+
+static int _thread_pool_claim(_thread_pool_internals *tpi,
+                              _thread_pool_work *work)
+{
+  _thread_pool_work **pw;
+  int i;
+
+    // Sanity check parameters.
+  assert(tpi);
+  assert(work);
+
+  if (work->next >= work->count) return -1;
+
+  i = work->next++;
+
+  if (work->next == work->count)
+  {
+    for (pw = &tpi->head; *pw != work; pw = &(*pw)->link) ;
+    *pw = work->link;
+    if (tpi->tail == work)
+    {
+      for (tpi->tail = tpi->head;
+           tpi->tail && tpi->tail->link;
+           tpi->tail = tpi->tail->link) ;
+    }
+  }
+
+    // Return "int"
+  return i;
+}
+
+  /*!
+
+     @brief INTERNAL:  Record that an index of a job has finished
+
+     NOTE:  The pool lock must be held.
+
+     @param tpi    pointer to thread pool internals
+     @param work    pointer to job
+
+     @retval NONE
+
+  */
+
+static void _thread_pool_finish(_thread_pool_internals *tpi,
+                                _thread_pool_work *work)
+{
+    // Sanity check parameters.
+  assert(tpi);
+  assert(work);
+
+  if (++work->done == work->count)
+    pthread_cond_broadcast(&tpi->finished);
+}
+
@@ -141,9 +141,12 @@ vertex_s *vertex_copy(vertex_s *v)
   assert(v);
 
   nv = vertex_create();
-  memcpy(nv, v, sizeof(vertex_s));
+  if (!nv) return NULL;
 
-  if (v->tag) nv->tag = strdup(v->tag);
+    // The copy takes its own copy of the tag, in place of the default tag
+  free(nv->tag);
+  memcpy(nv, v, sizeof(vertex_s));
+  nv->tag = (v->tag) ? strdup(v->tag) : NULL;
 
     // Return "vertex_s *"
   return nv;
@@ -0,0 +1,240 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "grid-api.h"
+#include "thread-pool.h"
+
+#define JOBS 4
+#define BATCHES 200
+#define BATCH 64
+#define VALUES 256
+
+static int values[VALUES];
+
+static void run(int index, void *data);
+static int compare(grid_api_s *a, grid_api_s *b);
+static grid_api_cmd_s command(unsigned *seed, vertex_s *location);
+static void *copy(void *d);
+static void *paste(void *d);
+static void keep(void *d);
+static int next(unsigned *seed, int n);
+
+int main(int argc, char **argv)
+{
+  thread_pool_s *pool;
+  grid_api_status_s stat[2];
+  grid_api_cmd_s cmds[2];
+  grid_api_s *ga;
+  vertex_s *v;
+  int failed[JOBS];
+  int i;
+  int rc = 0;
+
+  (void)argc;
+  (void)argv;
+
+  for (i = 0; i < VALUES; i++) values[i] = i;
+
+    // Independent grid APIs driven from the pool at once
+  pool = thread_pool_create(JOBS);
+  memset(failed, 0, sizeof(failed));
+  if (pool)
+  {
+    thread_pool_run(pool, JOBS, run, failed);
+    thread_pool_destroy(pool);
+  }
+  else
+    run(0, failed);
+
+  for (i = 0; i < JOBS; i++)
+    if (failed[i]) rc = 1;
+
+  printf("api batch: %s\n", rc ? "FAILED" : "PASSED");
+
+    // A batch with an invalid command executes nothing
+  ga = grid_api_create();
+  v = vertex_create();
+  vertex_set_x(v, 3);
+  vertex_set_y(v, 4);
+  cmds[0].command = grid_api_command_set_size;
+  cmds[0].data.location = v;
+  cmds[1].command = grid_api_command_goto;
+  cmds[1].data.location = NULL;
+  if (grid_api_do_batch(ga, cmds, 2, stat) != -1 ||
+      stat[0].code != 0 || stat[1].code != -1 ||
+      stat[1].rows != 1 || stat[1].columns != 1)
+    rc = 1;
+  vertex_destroy(v);
+  grid_api_destroy(ga);
+
+  printf("api batch invalid: %s\n", rc ? "FAILED" : "PASSED");
+
+  return rc;
+}
+
+  // Drive one grid API with single commands and another with batches of the
+  // same commands; both must end up alike, with alike statuses
+
+static void run(int index, void *data)
+{
+  grid_api_status_s single[BATCH];
+  grid_api_status_s batch[BATCH];
+  grid_api_cmd_s cmds[BATCH];
+  vertex_s *locations[BATCH];
+  const grid_api_status_s *stat;
+  grid_api_s *a, *b;
+  unsigned seed = (unsigned)index + 1;
+  int *failed = (int *)data;
+  int i, k, n, nfail;
+
+    // Payload data lives in values, and is never de-allocated
+  a = grid_api_create();
+  b = grid_api_create();
+  grid_api_set_free(a, keep);
+  grid_api_set_free(b, keep);
+  grid_api_set_copy(a, copy);
+  grid_api_set_copy(b, copy);
+  grid_api_set_paste(a, paste);
+  grid_api_set_paste(b, paste);
+
+  for (i = 0; i < BATCH; i++) locations[i] = vertex_create();
+
+  for (k = 0; k < BATCHES && !failed[index]; k++)
+  {
+    n = 1 + next(&seed, BATCH);
+    nfail = 0;
+    for (i = 0; i < n; i++)
+    {
+      cmds[i] = command(&seed, locations[i]);
+      stat = grid_api_do(a, cmds[i].command, cmds[i].data);
+      single[i] = *stat;
+      if (stat->code) ++nfail;
+    }
+
+    if (grid_api_do_batch(b, cmds, n, batch) != nfail) failed[index] = 1;
+
+    for (i = 0; i < n; i++)
+      if (single[i].code != batch[i].code ||
+          single[i].rows != batch[i].rows ||
+          single[i].columns != batch[i].columns ||
+          single[i].data != batch[i].data)
+        failed[index] = 1;
+
+    if (compare(a, b)) failed[index] = 1;
+  }
+
+  for (i = 0; i < BATCH; i++) vertex_destroy(locations[i]);
+
+  grid_api_destroy(a);
+  grid_api_destroy(b);
+}
+
+static int compare(grid_api_s *a, grid_api_s *b)
+{
+  const grid_api_status_s *sa, *sb;
+  grid_api_data_u data;
+  vertex_s *v;
+  double x, y;
+  int row, col;
+  int rc = 0;
+
+  memset(&data, 0, sizeof(data));
+  sa = grid_api_do(a, grid_api_command_nop, data);
+  sb = grid_api_do(b, grid_api_command_nop, data);
+
+  if (sa->rows != sb->rows || sa->columns != sb->columns ||
+      vertex_get_x(sa->location) != vertex_get_x(sb->location) ||
+      vertex_get_y(sa->location) != vertex_get_y(sb->location))
+    return -1;
+
+  x = vertex_get_x(sa->location);
+  y = vertex_get_y(sa->location);
+
+  v = vertex_create();
+  data.location = v;
+
+  for (row = 0; row < sa->rows && !rc; row++)
+    for (col = 0; col < sa->columns && !rc; col++)
+    {
+      vertex_set_x(v, col + 1);
+      vertex_set_y(v, row + 1);
+      grid_api_do(a, grid_api_command_goto, data);
+      grid_api_do(b, grid_api_command_goto, data);
+      if (grid_api_do(a, grid_api_command_get_data, data)->data !=
+          grid_api_do(b, grid_api_command_get_data, data)->data)
+        rc = -1;
+    }
+
+    // Put both cursors back
+  vertex_set_x(v, x + 1);
+  vertex_set_y(v, y + 1);
+  grid_api_do(a, grid_api_command_goto, data);
+  grid_api_do(b, grid_api_command_goto, data);
+
+  vertex_destroy(v);
+
+  return rc;
+}
+
+static grid_api_cmd_s command(unsigned *seed, vertex_s *location)
+{
+  static const grid_api_command_t commands[] =
+  {
+    grid_api_command_up, grid_api_command_down,
+    grid_api_command_left, grid_api_command_right,
+    grid_api_command_up, grid_api_command_down,
+    grid_api_command_left, grid_api_command_right,
+    grid_api_command_home, grid_api_command_end, grid_api_command_goto,
+    grid_api_command_goto, grid_api_command_set_data,
+    grid_api_command_set_data, grid_api_command_get_data,
+    grid_api_command_copy, grid_api_command_paste, grid_api_command_show,
+    grid_api_command_new_row, grid_api_command_del_row,
+    grid_api_command_new_column, grid_api_command_del_column,
+    grid_api_command_set_size, grid_api_command_get_size,
+    grid_api_command_nop
+  };
+  grid_api_cmd_s cmd;
+
+  cmd.command = commands[next(seed, sizeof(commands) / sizeof(commands[0]))];
+
+  switch (cmd.command)
+  {
+    case grid_api_command_goto:
+    case grid_api_command_set_size:
+      vertex_set_x(location, next(seed, 10) - 1);
+      vertex_set_y(location, next(seed, 10) - 1);
+      cmd.data.location = location;
+      break;
+    case grid_api_command_set_data:
+      cmd.data.data = &values[next(seed, VALUES)];
+      break;
+    default:
+      cmd.data.repeat = next(seed, 9) - 3;
+      break;
+  }
+
+  return cmd;
+}
+
+static void *copy(void *d)
+{
+  return d;
+}
+
+static void *paste(void *d)
+{
+  return d;
+}
+
+static void keep(void *d)
+{
+  (void)d;
+}
+
+static int next(unsigned *seed, int n)
+{
+  *seed = *seed * 1103515245u + 12345u;
+
+  return (int)((*seed >> 16) % (unsigned)n);
+}
@@ -16,7 +16,7 @@ void raw(void);
 void cooked(void);
 static void help(void);
 static int add_digit(int n, char digit);
-static void status(grid_api_status_s *stat);
+static void status(const grid_api_status_s *stat);
 
 void free_data(data* const d);
 void* edit(void* const d);
@@ -30,7 +30,7 @@ int main(int argc, char **argv)
   grid_api_s* fr;
   char cmd = 0;
   int quit = 0;
-  grid_api_status_s *stat;
+  const grid_api_status_s *stat;
   grid_api_data_u dat;
   int n1, n2;
   int which_num = 1;
@@ -415,7 +415,7 @@ static int add_digit(int n, char digit)
   return n;
 }
 
-static void status(grid_api_status_s *stat)
+static void status(const grid_api_status_s *stat)
 {
   assert(stat);
 
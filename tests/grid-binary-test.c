@@ -0,0 +1,243 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "grid-binary.h"
+
+#define ROWS 150
+#define COLS 40
+#define FILE_NAME "test.bin"
+
+static size_t to_binary(void *payload, void *buf, size_t size, void *data);
+static int strcmp_pl(void *pl1, void *pl2);
+static int check(grid_s *g, grid_s *m);
+static int check_damaged(grid_s *g);
+static uint64_t get64(FILE *fp, long pos);
+static void put64(FILE *fp, long pos, uint64_t n);
+
+int main(int argc, char **argv)
+{
+  grid_s *g;
+  grid_s *m;
+  grid_size_s *size;
+  char s[64];
+  FILE *fp;
+  int seed = 1;
+  int row, col;
+  int failed = 0;
+
+  if (argc > 1) seed = atoi(argv[1]);
+  srand(seed);
+
+  size = grid_size_create();
+  grid_size_set(size, COLS, ROWS);
+
+  g = grid_create_storage(grid_storage_tiled);
+  grid_set_size(g, size);
+  for (row = 0; row < ROWS; row++)
+    for (col = 0; col < COLS; col++)
+    {
+      if (rand() % 3 == 0) continue;
+      sprintf(s, "%d:%d:%.*s", row, col, rand() % 20, "abcdefghijklmnopqrstuvwxyz");
+      grid_goto(g, row, col);
+      grid_set_cell(g, strdup(s));
+    }
+
+  if (grid_binary_write(g, FILE_NAME, to_binary, NULL)) failed = 1;
+
+  m = grid_binary_open(FILE_NAME);
+  if (!m || check(g, m)) failed = 1;
+
+    // A mapped grid can not be changed
+  if (m)
+  {
+    grid_create_row(m, 0);
+    grid_goto(m, 1, 1);
+    grid_set_cell(m, NULL);
+    if (check(g, m)) failed = 1;
+
+    grid_goto(g, ROWS - 1, COLS - 1);
+    if (grid_get_cell(g) &&
+        !grid_find_by_value(m, grid_get_cell(g), strcmp_pl))
+      failed = 1;
+
+    grid_destroy(m);
+  }
+
+  printf("binary: %s\n", failed ? "FAILED" : "PASSED");
+
+  if (check_damaged(g)) failed = 1;
+
+  printf("binary damaged: %s\n", failed ? "FAILED" : "PASSED");
+
+    // An empty grid, then a damaged file
+  grid_size_set(size, 0, 0);
+  grid_set_size(g, size);
+  if (grid_binary_write(g, FILE_NAME, to_binary, NULL)) failed = 1;
+  m = grid_binary_open(FILE_NAME);
+  if (!m || grid_size_get_height(grid_get_size(m)) || grid_get_cell(m))
+    failed = 1;
+  if (m) grid_destroy(m);
+
+  fp = fopen(FILE_NAME, "r+b");
+  if (fp)
+  {
+    fputc('X', fp);
+    fclose(fp);
+  }
+  if (grid_binary_open(FILE_NAME)) failed = 1;
+
+  printf("binary empty: %s\n", failed ? "FAILED" : "PASSED");
+
+  grid_destroy(g);
+  grid_size_destroy(size);
+
+  return failed;
+}
+
+static size_t to_binary(void *payload, void *buf, size_t size, void *data)
+{
+  size_t n;
+
+  (void)data;
+
+  n = strlen((char *)payload) + 1;
+  if (n <= size) memcpy(buf, payload, n);
+
+  return n;
+}
+
+static int strcmp_pl(void *pl1, void *pl2)
+{
+  if (!pl1 || !pl2) return -1;
+  return strcmp((char *)pl1, (char *)pl2);
+}
+
+  // Every cell of the mapped grid must hold what the grid held
+
+static int check(grid_s *g, grid_s *m)
+{
+  grid_cursor_s *gc;
+  grid_cursor_s *mc;
+  char *gp, *mp;
+  int row, col;
+  int rc = 0;
+
+  if (grid_get_storage(m) != grid_storage_mapped ||
+      grid_size_get_height(grid_get_size(m)) != ROWS ||
+      grid_size_get_width(grid_get_size(m)) != COLS)
+    return -1;
+
+  gc = grid_cursor_create(g);
+  mc = grid_cursor_create(m);
+
+  for (row = 0; row < ROWS && !rc; row++)
+    for (col = 0; col < COLS && !rc; col++)
+    {
+      gp = (char *)grid_cursor_goto(gc, row, col);
+      mp = (char *)grid_cursor_goto(mc, row, col);
+      if (!gp != !mp) rc = -1;
+      else if (gp && (strcmp(gp, mp) ||
+                      grid_binary_payload_size(mp) != strlen(gp) + 1 ||
+                      (uintptr_t)mp % 8))
+        rc = -1;
+    }
+
+  grid_cursor_destroy(gc);
+  grid_cursor_destroy(mc);
+
+  return rc;
+}
+
+  // Offsets and sizes pointing outside of the payload data must read as empty
+  // cells, and a truncated file must not open
+
+static int check_damaged(grid_s *g)
+{
+  grid_s *m;
+  FILE *fp;
+  uint64_t table, data, limit;
+  uint64_t off[5];
+  long pos[5];
+  char *gp, *mp;
+  int i, k, row, col;
+  int rc = 0;
+
+  if (grid_binary_write(g, FILE_NAME, to_binary, NULL)) return -1;
+
+  fp = fopen(FILE_NAME, "r+b");
+  if (!fp) return -1;
+
+    // Header holds table, data and size at bytes 32, 40 and 48
+  table = get64(fp, 32);
+  data = get64(fp, 40);
+  limit = get64(fp, 48);
+
+    // Five non-empty cells, damaged in turn
+  for (i = k = 0; k < 5 && i < ROWS * COLS; i++)
+  {
+    pos[k] = (long)(table + (uint64_t)i * sizeof(uint64_t));
+    off[k] = get64(fp, pos[k]);
+    if (off[k]) ++k;
+  }
+  if (k < 5)
+  {
+    fclose(fp);
+    return -1;
+  }
+
+  put64(fp, pos[0], off[0] + 1);
+  put64(fp, pos[1], 4);
+  put64(fp, pos[2], limit + sizeof(uint64_t));
+  put64(fp, pos[3], UINT64_MAX - 7);
+  put64(fp, (long)(data + off[4] - sizeof(uint64_t)), limit);
+  fclose(fp);
+
+  m = grid_binary_open(FILE_NAME);
+  if (!m) return -1;
+
+  for (row = 0; row < ROWS && !rc; row++)
+    for (col = 0; col < COLS && !rc; col++)
+    {
+      grid_goto(g, row, col);
+      gp = (char *)grid_get_cell(g);
+      mp = (char *)grid_goto(m, row, col);
+      for (i = 0; i < 5; i++)
+        if (pos[i] == (long)(table + (uint64_t)(row * COLS + col) *
+                                       sizeof(uint64_t)))
+          break;
+      if (i < 5 ? mp != NULL : (!gp != !mp || (gp && strcmp(gp, mp))))
+        rc = -1;
+    }
+
+  grid_destroy(m);
+
+  if (rc) return rc;
+
+    // Cut the payload data short
+  if (truncate(FILE_NAME, (off_t)(data + limit / 2))) return -1;
+  m = grid_binary_open(FILE_NAME);
+  if (m)
+  {
+    grid_destroy(m);
+    return -1;
+  }
+
+  return 0;
+}
+
+static uint64_t get64(FILE *fp, long pos)
+{
+  uint64_t n = 0;
+
+  if (fseek(fp, pos, SEEK_SET) || fread(&n, sizeof(n), 1, fp) != 1) return 0;
+
+  return n;
+}
+
+static void put64(FILE *fp, long pos, uint64_t n)
+{
+  if (!fseek(fp, pos, SEEK_SET)) fwrite(&n, sizeof(n), 1, fp);
+}
@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "grid-csv.h"
+
+#define ROWS 150
+#define COLS 40
+#define FILE_NAME "test.csv"
+
+static void *from_csv(const char *field, size_t len, void *data);
+static size_t to_csv(void *payload, char *buf, size_t size, void *data);
+static int check(grid_s *g, grid_s *c, int rows, int cols);
+static int check_cell(grid_s *c, int row, int col, const char *s);
+
+int main(int argc, char **argv)
+{
+  static const char chars[] = "abcdefghijklmnopqrstuvwxyz ,\t\"\r\n";
+  static const char text[] =
+    "a,\"b\"\"c\",\r\n"
+    "\"d\ne\",,\"\"\r\n"
+    "x\"y,\"f\"g,h\n"
+    "\n"
+    "i,";
+  grid_s *g;
+  grid_s *c;
+  grid_size_s *size;
+  char s[64];
+  FILE *fp;
+  int seed = 1;
+  int row, col, n, i;
+  int failed = 0;
+
+  if (argc > 1) seed = atoi(argv[1]);
+  srand(seed);
+
+  size = grid_size_create();
+  grid_size_set(size, COLS, ROWS);
+
+    // Values of all lengths, some needing quotes, some empty, some absent
+  g = grid_create_storage(grid_storage_dense);
+  grid_set_size(g, size);
+  for (row = 0; row < ROWS; row++)
+    for (col = 0; col < COLS; col++)
+    {
+      if (rand() % 4 == 0) continue;
+      n = rand() % 40;
+      for (i = 0; i < n; i++)
+        s[i] = (rand() % 8) ? chars[rand() % 26] : chars[rand() % 32];
+      s[n] = '\0';
+      grid_goto(g, row, col);
+      grid_set_cell(g, strdup(s));
+    }
+
+  if (grid_to_csv(g, FILE_NAME, ',', to_csv, NULL)) failed = 1;
+  c = grid_from_csv(FILE_NAME, ',', grid_storage_mesh, from_csv, NULL);
+  if (!c || check(g, c, ROWS, COLS)) failed = 1;
+  if (c) grid_destroy(c);
+
+  if (grid_to_csv(g, FILE_NAME, '\t', to_csv, NULL)) failed = 1;
+  c = grid_from_csv(FILE_NAME, '\t', grid_storage_tiled, from_csv, NULL);
+  if (!c || check(g, c, ROWS, COLS)) failed = 1;
+  if (c) grid_destroy(c);
+
+  printf("csv: %s\n", failed ? "FAILED" : "PASSED");
+
+    // Line ends, ragged rows, stray quotes and a trailing delimiter
+  fp = fopen(FILE_NAME, "wb");
+  if (fp)
+  {
+    fputs(text, fp);
+    fclose(fp);
+  }
+  c = grid_from_csv(FILE_NAME, ',', grid_storage_sparse, from_csv, NULL);
+  if (!c ||
+      grid_size_get_width(grid_get_size(c)) != 3 ||
+      grid_size_get_height(grid_get_size(c)) != 5 ||
+      check_cell(c, 0, 0, "a") || check_cell(c, 0, 1, "b\"c") ||
+      check_cell(c, 0, 2, NULL) || check_cell(c, 1, 0, "d\ne") ||
+      check_cell(c, 1, 1, NULL) || check_cell(c, 1, 2, "") ||
+      check_cell(c, 2, 0, "x\"y") || check_cell(c, 2, 1, "f") ||
+      check_cell(c, 2, 2, "h") || check_cell(c, 3, 0, NULL) ||
+      check_cell(c, 4, 0, "i") || check_cell(c, 4, 1, NULL))
+    failed = 1;
+  if (c) grid_destroy(c);
+
+    // An empty file is an empty grid
+  fp = fopen(FILE_NAME, "wb");
+  if (fp) fclose(fp);
+  c = grid_from_csv(FILE_NAME, ',', grid_storage_mesh, from_csv, NULL);
+  if (!c || check(g, c, 0, 0)) failed = 1;
+  if (c) grid_destroy(c);
+
+  printf("csv edges: %s\n", failed ? "FAILED" : "PASSED");
+
+  grid_destroy(g);
+  grid_size_destroy(size);
+
+  return failed;
+}
+
+static void *from_csv(const char *field, size_t len, void *data)
+{
+  char *s;
+
+  (void)data;
+
+  s = malloc(len + 1);
+  if (s)
+  {
+    memcpy(s, field, len);
+    s[len] = '\0';
+  }
+
+  return s;
+}
+
+static size_t to_csv(void *payload, char *buf, size_t size, void *data)
+{
+  size_t n;
+
+  (void)data;
+
+  n = strlen((char *)payload);
+  if (n <= size) memcpy(buf, payload, n);
+
+  return n;
+}
+
+  // Every cell of the CSV grid must hold what the grid held
+
+static int check(grid_s *g, grid_s *c, int rows, int cols)
+{
+  int row, col;
+  int rc = 0;
+
+  if (grid_size_get_height(grid_get_size(c)) != rows ||
+      grid_size_get_width(grid_get_size(c)) != cols)
+    return -1;
+
+  for (row = 0; row < rows && !rc; row++)
+    for (col = 0; col < cols && !rc; col++)
+      rc = check_cell(c, row, col, (char *)grid_goto(g, row, col));
+
+  return rc;
+}
+
+static int check_cell(grid_s *c, int row, int col, const char *s)
+{
+  char *p;
+
+  p = (char *)grid_goto(c, row, col);
+  if (!p != !s || (p && strcmp(p, s))) return -1;
+
+  return 0;
+}
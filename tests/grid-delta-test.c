@@ -0,0 +1,239 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "grid-delta.h"
+
+#define ROUNDS 300
+
+static size_t to_delta(void *payload, void *buf, size_t size, void *data);
+static void *from_delta(const void *buf, size_t size, void *data);
+static int intcmp(void *pl1, void *pl2);
+static int sync(grid_journal_s *j, unsigned long since, grid_s *replica);
+static int check(grid_s *g, grid_s *r);
+static int *number(int n);
+static void count(grid_change_t change, int row, int col, int n, void *data);
+
+int main(int argc, char **argv)
+{
+  static const int keys[] = { 0, 1 };
+  grid_journal_s *j;
+  grid_s *g;
+  grid_s *fast;
+  grid_s *slow;
+  grid_size_s *size;
+  unsigned long fast_token, slow_token;
+  FILE *fp;
+  int seed = 1;
+  int i, k, op, row, col;
+  int failed = 0;
+
+  if (argc > 1) seed = atoi(argv[1]);
+  srand(seed);
+
+  size = grid_size_create();
+
+  g = grid_create();
+  fast = grid_create_storage(grid_storage_dense);
+  slow = grid_create_storage(grid_storage_sparse);
+
+    // A journal of cell changes alone may be trimmed
+  j = grid_journal_create(fast);
+  assert(j);
+  grid_set_cell(fast, number(1));
+  grid_journal_trim(j, grid_journal_checkpoint(j));
+  grid_journal_destroy(j);
+  grid_clear_cell(fast);
+
+  j = grid_journal_create(g);
+  assert(j);
+  fast_token = slow_token = grid_journal_checkpoint(j);
+
+    // One replica synchronized after every round, the other every fifth
+  for (i = 0; i < ROUNDS && !failed; i++)
+  {
+    for (k = rand() % 20; k >= 0; k--)
+    {
+      op = rand() % 24;
+      row = rand() % 14;
+      col = rand() % 14;
+
+      switch (op)
+      {
+        case 0:
+          grid_create_rows(g, row, 1 + rand() % 3);
+          break;
+        case 1:
+          grid_create_columns(g, col, 1 + rand() % 3);
+          break;
+        case 2:
+          grid_destroy_rows(g, row, 1 + rand() % 3);
+          break;
+        case 3:
+          grid_destroy_columns(g, col, 1 + rand() % 3);
+          break;
+        case 4:
+          grid_size_set(size, col, row);
+          grid_set_size(g, size);
+          break;
+        case 5:
+          if (rand() % 10 == 0) grid_sort_rows(g, keys, 2, intcmp, NULL);
+          break;
+        case 6:
+        case 7:
+          grid_goto(g, row, col);
+          grid_clear_cell(g);
+          break;
+        default:
+          if (!grid_size_get_width(grid_get_size(g))) break;
+          grid_goto(g, row, col);
+          grid_set_cell(g, number(rand() % 100));
+          break;
+      }
+    }
+
+    if (sync(j, fast_token, fast) || check(g, fast)) failed = 1;
+    fast_token = grid_journal_checkpoint(j);
+
+    if (i % 5 == 4)
+    {
+      if (sync(j, slow_token, slow) || check(g, slow)) failed = 1;
+      slow_token = grid_journal_checkpoint(j);
+    }
+
+    grid_journal_trim(j, slow_token);
+  }
+
+    // Forgotten changes cannot be written
+  fp = tmpfile();
+  assert(fp);
+  grid_journal_trim(j, fast_token);
+  if (fast_token > slow_token &&
+      !grid_delta_write(j, slow_token, fp, to_delta, NULL))
+    failed = 1;
+  fclose(fp);
+
+    // A few changes to a large grid make a small delta
+  grid_size_set(size, 200, 200);
+  grid_set_size(g, size);
+  fast_token = grid_journal_checkpoint(j);
+  for (i = 0; i < 5; i++)
+  {
+    grid_goto(g, i * 40, i * 30);
+    grid_set_cell(g, number(i));
+  }
+  fp = tmpfile();
+  assert(fp);
+  if (grid_delta_write(j, fast_token, fp, to_delta, NULL) || ftell(fp) > 256)
+    failed = 1;
+  fclose(fp);
+
+    // Replacing a payload is a single change
+  grid_journal_destroy(j);
+  grid_set_notify(g, count, &k);
+  k = 0;
+  grid_goto(g, 40, 30);
+  grid_set_cell(g, number(7));
+  if (k != 1) failed = 1;
+
+  grid_destroy(g);
+  grid_destroy(fast);
+  grid_destroy(slow);
+  grid_size_destroy(size);
+
+  printf("delta: %s\n", failed ? "FAILED" : "PASSED");
+
+  return failed;
+}
+
+static size_t to_delta(void *payload, void *buf, size_t size, void *data)
+{
+  (void)data;
+
+  if (size >= sizeof(int)) memcpy(buf, payload, sizeof(int));
+
+  return sizeof(int);
+}
+
+static void *from_delta(const void *buf, size_t size, void *data)
+{
+  int n;
+
+  (void)data;
+
+  if (size != sizeof(int)) return NULL;
+  memcpy(&n, buf, sizeof(int));
+
+  return number(n);
+}
+
+static int intcmp(void *pl1, void *pl2)
+{
+  if (!pl1 || !pl2) return !pl1 - !pl2;
+  return (*(int *)pl1 > *(int *)pl2) - (*(int *)pl1 < *(int *)pl2);
+}
+
+static int sync(grid_journal_s *j, unsigned long since, grid_s *replica)
+{
+  FILE *fp;
+  int rc;
+
+  fp = tmpfile();
+  if (!fp) return -1;
+
+  rc = grid_delta_write(j, since, fp, to_delta, NULL);
+  if (!rc)
+  {
+    rewind(fp);
+    rc = grid_delta_apply(replica, fp, from_delta, NULL);
+  }
+
+  fclose(fp);
+
+  return rc;
+}
+
+static int check(grid_s *g, grid_s *r)
+{
+  int rows, cols;
+  int y, x;
+  void *gp, *rp;
+
+  rows = grid_size_get_height(grid_get_size(g));
+  cols = grid_size_get_width(grid_get_size(g));
+
+  if (rows != grid_size_get_height(grid_get_size(r)) ||
+      cols != grid_size_get_width(grid_get_size(r)))
+    return -1;
+
+  for (y = 0; y < rows; y++)
+    for (x = 0; x < cols; x++)
+    {
+      gp = grid_goto(g, y, x);
+      rp = grid_goto(r, y, x);
+      if (intcmp(gp, rp)) return -1;
+    }
+
+  return 0;
+}
+
+static int *number(int n)
+{
+  int *p;
+
+  p = malloc(sizeof(int));
+  assert(p);
+  *p = n;
+
+  return p;
+}
+
+static void count(grid_change_t change, int row, int col, int n, void *data)
+{
+  (void)row;
+  (void)col;
+  (void)n;
+
+  if (change == grid_change_cell) ++*(int *)data;
+}
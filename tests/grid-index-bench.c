@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "grid.h"
+
+  // Storage engines to benchmark
+
+static grid_storage_t engines[] =
+{
+  grid_storage_mesh,
+  grid_storage_dense,
+  grid_storage_sparse,
+  grid_storage_tiled
+};
+
+static const char *names[] =
+{
+  "mesh",
+  "dense",
+  "sparse",
+  "tiled"
+};
+
+static double seconds(clock_t start);
+static void bench(grid_storage_t storage, int index,
+                  int rows, int cols, int lookups);
+
+int main(int argc, char **argv)
+{
+  int rows = 500;
+  int cols = 100;
+  int lookups = 2000;
+  int e;
+
+  if (argc > 1) rows = atoi(argv[1]);
+  if (argc > 2) cols = atoi(argv[2]);
+  if (argc > 3) lookups = atoi(argv[3]);
+
+  if (rows < 1 || cols < 1 || lookups < 1)
+  {
+    fprintf(stderr, "usage: %s [rows [columns [lookups]]]\n", argv[0]);
+    return 1;
+  }
+
+  printf("%d rows, %d columns, %d lookups (seconds)\n\n", rows, cols, lookups);
+  printf("%-8s %-6s %10s %10s %10s %10s\n",
+         "storage", "index", "fill", "rows", "columns", "find");
+
+  for (e = 0; e < (int)(sizeof(engines) / sizeof(engines[0])); e++)
+  {
+    bench(engines[e], 0, rows, cols, lookups);
+    bench(engines[e], 1, rows, cols, lookups);
+  }
+
+  return 0;
+}
+
+static double seconds(clock_t start)
+{
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static void bench(grid_storage_t storage, int index,
+                  int rows, int cols, int lookups)
+{
+  grid_s *g;
+  grid_size_s *size;
+  int *cells;
+  double fill, rowops, colops, find;
+  clock_t start;
+  int y, x, i;
+
+  g = grid_create_storage(storage);
+  size = grid_size_create();
+  cells = malloc((size_t)rows * cols * sizeof(int));
+  if (!g || !size || !cells)
+  {
+    fprintf(stderr, "out of memory\n");
+    exit(1);
+  }
+
+  grid_set_free(g, NULL);
+  grid_set_index(g, index);
+
+  grid_size_set(size, cols, rows);
+  grid_set_size(g, size);
+
+    // Assign every cell
+  start = clock();
+  for (y = 0; y < rows; y++)
+    for (x = 0; x < cols; x++)
+    {
+      grid_goto(g, y, x);
+      grid_set_cell(g, &cells[y * cols + x]);
+    }
+  fill = seconds(start);
+
+    // Insert and remove rows in the middle of the grid
+  start = clock();
+  for (i = 0; i < 100; i++)
+  {
+    grid_create_row(g, rows / 2);
+    grid_free_row(g, rows / 2);
+  }
+  rowops = seconds(start);
+
+    // Insert and remove columns in the middle of the grid
+  start = clock();
+  for (i = 0; i < 100; i++)
+  {
+    grid_create_column(g, cols / 2);
+    grid_free_column(g, cols / 2);
+  }
+  colops = seconds(start);
+
+    // Look up random payloads
+  srand(1);
+  start = clock();
+  for (i = 0; i < lookups; i++)
+    grid_find_by_reference(g, &cells[rand() % (rows * cols)]);
+  find = seconds(start);
+
+  printf("%-8s %-6s %10.4f %10.4f %10.4f %10.4f\n",
+         names[storage], index ? "on" : "off", fill, rowops, colops, find);
+
+  grid_destroy(g);
+  grid_size_destroy(size);
+  free(cells);
+}
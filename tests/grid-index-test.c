@@ -0,0 +1,185 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "grid.h"
+
+#define OPS 1500
+#define VALUES (OPS * 4)
+
+  // Storage engines to check
+
+static grid_storage_t engines[] =
+{
+  grid_storage_mesh,
+  grid_storage_dense,
+  grid_storage_sparse,
+  grid_storage_tiled
+};
+
+  // Payload data, each value placed in a grid at most once
+
+static int values[VALUES];
+
+static int check(grid_s *g, int used);
+static int numcmp(void *pl1, void *pl2);
+
+int main(int argc, char **argv)
+{
+  grid_s *g;
+  grid_size_s *size;
+  int seed = 1;
+  int used;
+  int e, i, op, row, col, n;
+  int keys[1];
+  int failed = 0;
+
+  if (argc > 1) seed = atoi(argv[1]);
+
+  for (i = 0; i < VALUES; i++) values[i] = i;
+
+  size = grid_size_create();
+
+  for (e = 0; e < (int)(sizeof(engines) / sizeof(engines[0])); e++)
+  {
+    srand(seed);
+
+    g = grid_create_storage(engines[e]);
+    grid_set_free(g, NULL);
+    if (grid_set_index(g, 1) || !grid_get_index(g)) failed = 1;
+
+    used = 0;
+
+    for (i = 0; i < OPS && !failed; i++)
+    {
+      op = rand() % 12;
+      row = rand() % 14 - 1;
+      col = rand() % 14 - 1;
+      n = rand() % 4 + 1;
+
+      switch (op)
+      {
+        case 0:
+        case 1:
+        case 2:
+          if (!grid_size_get_width(grid_get_size(g))) break;
+          grid_goto(g, row, col);
+          grid_set_cell(g, &values[used++]);
+          break;
+        case 3:
+          grid_goto(g, row, col);
+          grid_clear_cell(g);
+          break;
+        case 4:
+          grid_create_rows(g, row, n);
+          break;
+        case 5:
+          grid_create_columns(g, col, n);
+          break;
+        case 6:
+          grid_destroy_rows(g, row, n);
+          break;
+        case 7:
+          grid_destroy_columns(g, col, n);
+          break;
+        case 8:
+          grid_size_set(size, col + 1, row + 1);
+          grid_set_size(g, size);
+          break;
+        case 9:
+          keys[0] = (col < 0) ? 0 : col;
+          grid_sort_rows(g, keys, 1, numcmp, NULL);
+          break;
+        case 10:
+            // Rebuilt from scratch when enabled again
+          if (rand() % 8) break;
+          grid_set_index(g, 0);
+          if (grid_get_index(g)) failed = 1;
+          grid_set_index(g, 1);
+          break;
+        case 11:
+          if (!grid_size_get_width(grid_get_size(g))) break;
+          grid_goto(g, row, col);
+          grid_set_cell(g, &values[used++]);
+          grid_create_row(g, row);
+          grid_free_column(g, col);
+          break;
+      }
+
+      if (!grid_get_index(g) || check(g, used)) failed = 1;
+    }
+
+    grid_destroy(g);
+
+    printf("index %d: %s\n", (int)engines[e], failed ? "FAILED" : "PASSED");
+    if (failed) break;
+  }
+
+  grid_size_destroy(size);
+
+  return failed;
+}
+
+  // Every value looked up through the index must be found where a scan of
+  // the grid finds it, or not at all
+
+static int check(grid_s *g, int used)
+{
+  int *rows, *cols;
+  int height, width;
+  int y, x, i;
+  void *pl;
+  int rc = 0;
+
+  rows = malloc((size_t)(used + 1) * sizeof(int));
+  cols = malloc((size_t)(used + 1) * sizeof(int));
+  if (!rows || !cols)
+  {
+    free(rows);
+    free(cols);
+    return -1;
+  }
+
+  for (i = 0; i < used; i++) rows[i] = cols[i] = -1;
+
+  height = grid_size_get_height(grid_get_size(g));
+  width = grid_size_get_width(grid_get_size(g));
+
+  for (y = 0; y < height; y++)
+    for (x = 0; x < width; x++)
+    {
+      pl = grid_goto(g, y, x);
+      if (!pl) continue;
+      i = (int *)pl - values;
+      if (i < 0 || i >= used || rows[i] >= 0) rc = -1;
+      else
+      {
+        rows[i] = y;
+        cols[i] = x;
+      }
+    }
+
+  for (i = 0; i < used && !rc; i++)
+  {
+    pl = grid_find_by_reference(g, &values[i]);
+    if (rows[i] < 0)
+    {
+      if (pl) rc = -1;
+    }
+    else if (pl != &values[i] ||
+             grid_get_location(g)->y != rows[i] ||
+             grid_get_location(g)->x != cols[i])
+      rc = -1;
+  }
+
+  free(rows);
+  free(cols);
+
+  return rc;
+}
+
+static int numcmp(void *pl1, void *pl2)
+{
+  if (!pl1 || !pl2) return !pl1 - !pl2;
+  return (*(int *)pl1 > *(int *)pl2) - (*(int *)pl1 < *(int *)pl2);
+}
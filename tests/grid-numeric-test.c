@@ -0,0 +1,290 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "grid-numeric.h"
+
+  // Reference model: a plain row-major array with explicit empty flags
+
+#define MAXR 40
+#define MAXC 40
+
+static double ref[MAXR][MAXC];
+static int used[MAXR][MAXC];
+static int height, width;
+
+static void ref_insert_row(int row);
+static void ref_insert_column(int col);
+static void ref_remove_row(int row);
+static void ref_remove_column(int col);
+static int check(grid_numeric_s *gn, int row, int col, int rows, int cols);
+static int check_limits(void);
+
+int main(int argc, char **argv)
+{
+  grid_numeric_s *gn;
+  grid_size_s *size;
+  grid_numeric_t type;
+  int seed = 1;
+  int i, op, row, col, rows, cols;
+  int failed = 0;
+
+  if (argc > 1) seed = atoi(argv[1]);
+
+  size = grid_size_create();
+
+  for (type = grid_numeric_double; type <= grid_numeric_int64; type++)
+  {
+    srand(seed);
+    memset(ref, 0, sizeof(ref));
+    memset(used, 0, sizeof(used));
+    height = width = 0;
+
+    gn = grid_numeric_create(type);
+
+    for (i = 0; i < 5000 && !failed; i++)
+    {
+      op = rand() % 8;
+      row = (height) ? rand() % height : 0;
+      col = (width) ? rand() % width : 0;
+
+      switch (op)
+      {
+        case 0:
+        case 1:
+          if (!height || !width) break;
+          ref[row][col] = (double)(rand() % 2001 - 1000);
+          used[row][col] = 1;
+          if (type == grid_numeric_double)
+            grid_numeric_set_double(gn, row, col, ref[row][col]);
+          else
+            grid_numeric_set_int64(gn, row, col, (int64_t)ref[row][col]);
+          break;
+        case 2:
+          if (!height || !width) break;
+          ref[row][col] = 0.0;
+          used[row][col] = 0;
+          grid_numeric_clear_cell(gn, row, col);
+          break;
+        case 3:
+          if (height == MAXR) break;
+          row = rand() % (height + 1);
+          ref_insert_row(row);
+          grid_numeric_create_row(gn, row);
+          break;
+        case 4:
+          if (width == MAXC) break;
+          col = rand() % (width + 1);
+          ref_insert_column(col);
+          grid_numeric_create_column(gn, col);
+          break;
+        case 5:
+          if (!height) break;
+          ref_remove_row(row);
+          grid_numeric_destroy_row(gn, row);
+          break;
+        case 6:
+          if (!width) break;
+          ref_remove_column(col);
+          grid_numeric_destroy_column(gn, col);
+          break;
+        case 7:
+          rows = rand() % MAXR;
+          cols = rand() % MAXC;
+          if (!rows || !cols) rows = cols = 0;
+          while (height > rows) ref_remove_row(height - 1);
+          while (width > cols) ref_remove_column(width - 1);
+          while (height < rows) ref_insert_row(height);
+          while (width < cols) ref_insert_column(width);
+          grid_size_set(size, cols, rows);
+          if (grid_numeric_set_size(gn, size)) failed = 1;
+          break;
+      }
+
+      rows = (height) ? rand() % (height + 1) : 0;
+      cols = (width) ? rand() % (width + 1) : 0;
+      if (check(gn, row, col, rows, cols) ||
+          check(gn, 0, 0, height, width))
+        failed = 1;
+    }
+
+    grid_numeric_destroy(gn);
+
+    printf("numeric %d: %s\n", (int)type, failed ? "FAILED" : "PASSED");
+    if (failed) break;
+  }
+
+  grid_size_destroy(size);
+
+  if (!failed)
+  {
+    failed = check_limits();
+    printf("numeric limits: %s\n", failed ? "FAILED" : "PASSED");
+  }
+
+  return failed;
+}
+
+  // Numbers and sums at the int64 limits are exact, or are rejected rather
+  // than wrapped around
+
+static int check_limits(void)
+{
+  grid_numeric_s *gn;
+  grid_numeric_stats_s st;
+  grid_size_s *size;
+  int rc = 0;
+
+  gn = grid_numeric_create(grid_numeric_int64);
+  size = grid_size_create();
+  grid_size_set(size, 2, 3);
+  if (grid_numeric_set_size(gn, size)) rc = 1;
+
+  grid_numeric_set_int64(gn, 0, 0, INT64_MAX - 1);
+  grid_numeric_set_int64(gn, 1, 0, 1);
+  grid_numeric_set_int64(gn, 0, 1, INT64_MIN);
+  grid_numeric_set_int64(gn, 1, 1, INT64_MAX);
+
+  if (grid_numeric_column_stats(gn, 0, &st) || st.isum != INT64_MAX ||
+      st.imax != INT64_MAX - 1 || st.imin != 1)
+    rc = 1;
+  if (grid_numeric_column_stats(gn, 1, &st) || st.isum != -1) rc = 1;
+
+    // One more in either column overflows
+  grid_numeric_set_int64(gn, 2, 0, 1);
+  if (grid_numeric_column_stats(gn, 0, &st) != -1) rc = 1;
+  if (grid_numeric_stats(gn, 0, 0, 3, 2, &st) != -1) rc = 1;
+  grid_numeric_set_int64(gn, 2, 0, INT64_MIN);
+  if (grid_numeric_column_stats(gn, 0, &st) || st.isum != -1) rc = 1;
+  grid_numeric_set_int64(gn, 0, 1, INT64_MIN);
+  grid_numeric_set_int64(gn, 1, 1, -1);
+  if (grid_numeric_column_stats(gn, 1, &st) != -1) rc = 1;
+
+    // Doubles without an int64 value are rejected
+  if (grid_numeric_set_double(gn, 0, 0, NAN) != -1 ||
+      grid_numeric_set_double(gn, 0, 0, INFINITY) != -1 ||
+      grid_numeric_set_double(gn, 0, 0, -1e19) != -1 ||
+      grid_numeric_set_double(gn, 0, 0, 9223372036854775808.0) != -1 ||
+      grid_numeric_get_int64(gn, 0, 0) != INT64_MAX - 1)
+    rc = 1;
+  if (grid_numeric_set_double(gn, 0, 0, -9223372036854775808.0) ||
+      grid_numeric_get_int64(gn, 0, 0) != INT64_MIN ||
+      grid_numeric_set_double(gn, 0, 0, -2.5) ||
+      grid_numeric_get_int64(gn, 0, 0) != -2 ||
+      grid_numeric_set_double(gn, 5, 0, 1.0) != -1)
+    rc = 1;
+
+  grid_numeric_destroy(gn);
+
+    // A double grid reads as zero where its numbers have no int64 value
+  gn = grid_numeric_create(grid_numeric_double);
+  if (grid_numeric_set_size(gn, size)) rc = 1;
+  grid_numeric_set_double(gn, 0, 0, 1e300);
+  grid_numeric_set_double(gn, 1, 0, NAN);
+  grid_numeric_set_double(gn, 2, 0, -7.9);
+  if (grid_numeric_get_int64(gn, 0, 0) || grid_numeric_get_int64(gn, 1, 0) ||
+      grid_numeric_get_int64(gn, 2, 0) != -7)
+    rc = 1;
+  grid_numeric_destroy(gn);
+
+  grid_size_destroy(size);
+
+  return rc;
+}
+
+static void ref_insert_row(int row)
+{
+  memmove(ref[row + 1], ref[row], (size_t)(height - row) * sizeof(ref[0]));
+  memmove(used[row + 1], used[row], (size_t)(height - row) * sizeof(used[0]));
+  memset(ref[row], 0, sizeof(ref[0]));
+  memset(used[row], 0, sizeof(used[0]));
+  ++height;
+}
+
+static void ref_insert_column(int col)
+{
+  int r;
+
+  for (r = 0; r < MAXR; r++)
+  {
+    memmove(&ref[r][col + 1], &ref[r][col],
+            (size_t)(width - col) * sizeof(double));
+    memmove(&used[r][col + 1], &used[r][col],
+            (size_t)(width - col) * sizeof(int));
+    ref[r][col] = 0.0;
+    used[r][col] = 0;
+  }
+  ++width;
+}
+
+static void ref_remove_row(int row)
+{
+  --height;
+  memmove(ref[row], ref[row + 1], (size_t)(height - row) * sizeof(ref[0]));
+  memmove(used[row], used[row + 1], (size_t)(height - row) * sizeof(used[0]));
+  memset(ref[height], 0, sizeof(ref[0]));
+  memset(used[height], 0, sizeof(used[0]));
+}
+
+static void ref_remove_column(int col)
+{
+  int r;
+
+  --width;
+  for (r = 0; r < MAXR; r++)
+  {
+    memmove(&ref[r][col], &ref[r][col + 1],
+            (size_t)(width - col) * sizeof(double));
+    memmove(&used[r][col], &used[r][col + 1],
+            (size_t)(width - col) * sizeof(int));
+    ref[r][width] = 0.0;
+    used[r][width] = 0;
+  }
+}
+
+  // Compare every cell, and the summary of a range, against the model
+
+static int check(grid_numeric_s *gn, int row, int col, int rows, int cols)
+{
+  grid_numeric_stats_s st;
+  grid_size_s *gs;
+  double sum = 0.0, lo = 0.0, hi = 0.0;
+  long count = 0;
+  int r, c;
+
+  gs = grid_numeric_get_size(gn);
+  if (grid_size_get_height(gs) != height || grid_size_get_width(gs) != width)
+    return 1;
+
+  for (r = 0; r < height; r++)
+    for (c = 0; c < width; c++)
+      if (grid_numeric_is_set(gn, r, c) != used[r][c] ||
+          grid_numeric_get_double(gn, r, c) != ref[r][c])
+        return 1;
+
+  for (r = row; r < row + rows && r < height; r++)
+    for (c = col; c < col + cols && c < width; c++)
+    {
+      if (!used[r][c]) continue;
+      if (!count || ref[r][c] < lo) lo = ref[r][c];
+      if (!count || ref[r][c] > hi) hi = ref[r][c];
+      sum += ref[r][c];
+      count++;
+    }
+
+  if (grid_numeric_stats(gn, row, col, rows, cols, &st)) return 1;
+
+  if (st.count != count || st.sum != sum || st.min != lo || st.max != hi)
+    return 1;
+  if (count && fabs(st.mean - sum / count) > 1e-9) return 1;
+  if (grid_numeric_get_type(gn) == grid_numeric_int64 &&
+      (st.isum != (int64_t)sum || st.imin != (int64_t)lo ||
+       st.imax != (int64_t)hi))
+    return 1;
+
+  if (height && grid_numeric_row_stats(gn, row, &st)) return 1;
+  if (width && grid_numeric_column_stats(gn, col, &st)) return 1;
+
+  return 0;
+}
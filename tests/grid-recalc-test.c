@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "grid-recalc.h"
+
+  // Every computed cell sums a range of cells in the rows above it, so that
+  // computing cells in row-major order is a valid order
+
+#define ROWS 30
+#define COLS 10
+
+typedef struct
+{
+  long value;
+  int computed;
+  int row, col, rows, cols;
+} cell_s;
+
+static void eval(grid_s *g, int row, int column, void *payload, void *data);
+static int check(grid_s *g, grid_recalc_s *gr);
+
+int main(int argc, char **argv)
+{
+  grid_s *g;
+  grid_recalc_s *gr;
+  grid_size_s *size;
+  thread_pool_s *pool;
+  cell_s *c;
+  int seed = 1;
+  int i, n, row, col;
+  int failed = 0;
+
+  if (argc > 1) seed = atoi(argv[1]);
+  srand(seed);
+
+  pool = thread_pool_create(3);
+  size = grid_size_create();
+  grid_size_set(size, COLS, ROWS);
+
+  g = grid_create_storage(grid_storage_dense);
+  grid_set_size(g, size);
+  for (row = 0; row < ROWS; row++)
+    for (col = 0; col < COLS; col++)
+    {
+      c = calloc(1, sizeof(cell_s));
+      c->value = rand() % 100;
+      grid_goto(g, row, col);
+      grid_set_cell(g, c);
+    }
+
+  gr = grid_recalc_create(g, eval, NULL);
+
+  for (i = 0; i < 600 && !failed; i++)
+  {
+    row = rand() % ROWS;
+    col = rand() % COLS;
+    c = (cell_s *)grid_goto(g, row, col);
+
+    switch (rand() % 3)
+    {
+      case 0:
+        if (c->computed) break;
+        c->value = rand() % 100;
+        if (grid_recalc_mark(gr, row, col)) failed = 1;
+        break;
+      case 1:
+        if (!row) break;
+        c->computed = 1;
+        c->row = rand() % row;
+        c->col = rand() % COLS;
+        c->rows = (rand() % 2) ? 1 : rand() % (row - c->row) + 1;
+        c->cols = (rand() % 2) ? 1 : rand() % (COLS - c->col) + 1;
+        if (grid_recalc_set(gr, row, col) ||
+            grid_recalc_depend(gr, row, col, c->row, c->col, c->rows, c->cols))
+          failed = 1;
+        break;
+      case 2:
+        if (!c->computed) break;
+        c->computed = 0;
+        grid_recalc_unset(gr, row, col);
+        break;
+    }
+
+    if (i % 20 == 19)
+    {
+      n = grid_recalc_run(gr, (i % 40) ? pool : NULL);
+      if (n < 0 || grid_recalc_run(gr, pool) || check(g, gr)) failed = 1;
+    }
+  }
+
+  printf("recalc: %s\n", failed ? "FAILED" : "PASSED");
+
+    // A cell depending on itself is never computed
+  grid_recalc_depend(gr, 0, 0, 0, 0, 1, 1);
+  if (grid_recalc_run(gr, pool) != -1 || !grid_recalc_is_dirty(gr, 0, 0))
+    failed = 1;
+  grid_recalc_unset(gr, 0, 0);
+  if (grid_recalc_run(gr, pool) < 0 || grid_recalc_is_dirty(gr, 0, 0))
+    failed = 1;
+
+  printf("recalc cycle: %s\n", failed ? "FAILED" : "PASSED");
+
+  grid_recalc_destroy(gr);
+  grid_destroy(g);
+  grid_size_destroy(size);
+  thread_pool_destroy(pool);
+
+  return failed;
+}
+
+static void eval(grid_s *g, int row, int column, void *payload, void *data)
+{
+  grid_cursor_s *gc;
+  cell_s *c = (cell_s *)payload;
+  int y, x;
+
+  (void)row;
+  (void)column;
+  (void)data;
+
+  gc = grid_cursor_create(g);
+
+  c->value = 0;
+  for (y = c->row; y < c->row + c->rows; y++)
+    for (x = c->col; x < c->col + c->cols; x++)
+      c->value += ((cell_s *)grid_cursor_goto(gc, y, x))->value;
+
+  grid_cursor_destroy(gc);
+}
+
+  // Compare every computed cell against computing every cell again
+
+static int check(grid_s *g, grid_recalc_s *gr)
+{
+  static long ref[ROWS][COLS];
+  cell_s *c;
+  int row, col, y, x;
+
+  for (row = 0; row < ROWS; row++)
+    for (col = 0; col < COLS; col++)
+    {
+      c = (cell_s *)grid_goto(g, row, col);
+      ref[row][col] = c->value;
+      if (!c->computed) continue;
+
+      if (grid_recalc_is_dirty(gr, row, col)) return -1;
+
+      ref[row][col] = 0;
+      for (y = c->row; y < c->row + c->rows; y++)
+        for (x = c->col; x < c->col + c->cols; x++)
+          ref[row][col] += ref[y][x];
+      if (ref[row][col] != c->value) return -1;
+    }
+
+  grid_origin(g);
+
+  return 0;
+}
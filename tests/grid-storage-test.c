@@ -0,0 +1,682 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "grid.h"
+
+  // Storage engines to compare against the default mesh engine
+
+static grid_storage_t engines[] =
+{
+  grid_storage_dense,
+  grid_storage_sparse,
+  grid_storage_tiled
+};
+
+#define READERS 6
+
+  // Views of one mesh grid read from several threads at once
+
+typedef struct
+{
+  grid_view_s *views[READERS];
+  unsigned long rows[READERS];
+  unsigned long columns[READERS];
+  int failed[READERS];
+} readers_s;
+
+static int check(grid_s *ref, grid_s *g);
+static int check_cursor(grid_s *ref, grid_s *g);
+static int *number(int n);
+static int numcmp(void *pl1, void *pl2);
+static int paritycmp(void *pl1, void *pl2);
+static int eighthcmp(void *pl1, void *pl2);
+static int check_sorted(grid_s *ref, int key);
+static int check_find(grid_s *ref, grid_s *g, thread_pool_s *pool, int n);
+static int check_view(grid_s *ref, grid_s *g);
+static int check_readers(thread_pool_s *pool);
+static void read_view(int index, void *data);
+static int check_bands(int seed);
+static int edge(void);
+static unsigned long digest(grid_s *g, grid_order_t order);
+static int digest_cell(void *payload, int row, int col, void *data);
+static int digest_span(void * const *payloads, int row, int col, int count,
+                       void *data);
+
+int main(int argc, char **argv)
+{
+  grid_s *ref;
+  grid_s *g;
+  grid_s *snap;
+  grid_size_s *size;
+  unsigned long sd = 0;
+  thread_pool_s *pool;
+  reclaim_s *reclaim;
+  int seed = 1;
+  int e, i;
+  int op, row, col, n;
+  int keys[2];
+  int failed = 0;
+
+  if (argc > 1) seed = atoi(argv[1]);
+
+  size = grid_size_create();
+  pool = thread_pool_create(3);
+  reclaim = reclaim_create(1);
+
+  for (e = 0; e < (int)(sizeof(engines) / sizeof(engines[0])); e++)
+  {
+    srand(seed);
+
+    ref = grid_create();
+    g = grid_create_storage(engines[e]);
+    grid_set_reclaim(g, reclaim);
+    snap = NULL;
+
+    for (i = 0; i < 2000 && !failed; i++)
+    {
+      op = rand() % 14;
+      row = rand() % 12 - 1;
+      col = rand() % 12 - 1;
+
+      switch (op)
+      {
+        case 0:
+        case 1:
+          n = rand();
+            // An empty grid ignores the payload data
+          if (!grid_size_get_width(grid_get_size(ref))) break;
+          grid_goto(ref, row, col);
+          grid_goto(g, row, col);
+          grid_set_cell(ref, number(n));
+          grid_set_cell(g, number(n));
+          break;
+        case 2:
+          grid_create_row(ref, row);
+          grid_create_row(g, row);
+          break;
+        case 3:
+          grid_create_column(ref, col);
+          grid_create_column(g, col);
+          break;
+        case 4:
+          grid_destroy_row(ref, row);
+          grid_destroy_row(g, row);
+          break;
+        case 5:
+          grid_destroy_column(ref, col);
+          grid_destroy_column(g, col);
+          break;
+        case 6:
+          grid_size_set(size, col + 1, row + 1);
+          grid_set_size(ref, size);
+          grid_set_size(g, size);
+          break;
+        case 7:
+          grid_goto(ref, row, col);
+          grid_goto(g, row, col);
+          n = grid_current(ref) ? *(int *)grid_current(ref) : 0;
+          grid_origin(ref);
+          grid_origin(g);
+          if (n && (grid_find_by_value(ref, &n, numcmp) == NULL ||
+                    grid_find_by_value(g, &n, numcmp) == NULL))
+            failed = 1;
+          break;
+        case 8:
+          grid_goto(ref, row, col);
+          grid_goto(g, row, col);
+          if (digest(ref, grid_order_rows) != digest(g, grid_order_rows) ||
+              digest(ref, grid_order_columns) !=
+                digest(g, grid_order_columns))
+            failed = 1;
+          if (check_view(ref, g)) failed = 1;
+          break;
+        case 9:
+          grid_goto(ref, row, col);
+          grid_goto(g, row, col);
+          if (check_find(ref, g, pool, rand() % 2)) failed = 1;
+          break;
+        case 10:
+            // A snapshot must not change, whatever happens to g meanwhile
+          if (snap)
+          {
+            grid_destroy_row(snap, 0);
+            if (digest(snap, grid_order_rows) != sd) failed = 1;
+            grid_destroy(snap);
+            snap = NULL;
+            break;
+          }
+          snap = grid_snapshot(g);
+          if (!snap || !grid_is_snapshot(snap) || grid_is_snapshot(g))
+            failed = 1;
+          else if ((sd = digest(snap, grid_order_rows)) !=
+                     digest(g, grid_order_rows))
+            failed = 1;
+          break;
+        case 11:
+          n = rand() % 4 + 1;
+          if (rand() % 2)
+          {
+            grid_create_rows(ref, row, n);
+            grid_create_rows(g, row, n);
+          }
+          else
+          {
+            grid_create_columns(ref, col, n);
+            grid_create_columns(g, col, n);
+          }
+          break;
+        case 12:
+          n = rand() % 4 + 1;
+          if (rand() % 2)
+          {
+            grid_destroy_rows(ref, row, n);
+            grid_destroy_rows(g, row, n);
+          }
+          else
+          {
+            grid_destroy_columns(ref, col, n);
+            grid_destroy_columns(g, col, n);
+          }
+          break;
+        case 13:
+            // Ties on the first key must keep the same order however the
+            // sort is split across threads
+          keys[0] = col;
+          keys[1] = row;
+          n = grid_sort_rows(ref, keys, 2, eighthcmp, NULL);
+          if (grid_sort_rows(g, keys, 2, eighthcmp, pool) != n ||
+              (!n && check_sorted(ref, col)))
+            failed = 1;
+          break;
+      }
+
+      if (check(ref, g) || check_cursor(ref, g)) failed = 1;
+    }
+
+    grid_destroy(ref);
+    grid_destroy(g);
+
+      // Payload data of g is de-allocated in the background
+    reclaim_flush(reclaim);
+    if (reclaim_get_pending(reclaim)) failed = 1;
+
+      // Payload data of a snapshot outlives the grid
+    if (snap)
+    {
+      if (digest(snap, grid_order_rows) != sd) failed = 1;
+      grid_destroy(snap);
+    }
+
+    printf("storage %d: %s\n", (int)engines[e], failed ? "FAILED" : "PASSED");
+    if (failed) break;
+  }
+
+    // Grids spanning many tiles and bands of the tiled engine
+  if (!failed)
+  {
+    failed = check_bands(seed);
+    printf("storage bands: %s\n", failed ? "FAILED" : "PASSED");
+  }
+
+    // Views of a mesh grid read concurrently
+  if (!failed)
+  {
+    failed = check_readers(pool);
+    printf("storage readers: %s\n", failed ? "FAILED" : "PASSED");
+  }
+
+  grid_size_destroy(size);
+  thread_pool_destroy(pool);
+  reclaim_destroy(reclaim);
+
+  return failed;
+}
+
+static int check(grid_s *ref, grid_s *g)
+{
+  vertex_s *rv, *gv;
+  int rows, cols;
+  int y, x;
+  void *rp, *gp;
+
+  rows = grid_size_get_height(grid_get_size(ref));
+  cols = grid_size_get_width(grid_get_size(ref));
+
+  if (rows != grid_size_get_height(grid_get_size(g)) ||
+      cols != grid_size_get_width(grid_get_size(g)))
+    return -1;
+
+  rv = grid_get_location(ref);
+  gv = grid_get_location(g);
+  if (rv->x != gv->x || rv->y != gv->y) return -1;
+
+  for (y = 0; y < rows; y++)
+  {
+    for (x = 0; x < cols; x++)
+    {
+      rp = grid_goto(ref, y, x);
+      gp = grid_goto(g, y, x);
+      if (!rp != !gp) return -1;
+      if (rp && *(int *)rp != *(int *)gp) return -1;
+    }
+  }
+
+  grid_origin(ref);
+  grid_origin(g);
+
+  return 0;
+}
+
+static int check_cursor(grid_s *ref, grid_s *g)
+{
+  grid_cursor_s *gc;
+  vertex_s *gv;
+  double gx, gy;
+  int rows, cols;
+  int y, x, r, c;
+  void *rp, *gp;
+  int rc = 0;
+
+  rows = grid_size_get_height(grid_get_size(ref));
+  cols = grid_size_get_width(grid_get_size(ref));
+
+  gv = grid_get_location(g);
+  gx = gv->x;
+  gy = gv->y;
+
+  gc = grid_cursor_create(g);
+  assert(gc);
+
+    // Walk the grid in a snake, left to right then right to left
+  gp = grid_cursor_origin(gc);
+  for (y = 0; y < rows && !rc; y++)
+  {
+    for (x = 0; x < cols && !rc; x++)
+    {
+      grid_cursor_get_location(gc, &r, &c);
+      if (r != y || c != ((y % 2) ? cols - 1 - x : x)) rc = -1;
+      rp = grid_goto(ref, r, c);
+      if (!rp != !gp || (rp && *(int *)rp != *(int *)gp)) rc = -1;
+      if (x < cols - 1)
+        gp = (y % 2) ? grid_cursor_left(gc) : grid_cursor_right(gc);
+    }
+    if (y < rows - 1) gp = grid_cursor_down(gc);
+  }
+
+    // Moving off the grid fails, going beyond it is limited to the grid
+  if (rows && grid_cursor_down(gc)) rc = -1;
+  rp = grid_goto(ref, 0, 0);
+  gp = grid_cursor_goto(gc, -5, -5);
+  if (!rp != !gp || (rp && *(int *)rp != *(int *)gp)) rc = -1;
+
+  grid_cursor_destroy(gc);
+
+  if (gv->x != gx || gv->y != gy) rc = -1;
+  grid_goto(g, (int)gy, (int)gx);
+  grid_origin(ref);
+
+  return rc;
+}
+
+  // Insert, remove and resize across tile and band edges of a tiled grid,
+  // several hundred rows and columns at a time, against a dense grid
+
+static int check_bands(int seed)
+{
+  grid_s *ref;
+  grid_s *g;
+  grid_size_s *size;
+  int rows, cols;
+  int i, k, op, row, col, n;
+  int failed = 0;
+
+  srand(seed);
+
+  size = grid_size_create();
+  grid_size_set(size, 200, 300);
+
+  ref = grid_create_storage(grid_storage_dense);
+  g = grid_create_storage(grid_storage_tiled);
+  grid_set_size(ref, size);
+  grid_set_size(g, size);
+
+  for (i = 0; i < 120 && !failed; i++)
+  {
+    rows = grid_size_get_height(grid_get_size(ref));
+    cols = grid_size_get_width(grid_get_size(ref));
+
+    for (k = (rows && cols) ? 200 : 0; k > 0; k--)
+    {
+      row = rand() % rows;
+      col = rand() % cols;
+      n = rand();
+      grid_goto(ref, row, col);
+      grid_goto(g, row, col);
+      grid_set_cell(ref, number(n));
+      grid_set_cell(g, number(n));
+    }
+
+    op = rand() % 5;
+    row = edge();
+    col = edge();
+    n = 1 + rand() % 150;
+
+    switch (op)
+    {
+      case 0:
+        grid_create_rows(ref, row, n);
+        grid_create_rows(g, row, n);
+        break;
+      case 1:
+        grid_destroy_rows(ref, row, n);
+        grid_destroy_rows(g, row, n);
+        break;
+      case 2:
+        grid_create_columns(ref, col, n);
+        grid_create_columns(g, col, n);
+        break;
+      case 3:
+        grid_destroy_columns(ref, col, n);
+        grid_destroy_columns(g, col, n);
+        break;
+      case 4:
+        grid_size_set(size, 1 + rand() % 400, 1 + rand() % 700);
+        grid_set_size(ref, size);
+        grid_set_size(g, size);
+        break;
+    }
+
+    if (check(ref, g) ||
+        digest(ref, grid_order_rows) != digest(g, grid_order_rows))
+      failed = 1;
+  }
+
+  grid_destroy(ref);
+  grid_destroy(g);
+  grid_size_destroy(size);
+
+  return failed;
+}
+
+  // A row or column on or next to a tile boundary
+
+static int edge(void)
+{
+  return (rand() % 10) * 64 + rand() % 5 - 2;
+}
+
+static int *number(int n)
+{
+  int *p;
+
+  p = malloc(sizeof(int));
+  assert(p);
+  *p = n;
+
+  return p;
+}
+
+static int numcmp(void *pl1, void *pl2)
+{
+  if (!pl1 || !pl2) return -1;
+  return (*(int *)pl1 > *(int *)pl2) - (*(int *)pl1 < *(int *)pl2);
+}
+
+static int eighthcmp(void *pl1, void *pl2)
+{
+  return (*(int *)pl1 & 7) - (*(int *)pl2 & 7);
+}
+
+  // Rows must be in order of their first key, empty cells last
+
+static int check_sorted(grid_s *ref, int key)
+{
+  void *prev = NULL;
+  void *pl;
+  int rows;
+  int y;
+
+  rows = grid_size_get_height(grid_get_size(ref));
+
+  for (y = 0; y < rows; y++)
+  {
+    pl = grid_goto(ref, y, key);
+    if (y && (!prev ? pl != NULL : pl && eighthcmp(prev, pl) > 0))
+      return -1;
+    prev = pl;
+  }
+
+  grid_origin(ref);
+
+  return 0;
+}
+
+static int paritycmp(void *pl1, void *pl2)
+{
+  if (!pl1 || !pl2) return -1;
+  return (*(int *)pl1 & 1) != (*(int *)pl2 & 1);
+}
+
+  // Parallel search of g must agree with serial search of ref, and must
+  // leave both cursors alone
+
+static int check_find(grid_s *ref, grid_s *g, thread_pool_s *pool, int n)
+{
+  grid_cursor_s *gc;
+  vertices_s *all;
+  vertex_s *v;
+  double x, y;
+  void *pl, *rpl;
+  int row = -1, col = -1;
+  int rrow = -1, rcol = -1;
+  int count = 0;
+  int rc = 0;
+
+  x = grid_get_location(g)->x;
+  y = grid_get_location(g)->y;
+
+  pl = grid_find_first_by_value(g, &n, paritycmp, pool, &row, &col);
+  rpl = grid_find_first_by_value(ref, &n, paritycmp, NULL, &rrow, &rcol);
+  if (!pl != !rpl || (pl && numcmp(pl, rpl)) || row != rrow || col != rcol)
+    rc = 1;
+
+  all = grid_find_all_by_value(g, &n, paritycmp, pool);
+  if (!all) return 1;
+
+  gc = grid_cursor_create(ref);
+  for (v = list_head(all->vertices); v; v = list_next(all->vertices))
+  {
+    if (!count && (v->y != row || v->x != col)) rc = 1;
+    if (paritycmp(grid_cursor_goto(gc, (int)v->y, (int)v->x), &n)) rc = 1;
+    ++count;
+  }
+  grid_cursor_destroy(gc);
+  vertices_destroy(all);
+
+  if (!pl != !count) rc = 1;
+
+  all = grid_find_all_by_value(ref, &n, paritycmp, NULL);
+  if (!all || list_len(all->vertices) != count) rc = 1;
+  if (all) vertices_destroy(all);
+
+  if (grid_get_location(g)->x != x || grid_get_location(g)->y != y) rc = 1;
+
+  return rc;
+}
+
+  // A view of g must read the window of ref it shows, and must not change
+
+static int check_view(grid_s *ref, grid_s *g)
+{
+  grid_view_s *view;
+  grid_cursor_s *gc;
+  unsigned long d = 0;
+  int row, col, rows, cols, transpose;
+  int height, width;
+  int y, x;
+
+  row = rand() % 4;
+  col = rand() % 4;
+  rows = rand() % 10;
+  cols = rand() % 10;
+  transpose = rand() % 2;
+
+  view = grid_view_create(g, row, col, rows, cols, transpose);
+  if (!view) return 1;
+
+  height = grid_size_get_height(grid_get_size(view));
+  width = grid_size_get_width(grid_get_size(view));
+
+  gc = grid_cursor_create(ref);
+  for (y = 0; y < height; y++)
+    for (x = 0; x < width; x++)
+      digest_cell(transpose ? grid_cursor_goto(gc, row + x, col + y)
+                            : grid_cursor_goto(gc, row + y, col + x),
+                  y, x, &d);
+  grid_cursor_destroy(gc);
+
+  grid_destroy_row(view, 0);
+  grid_create_column(view, 0);
+
+  if (grid_get_storage(view) != grid_storage_view ||
+      height != grid_size_get_height(grid_get_size(view)) ||
+      width != grid_size_get_width(grid_get_size(view)) ||
+      digest(view, grid_order_rows) != d)
+  {
+    grid_view_destroy(view);
+    return 1;
+  }
+
+  grid_view_destroy(view);
+
+  return 0;
+}
+
+  // Views of a mesh grid, some transposed, must read alike whether read one
+  // at a time or all at once
+
+static int check_readers(thread_pool_s *pool)
+{
+  readers_s rd;
+  grid_s *g;
+  grid_size_s *size;
+  int i, k, y, x;
+  int rc = 0;
+
+  g = grid_create();
+  size = grid_size_create();
+  grid_size_set(size, 90, 120);
+  grid_set_size(g, size);
+  grid_size_destroy(size);
+
+  for (y = 0; y < 120; y++)
+    for (x = 0; x < 90; x++)
+    {
+      grid_goto(g, y, x);
+      if ((x + y) % 7) grid_set_cell(g, number(y * 90 + x));
+    }
+
+  for (i = 0; i < READERS; i++)
+  {
+    rd.views[i] = grid_view_create(g, i * 9, i * 5, 100 - i * 9, 80 - i * 5,
+                                   i % 2);
+    if (!rd.views[i]) return 1;
+    rd.rows[i] = digest(rd.views[i], grid_order_rows);
+    rd.columns[i] = digest(rd.views[i], grid_order_columns);
+    rd.failed[i] = !rd.rows[i] || !rd.columns[i];
+  }
+
+  for (k = 0; k < 4; k++)
+    thread_pool_run(pool, READERS, read_view, &rd);
+
+  for (i = 0; i < READERS; i++)
+  {
+    if (rd.failed[i]) rc = 1;
+    grid_view_destroy(rd.views[i]);
+  }
+
+  grid_destroy(g);
+
+  return rc;
+}
+
+static void read_view(int index, void *data)
+{
+  readers_s *rd = (readers_s *)data;
+  grid_view_s *view = rd->views[index];
+  grid_cursor_s *gc;
+  unsigned long d = 0;
+  int height, width;
+  int y, x;
+
+  if (digest(view, grid_order_rows) != rd->rows[index] ||
+      digest(view, grid_order_columns) != rd->columns[index])
+    rd->failed[index] = 1;
+
+    // A cursor walking down the columns of the view
+  height = grid_size_get_height(grid_get_size(view));
+  width = grid_size_get_width(grid_get_size(view));
+  gc = grid_cursor_create(view);
+  for (x = 0; x < width; x++)
+    for (y = 0; y < height; y++)
+      digest_cell(grid_cursor_goto(gc, y, x), y, x, &d);
+  grid_cursor_destroy(gc);
+
+  if (d != rd->columns[index]) rd->failed[index] = 1;
+
+    // Cells got straight from the view
+  d = 0;
+  for (y = 0; y < height; y++)
+    for (x = 0; x < width; x++)
+      digest_cell(grid_goto(view, y, x), y, x, &d);
+
+  if (d != rd->rows[index]) rd->failed[index] = 1;
+}
+
+static unsigned long digest(grid_s *g, grid_order_t order)
+{
+  unsigned long d = 0;
+  unsigned long s = 0;
+  vertex_s *v;
+  double x, y;
+
+  v = grid_get_location(g);
+  x = v->x;
+  y = v->y;
+
+  grid_foreach(g, order, digest_cell, &d);
+
+    // Row spans must visit the same cells as a row-major walk
+  if (order == grid_order_rows)
+  {
+    grid_foreach_row(g, digest_span, &s);
+    if (s != d) return 0;
+  }
+
+  if (v->x != x || v->y != y) return 0;
+
+  return d;
+}
+
+static int digest_cell(void *payload, int row, int col, void *data)
+{
+  unsigned long *d = (unsigned long *)data;
+
+  *d = *d * 31 + (unsigned long)(row * 1000 + col);
+  if (payload) *d = *d * 31 + (unsigned long)*(int *)payload;
+
+  return 0;
+}
+
+static int digest_span(void * const *payloads, int row, int col, int count,
+                       void *data)
+{
+  int i;
+
+  for (i = 0; i < count; i++)
+    digest_cell(payloads[i], row, col + i, data);
+
+  return 0;
+}
@@ -6,12 +6,17 @@
 
 void* xml2data(xmlNodePtr node);
 xmlNodePtr data2xml(void* payload);
+int data2writer(xmlTextWriterPtr writer, void* payload);
+void* reader2data(xmlTextReaderPtr reader);
 
 int main(int argc, char **argv)
 {
   char fname[80];
   grid_s *g;
   xmlDocPtr doc;
+  FILE *file;
+  thread_pool_s *pool;
+  int rc;
 
   if (argc < 2)
     return -1;
@@ -21,14 +26,45 @@ int main(int argc, char **argv)
   doc = xmlReadFile(fname, "UTF-8", 0);
 
   g = grid_from_xml_doc(doc, xml2data);
+  xmlFreeDoc(doc);
+  doc = NULL;
 
   if (g)
     doc = grid_to_xml_doc(g, data2xml);
 
   sprintf(fname, "%.70s.cmp", argv[1]);
   xmlSaveFormatFileEnc(fname, doc, "UTF-8", 1);
+  xmlFreeDoc(doc);
 
-  return 0;
+  if (!g)
+    return -1;
+  grid_destroy(g);
+
+  sprintf(fname, "%.70s.xml", argv[1]);
+  file = fopen(fname, "r");
+  if (!file)
+    return -1;
+  g = grid_read_xml(file, reader2data);
+  fclose(file);
+  if (!g)
+    return -1;
+
+  sprintf(fname, "%.70s.str", argv[1]);
+  file = fopen(fname, "w");
+  if (!file || grid_write_xml(g, file, data2writer, NULL))
+    return -1;
+  fclose(file);
+
+  pool = thread_pool_create(3);
+  sprintf(fname, "%.70s.par", argv[1]);
+  file = fopen(fname, "w");
+  rc = (!pool || !file || grid_write_xml(g, file, data2writer, pool)) ? -1 : 0;
+  if (file) fclose(file);
+  if (pool) thread_pool_destroy(pool);
+
+  grid_destroy(g);
+
+  return rc;
 }
 
 void* xml2data(xmlNodePtr node)
@@ -45,3 +81,25 @@ xmlNodePtr data2xml(void* payload)
   return text;
 }
 
+
+int data2writer(xmlTextWriterPtr writer, void* payload)
+{
+  if (!payload)
+    return 0;
+
+  return xmlTextWriterWriteString(writer, (const xmlChar*)payload);
+}
+
+void* reader2data(xmlTextReaderPtr reader)
+{
+  xmlNodePtr node;
+
+  if (xmlTextReaderIsEmptyElement(reader))
+    return NULL;
+
+  node = xmlTextReaderExpand(reader);
+  if (!node)
+    return NULL;
+
+  return (void*)xmlNodeGetContent(node);
+}
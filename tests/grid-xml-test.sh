@@ -12,4 +12,16 @@ then
   exit 1
 fi
 
+if ! cmp test.str test.xml > /dev/null
+then
+  echo test.str and test.xml differ
+  exit 1
+fi
+
+if ! cmp test.par test.xml > /dev/null
+then
+  echo test.par and test.xml differ
+  exit 1
+fi
+
 echo PASSED
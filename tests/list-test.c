@@ -5,8 +5,14 @@
 
 #include "list.h"
 
+#define RECLAIMED 5000
+
 void print_list(list_s *list);
 void print_reverse(list_s *list);
+int check_reclaim(int background);
+void count_free(void * const payload);
+
+static int freed;
 
 int main(int argc, char **argv)
 {
@@ -55,9 +61,58 @@ int main(int argc, char **argv)
 
   list_destroy(list);
 
+  if (check_reclaim(0) || check_reclaim(1)) return 1;
+
   return 0;
 }
 
+  // Every item handed to a reclaimer must be de-allocated once it drains
+
+int check_reclaim(int background)
+{
+  reclaim_s *r;
+  list_s *list;
+  int *n;
+  int i;
+  int rc = 0;
+
+  r = reclaim_create(background);
+  assert(r);
+
+  list = list_create();
+  list_set_free(list, count_free);
+  list_set_reclaim(list, r);
+
+  freed = 0;
+  for (i = 0; i < RECLAIMED; i++)
+  {
+    n = malloc(sizeof(int));
+    assert(n);
+    *n = i;
+    list_insert(list, n, (void*)TAIL);
+  }
+
+  for (i = 0; i < RECLAIMED / 10; i++)
+    list_delete(list, (void*)HEAD);
+
+  list_destroy(list);
+
+  reclaim_flush(r);
+  if (reclaim_get_pending(r) || freed != RECLAIMED) rc = 1;
+
+  reclaim_destroy(r);
+
+  printf("reclaim %d: %s\n", background, rc ? "FAILED" : "PASSED");
+
+  return rc;
+}
+
+void count_free(void * const payload)
+{
+  ++freed;
+  free(payload);
+}
+
 void print_list(list_s *list)
 {
   char *s;